@@ -0,0 +1,124 @@
+#include "benchSetup.h"
+#include "TilePool.h"
+#include "generateImage.h"
+#include "scenes.h"
+#include <cctype>   // Para std::isdigit
+#include <cstdlib>  // Para std::atoll
+#include <iostream> // Para std::cerr
+
+/**
+ * @brief Muestra el uso de un benchmark y las opciones de render que acepta.
+ * @param usage Línea de uso del programa.
+ */
+static void printBenchUsage(const char* usage) {
+    std::cerr << "Uso: " << usage << "\n"
+              << "Opciones de render (como en main; --config archivo lee un archivo \"clave = valor\"):\n";
+    for (const RenderConfigOption& option : renderConfigOptions()) {
+        std::string flag = option.flag;
+        std::cerr << "  " << flag << std::string(flag.size() < 20 ? 20 - flag.size() : 1, ' ') << option.description << "\n";
+    }
+    std::cerr << std::flush;
+}
+
+/**
+ * Lee los argumentos de un benchmark y aplica la configuración global del render.
+ *
+ * @param argc: Número de argumentos.
+ * @param argv: Argumentos del programa.
+ * @param usage: Línea de uso del programa.
+ * @param count: N leído.
+ * @param sceneName: Escena indicada.
+ * @param config: Configuración del render.
+ * @return bool: true si los argumentos son válidos.
+ */
+bool parseBenchArguments(int argc, char* argv[], const char* usage, long long& count, std::string& sceneName, RenderConfig& config) {
+    std::string error;
+    count = 0;
+    sceneName = "default";
+
+    // Como en main, el archivo de configuración se lee antes que las opciones, que tienen prioridad
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--config" && !loadRenderConfig(argv[i + 1], config, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return false;
+        }
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const RenderConfigOption* option = findRenderConfigFlag(arg);
+        if (option && i + 1 < argc) {
+            if (!setRenderConfigValue(config, option->key, argv[++i], error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return false;
+            }
+        } else if (arg == "--config" && i + 1 < argc) {
+            ++i; // Ya leído
+        } else if (!arg.empty() && std::isdigit(static_cast<unsigned char>(arg[0]))) {
+            count = std::atoll(arg.c_str());
+        } else if (!arg.empty() && arg[0] != '-') {
+            sceneName = arg;
+        } else {
+            printBenchUsage(usage);
+            return false;
+        }
+    }
+    if (count <= 0) {
+        printBenchUsage(usage);
+        return false;
+    }
+    if (!validateRenderConfig(config, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return false;
+    }
+
+    TilePool::setSharedThreadCount(config.threads);
+    setTileSize(config.tileSize);
+    setFrustumCulling(config.acceleration != Acceleration::NONE);
+    return true;
+}
+
+/**
+ * Construye una escena con su geometría paginada y su malla de esferas, como main.
+ *
+ * @param sceneName: Nombre de la escena.
+ * @param config: Configuración del render.
+ * @param scene: Escena construida.
+ * @param camera: Cámara de la escena.
+ * @param geometry: Geometría paginada abierta (nula si no hay --geometry).
+ * @return bool: true si la escena existe y la geometría se pudo abrir.
+ */
+bool buildBenchScene(const std::string& sceneName, const RenderConfig& config, Scene& scene, Camera& camera, std::shared_ptr<PagedGeometry>& geometry) {
+    if (!buildScene(sceneName, scene, camera)) {
+        std::cerr << "Error: escena desconocida '" << sceneName << "'" << std::endl;
+        return false;
+    }
+    if (!config.geometryPath.empty()) {
+        geometry = std::make_shared<PagedGeometry>();
+        if (!geometry->open(config.geometryPath, static_cast<size_t>(config.geometryCacheMB) * 1024 * 1024)) {
+            return false;
+        }
+        scene.setPagedGeometry(geometry);
+    }
+    if (config.acceleration == Acceleration::GRID) {
+        scene.moveSpheresToGrid();
+    }
+    return true;
+}
+
+/**
+ * Genera los rayos primarios de una imagen completa.
+ *
+ * @param camera: Cámara.
+ * @param config: Resolución y viewport.
+ * @return std::vector<Ray>: width x height rayos.
+ */
+std::vector<Ray> generatePrimaryRays(const Camera& camera, const RenderConfig& config) {
+    std::vector<Ray> rays;
+    rays.reserve(static_cast<size_t>(config.width) * config.height);
+    for (int y = 0; y < config.height; ++y) {
+        for (int x = 0; x < config.width; ++x) {
+            rays.push_back(camera.generateRay(x + 0.5, y + 0.5, config.width, config.height, config.viewportWidth, config.getViewportHeight(), config.distanceToViewport));
+        }
+    }
+    return rays;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file benchSetup.h
+ * @brief Argumentos, escena y rayos comunes de los programas de benchmark de bench/.
+ *
+ * Cada programa mide un subsistema del renderizador (kernels, malla de esferas, mallas comprimidas,
+ * geometría paginada, rayos secundarios, servicio de render, colocación NUMA) y acepta las mismas
+ * opciones de render que main, así que main solo construye escenas y renderiza.
+ */
+#ifndef BENCH_SETUP_H
+#define BENCH_SETUP_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Camera.h"
+#include "PagedGeometry.h"
+#include "Ray.h"
+#include "RenderConfig.h"
+#include "Scene.h"
+
+/**
+ * Lee los argumentos de un benchmark: el número N (obligatorio y positivo), el nombre de la escena y
+ * las opciones de RenderConfig (también --config archivo), y aplica los hilos, el tamaño de los tiles
+ * y el recorte por frustum.
+ *
+ * @param argc: Número de argumentos.
+ * @param argv: Argumentos del programa.
+ * @param usage: Línea de uso del programa, que se muestra si los argumentos no son válidos.
+ * @param count: N leído.
+ * @param sceneName: Escena indicada ("default" si no hay ninguna).
+ * @param config: Configuración del render.
+ * @return bool: true si los argumentos son válidos.
+ */
+bool parseBenchArguments(int argc, char* argv[], const char* usage, long long& count, std::string& sceneName, RenderConfig& config);
+
+/**
+ * Construye una escena como main: con la geometría paginada de --geometry y, con --accel grid, sus
+ * esferas movidas a la malla.
+ *
+ * @param sceneName: Nombre de la escena.
+ * @param config: Configuración del render.
+ * @param scene: Escena construida.
+ * @param camera: Cámara de la escena.
+ * @param geometry: Geometría paginada abierta (nula si no hay --geometry).
+ * @return bool: true si la escena existe y la geometría se pudo abrir.
+ */
+bool buildBenchScene(const std::string& sceneName, const RenderConfig& config, Scene& scene, Camera& camera, std::shared_ptr<PagedGeometry>& geometry);
+
+/**
+ * Genera los rayos primarios de una imagen completa, fila a fila, por el centro de cada píxel.
+ *
+ * @param camera: Cámara.
+ * @param config: Resolución y viewport.
+ * @return std::vector<Ray>: width x height rayos.
+ */
+std::vector<Ray> generatePrimaryRays(const Camera& camera, const RenderConfig& config);
+
+#endif // BENCH_SETUP_H
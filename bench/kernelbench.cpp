@@ -0,0 +1,63 @@
+/**
+ * @file kernelbench.cpp
+ * @brief Compara el kernel de trazado genérico con el especializado para las características de una escena.
+ *
+ * Renderiza la imagen completa N veces con cada kernel, alternándolos para que las variaciones de la
+ * máquina afecten a ambos por igual, e informa el mejor tiempo y el promedio de cada uno. Las dos
+ * imágenes deben ser idénticas.
+ *
+ * Uso:
+ *     kernelbench [escena] N [opciones de render]
+ */
+#include "benchSetup.h"
+#include "Framebuffer.h"
+#include "generateImage.h"
+#include <algorithm> // Para std::min
+#include <chrono>    // Para std::chrono::high_resolution_clock
+#include <cstring>   // Para std::memcmp
+#include <iostream>  // Para std::cout
+#include <limits>    // Para std::numeric_limits
+
+int main(int argc, char* argv[]) {
+    RenderConfig config;
+    std::string sceneName;
+    long long repetitions = 0;
+    if (!parseBenchArguments(argc, argv, "kernelbench [escena] N   (N renders por kernel)", repetitions, sceneName, config)) {
+        return 1;
+    }
+    Scene scene;
+    Camera camera;
+    std::shared_ptr<PagedGeometry> geometry;
+    if (!buildBenchScene(sceneName, config, scene, camera, geometry)) {
+        return 1;
+    }
+
+    unsigned features = scene.getFeatures(config.maxDepth);
+    std::cout << "Características de la escena: " << Scene::describeFeatures(features) << std::endl;
+
+    const char* names[2] = { "genérico", "especializado" };
+    Framebuffer images[2] = { Framebuffer(config.width, config.height), Framebuffer(config.width, config.height) };
+    double best[2] = { std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+    double total[2] = { 0.0, 0.0 };
+
+    for (long long run = 0; run < repetitions; ++run) {
+        for (int variant = 0; variant < 2; ++variant) {
+            auto start = std::chrono::high_resolution_clock::now();
+            generateImageRows(scene, camera, images[variant], config.width, config.height, 0, config.height, config.maxDepth,
+                              config.viewportWidth, config.getViewportHeight(), config.distanceToViewport, variant == 1);
+            std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+            best[variant] = std::min(best[variant], duration.count());
+            total[variant] += duration.count();
+        }
+    }
+
+    for (int variant = 0; variant < 2; ++variant) {
+        std::cout << "Kernel " << names[variant] << ": mejor " << best[variant] << " s, promedio "
+                  << total[variant] / repetitions << " s" << std::endl;
+    }
+    std::cout << "Aceleración (mejor tiempo): " << best[0] / best[1] << "x" << std::endl;
+
+    bool identical = std::memcmp(images[0].getData(), images[1].getData(), images[0].getByteSize()) == 0;
+    std::cout << "Imágenes idénticas: " << (identical ? "sí" : "no") << std::endl;
+    return identical ? 0 : 1;
+}
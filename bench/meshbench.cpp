@@ -0,0 +1,129 @@
+/**
+ * @file meshbench.cpp
+ * @brief Compara una CompressedMesh con un BVH en precisión completa (MeshBVH) para unos N triángulos.
+ *
+ * Uso:
+ *     meshbench N [opciones de render]
+ * La resolución y el viewport de las opciones fijan los rayos primarios que se trazan.
+ */
+#include "benchSetup.h"
+#include "CompressedMesh.h"
+#include "Triangle.h"
+#include "scenes.h"
+#include <algorithm> // Para std::max
+#include <chrono>    // Para std::chrono::high_resolution_clock
+#include <cmath>     // Para std::fabs
+#include <cstdint>   // Para std::uint32_t
+#include <iostream>  // Para std::cout
+#include <limits>    // Para std::numeric_limits
+
+#define MESH_FACE_JUMP_STEPS 10 // Diferencia de distancia (en pasos de la rejilla) a partir de la cual se cuenta otra cara
+
+/**
+ * @brief Compara una CompressedMesh con un BVH en precisión completa (MeshBVH) sobre la misma malla indexada.
+ *
+ * Informa la memoria por triángulo de las dos mallas con su BVH (y, como referencia, la de un objeto
+ * Triangle), el error de cuantización de los vértices y los rayos por segundo de cada una con los
+ * rayos primarios de una imagen completa. Ambos BVH se construyen con el mismo SAH, así que la
+ * diferencia de velocidad y de memoria es la de la cuantización; también se cuentan los rayos con
+ * impacto en solo una de las dos y la mayor diferencia de distancia, que debe ser del orden del
+ * paso de la rejilla salvo en los rayos rasantes que acaban en otra cara.
+ *
+ * @param count Número aproximado de triángulos.
+ * @param config Parámetros del render (resolución y viewport de los rayos).
+ * @return Código de salida del programa.
+ */
+static int benchmarkCompressedMesh(size_t count, const RenderConfig& config) {
+    TriangleMesh surface;
+    addBumpySphere(surface, count, Vector3D(0, 0, 0), 3.0);
+    size_t triangleCount = surface.triangleCount();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    CompressedMesh mesh;
+    mesh.build(surface, MeshMaterial());
+    std::chrono::duration<double> buildDuration = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    MeshBVH reference;
+    reference.build(surface);
+    std::chrono::duration<double> referenceBuildDuration = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Triángulos: " << triangleCount << ", vértices: " << surface.vertices.size() << ", nodos del BVH: "
+              << mesh.getNodeCount() << " comprimidos y " << reference.getNodeCount() << " en precisión completa" << std::endl;
+    std::cout << "Construcción: " << buildDuration.count() << " s la malla comprimida, " << referenceBuildDuration.count()
+              << " s la de precisión completa" << std::endl;
+    double compressedBytes = static_cast<double>(mesh.getMemoryBytes()) / triangleCount;
+    double referenceBytes = static_cast<double>(reference.getMemoryBytes()) / triangleCount;
+    std::cout << "Memoria por triángulo con el BVH: " << compressedBytes << " bytes en la malla comprimida, " << referenceBytes
+              << " en la malla indexada con double (" << referenceBytes / compressedBytes << "x); un objeto Triangle, sin BVH, ocupa "
+              << sizeof(Triangle) << std::endl;
+
+    // Error de cuantización: los índices de la malla comprimida siguen apuntando a los vértices originales
+    double maxError = 0.0;
+    for (std::uint32_t i = 0; i < mesh.size(); ++i) {
+        Vector3D corners[3];
+        mesh.getTriangle(i, corners[0], corners[1], corners[2]);
+        for (int corner = 0; corner < 3; ++corner) {
+            Vector3D error = corners[corner] - surface.vertices[mesh.getIndices()[i * 3 + corner]];
+            maxError = std::max(maxError, std::max(std::fabs(error.getX()), std::max(std::fabs(error.getY()), std::fabs(error.getZ()))));
+        }
+    }
+    std::cout << "Cuantización: paso de " << mesh.getQuantizationStep() << ", error máximo de un vértice " << maxError << std::endl;
+
+    // Rayos primarios de una imagen completa, con la malla ocupando el centro
+    Camera camera(0, 0, -6);
+    std::vector<Ray> rays = generatePrimaryRays(camera, config);
+
+    std::vector<double> meshDistances(rays.size()), referenceDistances(rays.size());
+    size_t hits = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < rays.size(); ++r) {
+        std::uint32_t index;
+        meshDistances[r] = std::numeric_limits<double>::infinity();
+        hits += mesh.intersect(rays[r], std::numeric_limits<double>::infinity(), meshDistances[r], index);
+    }
+    std::chrono::duration<double> meshDuration = std::chrono::high_resolution_clock::now() - start;
+    double meshRate = rays.size() / meshDuration.count();
+    std::cout << "Malla comprimida: " << rays.size() << " rayos en " << meshDuration.count() << " s ("
+              << meshRate / 1e6 << " millones de rayos por segundo, " << hits << " impactos)" << std::endl;
+
+    size_t referenceHits = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < rays.size(); ++r) {
+        std::uint32_t index;
+        referenceDistances[r] = std::numeric_limits<double>::infinity();
+        referenceHits += reference.intersect(rays[r], std::numeric_limits<double>::infinity(), referenceDistances[r], index);
+    }
+    std::chrono::duration<double> referenceDuration = std::chrono::high_resolution_clock::now() - start;
+    double referenceRate = rays.size() / referenceDuration.count();
+    std::cout << "Precisión completa: " << rays.size() << " rayos en " << referenceDuration.count() << " s ("
+              << referenceRate / 1e6 << " millones de rayos por segundo, " << referenceHits << " impactos)" << std::endl;
+    std::cout << "Velocidad de la malla comprimida frente a la de precisión completa: " << meshRate / referenceRate << "x" << std::endl;
+
+    // Un impacto a más de MESH_FACE_JUMP_STEPS pasos de la rejilla es otra cara (un rayo rasante en la silueta)
+    int mismatches = 0, faceJumps = 0;
+    double maxDistanceError = 0.0;
+    double jumpThreshold = MESH_FACE_JUMP_STEPS * mesh.getQuantizationStep();
+    for (size_t r = 0; r < rays.size(); ++r) {
+        bool meshHit = meshDistances[r] < std::numeric_limits<double>::infinity();
+        double distanceError = std::fabs(meshDistances[r] - referenceDistances[r]);
+        if (meshHit != (referenceDistances[r] < std::numeric_limits<double>::infinity())) {
+            ++mismatches;
+        } else if (meshHit && distanceError > jumpThreshold) {
+            ++faceJumps;
+        } else if (meshHit) {
+            maxDistanceError = std::max(maxDistanceError, distanceError);
+        }
+    }
+    std::cout << "Rayos con impacto en solo una de las dos: " << mismatches << ", en otra cara: " << faceJumps
+              << ", diferencia máxima de distancia en los demás " << maxDistanceError << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    RenderConfig config;
+    std::string sceneName;
+    long long count = 0;
+    if (!parseBenchArguments(argc, argv, "meshbench N   (unos N triángulos)", count, sceneName, config)) {
+        return 1;
+    }
+    return benchmarkCompressedMesh(static_cast<size_t>(count), config);
+}
@@ -0,0 +1,368 @@
+/**
+ * @file microbench.cpp
+ * @brief Micro-benchmarks de los kernels de intersección y sombreado.
+ *
+ * Mide Triangle::intersects, Sphere::intersects, Plane::intersects, Scene::computeLighting y
+ * reflectRay sobre conjuntos de rayos aleatorios (deterministas) con muchos impactos, pocos impactos
+ * y rayos rasantes, e informa nanosegundos y ciclos por llamada. Cada medición se repite varias veces
+ * después de unas pasadas de calentamiento; se informa la mediana, el mínimo y la dispersión.
+ *
+ * Sirve para validar cambios de SIMD o de disposición de datos en un kernel antes de medir imágenes
+ * completas. Se compila y ejecuta con `make microbench`.
+ *
+ * Uso:
+ *     microbench [filtro] [--reps N]
+ * Solo se ejecutan los kernels cuyo nombre contiene el filtro.
+ */
+#include "Camera.h"
+#include "Plane.h"
+#include "Random.h"
+#include "Ray.h"
+#include "Scene.h"
+#include "Sphere.h"
+#include "Triangle.h"
+#include "Vector3D.h"
+#include "scenes.h"
+#include "utils.h"
+#include <algorithm> // Para std::sort y std::min
+#include <chrono>    // Para std::chrono::steady_clock
+#include <cmath>     // Para std::sqrt
+#include <cstdint>   // Para uint64_t
+#include <cstdio>    // Para std::printf
+#include <cstdlib>   // Para std::atoi
+#include <string>    // Para std::string
+#include <vector>    // Para std::vector
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // Para __rdtsc
+#define MICROBENCH_HAS_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>    // Para __rdtsc
+#define MICROBENCH_HAS_TSC 1
+#else
+#define MICROBENCH_HAS_TSC 0
+#endif
+
+#define MICROBENCH_RAYS 4096          // Elementos de cada conjunto (caben en la caché de datos)
+#define MICROBENCH_MIN_CALLS 400000   // Llamadas mínimas de cada repetición
+#define MICROBENCH_WARMUP 3           // Repeticiones de calentamiento, no medidas
+#define MICROBENCH_REPETITIONS 15     // Repeticiones medidas por defecto
+
+// Acumula los resultados de los kernels para que el compilador no elimine las llamadas
+static volatile double sink = 0.0;
+
+/**
+ * @brief Resultado de medir un kernel sobre un conjunto de entradas.
+ */
+struct MicroResult {
+    double nsMedian = 0.0;      ///< Mediana de los nanosegundos por llamada.
+    double nsMin = 0.0;         ///< Mínimo de los nanosegundos por llamada.
+    double nsSpread = 0.0;      ///< Desviación estándar relativa a la media (en %).
+    double cyclesMedian = 0.0;  ///< Mediana de los ciclos del contador de tiempo por llamada (0 si no hay).
+    double hitRate = 0.0;       ///< Fracción de llamadas que devolvieron un impacto.
+    size_t calls = 0;           ///< Llamadas de cada repetición (0 si el conjunto estaba vacío y no se midió).
+};
+
+/**
+ * Lee el contador de ciclos del procesador (TSC en x86).
+ *
+ * El TSC avanza a frecuencia constante (la nominal), así que con turbo o ahorro de energía no coincide
+ * exactamente con los ciclos del núcleo; sirve para comparar dos versiones en la misma máquina.
+ *
+ * @return uint64_t: Valor del contador, o 0 si la arquitectura no tiene uno accesible.
+ */
+static uint64_t readCycles() {
+#if MICROBENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Mide un kernel llamándolo para cada elemento de un conjunto.
+ *
+ * @param count: Número de elementos del conjunto.
+ * @param repetitions: Repeticiones medidas.
+ * @param kernel: Función que procesa el elemento i; devuelve 1 si hubo impacto (o un valor cualquiera que se acumula en sink).
+ * @return MicroResult: Tiempos por llamada (con calls = 0 si el conjunto está vacío).
+ */
+template <typename Kernel>
+static MicroResult measure(size_t count, int repetitions, Kernel&& kernel) {
+    if (count == 0) {
+        return MicroResult();
+    }
+    size_t passes = (MICROBENCH_MIN_CALLS + count - 1) / count;
+    double calls = static_cast<double>(passes * count);
+    std::vector<double> nanoseconds, cycles;
+    double hits = 0.0;
+
+    for (int repetition = -MICROBENCH_WARMUP; repetition < repetitions; ++repetition) {
+        double accumulated = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        uint64_t startCycles = readCycles();
+        for (size_t pass = 0; pass < passes; ++pass) {
+            for (size_t i = 0; i < count; ++i) {
+                accumulated += kernel(i);
+            }
+        }
+        uint64_t endCycles = readCycles();
+        std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+        sink = sink + accumulated;
+        if (repetition >= 0) {
+            nanoseconds.push_back(duration.count() / calls);
+            cycles.push_back(static_cast<double>(endCycles - startCycles) / calls);
+            hits = accumulated / calls;
+        }
+    }
+
+    MicroResult result;
+    double mean = 0.0, variance = 0.0;
+    for (double value : nanoseconds) {
+        mean += value / nanoseconds.size();
+    }
+    for (double value : nanoseconds) {
+        variance += (value - mean) * (value - mean) / nanoseconds.size();
+    }
+    std::sort(nanoseconds.begin(), nanoseconds.end());
+    std::sort(cycles.begin(), cycles.end());
+    result.nsMedian = nanoseconds[nanoseconds.size() / 2];
+    result.nsMin = nanoseconds.front();
+    result.nsSpread = mean > 0.0 ? 100.0 * std::sqrt(variance) / mean : 0.0;
+    result.cyclesMedian = cycles[cycles.size() / 2];
+    result.hitRate = hits;
+    result.calls = passes * count;
+    return result;
+}
+
+/**
+ * Devuelve el número aleatorio i de una secuencia determinista.
+ *
+ * @param seed: Semilla de la secuencia.
+ * @param i: Posición dentro de la secuencia.
+ * @return double: Número en [0, 1).
+ */
+static double uniform(uint64_t seed, uint64_t i) {
+    return hashToUnit(hashMix(seed * 0x9E3779B97F4A7C15ull + i));
+}
+
+/**
+ * Devuelve una dirección aleatoria uniforme sobre la esfera unidad.
+ *
+ * @param seed: Semilla de la secuencia.
+ * @param i: Índice de la dirección.
+ * @return Vector3D: Vector unitario.
+ */
+static Vector3D randomDirection(uint64_t seed, uint64_t i) {
+    double z = 2.0 * uniform(seed, 2 * i) - 1.0;
+    double phi = 2.0 * 3.14159265358979323846 * uniform(seed, 2 * i + 1);
+    double r = std::sqrt(std::max(0.0, 1.0 - z * z));
+    return Vector3D(r * std::cos(phi), r * std::sin(phi), z);
+}
+
+/**
+ * Genera rayos hacia una esfera con el parámetro de impacto (distancia entre la recta del rayo y el
+ * centro, relativa al radio) en un rango dado: menor que 1 impacta, mayor que 1 no, cerca de 1 es rasante.
+ *
+ * @param center: Centro de la esfera.
+ * @param radius: Radio de la esfera.
+ * @param minImpact: Parámetro de impacto mínimo.
+ * @param maxImpact: Parámetro de impacto máximo.
+ * @param seed: Semilla de los rayos.
+ * @return std::vector<Ray>: MICROBENCH_RAYS rayos.
+ */
+static std::vector<Ray> raysTowardSphere(const Vector3D& center, double radius, double minImpact, double maxImpact, uint64_t seed) {
+    std::vector<Ray> rays;
+    for (uint64_t i = 0; i < MICROBENCH_RAYS; ++i) {
+        Vector3D direction = randomDirection(seed, i);
+        Vector3D origin = center - direction * (5.0 * radius);
+        // Desplazar el origen en perpendicular a la dirección según el parámetro de impacto
+        Vector3D side = direction.cross(std::abs(direction.getX()) < 0.9 ? Vector3D(1, 0, 0) : Vector3D(0, 1, 0)).normalize();
+        double impact = minImpact + (maxImpact - minImpact) * uniform(seed + 1, i);
+        rays.emplace_back(origin + side * (impact * radius), direction);
+    }
+    return rays;
+}
+
+/**
+ * Genera rayos hacia puntos del plano z = 0 elegidos por un generador, desde el semiespacio z > 0.
+ *
+ * @param seed: Semilla de los rayos.
+ * @param target: Función que devuelve el punto objetivo i (en el plano z = 0).
+ * @return std::vector<Ray>: MICROBENCH_RAYS rayos.
+ */
+template <typename Target>
+static std::vector<Ray> raysTowardPlane(uint64_t seed, Target&& target) {
+    std::vector<Ray> rays;
+    for (uint64_t i = 0; i < MICROBENCH_RAYS; ++i) {
+        Vector3D direction = randomDirection(seed, i);
+        // Orígenes en el hemisferio z > 0, sin direcciones casi paralelas al plano
+        Vector3D up = Vector3D(direction.getX(), direction.getY(), std::max(0.2, std::abs(direction.getZ()))).normalize();
+        Vector3D goal = target(i);
+        rays.emplace_back(goal + up * 5.0, -up);
+    }
+    return rays;
+}
+
+/**
+ * Imprime una fila de la tabla de resultados.
+ *
+ * @param kernel: Nombre del kernel.
+ * @param set: Nombre del conjunto de entradas.
+ * @param result: Resultado de la medición.
+ * @param showHits: false si el kernel no tiene impactos que contar.
+ */
+static void printResult(const char* kernel, const char* set, const MicroResult& result, bool showHits = true) {
+    std::printf("%-24s %-22s ", kernel, set);
+    if (result.calls == 0) {
+        std::printf("(conjunto vacío, sin medir)\n");
+        return;
+    }
+    if (showHits) {
+        std::printf("%8.1f%% ", 100.0 * result.hitRate);
+    } else {
+        std::printf("%9s ", "-");
+    }
+    std::printf("%10.2f %10.2f %7.1f%% ", result.nsMedian, result.nsMin, result.nsSpread);
+    if (MICROBENCH_HAS_TSC) {
+        std::printf("%10.1f\n", result.cyclesMedian);
+    } else {
+        std::printf("%10s\n", "-");
+    }
+}
+
+/**
+ * @brief Ejecuta los micro-benchmarks seleccionados e imprime una tabla.
+ */
+int main(int argc, char* argv[]) {
+    std::string filter;
+    int repetitions = MICROBENCH_REPETITIONS;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--reps" && i + 1 < argc) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        } else {
+            filter = arg;
+        }
+    }
+    auto selected = [&](const char* kernel) { return filter.empty() || std::string(kernel).find(filter) != std::string::npos; };
+
+    std::printf("%d repeticiones de al menos %d llamadas (%d de calentamiento); conjuntos de %d elementos\n",
+                repetitions, MICROBENCH_MIN_CALLS, MICROBENCH_WARMUP, MICROBENCH_RAYS);
+    std::printf("%-24s %-22s %9s %10s %11s %8s %10s\n", "kernel", "conjunto", "impactos", "ns (med.)", "ns (mín.)", "disp.", "ciclos");
+
+    const Vector3D white(255, 255, 255);
+
+    if (selected("Sphere::intersects")) {
+        Sphere sphere(Vector3D(0, 0, 0), 1.0, white, -1, 0.0);
+        const struct { const char* name; double minImpact, maxImpact; } sets[] = {
+            { "impactos", 0.0, 0.9 }, { "fallos", 1.1, 3.0 }, { "rasantes", 0.98, 1.02 } };
+        for (const auto& set : sets) {
+            std::vector<Ray> rays = raysTowardSphere(Vector3D(0, 0, 0), 1.0, set.minImpact, set.maxImpact, 11);
+            printResult("Sphere::intersects", set.name, measure(rays.size(), repetitions, [&](size_t i) {
+                double t;
+                return sphere.intersects(rays[i], t) ? 1.0 : 0.0;
+            }));
+        }
+    }
+
+    if (selected("Triangle::intersects")) {
+        Vector3D a(-1, -1, 0), b(1, -1, 0), c(0, 1, 0);
+        Triangle triangle(a, b, c, white, -1, 0.0);
+        // Objetivos: dentro del triángulo, fuera de él en su plano, o junto a sus aristas
+        auto barycentric = [&](double u, double v) { return a + (b - a) * u + (c - a) * v; };
+        Vector3D centroid = (a + b + c) * (1.0 / 3.0);
+        std::vector<Ray> inside = raysTowardPlane(21, [&](uint64_t i) {
+            double u = uniform(22, 2 * i), v = uniform(22, 2 * i + 1);
+            if (u + v > 1.0) {
+                u = 1.0 - u;
+                v = 1.0 - v;
+            }
+            // Reducido hacia el centroide para no acercarse a las aristas
+            return centroid + (barycentric(u, v) - centroid) * 0.9;
+        });
+        std::vector<Ray> outside = raysTowardPlane(23, [&](uint64_t i) {
+            double angle = 2.0 * 3.14159265358979323846 * uniform(24, 2 * i);
+            double distance = 1.5 + 2.0 * uniform(24, 2 * i + 1);
+            return Vector3D(distance * std::cos(angle), distance * std::sin(angle), 0);
+        });
+        std::vector<Ray> edges = raysTowardPlane(25, [&](uint64_t i) {
+            const Vector3D corners[3] = { a, b, c };
+            int edge = static_cast<int>(3 * uniform(26, 3 * i));
+            Vector3D p = corners[edge] + (corners[(edge + 1) % 3] - corners[edge]) * uniform(26, 3 * i + 1);
+            // Un poco hacia dentro o hacia fuera del triángulo
+            return p + (centroid - p) * (0.02 * (uniform(26, 3 * i + 2) - 0.5));
+        });
+        const struct { const char* name; const std::vector<Ray>* rays; } sets[] = {
+            { "impactos", &inside }, { "fallos", &outside }, { "rasantes", &edges } };
+        for (const auto& set : sets) {
+            const std::vector<Ray>& rays = *set.rays;
+            printResult("Triangle::intersects", set.name, measure(rays.size(), repetitions, [&](size_t i) {
+                double t;
+                Vector3D point;
+                return triangle.intersects(rays[i], t, point) ? 1.0 : 0.0;
+            }));
+        }
+    }
+
+    if (selected("Plane::intersects")) {
+        Plane plane(Vector3D(0, -1, 0), Vector3D(0, 1, 0), white, -1, 0.0);
+        // Rayos desde arriba del plano hacia abajo, hacia arriba, o casi paralelos a él
+        const struct { const char* name; double minY, maxY; } sets[] = {
+            { "impactos", -1.0, -0.1 }, { "fallos", 0.1, 1.0 }, { "rasantes", -0.01, 0.0 } };
+        for (const auto& set : sets) {
+            std::vector<Ray> rays;
+            for (uint64_t i = 0; i < MICROBENCH_RAYS; ++i) {
+                Vector3D d = randomDirection(31, i);
+                double y = set.minY + (set.maxY - set.minY) * uniform(32, i);
+                double horizontal = std::sqrt(1.0 - y * y) / std::max(1e-12, std::sqrt(d.getX() * d.getX() + d.getZ() * d.getZ()));
+                rays.emplace_back(Vector3D(4.0 * uniform(33, i) - 2.0, 1.0, 4.0 * uniform(34, i) - 2.0),
+                                  Vector3D(d.getX() * horizontal, y, d.getZ() * horizontal));
+            }
+            printResult("Plane::intersects", set.name, measure(rays.size(), repetitions, [&](size_t i) {
+                double t;
+                Vector3D point;
+                return plane.intersects(rays[i], t, point) ? 1.0 : 0.0;
+            }));
+        }
+    }
+
+    if (selected("Scene::computeLighting")) {
+        // Puntos visibles de escenas reales: luces puntuales y direccionales (default) y luces de área (softshadows)
+        const char* sceneNames[] = { "default", "softshadows" };
+        for (const char* sceneName : sceneNames) {
+            Scene scene;
+            Camera camera;
+            buildScene(sceneName, scene, camera);
+            std::vector<Vector3D> points, normals, views;
+            for (uint64_t i = 0; points.size() < MICROBENCH_RAYS && i < 64 * MICROBENCH_RAYS; ++i) {
+                Ray ray = camera.generateRay(1000 * uniform(41, 2 * i), 1000 * uniform(41, 2 * i + 1), 1000, 1000, 2.0, 2.0, 1.0);
+                Vector3D point, normal;
+                if (scene.intersects(ray, point, normal)) {
+                    points.push_back(point);
+                    normals.push_back(normal);
+                    views.push_back(-ray.getDirection());
+                }
+            }
+            const struct { const char* name; int specular; } sets[] = { { "difuso", -1 }, { "especular", 500 } };
+            for (const auto& set : sets) {
+                std::string setName = std::string(sceneName) + "/" + set.name;
+                printResult("Scene::computeLighting", setName.c_str(), measure(points.size(), repetitions, [&](size_t i) {
+                    return scene.computeLighting(points[i], normals[i], views[i], set.specular);
+                }), false);
+            }
+        }
+    }
+
+    if (selected("reflectRay")) {
+        std::vector<Vector3D> incident, normals;
+        for (uint64_t i = 0; i < MICROBENCH_RAYS; ++i) {
+            incident.push_back(randomDirection(51, i));
+            normals.push_back(randomDirection(52, i));
+        }
+        printResult("reflectRay", "aleatorio", measure(incident.size(), repetitions, [&](size_t i) {
+            return reflectRay(incident[i], normals[i]).getY();
+        }), false);
+    }
+    return 0;
+}
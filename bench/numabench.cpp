@@ -0,0 +1,94 @@
+/**
+ * @file numabench.cpp
+ * @brief Compara N veces la colocación NUMA local con la intercalada.
+ *
+ * Los hilos del pool compartido se fijan siempre a los nodos, como con main --numa.
+ *
+ * Uso:
+ *     numabench [escena] N [opciones de render]
+ */
+#include "benchSetup.h"
+#include "Framebuffer.h"
+#include "TilePool.h"
+#include "generateImage.h"
+#include "numaPlacement.h"
+#include <algorithm> // Para std::min
+#include <chrono>    // Para std::chrono::high_resolution_clock
+#include <cstring>   // Para std::memcmp
+#include <iostream>  // Para std::cout y std::cerr
+#include <limits>    // Para std::numeric_limits
+
+/**
+ * @brief Compara la colocación NUMA local (escena por nodo y franjas de la imagen en su nodo) con la intercalada.
+ *
+ * Muestra los nodos y sus CPUs y, para cada colocación, el tiempo de preparar las escenas y el mejor de
+ * runs renders (primera escritura del framebuffer incluida) sobre memoria sin tocar, los tiles que cada
+ * nodo tomó de otras franjas y si la imagen es idéntica a la de generateImageRows. Con un solo nodo las
+ * dos colocaciones hacen el mismo trabajo, salvo la copia de la escena.
+ *
+ * @param scene Escena a renderizar.
+ * @param camera Cámara del render.
+ * @param config Parámetros del render.
+ * @param runs Número de renders de cada colocación.
+ * @return Código de salida del programa (1 si alguna imagen difiere).
+ */
+static int benchmarkNumaPlacement(const Scene& scene, const Camera& camera, const RenderConfig& config, int runs) {
+    std::vector<NumaNode> topology = readNumaTopology();
+    std::cout << "Nodos NUMA: " << topology.size() << std::endl;
+    for (const NumaNode& node : topology) {
+        std::cout << "  nodo " << node.id << ": " << node.cpus.size() << " CPUs" << std::endl;
+    }
+    std::cout << "Hilos: " << TilePool::shared().getThreadCount() << " fijados en " << TilePool::shared().getNodeCount() << " nodos" << std::endl;
+
+    Framebuffer reference(config.width, config.height, config.format);
+    generateImageRows(scene, camera, reference, config.width, config.height, 0, config.height, config.maxDepth,
+                      config.viewportWidth, config.getViewportHeight(), config.distanceToViewport);
+
+    bool allIdentical = true;
+    for (NumaPlacement placement : { NumaPlacement::INTERLEAVED, NumaPlacement::LOCAL }) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<SceneSnapshot> scenes = replicateScene(scene, placement);
+        std::chrono::duration<double> replicateDuration = std::chrono::high_resolution_clock::now() - start;
+
+        double best = std::numeric_limits<double>::infinity();
+        NumaStats stats;
+        bool identical = true;
+        for (int run = 0; run < runs; ++run) {
+            FirstTouchBuffer pixels;
+            if (!pixels.allocate(reference.getByteSize())) {
+                std::cerr << "Error: no se pudo reservar la memoria del framebuffer" << std::endl;
+                return 1;
+            }
+            Framebuffer image(config.width, config.height, config.format, pixels.getData());
+            start = std::chrono::high_resolution_clock::now();
+            stats = generateImageNuma(scenes, camera, image, config.width, config.height, 0, config.height, config.maxDepth,
+                                      config.viewportWidth, config.getViewportHeight(), config.distanceToViewport, placement);
+            std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+            best = std::min(best, duration.count());
+            identical = identical && std::memcmp(image.getData(), reference.getData(), reference.getByteSize()) == 0;
+        }
+        allIdentical = allIdentical && identical;
+        std::cout << numaPlacementName(placement) << ": escenas " << replicateDuration.count() << " s, render " << best
+                  << " s (primera escritura " << stats.touchSeconds << " s), " << stats.stolenTiles << "/"
+                  << stats.localTiles + stats.stolenTiles << " tiles de otro nodo, idéntico a generateImageRows: "
+                  << (identical ? "sí" : "no") << std::endl;
+    }
+    return allIdentical ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    RenderConfig config;
+    std::string sceneName;
+    long long runs = 0;
+    TilePool::setSharedPinning(true);
+    if (!parseBenchArguments(argc, argv, "numabench [escena] N   (N renders por colocación)", runs, sceneName, config)) {
+        return 1;
+    }
+    Scene scene;
+    Camera camera;
+    std::shared_ptr<PagedGeometry> geometry;
+    if (!buildBenchScene(sceneName, config, scene, camera, geometry)) {
+        return 1;
+    }
+    return benchmarkNumaPlacement(scene, camera, config, static_cast<int>(runs));
+}
@@ -0,0 +1,104 @@
+/**
+ * @file pagingbench.cpp
+ * @brief Compara rayos sueltos con lotes de N rayos sobre la geometría paginada de --geometry.
+ *
+ * Uso:
+ *     pagingbench [escena] N --geometry archivo [opciones de render]
+ * El archivo se genera con main --write-city (ver la escena city).
+ */
+#include "benchSetup.h"
+#include "Random.h"
+#include <algorithm> // Para std::min y std::swap
+#include <chrono>    // Para std::chrono::high_resolution_clock
+#include <iostream>  // Para std::cout y std::cerr
+#include <limits>    // Para std::numeric_limits
+
+/**
+ * @brief Muestra los contadores de la caché de la geometría paginada.
+ * @param label Texto al inicio de la línea.
+ * @param geometry Geometría paginada.
+ */
+static void printPagingStats(const std::string& label, const PagedGeometry& geometry) {
+    std::cout << label << ": ";
+    writePagedGeometryStats(std::cout, geometry.getStats());
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Compara el acceso rayo a rayo con el acceso por lotes a la geometría paginada.
+ *
+ * Los rayos primarios de la imagen se barajan para imitar rayos secundarios incoherentes: rayo a
+ * rayo, cada uno puede necesitar un chunk distinto y, si la caché es menor que la geometría, los
+ * chunks se leen una y otra vez; por lotes, cada chunk se lee a lo sumo una vez por lote.
+ *
+ * @param geometry Geometría paginada (su caché se vacía antes de cada pasada).
+ * @param camera Cámara de la escena.
+ * @param config Resolución y viewport de los rayos.
+ * @param batchSize Rayos por lote.
+ * @return Código de salida del programa.
+ */
+static int benchmarkPagedGeometry(PagedGeometry& geometry, const Camera& camera, const RenderConfig& config, size_t batchSize) {
+    std::cout << "Geometría: " << geometry.getChunks().size() << " chunks, " << geometry.getTriangleCount() << " triángulos, "
+              << geometry.getFileBytes() / (1024.0 * 1024.0) << " MB en el archivo; caché de " << geometry.getCacheBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+
+    std::vector<Ray> rays = generatePrimaryRays(camera, config);
+    for (size_t i = rays.size(); i > 1; --i) {
+        std::swap(rays[i - 1], rays[hashMix(i) % i]);
+    }
+    const double tMax = std::numeric_limits<double>::infinity();
+
+    geometry.resetCache();
+    std::vector<PagedHit> single(rays.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < rays.size(); ++i) {
+        geometry.intersect(rays[i], tMax, single[i]);
+    }
+    std::chrono::duration<double> singleDuration = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Rayo a rayo: " << rays.size() << " rayos en " << singleDuration.count() << " s" << std::endl;
+    printPagingStats("  caché", geometry);
+
+    geometry.resetCache();
+    std::vector<PagedHit> batched;
+    std::vector<Ray> batch;
+    std::vector<PagedHit> batchHits;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t begin = 0; begin < rays.size(); begin += batchSize) {
+        batch.assign(rays.begin() + begin, rays.begin() + std::min(rays.size(), begin + batchSize));
+        geometry.intersectBatch(batch, tMax, batchHits);
+        batched.insert(batched.end(), batchHits.begin(), batchHits.end());
+    }
+    std::chrono::duration<double> batchDuration = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Por lotes de " << batchSize << ": " << rays.size() << " rayos en " << batchDuration.count() << " s ("
+              << geometry.getStats().batches << " lotes)" << std::endl;
+    printPagingStats("  caché", geometry);
+
+    size_t hits = 0, mismatches = 0;
+    for (size_t i = 0; i < rays.size(); ++i) {
+        hits += single[i].found;
+        if (single[i].found != batched[i].found || (single[i].found && single[i].t != batched[i].t)) {
+            ++mismatches;
+        }
+    }
+    std::cout << "Impactos: " << hits << ", rayos con resultado distinto entre las dos pasadas: " << mismatches << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    RenderConfig config;
+    std::string sceneName;
+    long long batchSize = 0;
+    if (!parseBenchArguments(argc, argv, "pagingbench [escena] N --geometry archivo   (lotes de N rayos)", batchSize, sceneName, config)) {
+        return 1;
+    }
+    if (config.geometryPath.empty()) {
+        std::cerr << "Error: pagingbench necesita --geometry" << std::endl;
+        return 1;
+    }
+    Scene scene;
+    Camera camera;
+    std::shared_ptr<PagedGeometry> geometry;
+    if (!buildBenchScene(sceneName, config, scene, camera, geometry)) {
+        return 1;
+    }
+    return benchmarkPagedGeometry(*geometry, camera, config, static_cast<size_t>(batchSize));
+}
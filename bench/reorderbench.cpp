@@ -0,0 +1,92 @@
+/**
+ * @file reorderbench.cpp
+ * @brief Compara el trazado recursivo de los rayos secundarios con los frentes de onda sin ordenar y ordenados.
+ *
+ * Uso:
+ *     reorderbench [escena] N [opciones de render]
+ */
+#include "benchSetup.h"
+#include "Framebuffer.h"
+#include "generateImage.h"
+#include "imageCompare.h"
+#include "wavefront.h"
+#include <algorithm> // Para std::fill y std::min
+#include <chrono>    // Para std::chrono::high_resolution_clock
+#include <cstring>   // Para std::memcmp
+#include <iostream>  // Para std::cout
+#include <limits>    // Para std::numeric_limits
+
+/**
+ * @brief Compara el trazado recursivo de los rayos secundarios con los frentes de onda sin ordenar y ordenados.
+ *
+ * Renderiza la imagen completa repetitions veces con cada variante, alternándolas como kernelbench.
+ * Los dos renders por frentes de onda deben ser idénticos entre sí (el orden de trazado no cambia el color
+ * de ningún rayo) y coincidir con el recursivo dentro de los umbrales de --golden.
+ *
+ * @param scene Escena a renderizar.
+ * @param camera Cámara del render.
+ * @param config Parámetros del render (wavefrontBatch fija el tamaño de los lotes).
+ * @param repetitions Renders por variante.
+ * @return Código de salida del programa (1 si las imágenes no coinciden).
+ */
+static int benchmarkSecondaryRays(const Scene& scene, const Camera& camera, const RenderConfig& config, int repetitions) {
+    const SecondaryRays variants[3] = { SecondaryRays::RECURSIVE, SecondaryRays::WAVEFRONT, SecondaryRays::SORTED };
+    Framebuffer images[3] = { Framebuffer(config.width, config.height), Framebuffer(config.width, config.height), Framebuffer(config.width, config.height) };
+    double best[3], total[3] = { 0.0, 0.0, 0.0 };
+    WavefrontStats stats[3];
+    std::fill(best, best + 3, std::numeric_limits<double>::infinity());
+
+    for (int run = 0; run < repetitions; ++run) {
+        for (int variant = 0; variant < 3; ++variant) {
+            auto start = std::chrono::high_resolution_clock::now();
+            if (variants[variant] == SecondaryRays::RECURSIVE) {
+                generateImageRows(scene, camera, images[variant], config.width, config.height, 0, config.height, config.maxDepth,
+                                  config.viewportWidth, config.getViewportHeight(), config.distanceToViewport);
+            } else {
+                stats[variant] = generateImageWavefront(scene, camera, images[variant], config.width, config.height, 0, config.height, config.maxDepth,
+                                                        config.viewportWidth, config.getViewportHeight(), config.distanceToViewport,
+                                                        variants[variant] == SecondaryRays::SORTED, config.wavefrontBatch);
+            }
+            std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+            best[variant] = std::min(best[variant], duration.count());
+            total[variant] += duration.count();
+        }
+    }
+
+    std::cout << "Rayos secundarios: " << stats[1].secondaryRays << " en " << stats[1].waves << " frentes (lotes de "
+              << config.wavefrontBatch << " píxeles)" << std::endl;
+    for (int variant = 0; variant < 3; ++variant) {
+        std::cout << "Rayos secundarios " << secondaryRaysName(variants[variant]) << ": mejor " << best[variant] << " s, promedio "
+                  << total[variant] / repetitions << " s";
+        if (variants[variant] != SecondaryRays::RECURSIVE) {
+            std::cout << " (trazado de los secundarios " << stats[variant].traceSeconds << " s, ordenación " << stats[variant].sortSeconds << " s)";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Aceleración de la ordenación (mejor tiempo): " << best[1] / best[2] << "x frente a wavefront, "
+              << best[0] / best[2] << "x frente a recursive" << std::endl;
+
+    bool identical = std::memcmp(images[1].getData(), images[2].getData(), images[1].getByteSize()) == 0;
+    ImageDifference difference = compareImages(images[2], images[0], GOLDEN_TOLERANCE);
+    bool matches = difference.changedFraction <= GOLDEN_MAX_CHANGED_FRACTION && difference.psnr >= GOLDEN_MIN_PSNR;
+    std::cout << "Frentes sin ordenar y ordenados idénticos: " << (identical ? "sí" : "no") << std::endl;
+    std::cout << "Frente al recursivo: diferencia máxima " << difference.maxDifference << ", " << difference.changedPixels
+              << " píxeles sobre la tolerancia " << GOLDEN_TOLERANCE << ", PSNR " << difference.psnr << " dB" << std::endl;
+    return identical && matches ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    RenderConfig config;
+    std::string sceneName;
+    long long repetitions = 0;
+    if (!parseBenchArguments(argc, argv, "reorderbench [escena] N   (N renders por variante)", repetitions, sceneName, config)) {
+        return 1;
+    }
+    Scene scene;
+    Camera camera;
+    std::shared_ptr<PagedGeometry> geometry;
+    if (!buildBenchScene(sceneName, config, scene, camera, geometry)) {
+        return 1;
+    }
+    return benchmarkSecondaryRays(scene, camera, config, static_cast<int>(repetitions));
+}
@@ -0,0 +1,115 @@
+/**
+ * @file servicebench.cpp
+ * @brief Prueba el servicio de render asíncrono con N renders de fondo, una vista previa prioritaria y una cancelación.
+ *
+ * Uso:
+ *     servicebench [escena] N [opciones de render]
+ */
+#include "benchSetup.h"
+#include "Framebuffer.h"
+#include "RenderService.h"
+#include "generateImage.h"
+#include <algorithm> // Para std::max
+#include <atomic>    // Para std::atomic
+#include <cstring>   // Para std::memcmp
+#include <future>    // Para std::promise
+#include <iostream>  // Para std::cout y std::cerr
+
+/**
+ * @brief Prueba el servicio de render asíncrono con renders de fondo, una vista previa prioritaria y una cancelación.
+ *
+ * Envía jobs renders de fondo de la imagen completa. Cuando el primero lleva una cuarta parte de sus
+ * tiles, envía una vista previa a un cuarto de la resolución con prioridad PREVIEW y compara su latencia
+ * con la de la misma vista previa con el servicio libre. Cuando el segundo lleva la mitad de sus tiles, lo
+ * cancela. El primero debe ser idéntico al render de generateImageRows y el segundo debe quedar a medias.
+ *
+ * @param scene Escena a renderizar.
+ * @param camera Cámara del render.
+ * @param config Parámetros del render (threads fija los hilos del servicio).
+ * @param jobs Renders de fondo (al menos 2).
+ * @return Código de salida del programa (1 si el resultado no es el esperado).
+ */
+static int benchmarkRenderService(const Scene& scene, const Camera& camera, const RenderConfig& config, int jobs) {
+    if (jobs < 2) {
+        std::cerr << "Error: servicebench necesita al menos 2 renders" << std::endl;
+        return 1;
+    }
+    Framebuffer reference(config.width, config.height, config.format);
+    generateImageRows(scene, camera, reference, config.width, config.height, 0, config.height, config.maxDepth,
+                      config.viewportWidth, config.getViewportHeight(), config.distanceToViewport);
+
+    // La escena vive en main(): el shared_ptr no la posee
+    RenderRequest batch;
+    batch.scene = SceneSnapshot(SceneSnapshot(), &scene);
+    batch.camera = camera;
+    batch.config = config;
+    batch.priority = RenderPriority::BACKGROUND;
+    RenderRequest preview = batch;
+    preview.config.width = std::max(1, config.width / 4);
+    preview.config.height = std::max(1, config.height / 4);
+    preview.priority = RenderPriority::PREVIEW;
+
+    // Avisos de los trabajos de fondo (deben vivir más que el servicio)
+    std::promise<void> firstQuarter, secondHalf;
+    std::atomic<bool> firstSignalled{false}, secondSignalled{false};
+
+    RenderService service(config.threads);
+    double idleLatency = service.submit(preview)->getResult().get().seconds;
+
+    std::vector<std::shared_ptr<RenderService::Job>> batchJobs;
+    for (int job = 0; job < jobs; ++job) {
+        RenderRequest request = batch;
+        if (job == 0) {
+            request.progress = [&](const RenderProgress& progress) {
+                if (progress.tilesDone * 4 >= progress.tilesTotal && !firstSignalled.exchange(true)) {
+                    firstQuarter.set_value();
+                }
+            };
+        } else if (job == 1) {
+            request.progress = [&](const RenderProgress& progress) {
+                if (progress.tilesDone * 2 >= progress.tilesTotal && !secondSignalled.exchange(true)) {
+                    secondHalf.set_value();
+                }
+            };
+        }
+        batchJobs.push_back(service.submit(request));
+    }
+
+    firstQuarter.get_future().wait();
+    RenderResult previewResult = service.submit(preview)->getResult().get();
+    int tilesAtPreview = batchJobs[0]->getProgress().tilesDone;
+    secondHalf.get_future().wait();
+    batchJobs[1]->cancel();
+
+    std::cout << "Servicio: " << service.getThreadCount() << " hilos, " << jobs << " renders de fondo de " << config.width << "x" << config.height << std::endl;
+    std::cout << "Vista previa " << preview.config.width << "x" << preview.config.height << ": " << idleLatency << " s con el servicio libre, "
+              << previewResult.seconds << " s durante los renders de fondo (el primero llevaba " << tilesAtPreview << "/"
+              << batchJobs[0]->getProgress().tilesTotal << " tiles)" << std::endl;
+    bool ok = true;
+    for (int job = 0; job < jobs; ++job) {
+        const RenderResult& result = batchJobs[job]->getResult().get();
+        std::cout << "Render " << job + 1 << ": " << (result.cancelled ? "cancelado" : "terminado") << ", " << result.tilesDone << "/"
+                  << batchJobs[job]->getProgress().tilesTotal << " tiles en " << result.seconds << " s" << std::endl;
+        ok = ok && result.cancelled == (job == 1);
+    }
+    const Framebuffer& first = batchJobs[0]->getResult().get().image;
+    bool identical = std::memcmp(first.getData(), reference.getData(), reference.getByteSize()) == 0;
+    std::cout << "Primer render idéntico a generateImageRows: " << (identical ? "sí" : "no") << std::endl;
+    return ok && identical ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    RenderConfig config;
+    std::string sceneName;
+    long long jobs = 0;
+    if (!parseBenchArguments(argc, argv, "servicebench [escena] N   (N renders de fondo, al menos 2)", jobs, sceneName, config)) {
+        return 1;
+    }
+    Scene scene;
+    Camera camera;
+    std::shared_ptr<PagedGeometry> geometry;
+    if (!buildBenchScene(sceneName, config, scene, camera, geometry)) {
+        return 1;
+    }
+    return benchmarkRenderService(scene, camera, config, static_cast<int>(jobs));
+}
@@ -0,0 +1,108 @@
+/**
+ * @file spherebench.cpp
+ * @brief Compara la SphereGrid con el bucle lineal sobre objetos Sphere para N esferas aleatorias.
+ *
+ * Uso:
+ *     spherebench N [opciones de render]
+ * La resolución y el viewport de las opciones fijan los rayos primarios que se trazan.
+ */
+#include "benchSetup.h"
+#include "Sphere.h"
+#include "SphereGrid.h"
+#include "scenes.h"
+#include <algorithm> // Para std::max
+#include <chrono>    // Para std::chrono::high_resolution_clock
+#include <cstdint>   // Para std::uint32_t
+#include <iostream>  // Para std::cout
+#include <limits>    // Para std::numeric_limits
+
+#define LINEAR_SPHERE_SAMPLE 256 // Rayos que se prueban también con el bucle lineal
+
+/**
+ * @brief Compara la SphereGrid con el bucle lineal sobre objetos Sphere para muchas esferas aleatorias.
+ *
+ * Mide la construcción de la malla, la memoria por esfera y los rayos por segundo de la malla con los
+ * rayos primarios de una imagen completa. El bucle lineal solo se ejecuta con LINEAR_SPHERE_SAMPLE
+ * rayos (con un millón de esferas tardaría horas con todos) y su tasa se extrapola; en esos rayos se
+ * comprueba además que los dos métodos encuentran la misma esfera.
+ *
+ * @param count Número de esferas.
+ * @param config Parámetros del render (resolución y viewport de los rayos).
+ * @return Código de salida del programa (1 si algún rayo de la muestra no coincide).
+ */
+static int benchmarkSphereGrid(size_t count, const RenderConfig& config) {
+    SphereGrid grid;
+    addRandomParticles(grid, count, Vector3D(0, 0, 0), 5.0);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    grid.build();
+    std::chrono::duration<double> buildDuration = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Esferas: " << count << ", celdas: " << grid.getCellCount()
+              << ", construcción de la malla: " << buildDuration.count() << " s" << std::endl;
+    std::cout << "Memoria: " << static_cast<double>(grid.getMemoryBytes()) / count << " bytes por esfera con la malla ("
+              << sizeof(PackedSphere) << " de geometría), " << sizeof(Sphere) << " por objeto Sphere" << std::endl;
+
+    // Rayos primarios de una imagen completa, con la nube ocupando el centro
+    Camera camera(0, 0, -9);
+    std::vector<Ray> rays = generatePrimaryRays(camera, config);
+
+    size_t hits = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (const Ray& ray : rays) {
+        double t;
+        std::uint32_t index;
+        hits += grid.intersect(ray, std::numeric_limits<double>::infinity(), t, index);
+    }
+    std::chrono::duration<double> gridDuration = std::chrono::high_resolution_clock::now() - start;
+    double gridRate = rays.size() / gridDuration.count();
+    std::cout << "Malla: " << rays.size() << " rayos en " << gridDuration.count() << " s ("
+              << gridRate / 1e6 << " millones de rayos por segundo, " << hits << " impactos)" << std::endl;
+
+    // Las mismas esferas como objetos Sphere, probadas todas por cada rayo de la muestra
+    std::vector<Sphere> spheres;
+    spheres.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const PackedSphere& packed = grid.getSpheres()[i];
+        const SphereMaterial& material = grid.getMaterial(i);
+        spheres.emplace_back(Vector3D(packed.x, packed.y, packed.z), packed.radius, material.color, material.specular, material.reflectivity);
+    }
+
+    int mismatches = 0;
+    size_t sampleStride = std::max<size_t>(1, rays.size() / LINEAR_SPHERE_SAMPLE);
+    size_t sampleCount = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t r = sampleStride / 2; r < rays.size(); r += sampleStride, ++sampleCount) {
+        double closest = std::numeric_limits<double>::infinity();
+        size_t linearIndex = count;
+        for (size_t i = 0; i < count; ++i) {
+            double t;
+            if (spheres[i].intersects(rays[r], t, closest)) {
+                closest = t;
+                linearIndex = i;
+            }
+        }
+        double t;
+        std::uint32_t gridIndex;
+        bool gridHit = grid.intersect(rays[r], std::numeric_limits<double>::infinity(), t, gridIndex);
+        if (gridHit != (linearIndex < count) || (gridHit && gridIndex != linearIndex)) {
+            ++mismatches;
+        }
+    }
+    std::chrono::duration<double> linearDuration = std::chrono::high_resolution_clock::now() - start;
+    double linearRate = sampleCount / linearDuration.count();
+    std::cout << "Bucle lineal: " << sampleCount << " rayos en " << linearDuration.count() << " s ("
+              << linearRate << " rayos por segundo; " << rays.size() / linearRate << " s estimados para todos)" << std::endl;
+    std::cout << "Aceleración: " << gridRate / linearRate << "x" << std::endl;
+    std::cout << "Rayos de la muestra con resultados distintos: " << mismatches << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    RenderConfig config;
+    std::string sceneName;
+    long long count = 0;
+    if (!parseBenchArguments(argc, argv, "spherebench N   (N esferas aleatorias)", count, sceneName, config)) {
+        return 1;
+    }
+    return benchmarkSphereGrid(static_cast<size_t>(count), config);
+}
@@ -21,6 +21,15 @@ public:
      */
     Camera();
 
+    /**
+     * Constructor de una cámara orientada. Sin orientación la cámara mira hacia +z con +y hacia arriba.
+     *
+     * @param position: Posición de la cámara.
+     * @param forward: Dirección de la vista (no necesita estar normalizada).
+     * @param up: Dirección aproximada hacia arriba (no paralela a forward).
+     */
+    Camera(const Vector3D& position, const Vector3D& forward, const Vector3D& up);
+
     /**
      * Obtiene la posición de la cámara como un objeto Vector3D.
      *
@@ -28,6 +37,15 @@ public:
      */
     Vector3D getPosition() const;
 
+    /**
+     * Obtienen la base ortonormal de la cámara: derecha, arriba y dirección de la vista.
+     *
+     * @return Vector3D: Vector de la base.
+     */
+    Vector3D getRight() const;
+    Vector3D getUp() const;
+    Vector3D getForward() const;
+
     /**
      * Genera un rayo que parte desde la cámara hacia un píxel específico en la pantalla.
      *
@@ -42,8 +60,26 @@ public:
      */
     Ray generateRay(int pixelX, int pixelY, int imageWidth, int imageHeight, double viewportWidth, double viewportHeight, double distanceToViewport) const;
 
+    /**
+     * Genera un rayo hacia una posición fraccionaria de la pantalla (para muestrear dentro de un píxel).
+     *
+     * @param pixelX: Coordenada x en píxeles; generateRay(x, y, ...) equivale a usar la esquina (x, y).
+     * @param pixelY: Coordenada y en píxeles.
+     * @param imageWidth: Ancho de la imagen en píxeles.
+     * @param imageHeight: Alto de la imagen en píxeles.
+     * @param viewportWidth: Ancho del viewport.
+     * @param viewportHeight: Alto del viewport.
+     * @param distanceToViewport: Distancia de la cámara al viewport.
+     * @return Ray: Rayo generado desde la posición de la cámara hacia ese punto.
+     */
+    Ray generateRay(double pixelX, double pixelY, int imageWidth, int imageHeight, double viewportWidth, double viewportHeight, double distanceToViewport) const;
+
 private:
     double p[3]; // Array que contiene las coordenadas x, y, z de la posición de la cámara
+    Vector3D right = Vector3D(1, 0, 0);   // Eje x de la imagen
+    Vector3D up = Vector3D(0, 1, 0);      // Eje y de la imagen
+    Vector3D forward = Vector3D(0, 0, 1); // Dirección de la vista
+    bool oriented = false;                // false si la base son los ejes del mundo (los rayos se calculan sin rotar)
 };
 
 #endif // CAMERA_H
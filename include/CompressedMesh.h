@@ -0,0 +1,284 @@
+#ifndef COMPRESSED_MESH_H
+#define COMPRESSED_MESH_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "Ray.h"
+#include "Vector3D.h"
+
+#define MESH_QUANTIZATION_LEVELS 65535 // Niveles por eje de las posiciones cuantizadas (16 bits)
+#define MESH_LEAF_TRIANGLES 4          // Triángulos máximos por hoja del BVH
+#define MESH_BVH_BINS 16               // Cubetas por eje al evaluar las particiones con SAH
+#define MESH_BVH_MAX_DEPTH 64          // Profundidad máxima del BVH (tamaño de la pila de recorrido)
+
+/**
+ * @brief Malla de triángulos indexada en precisión completa (entrada de CompressedMesh).
+ */
+struct TriangleMesh {
+    std::vector<Vector3D> vertices;      ///< Posiciones de los vértices.
+    std::vector<std::uint32_t> indices;  ///< Tres índices de vértice por triángulo.
+
+    /**
+     * @brief Devuelve el número de triángulos.
+     * @return indices.size() / 3.
+     */
+    size_t triangleCount() const;
+
+    /**
+     * @brief Devuelve la memoria ocupada por los vértices y los índices.
+     * @return Bytes ocupados.
+     */
+    size_t getMemoryBytes() const;
+};
+
+/**
+ * @brief Material compartido por todos los triángulos de una CompressedMesh.
+ */
+struct MeshMaterial {
+    Vector3D color;                ///< Color (escala 0-255).
+    double specular = -1;          ///< Exponente especular (-1 = sin brillo).
+    double reflectivity = 0.0;     ///< Reflectividad.
+    double transparency = 0.0;     ///< Fracción de la luz que atraviesa el material.
+    double refractiveIndex = 1.0;  ///< Índice de refracción.
+};
+
+/**
+ * @brief Vértice cuantizado: posición en 16 bits por eje dentro de la caja de la malla (6 bytes).
+ */
+struct QuantizedVertex {
+    std::uint16_t x, y, z;  ///< Posición en [0, MESH_QUANTIZATION_LEVELS] por eje.
+};
+
+/**
+ * @brief Nodo interno del BVH comprimido (32 bytes): las cajas de sus dos hijos y sus referencias.
+ *
+ * Las cajas se guardan en la misma rejilla de 16 bits que los vértices, así que no hay error de
+ * redondeo: la caja de un hijo es exactamente la de sus vértices cuantizados. Cada referencia es el
+ * índice de otro nodo, o bien una hoja (bit MESH_LEAF_FLAG) con el primer triángulo en los 27 bits
+ * bajos y el número de triángulos menos uno en los 4 siguientes.
+ */
+struct CompressedBVHNode {
+    std::uint16_t childMin[2][3];  ///< Esquina mínima de la caja de cada hijo.
+    std::uint16_t childMax[2][3];  ///< Esquina máxima de la caja de cada hijo.
+    std::uint32_t child[2];        ///< Referencia de cada hijo (nodo u hoja).
+};
+
+/**
+ * @brief Malla de muchos triángulos con un solo material, guardada de forma compacta.
+ *
+ * Las posiciones se cuantizan a 16 bits por eje relativas a la caja envolvente de la malla (6 bytes por
+ * vértice frente a los 24 de tres double, con un error máximo de medio paso de la rejilla), los
+ * triángulos se guardan como tres índices de 32 bits y el BVH usa nodos de 32 bytes con las cajas de
+ * los hijos cuantizadas. Durante el recorrido solo se descomprimen las cajas y los vértices que el
+ * rayo visita. La malla descomprimida es la geometría que se renderiza: los vértices compartidos se
+ * descomprimen siempre igual, así que la superficie no se abre entre triángulos vecinos.
+ *
+ * La normal es la del triángulo (sin suavizado) y no hay coordenadas de textura.
+ */
+class CompressedMesh {
+public:
+    /**
+     * @brief Comprime una malla y construye su BVH (con SAH por cubetas).
+     *
+     * Lanza std::length_error si la malla tiene más de 2^27 triángulos.
+     *
+     * @param mesh Malla en precisión completa.
+     * @param material Material de todos los triángulos.
+     */
+    void build(const TriangleMesh& mesh, const MeshMaterial& material);
+
+    /**
+     * @brief Escribe la malla comprimida en formato binario: cabecera (tamaños, rejilla y material),
+     * vértices, índices y nodos, tal como están en memoria.
+     * @param out Flujo binario.
+     * @return true si se escribió correctamente.
+     */
+    bool write(std::ostream& out) const;
+
+    /**
+     * @brief Lee una malla escrita con write() desde un bloque de memoria (p. ej. un archivo mapeado).
+     *
+     * Comprueba que los índices, las referencias del BVH y su profundidad sean válidos, así que un
+     * bloque corrupto no puede provocar accesos fuera de los vectores durante el recorrido.
+     *
+     * @param data Bytes de la malla.
+     * @param size Número de bytes.
+     * @return true si el bloque es válido; si no, la malla queda vacía.
+     */
+    bool read(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Busca el triángulo más cercano que intersecta un rayo.
+     * @param ray Rayo.
+     * @param tMax Solo se consideran impactos con t < tMax.
+     * @param t Distancia del impacto más cercano.
+     * @param index Índice del triángulo intersectado.
+     * @return true si hay impacto.
+     */
+    bool intersect(const Ray& ray, double tMax, double& t, std::uint32_t& index) const;
+
+    /**
+     * @brief Comprueba si algún triángulo bloquea un rayo de sombra (termina en el primer impacto).
+     * @param ray Rayo.
+     * @param tMin Distancia mínima de los impactos que cuentan.
+     * @param tMax Distancia máxima de los impactos que cuentan.
+     * @return true si hay algún impacto entre tMin y tMax.
+     */
+    bool occluded(const Ray& ray, double tMin, double tMax) const;
+
+    /**
+     * @brief Descomprime los vértices de un triángulo.
+     * @param index Índice del triángulo.
+     * @param a Primer vértice.
+     * @param b Segundo vértice.
+     * @param c Tercer vértice.
+     */
+    void getTriangle(std::uint32_t index, Vector3D& a, Vector3D& b, Vector3D& c) const;
+
+    /**
+     * @brief Devuelve la normal de un triángulo.
+     * @param index Índice del triángulo.
+     * @return Normal unitaria (orientada según el orden de los vértices).
+     */
+    Vector3D getNormal(std::uint32_t index) const;
+
+    /**
+     * @brief Devuelve el material de la malla.
+     * @return Material.
+     */
+    const MeshMaterial& getMaterial() const;
+
+    /**
+     * @brief Devuelve los datos comprimidos (para el hash de la escena).
+     */
+    const std::vector<QuantizedVertex>& getVertices() const;
+    const std::vector<std::uint32_t>& getIndices() const;
+
+    /**
+     * @brief Devuelve la caja envolvente de la malla.
+     * @param minimum Esquina mínima.
+     * @param maximum Esquina máxima.
+     */
+    void getBounds(Vector3D& minimum, Vector3D& maximum) const;
+
+    /**
+     * @brief Devuelve el mayor paso de la rejilla de cuantización (el error máximo por eje es la mitad).
+     * @return Paso en unidades del mundo.
+     */
+    double getQuantizationStep() const;
+
+    /**
+     * @brief Indica si no hay triángulos.
+     * @return true si la malla está vacía.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Devuelve el número de triángulos.
+     * @return Número de triángulos.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Devuelve el número de nodos del BVH.
+     * @return Nodos internos (0 antes de build()).
+     */
+    size_t getNodeCount() const;
+
+    /**
+     * @brief Devuelve la memoria ocupada por los vértices, los índices y el BVH.
+     * @return Bytes ocupados.
+     */
+    size_t getMemoryBytes() const;
+
+private:
+    /**
+     * @brief Descomprime un vértice cuantizado.
+     */
+    Vector3D decode(const QuantizedVertex& vertex) const;
+
+    /**
+     * @brief Intersección de un rayo con un triángulo (Möller-Trumbore, como Triangle::intersects).
+     */
+    bool intersectTriangle(std::uint32_t index, const Ray& ray, double tMin, double tMax, double& t) const;
+
+    /**
+     * @brief Recorre el BVH visitando primero el hijo más cercano.
+     *
+     * visitLeaf(primero, cantidad, tMax) prueba los triángulos de una hoja, puede reducir tMax y
+     * devuelve true para detener el recorrido.
+     */
+    template <typename Visitor>
+    void traverse(const Ray& ray, double tMax, Visitor&& visitLeaf) const;
+
+    std::vector<QuantizedVertex> vertices;  // Vértices cuantizados
+    std::vector<std::uint32_t> indices;     // Tres índices por triángulo, en el orden de las hojas del BVH
+    std::vector<CompressedBVHNode> nodes;   // Nodos internos del BVH (la raíz es el 0)
+    MeshMaterial material;                  // Material de todos los triángulos
+    double origin[3] = { 0, 0, 0 };         // Esquina mínima de la caja de la malla
+    double scale[3] = { 0, 0, 0 };          // Tamaño de un paso de la rejilla por eje
+};
+
+/**
+ * @brief Nodo interno de MeshBVH (104 bytes): las cajas de sus dos hijos en double y sus referencias,
+ * codificadas como en CompressedBVHNode.
+ */
+struct MeshBVHNode {
+    double childMin[2][3];   ///< Esquina mínima de la caja de cada hijo.
+    double childMax[2][3];   ///< Esquina máxima de la caja de cada hijo.
+    std::uint32_t child[2];  ///< Referencia de cada hijo (nodo u hoja).
+};
+
+/**
+ * @brief BVH en precisión completa sobre una TriangleMesh: la referencia con la que se mide CompressedMesh.
+ *
+ * Se construye con el mismo SAH por cubetas y las mismas hojas que CompressedMesh, pero guarda los
+ * vértices en double y las cajas de los nodos en coordenadas del mundo, sin cuantizar nada.
+ */
+class MeshBVH {
+public:
+    /**
+     * @brief Copia la malla y construye su BVH.
+     *
+     * Lanza std::length_error si la malla tiene más de 2^27 triángulos.
+     *
+     * @param mesh Malla en precisión completa.
+     */
+    void build(const TriangleMesh& mesh);
+
+    /**
+     * @brief Busca el triángulo más cercano que intersecta un rayo.
+     * @param ray Rayo.
+     * @param tMax Solo se consideran impactos con t < tMax.
+     * @param t Distancia del impacto más cercano.
+     * @param index Índice del triángulo intersectado (en el orden de las hojas).
+     * @return true si hay impacto.
+     */
+    bool intersect(const Ray& ray, double tMax, double& t, std::uint32_t& index) const;
+
+    /**
+     * @brief Devuelve el número de triángulos.
+     * @return Número de triángulos.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Devuelve el número de nodos del BVH.
+     * @return Nodos internos (0 antes de build()).
+     */
+    size_t getNodeCount() const;
+
+    /**
+     * @brief Devuelve la memoria ocupada por los vértices, los índices y el BVH.
+     * @return Bytes ocupados.
+     */
+    size_t getMemoryBytes() const;
+
+private:
+    std::vector<Vector3D> vertices;      // Vértices en double
+    std::vector<std::uint32_t> indices;  // Tres índices por triángulo, en el orden de las hojas del BVH
+    std::vector<MeshBVHNode> nodes;      // Nodos internos del BVH (la raíz es el 0)
+};
+
+#endif // COMPRESSED_MESH_H
@@ -0,0 +1,214 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Vector3D.h"
+
+#define FRAMEBUFFER_GAMMA 2.2  // Gamma con la que se codifican los píxeles de 8 bits
+
+/**
+ * @brief Formatos de almacenamiento de los píxeles del framebuffer.
+ */
+enum class PixelFormat {
+    RGB_F16,   ///< Color lineal en media precisión (6 bytes por píxel).
+    RGBA_F32,  ///< Color lineal en float más alfa (16 bytes por píxel, alineado para SIMD).
+    SRGB8      ///< Color con corrección gamma en 8 bits (3 bytes por píxel, listo para escribir).
+};
+
+/**
+ * @brief Imagen (o rango de filas de una imagen) en uno de los formatos de PixelFormat.
+ *
+ * Los renderizadores convierten cada píxel al formato elegido en cuanto lo calculan, de modo que la
+ * imagen completa nunca se guarda en double. Las filas son contiguas y sin relleno: en SRGB8 los datos
+ * son exactamente el cuerpo de un PPM binario (P6).
+ * Los colores se pasan en escala lineal, con 1.0 = blanco.
+ *
+ * Los píxeles pueden vivir en memoria externa (por ejemplo, el cuerpo de un archivo PPM mapeado en
+ * memoria, ver MappedImageFile): así los hilos de render escriben directamente en el archivo. Las
+ * copias de un framebuffer externo tienen siempre memoria propia.
+ */
+class Framebuffer {
+public:
+    /**
+     * @brief Crea un framebuffer vacío.
+     */
+    Framebuffer();
+
+    /**
+     * @brief Crea un framebuffer en negro.
+     * @param width Ancho en píxeles.
+     * @param rows Número de filas.
+     * @param format Formato de los píxeles.
+     */
+    Framebuffer(int width, int rows, PixelFormat format = PixelFormat::SRGB8);
+
+    /**
+     * @brief Crea un framebuffer sobre memoria externa, sin inicializarla.
+     * @param width Ancho en píxeles.
+     * @param rows Número de filas.
+     * @param format Formato de los píxeles.
+     * @param external Memoria de width * rows * pixelFormatSize(format) bytes, que debe seguir viva mientras se use el framebuffer.
+     */
+    Framebuffer(int width, int rows, PixelFormat format, unsigned char* external);
+
+    Framebuffer(const Framebuffer& other);
+    Framebuffer(Framebuffer&& other) noexcept;
+    Framebuffer& operator=(const Framebuffer& other);
+    Framebuffer& operator=(Framebuffer&& other) noexcept;
+
+    /**
+     * @brief Convierte un color y lo guarda en un píxel.
+     * @param x Columna.
+     * @param y Fila (relativa a la primera fila guardada).
+     * @param color Color lineal (1.0 = blanco).
+     */
+    void setPixel(int x, int y, const Vector3D& color);
+
+    /**
+     * @brief Lee un píxel como color lineal.
+     * @param x Columna.
+     * @param y Fila.
+     * @return Color lineal (1.0 = blanco).
+     */
+    Vector3D getPixel(int x, int y) const;
+
+    /**
+     * @brief Escribe una fila codificada en 8 bits con corrección gamma (RGB por píxel).
+     * @param y Fila.
+     * @param out Destino de getWidth() * 3 bytes.
+     */
+    void encodeRowSRGB8(int y, unsigned char* out) const;
+
+    /**
+     * @brief Copia otro framebuffer del mismo formato en una posición de este.
+     * @param source Framebuffer de origen (debe caber completo).
+     * @param x Columna de destino de su primer píxel.
+     * @param y Fila de destino de su primer píxel.
+     */
+    void copyFrom(const Framebuffer& source, int x, int y);
+
+    /**
+     * @brief Devuelve una copia convertida a otro formato.
+     * @param format Formato de la copia.
+     * @return Framebuffer convertido.
+     */
+    Framebuffer convertTo(PixelFormat format) const;
+
+    /**
+     * @brief Devuelve el ancho en píxeles.
+     * @return Ancho.
+     */
+    int getWidth() const;
+
+    /**
+     * @brief Devuelve el número de filas guardadas.
+     * @return Filas.
+     */
+    int getRows() const;
+
+    /**
+     * @brief Devuelve el formato de los píxeles.
+     * @return Formato.
+     */
+    PixelFormat getFormat() const;
+
+    /**
+     * @brief Devuelve el tamaño de un píxel y de una fila en bytes.
+     */
+    size_t getBytesPerPixel() const;
+    size_t getRowBytes() const;
+
+    /**
+     * @brief Devuelve el tamaño total de los píxeles en bytes.
+     * @return Bytes ocupados por la imagen.
+     */
+    size_t getByteSize() const;
+
+    /**
+     * @brief Indica si los píxeles están en memoria externa.
+     * @return true si el framebuffer no es dueño de sus píxeles.
+     */
+    bool isExternal() const;
+
+    /**
+     * @brief Devuelve los bytes de una fila.
+     * @param y Fila.
+     */
+    unsigned char* getRow(int y);
+    const unsigned char* getRow(int y) const;
+
+    /**
+     * @brief Devuelve los bytes de la imagen completa (getByteSize() bytes, fila por fila).
+     */
+    unsigned char* getData();
+    const unsigned char* getData() const;
+
+private:
+    int width;                       // Ancho en píxeles
+    int rows;                        // Número de filas
+    PixelFormat format;              // Formato de los píxeles
+    size_t bytesPerPixel;            // Tamaño de un píxel en bytes
+    std::vector<unsigned char> data; // Píxeles fila por fila (vacío si son externos)
+    unsigned char* pixels;           // Primer byte de los píxeles (data.data() o memoria externa)
+};
+
+/**
+ * Devuelve el tamaño en bytes de un píxel de un formato.
+ *
+ * @param format: Formato de los píxeles.
+ * @return size_t: Bytes por píxel.
+ */
+size_t pixelFormatSize(PixelFormat format);
+
+/**
+ * Devuelve el nombre de un formato tal como se escribe en la línea de comandos.
+ *
+ * @param format: Formato de los píxeles.
+ * @return const char*: "srgb8", "rgb16f" o "rgba32f".
+ */
+const char* pixelFormatName(PixelFormat format);
+
+/**
+ * Interpreta el nombre de un formato.
+ *
+ * @param name: Nombre ("srgb8", "rgb16f" o "rgba32f").
+ * @param format: Formato leído.
+ * @return bool: true si el nombre es válido.
+ */
+bool parsePixelFormat(const std::string& name, PixelFormat& format);
+
+/**
+ * Convierte un float a media precisión (IEEE 754 binary16) redondeando al par más cercano.
+ *
+ * @param value: Valor a convertir.
+ * @return std::uint16_t: Bits del valor en media precisión.
+ */
+std::uint16_t floatToHalf(float value);
+
+/**
+ * Convierte un valor en media precisión a float (la conversión es exacta).
+ *
+ * @param bits: Bits del valor en media precisión.
+ * @return float: Valor convertido.
+ */
+float halfToFloat(std::uint16_t bits);
+
+/**
+ * Codifica un canal lineal en 8 bits con corrección gamma FRAMEBUFFER_GAMMA.
+ *
+ * @param linear: Valor lineal (1.0 = blanco).
+ * @return unsigned char: Valor codificado (recortado a 0-255).
+ */
+unsigned char encodeSRGB8(double linear);
+
+/**
+ * Decodifica un canal de 8 bits con corrección gamma a escala lineal.
+ *
+ * @param value: Valor codificado.
+ * @return double: Valor lineal (1.0 = blanco).
+ */
+double decodeSRGB8(unsigned char value);
+
+#endif // FRAMEBUFFER_H
@@ -0,0 +1,54 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include "Vector3D.h"
+
+/**
+ * @brief Pirámide de visión (sin plano cercano ni lejano) definida por un vértice y cuatro rayos de esquina.
+ *
+ * Se usa para descartar, una sola vez por tile, las primitivas que ningún rayo primario del tile puede
+ * intersectar. Las pruebas son conservadoras: nunca descartan un objeto que pueda estar dentro.
+ */
+class Frustum {
+public:
+    /**
+     * @brief Construye el frustum a partir de su vértice y las direcciones de sus cuatro esquinas.
+     *
+     * Las esquinas deben darse en orden alrededor del contorno (horario o antihorario).
+     *
+     * @param apex Vértice del frustum (posición de la cámara).
+     * @param corner0 Dirección de la primera esquina.
+     * @param corner1 Dirección de la segunda esquina.
+     * @param corner2 Dirección de la tercera esquina.
+     * @param corner3 Dirección de la cuarta esquina.
+     */
+    Frustum(const Vector3D& apex, const Vector3D& corner0, const Vector3D& corner1, const Vector3D& corner2, const Vector3D& corner3);
+
+    /**
+     * @brief Determina si una esfera puede intersectar el frustum.
+     * @param center Centro de la esfera.
+     * @param radius Radio de la esfera.
+     * @return false solo si la esfera está completamente fuera de alguno de los planos laterales.
+     */
+    bool intersectsSphere(const Vector3D& center, double radius) const;
+
+    /**
+     * @brief Determina si un triángulo puede intersectar el frustum.
+     * @param a Primer vértice.
+     * @param b Segundo vértice.
+     * @param c Tercer vértice.
+     * @return false solo si los tres vértices están fuera del mismo plano lateral.
+     */
+    bool intersectsTriangle(const Vector3D& a, const Vector3D& b, const Vector3D& c) const;
+
+private:
+    /**
+     * @brief Distancia con signo de un punto al plano lateral i (positiva hacia el interior).
+     */
+    double signedDistance(int i, const Vector3D& point) const;
+
+    Vector3D apex;         ///< Vértice del frustum.
+    Vector3D normals[4];   ///< Normales unitarias de los planos laterales, orientadas hacia el interior.
+};
+
+#endif // FRUSTUM_H
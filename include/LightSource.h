@@ -14,8 +14,10 @@ public:
      * - AMBIENT: Luz ambiente que afecta a todos los objetos de manera uniforme.
      * - POINT: Luz que emana de un punto específico en todas las direcciones.
      * - DIRECTIONAL: Luz que proviene de una dirección específica, como el sol.
+     * - RECTANGLE: Luz de área rectangular, produce sombras suaves.
+     * - SPHERE: Luz de área esférica, produce sombras suaves.
      */
-    enum Type { AMBIENT, POINT, DIRECTIONAL };
+    enum Type { AMBIENT, POINT, DIRECTIONAL, RECTANGLE, SPHERE };
     
     /**
      * Constructor que inicializa la fuente de luz.
@@ -27,6 +29,25 @@ public:
      */
     LightSource(Type type, double intensity, const Vector3D& position = Vector3D(), const Vector3D& direction = Vector3D());
 
+    /**
+     * Constructor de una luz de área rectangular (tipo RECTANGLE).
+     *
+     * @param intensity: Intensidad total de la luz.
+     * @param center: Centro del rectángulo.
+     * @param edgeU: Vector de un lado del rectángulo.
+     * @param edgeV: Vector del otro lado del rectángulo.
+     */
+    LightSource(double intensity, const Vector3D& center, const Vector3D& edgeU, const Vector3D& edgeV);
+
+    /**
+     * Constructor de una luz de área esférica (tipo SPHERE).
+     *
+     * @param intensity: Intensidad total de la luz.
+     * @param center: Centro de la esfera.
+     * @param radius: Radio de la esfera.
+     */
+    LightSource(double intensity, const Vector3D& center, double radius);
+
     /**
      * @brief Devuelve el tipo de luz.
      * @return Tipo de la luz.
@@ -51,11 +72,44 @@ public:
      */
     Vector3D getDirection() const;
 
+    /**
+     * @brief Indica si la luz tiene área (RECTANGLE o SPHERE) y necesita varias muestras de sombra.
+     * @return true para luces de área.
+     */
+    bool isAreaLight() const;
+
+    /**
+     * @brief Devuelve los lados del rectángulo (solo para RECTANGLE).
+     */
+    Vector3D getEdgeU() const;
+    Vector3D getEdgeV() const;
+
+    /**
+     * @brief Devuelve el radio de la esfera (solo para SPHERE).
+     */
+    double getRadius() const;
+
+    /**
+     * @brief Calcula un punto de muestreo sobre la superficie de una luz de área.
+     *
+     * Para RECTANGLE, (s, t) recorren el rectángulo. Para SPHERE, (s, t) recorren el disco de la esfera
+     * perpendicular a la dirección desde el punto iluminado, que es lo que ese punto ve de la luz.
+     *
+     * @param s: Primera coordenada en [0, 1).
+     * @param t: Segunda coordenada en [0, 1).
+     * @param from: Punto iluminado.
+     * @return Vector3D: Punto de la luz.
+     */
+    Vector3D samplePoint(double s, double t, const Vector3D& from) const;
+
 private:
-    Type type;                // Tipo de luz (AMBIENT, POINT, DIRECTIONAL)
+    Type type;                // Tipo de luz (AMBIENT, POINT, DIRECTIONAL, RECTANGLE, SPHERE)
     double intensity;         // Intensidad de la luz
     Vector3D position;        // Posición de la luz, aplicable a luz tipo POINT
     Vector3D direction;       // Dirección de la luz, aplicable a luz tipo DIRECTIONAL
+    Vector3D edgeU;           // Primer lado, aplicable a luz tipo RECTANGLE
+    Vector3D edgeV;           // Segundo lado, aplicable a luz tipo RECTANGLE
+    double radius = 0.0;      // Radio, aplicable a luz tipo SPHERE
 };
 
 #endif // LIGHTSOURCE_H
@@ -0,0 +1,62 @@
+#ifndef MAPPED_IMAGE_FILE_H
+#define MAPPED_IMAGE_FILE_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Archivo PPM binario (P6) creado con su tamaño final y mapeado en memoria.
+ *
+ * La cabecera se escribe al abrir y el cuerpo queda mapeado como width * height píxeles RGB de 8
+ * bits, con el mismo orden que un framebuffer PixelFormat::SRGB8. Un Framebuffer construido sobre
+ * getPixels() permite que cada hilo de render escriba sus tiles cuantizados directamente en el
+ * archivo, sin framebuffer intermedio ni fase final de escritura: el sistema operativo vuelca las
+ * páginas al disco.
+ */
+class MappedImageFile {
+public:
+    MappedImageFile() = default;
+
+    /**
+     * @brief Desmapea y cierra el archivo (ver close()).
+     */
+    ~MappedImageFile();
+
+    MappedImageFile(const MappedImageFile&) = delete;
+    MappedImageFile& operator=(const MappedImageFile&) = delete;
+
+    /**
+     * @brief Crea (o trunca) el archivo, escribe la cabecera, lo agranda al tamaño final y lo mapea.
+     * @param path Ruta del archivo.
+     * @param width Ancho de la imagen.
+     * @param height Alto de la imagen.
+     * @return true si el archivo quedó mapeado; si no, no queda ningún archivo abierto.
+     */
+    bool open(const std::string& path, int width, int height);
+
+    /**
+     * @brief Desmapea y cierra el archivo. Los píxeles escritos quedan en el archivo.
+     */
+    void close();
+
+    /**
+     * @brief Indica si el archivo está mapeado.
+     * @return true si getPixels() es válido.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Devuelve el primer byte del cuerpo del PPM (el píxel 0, 0).
+     * @return Puntero a width * height * 3 bytes, o nullptr si el archivo no está abierto.
+     */
+    unsigned char* getPixels() const;
+
+private:
+    unsigned char* mapping = nullptr; // Inicio del archivo mapeado (cabecera incluida)
+    size_t mappedSize = 0;            // Tamaño total del archivo mapeado
+    size_t headerSize = 0;            // Bytes de la cabecera P6
+    std::intptr_t fileHandle = -1;    // Descriptor (POSIX) o HANDLE (Windows) del archivo
+    std::intptr_t mappingHandle = 0;  // HANDLE del objeto de mapeo (solo Windows)
+};
+
+#endif // MAPPED_IMAGE_FILE_H
@@ -0,0 +1,307 @@
+#ifndef PAGED_GEOMETRY_H
+#define PAGED_GEOMETRY_H
+
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "CompressedMesh.h"
+#include "Ray.h"
+#include "Vector3D.h"
+
+#define GEOMETRY_CACHE_MB 256        // Memoria por defecto de los chunks residentes (MB)
+#define GEOMETRY_TOP_MAX_DEPTH 64    // Profundidad máxima del BVH de chunks (tamaño de la pila de recorrido)
+
+/**
+ * @brief Entrada de la tabla de chunks de un archivo de geometría (se mantiene siempre en memoria).
+ */
+struct GeometryChunkInfo {
+    std::uint64_t offset = 0;     ///< Posición del chunk serializado en el archivo.
+    std::uint64_t size = 0;       ///< Bytes del chunk serializado.
+    std::uint64_t hash = 0;       ///< Hash del contenido (identifica el chunk sin leerlo).
+    std::uint64_t triangles = 0;  ///< Número de triángulos.
+    Vector3D boundsMin;           ///< Esquina mínima de la caja del chunk.
+    Vector3D boundsMax;           ///< Esquina máxima de la caja del chunk.
+    MeshMaterial material;        ///< Material de todos los triángulos del chunk.
+};
+
+/**
+ * @brief Escribe un archivo de geometría chunk a chunk.
+ *
+ * Cada chunk es una CompressedMesh (vértices cuantizados, índices y BVH) serializada con
+ * CompressedMesh::write(); la tabla de chunks va al final y la cabecera apunta a ella. Solo el chunk
+ * que se está agregando está en memoria, así que se pueden generar archivos mayores que la RAM.
+ */
+class GeometryFileWriter {
+public:
+    /**
+     * @brief Crea (o trunca) el archivo y reserva la cabecera.
+     * @param path Ruta del archivo.
+     * @return true si el archivo se pudo crear.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Comprime un trozo de geometría y lo agrega como un chunk.
+     * @param mesh Malla del chunk (conviene que sea espacialmente compacta).
+     * @param material Material de sus triángulos.
+     * @return true si se escribió; una malla vacía no agrega ningún chunk.
+     */
+    bool addChunk(const TriangleMesh& mesh, const MeshMaterial& material);
+
+    /**
+     * @brief Escribe la tabla de chunks, completa la cabecera y cierra el archivo.
+     * @return true si el archivo quedó completo.
+     */
+    bool close();
+
+    /**
+     * @brief Devuelve el número de chunks escritos.
+     * @return Chunks agregados desde open().
+     */
+    size_t getChunkCount() const;
+
+    /**
+     * @brief Devuelve el número de triángulos escritos.
+     * @return Suma de los triángulos de los chunks.
+     */
+    size_t getTriangleCount() const;
+
+private:
+    std::ofstream file;                     // Archivo abierto
+    std::string path;                       // Ruta (para los mensajes de error)
+    std::vector<GeometryChunkInfo> chunks;  // Tabla de los chunks escritos
+};
+
+/**
+ * @brief Impacto de un rayo con la geometría paginada.
+ *
+ * La normal se calcula mientras el chunk está residente, para que el sombreado no tenga que volver
+ * a leerlo si otro hilo lo descarta de la caché entretanto.
+ */
+struct PagedHit {
+    bool found = false;            ///< true si el rayo intersecta algún triángulo.
+    double t = 0.0;                ///< Distancia del impacto.
+    std::uint32_t chunk = 0;       ///< Chunk del triángulo intersectado.
+    std::uint32_t triangle = 0;    ///< Índice del triángulo dentro del chunk.
+    Vector3D normal;               ///< Normal del triángulo.
+};
+
+/**
+ * @brief Contadores de la caché de chunks.
+ */
+struct PagedGeometryStats {
+    size_t pageIns = 0;            ///< Chunks leídos del archivo.
+    size_t cacheHits = 0;          ///< Accesos a chunks que ya estaban residentes.
+    size_t evictions = 0;          ///< Chunks descartados para respetar el límite de memoria.
+    size_t batches = 0;            ///< Lotes de rayos procesados con intersectBatch().
+    size_t residentChunks = 0;     ///< Chunks residentes ahora.
+    size_t residentBytes = 0;      ///< Memoria de los chunks residentes.
+    size_t peakResidentBytes = 0;  ///< Máximo de residentBytes.
+};
+
+/**
+ * @brief Geometría fuera de memoria: un archivo de chunks mapeado en memoria con una caché LRU.
+ *
+ * Solo la tabla de chunks y un BVH sobre sus cajas (cuyas hojas son chunks) están siempre en
+ * memoria. Un chunk se lee del archivo mapeado la primera vez que un rayo llega a su caja y queda
+ * residente, descomprimido como CompressedMesh, hasta que la caché supera su límite de bytes y se
+ * descartan los menos usados recientemente. Tras leer un chunk se liberan sus páginas del archivo
+ * mapeado, de modo que la única copia residente es la de la caché.
+ *
+ * Las consultas son seguras desde varios hilos: los chunks en uso se comparten con std::shared_ptr y
+ * siguen vivos aunque la caché los descarte mientras un rayo los recorre.
+ */
+class PagedGeometry {
+public:
+    PagedGeometry() = default;
+
+    /**
+     * @brief Desmapea y cierra el archivo (ver close()).
+     */
+    ~PagedGeometry();
+
+    PagedGeometry(const PagedGeometry&) = delete;
+    PagedGeometry& operator=(const PagedGeometry&) = delete;
+
+    /**
+     * @brief Mapea un archivo escrito con GeometryFileWriter, lee su tabla y construye el BVH de chunks.
+     * @param path Ruta del archivo.
+     * @param cacheBytes Memoria máxima de los chunks residentes (siempre se admite al menos uno).
+     * @return true si el archivo es válido; si no, no queda ningún archivo abierto.
+     */
+    bool open(const std::string& path, size_t cacheBytes);
+
+    /**
+     * @brief Vacía la caché, desmapea y cierra el archivo.
+     */
+    void close();
+
+    /**
+     * @brief Busca el triángulo más cercano que intersecta un rayo.
+     *
+     * Los chunks se visitan en orden de distancia de entrada y se leen solo si su caja empieza antes
+     * del impacto más cercano encontrado.
+     *
+     * @param ray Rayo.
+     * @param tMax Solo se consideran impactos con t < tMax.
+     * @param hit Impacto más cercano.
+     * @return true si hay impacto.
+     */
+    bool intersect(const Ray& ray, double tMax, PagedHit& hit) const;
+
+    /**
+     * @brief Comprueba si algún triángulo bloquea un rayo de sombra.
+     * @param ray Rayo.
+     * @param tMin Distancia mínima de los impactos que cuentan.
+     * @param tMax Distancia máxima de los impactos que cuentan.
+     * @return true si hay algún impacto entre tMin y tMax.
+     */
+    bool occluded(const Ray& ray, double tMin, double tMax) const;
+
+    /**
+     * @brief Intersecta un lote de rayos leyendo cada chunk a lo sumo una vez.
+     *
+     * Cada rayo se encola en los chunks cuya caja atraviesa; las colas se procesan chunk a chunk
+     * (primero los residentes, después por distancia de entrada), y una entrada se descarta sin leer
+     * el chunk si el rayo ya tiene un impacto más cercano que la caja.
+     *
+     * @param rays Rayos del lote.
+     * @param tMax Solo se consideran impactos con t < tMax.
+     * @param hits Impacto más cercano de cada rayo (mismo orden que rays).
+     */
+    void intersectBatch(const std::vector<Ray>& rays, double tMax, std::vector<PagedHit>& hits) const;
+
+    /**
+     * @brief Intersecta un lote de rayos, cada uno con su propia distancia máxima (p. ej. el impacto más
+     * cercano que ya tiene con el resto de la escena).
+     * @param rays Rayos del lote.
+     * @param tMax Distancia máxima de cada rayo (mismo orden que rays).
+     * @param hits Impacto más cercano de cada rayo (mismo orden que rays).
+     */
+    void intersectBatch(const std::vector<Ray>& rays, const std::vector<double>& tMax, std::vector<PagedHit>& hits) const;
+
+    /**
+     * @brief Indica si hay un archivo abierto.
+     * @return true si hay geometría.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Devuelve la tabla de chunks.
+     * @return Un elemento por chunk.
+     */
+    const std::vector<GeometryChunkInfo>& getChunks() const;
+
+    /**
+     * @brief Devuelve el material de un chunk (sin leerlo).
+     * @param chunk Índice del chunk.
+     * @return Material.
+     */
+    const MeshMaterial& getMaterial(std::uint32_t chunk) const;
+
+    /**
+     * @brief Devuelve el número total de triángulos.
+     * @return Suma de los triángulos de los chunks.
+     */
+    size_t getTriangleCount() const;
+
+    /**
+     * @brief Devuelve el tamaño del archivo mapeado.
+     * @return Bytes.
+     */
+    size_t getFileBytes() const;
+
+    /**
+     * @brief Devuelve la memoria máxima de los chunks residentes.
+     * @return Bytes.
+     */
+    size_t getCacheBytes() const;
+
+    /**
+     * @brief Devuelve los contadores de la caché.
+     * @return Copia de los contadores.
+     */
+    PagedGeometryStats getStats() const;
+
+    /**
+     * @brief Descarta todos los chunks residentes y pone los contadores a cero.
+     */
+    void resetCache();
+
+private:
+    /**
+     * @brief Nodo del BVH de chunks: su caja y dos hijos, o un chunk si es hoja.
+     */
+    struct ChunkNode {
+        double min[3];        // Esquina mínima de la caja
+        double max[3];        // Esquina máxima de la caja
+        std::uint32_t left;   // Primer hijo, o el chunk si es hoja
+        std::uint32_t right;  // Segundo hijo (sin uso en las hojas)
+        bool leaf;            // El nodo es un chunk
+    };
+
+    /**
+     * @brief Chunk atravesado por un rayo y la distancia a la que entra en su caja.
+     */
+    struct ChunkEntry {
+        std::uint32_t chunk;
+        double tNear;
+    };
+
+    /**
+     * @brief Chunk residente y su posición en la lista LRU.
+     */
+    struct ResidentChunk {
+        std::shared_ptr<const CompressedMesh> mesh;
+        std::list<std::uint32_t>::iterator position;
+    };
+
+    /**
+     * @brief Construye el BVH de chunks sobre un rango de chunks (división por la mediana).
+     */
+    std::uint32_t buildNode(std::vector<std::uint32_t>& order, size_t begin, size_t end);
+
+    /**
+     * @brief Agrega a entries los chunks cuya caja atraviesa el rayo antes de tMax.
+     */
+    void findChunks(const Ray& ray, double tMax, std::vector<ChunkEntry>& entries) const;
+
+    /**
+     * @brief Devuelve un chunk residente; si no lo está, lo lee del archivo (o devuelve nullptr si load es false).
+     */
+    std::shared_ptr<const CompressedMesh> acquire(std::uint32_t chunk, bool load = true) const;
+
+    /**
+     * @brief Libera las páginas del archivo mapeado que ocupa un chunk.
+     */
+    void releasePages(const GeometryChunkInfo& info) const;
+
+    unsigned char* mapping = nullptr;        // Archivo mapeado (solo lectura)
+    size_t mappedSize = 0;                   // Bytes mapeados
+    std::intptr_t fileHandle = -1;           // Descriptor (POSIX) o HANDLE (Windows) del archivo
+    std::intptr_t mappingHandle = 0;         // HANDLE del objeto de mapeo (solo Windows)
+    std::vector<GeometryChunkInfo> chunks;   // Tabla de chunks
+    std::vector<ChunkNode> nodes;            // BVH de chunks (la raíz es el 0)
+    size_t triangleCount = 0;                // Triángulos de todos los chunks
+    size_t cacheBytes = 0;                   // Límite de memoria de los chunks residentes
+
+    mutable std::mutex cacheMutex;                 // Protege la caché y los contadores
+    mutable std::vector<ResidentChunk> resident;   // Un elemento por chunk (mesh nulo si no está residente)
+    mutable std::list<std::uint32_t> lru;          // Chunks residentes, del más al menos usado recientemente
+    mutable PagedGeometryStats stats;              // Contadores
+};
+
+/**
+ * Escribe los contadores de la caché en una línea (sin el salto de línea final), como se muestran al terminar el render.
+ *
+ * @param out: Flujo de salida.
+ * @param stats: Contadores de la geometría paginada.
+ */
+void writePagedGeometryStats(std::ostream& out, const PagedGeometryStats& stats);
+
+#endif // PAGED_GEOMETRY_H
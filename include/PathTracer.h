@@ -0,0 +1,103 @@
+#ifndef PATH_TRACER_H
+#define PATH_TRACER_H
+
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+#include "Ray.h"
+#include "Random.h"
+#include "Vector3D.h"
+#include "Framebuffer.h"
+#include "PreviewStream.h"
+
+#define PATH_SAMPLES_PER_PASS 4   // Muestras por píxel que agrega cada pasada sobre la imagen
+#define PATH_MIN_BOUNCES 3        // Rebotes antes de aplicar ruleta rusa
+
+/**
+ * @brief Estadísticas de un render con trazado de caminos.
+ */
+struct PathTraceStats {
+    long long samples = 0;          ///< Total de muestras (caminos) trazadas.
+    double seconds = 0.0;           ///< Tiempo de render.
+    double samplesPerSecond = 0.0;  ///< Muestras por segundo.
+    int threads = 1;                ///< Hilos usados.
+};
+
+/**
+ * @brief Integrador de Monte Carlo (trazado de caminos) sobre la misma escena que Scene::traceRay.
+ *
+ * Usa Scene::closestHit e Scene::isInShadow para todas las intersecciones, de modo que cualquier
+ * mejora de la aceleración beneficia a los dos integradores. En cada vértice difuso se estima la luz
+ * directa muestreando las luces de la escena (next-event estimation) y el camino continúa en una
+ * dirección con distribución coseno. Las superficies reflectivas y transparentes eligen
+ * aleatoriamente entre difuso, espejo, reflexión de Fresnel y refracción según sus pesos.
+ *
+ * Se conserva la convención de iluminación del trazador de Whitted: una luz de intensidad I produce
+ * I * cos(theta) sobre una superficie blanca, sin atenuación con la distancia, y la luz AMBIENT es la
+ * radiancia del entorno que reciben los caminos que escapan de la escena. Las luces no son visibles
+ * para los rayos, así que no hace falta combinar estrategias de muestreo.
+ */
+class PathTracer {
+public:
+    /**
+     * @brief Crea el integrador.
+     * @param scene Escena a renderizar (debe seguir viva mientras se use el integrador).
+     * @param maxBounces Número máximo de rebotes de cada camino.
+     */
+    PathTracer(const Scene& scene, int maxBounces);
+
+    /**
+     * @brief Estima la radiancia que llega a lo largo de un rayo con un solo camino.
+     *
+     * @param ray Rayo primario.
+     * @param candidates Primitivas candidatas para el primer impacto (nullptr = toda la escena).
+     * @param random Secuencia aleatoria de la muestra.
+     * @return Radiancia (1.0 = blanco).
+     */
+    Vector3D tracePath(const Ray& ray, const PrimitiveList* candidates, RandomSequence& random) const;
+
+    /**
+     * @brief Renderiza un rango de filas acumulando samplesPerPixel caminos por píxel.
+     *
+     * Las muestras se agregan por pasadas de PATH_SAMPLES_PER_PASS sobre toda la imagen en un búfer de
+     * acumulación de floats; los tiles de cada pasada se reparten entre los hilos de TilePool::shared().
+     * Cada muestra usa una secuencia aleatoria que depende solo del píxel y del índice de la muestra,
+     * así que la imagen es idéntica con cualquier número de hilos o de procesos. Al final, los mismos
+     * hilos convierten el promedio de cada píxel al formato del framebuffer.
+     *
+     * Con vista previa, cada tile se promedia y se publica al terminar cada pasada (render progresivo);
+     * la vista previa solo envía los tiles que cambiaron en 8 bits desde la pasada anterior.
+     *
+     * @param cam Cámara.
+     * @param framebuffer Framebuffer de width x (rowEnd - rowBegin) píxeles.
+     * @param width Ancho de la imagen completa.
+     * @param height Alto de la imagen completa.
+     * @param rowBegin Primera fila a renderizar.
+     * @param rowEnd Fila siguiente a la última a renderizar.
+     * @param samplesPerPixel Muestras por píxel.
+     * @param viewportWidth Ancho del viewport en unidades del mundo.
+     * @param viewportHeight Alto del viewport en unidades del mundo.
+     * @param distanceToViewport Distancia entre la cámara y el viewport.
+     * @param preview Vista previa que recibe los tiles de cada pasada (nullptr = sin vista previa).
+     * @return Estadísticas del render (incluidas las muestras por segundo).
+     */
+    PathTraceStats render(const Camera& cam, Framebuffer& framebuffer, int width, int height, int rowBegin, int rowEnd,
+                          int samplesPerPixel, double viewportWidth, double viewportHeight, double distanceToViewport,
+                          PreviewStream* preview = nullptr) const;
+
+private:
+    /**
+     * @brief Estima la irradiancia directa de las luces en un punto (una muestra por luz de área).
+     * @param point Punto de la superficie.
+     * @param normal Normal orientada hacia el lado del que llega el camino.
+     * @param random Secuencia aleatoria de la muestra.
+     * @return Irradiancia directa.
+     */
+    double directLighting(const Vector3D& point, const Vector3D& normal, RandomSequence& random) const;
+
+    const Scene& scene;        // Escena a renderizar
+    int maxBounces;            // Rebotes máximos por camino
+    double environment;        // Radiancia del entorno (suma de las luces AMBIENT)
+};
+
+#endif // PATH_TRACER_H
@@ -1,8 +1,11 @@
 #ifndef PLANE_H
 #define PLANE_H
 
+#include <limits>
+#include <memory>
 #include "Vector3D.h"
 #include "Ray.h"
+#include "Texture.h"
 
 /**
  * @brief Clase que representa un plano en la escena.
@@ -17,8 +20,11 @@ public:
      * @param color Color del plano.
      * @param specular Valor especular del plano para cálculos de iluminación.
      * @param reflectivity Coeficiente de reflectividad del plano.
+     * @param transparency Fracción de la luz que atraviesa el material (0 = opaco).
+     * @param refractiveIndex Índice de refracción del material (1.0 = aire, 1.5 = vidrio).
      */
-    Plane(const Vector3D& point, const Vector3D& normal, const Vector3D& color, double specular, double reflectivity);
+    Plane(const Vector3D& point, const Vector3D& normal, const Vector3D& color, double specular, double reflectivity,
+          double transparency = 0.0, double refractiveIndex = 1.0);
 
     /**
      * @brief Método para comprobar si un rayo intersecta el plano y proporcionar el punto de intersección.
@@ -26,10 +32,40 @@ public:
      * @param ray Rayo con el que se verifica la intersección.
      * @param t Distancia desde el origen del rayo hasta el punto de intersección.
      * @param intersectionPoint Punto de intersección si la hay.
+     * @param tMax Distancia máxima a considerar (por defecto infinito).
      * @return true Si hay una intersección válida.
      * @return false Si no hay intersección.
      */
-    bool intersects(const Ray& ray, double& t, Vector3D& intersectionPoint) const;
+    bool intersects(const Ray& ray, double& t, Vector3D& intersectionPoint, double tMax = std::numeric_limits<double>::infinity()) const;
+
+    /**
+     * @brief Asigna una textura al plano con proyección plana que se repite.
+     *
+     * @param texture Textura (nullptr para volver al color constante).
+     * @param scale Tamaño en unidades del mundo de una repetición de la textura.
+     */
+    void setTexture(std::shared_ptr<const Texture> texture, double scale);
+
+    /**
+     * @brief Color del material en un punto del plano.
+     *
+     * @param point Punto sobre el plano.
+     * @param footprint Ancho de la huella del rayo en el punto (para elegir el nivel mip).
+     * @return Color de la textura en el punto, o el color constante si no tiene textura.
+     */
+    Vector3D getColorAt(const Vector3D& point, double footprint) const;
+
+    /**
+     * @brief Getter para obtener la textura del plano.
+     * @return Textura del material, o nullptr si usa un color constante.
+     */
+    const std::shared_ptr<const Texture>& getTexture() const;
+
+    /**
+     * @brief Getter para obtener el tamaño de una repetición de la textura.
+     * @return Tamaño en unidades del mundo.
+     */
+    double getTextureScale() const;
 
     /**
      * @brief Getter para obtener el color del plano.
@@ -49,6 +85,24 @@ public:
      */
     double getReflectivity() const;
 
+    /**
+     * @brief Getter para obtener la transparencia del plano.
+     * @return Fracción de la luz que atraviesa el plano.
+     */
+    double getTransparency() const;
+
+    /**
+     * @brief Getter para obtener el índice de refracción del plano.
+     * @return Índice de refracción del material.
+     */
+    double getRefractiveIndex() const;
+
+    /**
+     * @brief Getter para obtener el punto de referencia del plano.
+     * @return Punto sobre el plano.
+     */
+    Vector3D getPoint() const;
+
     /**
      * @brief Getter para obtener el vector normal del plano.
      * @return Vector normal del plano.
@@ -61,6 +115,12 @@ private:
     Vector3D color;       ///< Color del plano.
     double specular;      ///< Valor especular para los cálculos de iluminación.
     double reflectivity;  ///< Coeficiente de reflectividad para los cálculos de reflexión.
+    double transparency;  ///< Fracción de la luz que atraviesa el plano.
+    double refractiveIndex; ///< Índice de refracción del material.
+    std::shared_ptr<const Texture> texture; ///< Textura del material (opcional).
+    double textureScale = 1.0;  ///< Tamaño de una repetición de la textura.
+    Vector3D uAxis;       ///< Eje del plano para la coordenada u.
+    Vector3D vAxis;       ///< Eje del plano para la coordenada v.
 };
 
 #endif // PLANE_H
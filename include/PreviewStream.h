@@ -0,0 +1,150 @@
+#ifndef PREVIEW_STREAM_H
+#define PREVIEW_STREAM_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Framebuffer.h"
+
+#define PREVIEW_DEFAULT_PORT 5599  // Puerto por defecto del visor de vista previa (preview_viewer.py)
+#define PREVIEW_MAGIC "RTPREVW1"   // Identificador del protocolo, enviado al conectar
+
+/**
+ * @brief Estadísticas de una conexión de vista previa.
+ */
+struct PreviewStats {
+    long long tilesSent = 0;     ///< Tiles enviados.
+    long long tilesSkipped = 0;  ///< Tiles no enviados porque no cambiaron desde el último envío.
+    long long bytesSent = 0;     ///< Bytes enviados (cabeceras incluidas).
+};
+
+/**
+ * @brief Envía los tiles terminados de un render a un visor local por TCP.
+ *
+ * El protocolo usa enteros de 32 bits little-endian. Al conectar se envía PREVIEW_MAGIC seguido del
+ * ancho y el alto de la imagen; después, cada mensaje tiene una cabecera de cinco enteros
+ * (tipo, x, y, ancho, alto):
+ * - PREVIEW_TILE: seguido de ancho * alto píxeles RGB de 8 bits con corrección gamma;
+ * - PREVIEW_PASS_END: fin de una pasada progresiva (x = número de la pasada);
+ * - PREVIEW_FRAME_END: fin del render.
+ *
+ * Solo se envían los tiles cuyo contenido en 8 bits cambió desde el último envío, así que entre las
+ * pasadas del trazado de caminos solo viajan las zonas que siguen convergiendo. Los hilos de render
+ * solo codifican el tile y lo encolan: un hilo propio hace los envíos, de modo que un visor lento no
+ * frena el render. Si la conexión se pierde, el render continúa sin vista previa.
+ *
+ * Los tiles deben estar alineados a la cuadrícula global de tileSize (como los de generateImageRows
+ * y PathTracer::render); cada hilo debe publicar tiles distintos a la vez.
+ */
+class PreviewStream {
+public:
+    /**
+     * @brief Tipos de mensaje del protocolo.
+     */
+    enum MessageType : std::int32_t { PREVIEW_TILE = 1, PREVIEW_PASS_END = 2, PREVIEW_FRAME_END = 3 };
+
+    /**
+     * @brief Crea una vista previa sin conexión.
+     * @param width Ancho de la imagen completa.
+     * @param height Alto de la imagen completa.
+     * @param tileSize Tamaño de los tiles del render.
+     */
+    PreviewStream(int width, int height, int tileSize);
+
+    /**
+     * @brief Cierra la conexión (ver close()).
+     */
+    ~PreviewStream();
+
+    PreviewStream(const PreviewStream&) = delete;
+    PreviewStream& operator=(const PreviewStream&) = delete;
+
+    /**
+     * @brief Conecta con el visor y envía la cabecera.
+     * @param host Dirección IPv4 del visor (normalmente 127.0.0.1).
+     * @param port Puerto del visor.
+     * @return true si la conexión se estableció.
+     */
+    bool connect(const std::string& host, int port);
+
+    /**
+     * @brief Envía el fin del render, espera a que el hilo de envío vacíe la cola y cierra la conexión.
+     */
+    void close();
+
+    /**
+     * @brief Indica si hay un visor conectado.
+     * @return true si la conexión sigue abierta.
+     */
+    bool isConnected() const;
+
+    /**
+     * @brief Publica un tile ya codificado en RGB de 8 bits.
+     * @param x Primera columna del tile.
+     * @param y Primera fila del tile (en la imagen completa).
+     * @param width Ancho del tile.
+     * @param rows Filas del tile.
+     * @param pixels width * rows * 3 bytes, fila por fila.
+     */
+    void publishTile(int x, int y, int width, int rows, const unsigned char* pixels);
+
+    /**
+     * @brief Publica un rectángulo de un framebuffer, convertido a RGB de 8 bits.
+     * @param framebuffer Framebuffer de origen.
+     * @param x0 Primera columna.
+     * @param y0 Primera fila (en la imagen completa).
+     * @param x1 Columna siguiente a la última.
+     * @param y1 Fila siguiente a la última.
+     * @param rowOffset Fila de la imagen completa guardada en la fila 0 del framebuffer.
+     */
+    void publishTile(const Framebuffer& framebuffer, int x0, int y0, int x1, int y1, int rowOffset);
+
+    /**
+     * @brief Indica al visor que terminó una pasada progresiva.
+     * @param pass Número de la pasada (desde 1).
+     */
+    void endPass(int pass);
+
+    /**
+     * @brief Devuelve las estadísticas de la conexión.
+     * @return Tiles enviados y omitidos y bytes enviados.
+     */
+    PreviewStats getStats() const;
+
+private:
+    /**
+     * @brief Encola un mensaje para el hilo de envío.
+     */
+    void enqueue(std::vector<unsigned char> message);
+
+    /**
+     * @brief Bucle del hilo de envío: envía los mensajes en orden hasta que se cierra la vista previa.
+     */
+    void senderLoop();
+
+    /**
+     * @brief Envía un bloque completo por el socket.
+     * @return false si la conexión se perdió.
+     */
+    bool sendAll(const unsigned char* data, size_t size);
+
+    int width;                                    // Ancho de la imagen completa
+    int height;                                   // Alto de la imagen completa
+    int tileSize;                                 // Tamaño de los tiles
+    int tileColumns;                              // Tiles por fila de la imagen
+    std::vector<std::uint64_t> tileHashes;        // Hash del último contenido enviado de cada tile (0 = nunca)
+    std::intptr_t socketHandle = -1;              // Socket conectado (-1 = sin conexión)
+    bool connected = false;                       // La conexión sigue abierta
+    bool closing = false;                         // close() pidió terminar
+    mutable std::mutex mutex;                     // Protege la cola y las estadísticas
+    std::condition_variable queued;               // Avisa al hilo de envío de mensajes nuevos
+    std::deque<std::vector<unsigned char>> queue; // Mensajes pendientes de enviar
+    PreviewStats stats;                           // Estadísticas acumuladas
+    std::thread sender;                           // Hilo de envío
+};
+
+#endif // PREVIEW_STREAM_H
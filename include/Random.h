@@ -0,0 +1,51 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+/**
+ * @brief Mezcla los bits de un entero de 64 bits (finalizador de SplitMix64).
+ *
+ * Es una biyección con buen efecto avalancha: cambiar un bit de la entrada cambia en promedio
+ * la mitad de los bits de la salida.
+ *
+ * @param x Valor de entrada.
+ * @return Valor mezclado.
+ */
+uint64_t hashMix(uint64_t x);
+
+/**
+ * @brief Convierte 64 bits aleatorios en un número en [0, 1).
+ * @param bits Bits de entrada.
+ * @return Número con 53 bits de precisión en [0, 1).
+ */
+double hashToUnit(uint64_t bits);
+
+/**
+ * @brief Secuencia de números aleatorios basada en contador.
+ *
+ * Cada número es hashMix(clave + contador), donde la clave se deriva del píxel y del índice de la
+ * muestra. No hay estado compartido entre hilos: el valor de cada muestra depende solo de su píxel y
+ * su índice, así que el resultado es el mismo sin importar qué hilo procese cada tile ni en qué orden.
+ */
+class RandomSequence {
+public:
+    /**
+     * @brief Crea la secuencia de una muestra.
+     * @param pixelIndex Índice global del píxel (y * ancho + x).
+     * @param sampleIndex Índice de la muestra dentro del píxel.
+     */
+    RandomSequence(uint64_t pixelIndex, uint32_t sampleIndex);
+
+    /**
+     * @brief Devuelve el siguiente número de la secuencia.
+     * @return Número en [0, 1).
+     */
+    double next();
+
+private:
+    uint64_t key;      // Clave derivada del píxel y de la muestra
+    uint64_t counter;  // Posición dentro de la secuencia
+};
+
+#endif // RANDOM_H
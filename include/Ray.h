@@ -5,6 +5,9 @@
 
 /**
  * @brief Clase que representa un rayo en el espacio 3D.
+ *
+ * Además del origen y la dirección, el rayo lleva un cono (ancho en el origen y ángulo de apertura)
+ * que aproxima el área del píxel que representa; se usa para elegir el nivel mip de las texturas.
  */
 class Ray {
 public:
@@ -13,8 +16,23 @@ public:
      * 
      * @param origin Punto de origen del rayo.
      * @param direction Dirección del rayo.
+     * @param coneWidth Ancho del cono del rayo en su origen (por defecto 0).
+     * @param spreadAngle Ángulo de apertura del cono en radianes (por defecto 0).
      */
-    Ray(const Vector3D& origin, const Vector3D& direction);
+    Ray(const Vector3D& origin, const Vector3D& direction, double coneWidth = 0.0, double spreadAngle = 0.0);
+
+    /**
+     * @brief Crea un rayo cuya dirección ya está normalizada, sin volver a normalizarla.
+     *
+     * Reconstruye exactamente un rayo guardado por componentes (normalizar de nuevo puede cambiar el último bit).
+     *
+     * @param origin Punto de origen del rayo.
+     * @param direction Dirección de magnitud 1.
+     * @param coneWidth Ancho del cono del rayo en su origen.
+     * @param spreadAngle Ángulo de apertura del cono en radianes.
+     * @return Rayo.
+     */
+    static Ray withUnitDirection(const Vector3D& origin, const Vector3D& direction, double coneWidth, double spreadAngle);
 
     /**
      * @brief Método para obtener el origen del rayo.
@@ -28,9 +46,26 @@ public:
      */
     Vector3D getDirection() const;
 
+    /**
+     * @brief Ancho del cono del rayo a una distancia dada de su origen.
+     * @param t Distancia desde el origen.
+     * @return Ancho aproximado de la huella del rayo en unidades del mundo.
+     */
+    double getConeWidth(double t) const;
+
+    /**
+     * @brief Ángulo de apertura del cono del rayo.
+     * @return Ángulo en radianes.
+     */
+    double getSpreadAngle() const;
+
 private:
+    Ray() = default;
+
     Vector3D origin;     ///< Origen del rayo.
     Vector3D direction;  ///< Dirección del rayo, siempre normalizada.
+    double coneWidth;    ///< Ancho del cono en el origen.
+    double spreadAngle;  ///< Ángulo de apertura del cono.
 };
 
 #endif // RAY_H
@@ -0,0 +1,271 @@
+#ifndef RENDER_CONFIG_H
+#define RENDER_CONFIG_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Framebuffer.h"
+#include "generateImage.h" // Para DEFAULT_TILE_SIZE
+#include "PagedGeometry.h" // Para GEOMETRY_CACHE_MB
+#include "wavefront.h"     // Para WAVEFRONT_BATCH_PIXELS
+
+#define DEFAULT_IMAGE_WIDTH 1000                  // Ancho de la imagen en píxeles
+#define DEFAULT_IMAGE_HEIGHT 1000                 // Alto de la imagen en píxeles
+#define DEFAULT_VIEWPORT_WIDTH 2.0                // Ancho del viewport en unidades del mundo
+#define DEFAULT_DISTANCE_TO_VIEWPORT 1.0          // Distancia entre la cámara y el viewport
+#define DEFAULT_MAX_REFLECTION_DEPTH 10           // Profundidad de reflejo alta para reflejos detallados
+#define DEFAULT_PATH_TRACE_SAMPLES 16             // Muestras por píxel por defecto del trazado de caminos
+#define DEFAULT_MAX_PATH_BOUNCES 8                // Rebotes máximos de cada camino
+#define DEFAULT_OUTPUT_PATH "./output/output.ppm" // Ruta por defecto del PPM de salida
+#define DEFAULT_EYE_SEPARATION 0.065              // Distancia entre las cámaras de la vista estéreo en unidades del mundo
+
+/**
+ * @brief Estructuras de aceleración que se pueden elegir para el render.
+ */
+enum class Acceleration {
+    FRUSTUM,  ///< Descarte por frustum de cada tile de las primitivas de los rayos primarios (por defecto).
+    GRID,     ///< Como FRUSTUM, pero las esferas sin textura pasan a la malla uniforme (SphereGrid).
+    NONE      ///< Sin descarte: cada rayo primario prueba todas las primitivas (referencia para comparar).
+};
+
+/**
+ * @brief Formas de trazar los rayos secundarios (reflexión y refracción) del trazador de Whitted.
+ */
+enum class SecondaryRays {
+    RECURSIVE,  ///< Cada píxel traza su árbol de rayos recursivamente (por defecto).
+    WAVEFRONT,  ///< Por frentes de onda (generateImageWavefront), en el orden en que se generan los rayos.
+    SORTED      ///< Por frentes de onda, con cada frente ordenado por octante y celda de Morton.
+};
+
+/**
+ * @brief Organización del render del trazador de Whitted.
+ */
+enum class RenderPipeline {
+    MEGAKERNEL, ///< Un kernel calcula cada rayo de principio a fin (por defecto).
+    WAVEFRONT   ///< Por etapas (WavefrontPipeline): generación, intersección, sombras, oclusión y sombreado.
+};
+
+/**
+ * @brief Vistas que se renderizan a la vez desde la cámara de la escena (ver generateImageViews).
+ */
+enum class ViewLayout {
+    SINGLE,   ///< Una sola imagen (por defecto).
+    STEREO,   ///< Pareja estéreo lado a lado: ojo izquierdo y derecho.
+    CUBEMAP   ///< Las seis caras de un cubemap en una tira (+x, -x, +y, -y, +z, -z).
+};
+
+/**
+ * @brief Colocación de los hilos y la memoria en los nodos NUMA (ver generateImageNuma).
+ */
+enum class NumaPlacement {
+    OFF,         ///< Hilos sin fijar y memoria donde la toque primero cada hilo (por defecto).
+    LOCAL,       ///< Hilos fijados por nodo, una copia de la escena por nodo y cada franja de la imagen en su nodo.
+    INTERLEAVED  ///< Hilos fijados por nodo, una sola escena y las páginas de la imagen repartidas entre los nodos.
+};
+
+/**
+ * @brief Parámetros del render que antes se fijaban al compilar.
+ *
+ * Se leen de un archivo de configuración (loadRenderConfig) y de la línea de comandos
+ * (setRenderConfigValue), de modo que un mismo binario puede barrer resoluciones, profundidades,
+ * muestras, tiles y estructuras de aceleración sin recompilarse.
+ */
+struct RenderConfig {
+    int width = DEFAULT_IMAGE_WIDTH;                          ///< Ancho de la imagen en píxeles.
+    int height = DEFAULT_IMAGE_HEIGHT;                        ///< Alto de la imagen en píxeles.
+    double viewportWidth = DEFAULT_VIEWPORT_WIDTH;            ///< Ancho del viewport.
+    double viewportHeight = 0.0;                              ///< Alto del viewport (0 = según la proporción de la imagen).
+    double distanceToViewport = DEFAULT_DISTANCE_TO_VIEWPORT; ///< Distancia entre la cámara y el viewport.
+    int maxDepth = DEFAULT_MAX_REFLECTION_DEPTH;              ///< Profundidad máxima de reflexión y refracción.
+    int threads = 0;                                          ///< Hilos de render (0 = uno por núcleo).
+    int tileSize = DEFAULT_TILE_SIZE;                         ///< Lado de los tiles en píxeles.
+    int samplesPerPixel = DEFAULT_PATH_TRACE_SAMPLES;         ///< Muestras por píxel del trazado de caminos.
+    int maxBounces = DEFAULT_MAX_PATH_BOUNCES;                ///< Rebotes máximos de cada camino.
+    PixelFormat format = PixelFormat::SRGB8;                  ///< Formato del framebuffer.
+    std::string outputPath = DEFAULT_OUTPUT_PATH;             ///< Ruta del PPM de salida.
+    Acceleration acceleration = Acceleration::FRUSTUM;        ///< Estructura de aceleración.
+    std::string geometryPath;                                 ///< Archivo de geometría paginada que se agrega a la escena (vacío = ninguno).
+    int geometryCacheMB = GEOMETRY_CACHE_MB;                  ///< Memoria máxima de los chunks residentes de la geometría paginada (MB).
+    SecondaryRays secondaryRays = SecondaryRays::RECURSIVE;   ///< Forma de trazar los rayos secundarios.
+    int wavefrontBatch = WAVEFRONT_BATCH_PIXELS;              ///< Píxeles de cada lote del render por frentes de onda.
+    RenderPipeline pipeline = RenderPipeline::MEGAKERNEL;     ///< Organización del render del trazador de Whitted.
+    ViewLayout views = ViewLayout::SINGLE;                    ///< Vistas que se renderizan desde la cámara.
+    double eyeSeparation = DEFAULT_EYE_SEPARATION;            ///< Distancia entre las cámaras de la vista estéreo.
+    NumaPlacement numa = NumaPlacement::OFF;                  ///< Colocación de los hilos y la memoria en los nodos NUMA.
+
+    /**
+     * @brief Devuelve el alto efectivo del viewport.
+     * @return viewportHeight, o el que mantiene la proporción de la imagen si es 0.
+     */
+    double getViewportHeight() const;
+};
+
+/**
+ * @brief Opción de la configuración: clave del archivo, opción de la línea de comandos y descripción.
+ */
+struct RenderConfigOption {
+    const char* key;          ///< Clave en el archivo de configuración.
+    const char* flag;         ///< Opción equivalente de la línea de comandos.
+    const char* description;  ///< Descripción para la ayuda.
+};
+
+/**
+ * Devuelve las opciones de configuración conocidas.
+ *
+ * @return const std::vector<RenderConfigOption>&: Opciones en el orden en que se muestran.
+ */
+const std::vector<RenderConfigOption>& renderConfigOptions();
+
+/**
+ * Busca la opción de configuración que corresponde a una opción de la línea de comandos.
+ *
+ * @param flag: Opción de la línea de comandos (por ejemplo "--width").
+ * @return const RenderConfigOption*: Opción encontrada, o nullptr si no es una opción de configuración.
+ */
+const RenderConfigOption* findRenderConfigFlag(const std::string& flag);
+
+/**
+ * Asigna un valor de la configuración a partir de su clave.
+ *
+ * @param config: Configuración a modificar.
+ * @param key: Clave (ver renderConfigOptions()).
+ * @param value: Valor como texto.
+ * @param error: Descripción del error si el valor no es válido.
+ * @return bool: true si se asignó el valor.
+ */
+bool setRenderConfigValue(RenderConfig& config, const std::string& key, const std::string& value, std::string& error);
+
+/**
+ * Devuelve un valor de la configuración como texto, con el formato que acepta setRenderConfigValue.
+ *
+ * @param config: Configuración.
+ * @param key: Clave.
+ * @return std::string: Valor, o una cadena vacía si la clave no existe.
+ */
+std::string getRenderConfigValue(const RenderConfig& config, const std::string& key);
+
+/**
+ * Lee un archivo de configuración con líneas "clave = valor"; las líneas que empiezan por '#' son comentarios.
+ *
+ * @param path: Ruta del archivo.
+ * @param config: Configuración a modificar (las claves ausentes conservan su valor).
+ * @param error: Descripción del error (con el número de línea) si el archivo no es válido.
+ * @return bool: true si se leyó el archivo completo.
+ */
+bool loadRenderConfig(const std::string& path, RenderConfig& config, std::string& error);
+
+/**
+ * Escribe la configuración en el formato de loadRenderConfig, con la descripción de cada clave en un comentario encima.
+ *
+ * @param out: Flujo de salida.
+ * @param config: Configuración.
+ */
+void writeRenderConfig(std::ostream& out, const RenderConfig& config);
+
+/**
+ * Comprueba que los valores de la configuración sean coherentes.
+ *
+ * @param config: Configuración.
+ * @param error: Descripción del primer problema encontrado.
+ * @return bool: true si la configuración es válida.
+ */
+bool validateRenderConfig(const RenderConfig& config, std::string& error);
+
+/**
+ * Convierte en opciones de la línea de comandos los parámetros que afectan a los píxeles, para que
+ * los procesos trabajadores rendericen exactamente la misma imagen que el coordinador.
+ *
+ * No incluye los hilos, el formato ni la ruta de salida, que el coordinador fija por separado, ni el
+ * archivo de geometría si no hay ninguno.
+ *
+ * @param config: Configuración.
+ * @return std::vector<std::string>: Opciones y valores alternados.
+ */
+std::vector<std::string> renderConfigArguments(const RenderConfig& config);
+
+/**
+ * Devuelve el nombre de una estructura de aceleración ("frustum", "grid" o "none").
+ *
+ * @param acceleration: Estructura de aceleración.
+ * @return const char*: Nombre.
+ */
+const char* accelerationName(Acceleration acceleration);
+
+/**
+ * Convierte un nombre en una estructura de aceleración.
+ *
+ * @param name: Nombre (ver accelerationName).
+ * @param acceleration: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseAcceleration(const std::string& name, Acceleration& acceleration);
+
+/**
+ * Devuelve el nombre de una forma de trazar los rayos secundarios ("recursive", "wavefront" o "sorted").
+ *
+ * @param secondaryRays: Forma de trazar los rayos secundarios.
+ * @return const char*: Nombre.
+ */
+const char* secondaryRaysName(SecondaryRays secondaryRays);
+
+/**
+ * Convierte un nombre en una forma de trazar los rayos secundarios.
+ *
+ * @param name: Nombre (ver secondaryRaysName).
+ * @param secondaryRays: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseSecondaryRays(const std::string& name, SecondaryRays& secondaryRays);
+
+/**
+ * Devuelve el nombre de una organización del render ("megakernel" o "wavefront").
+ *
+ * @param pipeline: Organización del render.
+ * @return const char*: Nombre.
+ */
+const char* renderPipelineName(RenderPipeline pipeline);
+
+/**
+ * Convierte un nombre en una organización del render.
+ *
+ * @param name: Nombre (ver renderPipelineName).
+ * @param pipeline: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseRenderPipeline(const std::string& name, RenderPipeline& pipeline);
+
+/**
+ * Devuelve el nombre de un conjunto de vistas ("single", "stereo" o "cubemap").
+ *
+ * @param views: Conjunto de vistas.
+ * @return const char*: Nombre.
+ */
+const char* viewLayoutName(ViewLayout views);
+
+/**
+ * Convierte un nombre en un conjunto de vistas.
+ *
+ * @param name: Nombre (ver viewLayoutName).
+ * @param views: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseViewLayout(const std::string& name, ViewLayout& views);
+
+/**
+ * Devuelve el nombre de una colocación NUMA ("off", "local" o "interleaved").
+ *
+ * @param placement: Colocación.
+ * @return const char*: Nombre.
+ */
+const char* numaPlacementName(NumaPlacement placement);
+
+/**
+ * Convierte un nombre en una colocación NUMA.
+ *
+ * @param name: Nombre (ver numaPlacementName).
+ * @param placement: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseNumaPlacement(const std::string& name, NumaPlacement& placement);
+
+#endif // RENDER_CONFIG_H
@@ -0,0 +1,190 @@
+#ifndef RENDER_SERVICE_H
+#define RENDER_SERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+#include "Framebuffer.h"
+#include "RenderConfig.h"
+
+/**
+ * @brief Prioridad de un trabajo de RenderService. Los tiles de un trabajo se reparten antes que los
+ * de cualquier trabajo de menor prioridad; a igual prioridad, en el orden en que se enviaron.
+ */
+enum class RenderPriority {
+    BACKGROUND,  ///< Renders por lotes, que usan los núcleos que dejan libres los demás.
+    NORMAL,      ///< Prioridad por defecto.
+    PREVIEW      ///< Vistas previas interactivas, que adelantan a todos los trabajos en curso.
+};
+
+/**
+ * @brief Avance de un trabajo, que recibe la función de progreso tras cada tile.
+ */
+struct RenderProgress {
+    int tilesDone = 0;   ///< Tiles terminados.
+    int tilesTotal = 0;  ///< Tiles de la imagen.
+    int x0 = 0, y0 = 0;  ///< Primer píxel del último tile terminado.
+    int x1 = 0, y1 = 0;  ///< Píxel siguiente al último del último tile terminado.
+};
+
+/**
+ * @brief Resultado de un trabajo.
+ */
+struct RenderResult {
+    Framebuffer image;      ///< Imagen (con los tiles sin renderizar en negro si se canceló).
+    bool cancelled = false; ///< true si el trabajo se canceló antes de terminar.
+    int tilesDone = 0;      ///< Tiles renderizados.
+    double seconds = 0.0;   ///< Tiempo desde el envío hasta el último tile.
+};
+
+/**
+ * @brief Trabajo que se envía a RenderService: escena, cámara y parámetros del render.
+ */
+struct RenderRequest {
+    SceneSnapshot scene;                                 ///< Escena congelada (el servicio la mantiene viva hasta terminar).
+    Camera camera;                                       ///< Cámara.
+    RenderConfig config;                                 ///< Resolución, viewport, profundidad y formato (tileSize y threads son globales).
+    RenderPriority priority = RenderPriority::NORMAL;    ///< Prioridad de sus tiles.
+    std::function<void(const RenderProgress&)> progress; ///< Se llama desde los hilos del servicio tras cada tile (puede estar vacía).
+};
+
+/**
+ * @brief Ejecuta trabajos de render del trazador de Whitted en un conjunto de hilos compartido.
+ *
+ * submit() no bloquea: devuelve un Job con un future del resultado. Los hilos toman de uno en uno
+ * los tiles del trabajo pendiente de mayor prioridad (el más antiguo entre los de igual prioridad), así
+ * que un trabajo interactivo enviado en mitad de un render por lotes empieza en cuanto termina el tile
+ * en curso de cada hilo, y los trabajos de fondo continúan cuando se liberan los núcleos. Cada tile se
+ * renderiza con renderTile, así que la imagen es idéntica a la de generateImageRows.
+ *
+ * Es independiente de TilePool::shared(), cuyos lotes son síncronos: un proceso que usa el servicio no
+ * debería renderizar a la vez con las funciones generateImage*.
+ */
+class RenderService {
+public:
+    class Job;
+
+    /**
+     * @brief Crea el servicio y sus hilos.
+     * @param threadCount Número de hilos (0 = uno por núcleo).
+     */
+    explicit RenderService(int threadCount = 0);
+
+    /**
+     * @brief Cancela los trabajos pendientes, espera a los tiles en curso y detiene los hilos.
+     */
+    ~RenderService();
+
+    RenderService(const RenderService&) = delete;
+    RenderService& operator=(const RenderService&) = delete;
+
+    /**
+     * @brief Encola un trabajo.
+     * @param request Trabajo (la escena debe estar completa: el servicio no la modifica).
+     * @return Trabajo encolado, con el future de su resultado.
+     */
+    std::shared_ptr<Job> submit(RenderRequest request);
+
+    /**
+     * @brief Devuelve el número de hilos del servicio.
+     * @return Número de hilos.
+     */
+    int getThreadCount() const;
+
+private:
+    /**
+     * @brief Bucle de cada hilo: toma el siguiente tile de mayor prioridad y lo renderiza.
+     */
+    void workerLoop();
+
+    /**
+     * @brief Elige el trabajo del siguiente tile y quita de la cola los terminados o cancelados (con el mutex tomado).
+     * @param finished Trabajos sin tiles en curso que ya se pueden completar.
+     * @return Trabajo elegido (nullptr si no queda ningún tile).
+     */
+    std::shared_ptr<Job> nextJob(std::vector<std::shared_ptr<Job>>& finished);
+
+    std::vector<std::thread> workers;         // Hilos del servicio
+    std::mutex mutex;                         // Protege la cola y el reparto de tiles
+    std::condition_variable wake;             // Avisa a los hilos de trabajo nuevo
+    std::vector<std::shared_ptr<Job>> queue;  // Trabajos con tiles sin repartir
+    std::uint64_t submitted = 0;              // Trabajos enviados (orden entre los de igual prioridad)
+    bool stopping = false;                    // Indica a los hilos que deben terminar
+};
+
+/**
+ * @brief Trabajo enviado a RenderService.
+ */
+class RenderService::Job {
+public:
+    /**
+     * @brief Devuelve el future del resultado (se cumple al terminar o tras cancelar).
+     * @return Future compartido del resultado.
+     */
+    std::shared_future<RenderResult> getResult() const;
+
+    /**
+     * @brief Pide cancelar el trabajo: no se reparten más tiles y los que están en curso terminan.
+     */
+    void cancel();
+
+    /**
+     * @brief Indica si se pidió cancelar el trabajo.
+     * @return true tras cancel().
+     */
+    bool isCancelled() const;
+
+    /**
+     * @brief Devuelve el avance del trabajo.
+     * @return Tiles terminados y totales (sin la posición del último tile).
+     */
+    RenderProgress getProgress() const;
+
+    /**
+     * @brief Devuelve la prioridad del trabajo.
+     * @return Prioridad.
+     */
+    RenderPriority getPriority() const;
+
+private:
+    friend class RenderService;
+
+    Job(RenderRequest request, std::uint64_t sequence);
+
+    /**
+     * @brief Renderiza un tile y avisa del progreso.
+     * @param tile Índice del tile.
+     */
+    void renderTile(int tile);
+
+    /**
+     * @brief Cumple el future con la imagen (una sola vez, sin tiles en curso).
+     */
+    void finish();
+
+    RenderRequest request;                   // Trabajo enviado
+    std::uint64_t sequence;                  // Orden de envío
+    Scene::TraceKernel traceKernel;          // Kernel especializado para la escena
+    double viewportHeight;                   // Alto efectivo del viewport
+    int tileColumns, tileCount;              // Cuadrícula de tiles
+    Framebuffer image;                       // Imagen en curso
+    std::chrono::high_resolution_clock::time_point start; // Momento del envío
+    std::promise<RenderResult> promise;      // Resultado
+    std::shared_future<RenderResult> result; // Future compartido del resultado
+    std::atomic<bool> cancelled{false};      // Cancelación pedida
+    std::atomic<int> tilesDone{0};           // Tiles terminados
+    int nextTile = 0;                        // Siguiente tile a repartir (con el mutex del servicio)
+    int tilesInFlight = 0;                   // Tiles repartidos y sin terminar (con el mutex del servicio)
+    bool finished = false;                   // El future ya se cumplió (con el mutex del servicio)
+};
+
+#endif // RENDER_SERVICE_H
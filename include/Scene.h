@@ -1,6 +1,9 @@
 #ifndef SCENE_H
 #define SCENE_H
 
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 #include "Triangle.h"
 #include "Plane.h"
@@ -8,6 +11,104 @@
 #include "Ray.h"
 #include "Vector3D.h"
 #include "Sphere.h"  // Incluir la clase Sphere
+#include "SphereGrid.h"
+#include "CompressedMesh.h"
+#include "PagedGeometry.h"
+
+// Muestras de sombra por luz de área: mínimo (fuera de la penumbra) y máximo (rejilla 4x4 completa)
+#define AREA_LIGHT_MIN_SAMPLES 4
+#define AREA_LIGHT_MAX_SAMPLES 16
+
+#define POINT_LIGHT_MIN_DISTANCE 1e-9 // Distancia bajo la cual una luz puntual coincide con el punto iluminado y se omite
+
+// Control del árbol de rayos secundarios (reflexión y refracción):
+// no se traza una rama cuyo peso en el color final del píxel sea menor que MIN_RAY_CONTRIBUTION
+// (menos de medio nivel de 8 bits), y cada píxel traza como máximo MAX_SECONDARY_RAYS_PER_PIXEL rayos secundarios.
+#define MIN_RAY_CONTRIBUTION (1.0 / 512.0)
+#define MAX_SECONDARY_RAYS_PER_PIXEL 64
+
+/**
+ * @brief Características de una escena que los kernels de render especializados pueden omitir.
+ *
+ * Cada kernel se compila para un conjunto fijo de características: las ramas de las que no están
+ * presentes desaparecen del bucle interno. El kernel de FEATURE_ALL es el trazador genérico.
+ */
+enum SceneFeature : unsigned {
+    FEATURE_SECONDARY_RAYS = 1u << 0,   ///< Materiales reflectivos o transparentes (con profundidad mayor que 0).
+    FEATURE_SPECULAR = 1u << 1,         ///< Materiales con brillo especular (specular distinto de -1).
+    FEATURE_AREA_LIGHTS = 1u << 2,      ///< Luces RECTANGLE o SPHERE.
+    FEATURE_POINT_LIGHTS = 1u << 3,     ///< Luces POINT (sin ellas, las luces no ambientales son direccionales o de área).
+    FEATURE_FLAT_PRIMITIVES = 1u << 4,  ///< Triángulos o planos (sin ellos, la escena solo tiene esferas).
+    FEATURE_ALL = (1u << 5) - 1         ///< Todas las características.
+};
+
+/**
+ * @brief Subconjunto de las primitivas finitas de una escena.
+ *
+ * Se usa para trazar los rayos primarios de un tile solo contra los objetos cuyo volumen
+ * envolvente intersecta el frustum del tile. Los planos son infinitos y siempre se prueban.
+ */
+struct PrimitiveList {
+    std::vector<const Triangle*> triangles;  ///< Triángulos candidatos.
+    std::vector<const Sphere*> spheres;      ///< Esferas candidatas.
+};
+
+/**
+ * @brief Información de la intersección más cercana de un rayo con la escena.
+ *
+ * Exactamente uno de los punteros al objeto intersectado es distinto de nullptr cuando hay intersección.
+ */
+struct HitRecord {
+    double t = 0.0;                          ///< Distancia desde el origen del rayo.
+    Vector3D point;                          ///< Punto de intersección.
+    Vector3D normal;                         ///< Normal en el punto de intersección.
+    const Triangle* triangle = nullptr;      ///< Triángulo intersectado, si aplica.
+    const Plane* plane = nullptr;            ///< Plano intersectado, si aplica.
+    const Sphere* sphere = nullptr;          ///< Esfera intersectada, si aplica.
+    const SphereGrid* sphereGrid = nullptr;  ///< Malla de esferas intersectada, si aplica.
+    std::uint32_t gridSphere = 0;            ///< Índice de la esfera en sphereGrid.
+    const CompressedMesh* mesh = nullptr;    ///< Malla de triángulos intersectada, si aplica.
+    std::uint32_t meshTriangle = 0;          ///< Índice del triángulo en mesh.
+    const PagedGeometry* paged = nullptr;    ///< Geometría paginada intersectada, si aplica (la normal ya viene calculada).
+    std::uint32_t pagedChunk = 0;            ///< Chunk del triángulo en paged.
+    std::uint32_t pagedTriangle = 0;         ///< Índice del triángulo dentro del chunk.
+};
+
+/**
+ * @brief Material del objeto intersectado, evaluado en el punto de impacto.
+ */
+struct SurfaceMaterial {
+    Vector3D color;           ///< Color en el punto, con la textura aplicada (escala 0-255).
+    double specular;          ///< Exponente especular (-1 = sin brillo).
+    double reflectivity;      ///< Reflectividad.
+    double transparency;      ///< Fracción de la luz que atraviesa la superficie.
+    double refractiveIndex;   ///< Índice de refracción.
+};
+
+/**
+ * @brief Muestra de una luz vista desde un punto: dirección del rayo de sombra y distancia hasta la luz.
+ */
+struct LightSample {
+    Vector3D direction;       ///< Dirección normalizada hacia la muestra (sin valor si distance es 0).
+    double distance = 0.0;    ///< Distancia hasta la muestra (infinita en las luces direccionales; 0 si coincide con el punto).
+};
+
+/**
+ * @brief Rayo secundario diferido: se traza más tarde junto con los de otros píxeles (render por frentes de onda).
+ */
+struct DeferredRay {
+    Ray ray;                  ///< Rayo reflejado o refractado.
+    Vector3D fallback;        ///< Color local del punto que lo generó (lo sustituye si el rayo no se traza).
+    double weight;            ///< Peso del rayo en el color final del píxel.
+    std::uint32_t pixel;      ///< Píxel al que aporta su color.
+};
+
+class Scene;
+
+/**
+ * @brief Escena congelada (ver Scene::freeze): inmutable y compartida entre hilos y renders sin copiarla.
+ */
+typedef std::shared_ptr<const Scene> SceneSnapshot;
 
 /**
  * @brief Clase que representa una escena compuesta por varios objetos y fuentes de luz.
@@ -17,6 +118,24 @@
  */
 class Scene {
 public:
+    /**
+     * @brief Kernel de render: traza un rayo primario contra las primitivas candidatas de su tile.
+     *
+     * Equivale a Scene::traceRay(ray, depth, candidates), compilado para un conjunto de SceneFeature.
+     */
+    typedef Vector3D (*TraceKernel)(const Scene& scene, const Ray& ray, int depth, const PrimitiveList& candidates);
+
+    /**
+     * @brief Kernel de render diferido: sombrea un rayo sin trazar sus rayos secundarios.
+     *
+     * Devuelve el color que aporta el punto de impacto por sí mismo (sin multiplicar por weight): el
+     * color local por su peso más el de las ramas que no se trazan. Las ramas que sí se trazan se agregan
+     * a spawned con su peso absoluto para trazarlas después junto a las de otros rayos. Con candidates
+     * igual a nullptr el rayo se prueba contra toda la escena.
+     */
+    typedef Vector3D (*DeferredKernel)(const Scene& scene, const Ray& ray, const PrimitiveList* candidates, int depth,
+                                       double weight, std::uint32_t pixel, std::vector<DeferredRay>& spawned);
+
     /**
      * @brief Agrega un triángulo a la escena.
      * @param triangle Triángulo a agregar.
@@ -41,6 +160,46 @@ public:
      */
     void addSphere(const Sphere& sphere);
 
+    /**
+     * @brief Asigna la malla de esferas pequeñas de la escena (debe estar construida con build()).
+     * @param grid Malla de esferas.
+     */
+    void setSphereGrid(SphereGrid grid);
+
+    /**
+     * @brief Agrega una malla de triángulos comprimida (debe estar construida con build()).
+     * @param mesh Malla a agregar.
+     */
+    void addMesh(CompressedMesh mesh);
+
+    /**
+     * @brief Asigna la geometría paginada de la escena (un archivo de geometría ya abierto).
+     *
+     * Se comparte con std::shared_ptr porque la caché de chunks no se puede copiar.
+     *
+     * @param geometry Geometría paginada (nullptr para quitarla).
+     */
+    void setPagedGeometry(std::shared_ptr<const PagedGeometry> geometry);
+
+    /**
+     * @brief Pasa las esferas sin textura a la malla de esferas (junto a las que ya tuviera) y la reconstruye.
+     * @return Número de esferas movidas.
+     */
+    size_t moveSpheresToGrid();
+
+    /**
+     * @brief Congela una escena ya construida para compartirla entre renders concurrentes.
+     *
+     * La escena se mueve (sin copiar sus primitivas) a un objeto constante. Todas las consultas de una
+     * escena constante solo leen sus datos, así que varios hilos y varias cámaras pueden renderizarla a
+     * la vez sin bloqueos; la única excepción es la caché de chunks de la geometría paginada, que tiene
+     * su propio mutex. La escena se libera cuando termina el último render que la usa.
+     *
+     * @param scene Escena completa (queda vacía).
+     * @return Instantánea inmutable de la escena.
+     */
+    static SceneSnapshot freeze(Scene&& scene);
+
     /**
      * @brief Traza un rayo a través de la escena para determinar el color resultante.
      * @param ray Rayo a trazar.
@@ -49,6 +208,66 @@ public:
      */
     Vector3D traceRay(const Ray& ray, int depth) const;
 
+    /**
+     * @brief Traza un rayo primario probando solo las primitivas candidatas para la primera intersección.
+     *
+     * Los rayos reflejados posteriores se trazan contra la escena completa, ya que pueden salir del frustum.
+     *
+     * @param ray Rayo a trazar.
+     * @param depth Profundidad máxima de reflexión para el rayo.
+     * @param candidates Triángulos y esferas que el rayo puede intersectar (los planos siempre se prueban).
+     * @return Color (Vector3D) que representa el color calculado.
+     */
+    Vector3D traceRay(const Ray& ray, int depth, const PrimitiveList& candidates) const;
+
+    /**
+     * @brief Busca la intersección más cercana de un rayo con la escena.
+     * @param ray Rayo a evaluar.
+     * @param hit Información de la intersección más cercana (solo válida si se devuelve true).
+     * @return true si hay una intersección, false de lo contrario.
+     */
+    bool closestHit(const Ray& ray, HitRecord& hit) const;
+
+    /**
+     * @brief Busca la intersección más cercana de un rayo con un subconjunto de la escena (más todos los planos).
+     * @param ray Rayo a evaluar.
+     * @param candidates Triángulos y esferas a probar.
+     * @param hit Información de la intersección más cercana (solo válida si se devuelve true).
+     * @return true si hay una intersección, false de lo contrario.
+     */
+    bool closestHit(const Ray& ray, const PrimitiveList& candidates, HitRecord& hit) const;
+
+    /**
+     * @brief Busca la intersección más cercana de un lote de rayos; la geometría paginada se recorre con
+     * PagedGeometry::intersectBatch, que lee cada chunk a lo sumo una vez por lote.
+     * @param rays Rayos del lote.
+     * @param candidates Triángulos y esferas a probar con cada rayo (nullptr = toda la escena; los planos siempre se prueban).
+     * @param hits Intersección más cercana de cada rayo (solo válida si found es 1).
+     * @param found 1 si el rayo tiene intersección, 0 si no.
+     */
+    void closestHitBatch(const std::vector<Ray>& rays, const std::vector<const PrimitiveList*>& candidates, std::vector<HitRecord>& hits,
+                         std::vector<unsigned char>& found) const;
+
+    /**
+     * @brief Calcula el color de una intersección ya encontrada, incluyendo reflexiones y refracciones.
+     *
+     * Es la raíz del árbol de rayos de un píxel: dispone de MAX_SECONDARY_RAYS_PER_PIXEL rayos secundarios.
+     *
+     * @param ray Rayo que produjo la intersección.
+     * @param hit Intersección más cercana del rayo (obtenida con closestHit).
+     * @param depth Profundidad máxima de reflexión restante.
+     * @return Color (Vector3D) que representa el color calculado.
+     */
+    Vector3D shade(const Ray& ray, const HitRecord& hit, int depth) const;
+
+    /**
+     * @brief Devuelve el material del objeto intersectado.
+     * @param hit Intersección (obtenida con closestHit).
+     * @param footprint Ancho de la huella del rayo en el punto, para el nivel mip de las texturas.
+     * @return Material en el punto de impacto.
+     */
+    SurfaceMaterial getMaterial(const HitRecord& hit, double footprint) const;
+
     /**
      * @brief Calcula la iluminación en un punto específico de la escena.
      * @param point Punto donde se calcula la iluminación.
@@ -59,6 +278,49 @@ public:
      */
     double computeLighting(const Vector3D& point, const Vector3D& normal, const Vector3D& viewDirection, int specular) const;
 
+    /**
+     * @brief Calcula una muestra de una luz no ambiental vista desde un punto, como la usa computeLighting.
+     *
+     * Las luces de área tienen AREA_LIGHT_MAX_SAMPLES muestras, en el orden en que las traza
+     * computeAreaLighting; las puntuales y direccionales, una.
+     *
+     * @param light Luz (no ambiental).
+     * @param point Punto iluminado.
+     * @param index Número de muestra de las luces de área (se ignora en las demás).
+     * @return Dirección y distancia de la muestra.
+     */
+    static LightSample sampleLight(const LightSource& light, const Vector3D& point, int index);
+
+    /**
+     * @brief Calcula la contribución difusa y especular de una muestra de luz visible.
+     * @param light Luz de la muestra.
+     * @param sample Muestra (obtenida con sampleLight).
+     * @param normal Normal en el punto.
+     * @param viewDirection Dirección hacia la cámara.
+     * @param specular Valor especular del material.
+     * @return Intensidad aportada por la muestra.
+     */
+    static double sampleIntensity(const LightSource& light, const LightSample& sample, const Vector3D& normal, const Vector3D& viewDirection, int specular);
+
+    /**
+     * @brief Reparte la luz de una intersección ya sombreada y encola sus rayos secundarios en vez de trazarlos.
+     *
+     * Es la última parte de un kernel diferido (ver DeferredKernel) para quien ya calculó el material y la
+     * iluminación directa por separado.
+     *
+     * @param ray Rayo que produjo la intersección.
+     * @param hit Intersección más cercana.
+     * @param material Material en el punto de impacto (getMaterial).
+     * @param localColor Color del material por la iluminación directa.
+     * @param depth Profundidad restante.
+     * @param weight Peso del rayo en el color final del píxel.
+     * @param pixel Píxel del rayo.
+     * @param spawned Rayos secundarios que se trazarán después.
+     * @return Color que aporta el punto de impacto (sin multiplicar por weight).
+     */
+    Vector3D shadeDeferred(const Ray& ray, const HitRecord& hit, const SurfaceMaterial& material, const Vector3D& localColor,
+                           int depth, double weight, std::uint32_t pixel, std::vector<DeferredRay>& spawned) const;
+
     /**
      * @brief Determina si un rayo intersecta con algún objeto en la escena.
      * @param ray Rayo a evaluar.
@@ -71,23 +333,163 @@ public:
     /**
      * @brief Determina si un punto está en la sombra.
      * @param point Punto a evaluar.
-     * @param lightDirection Dirección de la luz.
-     * @param t_max Máxima distancia de la sombra.
+     * @param lightDirection Dirección normalizada hacia la luz.
+     * @param t_max Distancia hasta la luz; los objetos más allá no proyectan sombra.
      * @return true si el punto está en la sombra, false de lo contrario.
      */
     bool isInShadow(const Vector3D& point, const Vector3D& lightDirection, double t_max) const;
 
+    /**
+     * @brief Calcula la iluminación de una luz de área (RECTANGLE o SPHERE) con sombras suaves.
+     *
+     * La luz se divide en una rejilla estratificada de muestras. Primero se trazan AREA_LIGHT_MIN_SAMPLES
+     * rayos de sombra; si todos coinciden (punto totalmente iluminado o totalmente en sombra) se usa ese
+     * resultado, y solo en la penumbra se completan las AREA_LIGHT_MAX_SAMPLES muestras.
+     *
+     * @param light Luz de área.
+     * @param point Punto donde se calcula la iluminación.
+     * @param normal Normal en el punto.
+     * @param viewDirection Dirección hacia la cámara.
+     * @param specular Valor especular del material.
+     * @return Intensidad aportada por la luz.
+     */
+    double computeAreaLighting(const LightSource& light, const Vector3D& point, const Vector3D& normal,
+                               const Vector3D& viewDirection, int specular) const;
+
+    /**
+     * @brief Calcula las características que usa la escena.
+     * @param maxDepth Profundidad máxima de reflexión del render (con 0 no hay rayos secundarios).
+     * @return Combinación de valores de SceneFeature.
+     */
+    unsigned getFeatures(int maxDepth) const;
+
+    /**
+     * @brief Devuelve el kernel compilado para un conjunto de características.
+     *
+     * Se llama una vez por render; el kernel solo es válido para escenas cuyas características estén
+     * contenidas en features.
+     *
+     * @param features Combinación de valores de SceneFeature.
+     * @return Kernel especializado.
+     */
+    static TraceKernel selectKernel(unsigned features);
+
+    /**
+     * @brief Devuelve el kernel diferido compilado para un conjunto de características (ver selectKernel).
+     * @param features Combinación de valores de SceneFeature.
+     * @return Kernel diferido especializado.
+     */
+    static DeferredKernel selectDeferredKernel(unsigned features);
+
+    /**
+     * @brief Describe un conjunto de características para los mensajes del programa.
+     * @param features Combinación de valores de SceneFeature.
+     * @return Nombres de las características separados por '+' ("ninguna" si está vacío).
+     */
+    static std::string describeFeatures(unsigned features);
+
     // Getters para obtener objetos en la escena
     const std::vector<Triangle>& getTriangles() const;
     const std::vector<Plane>& getPlanes() const;
     const std::vector<LightSource>& getLights() const;
     const std::vector<Sphere>& getSpheres() const;
+    const SphereGrid& getSphereGrid() const;
+    const std::vector<CompressedMesh>& getMeshes() const;
+    const PagedGeometry* getPagedGeometry() const; // nullptr si la escena no tiene geometría paginada
 
 private:
+    // Versiones de las rutinas de trazado compiladas para un conjunto de SceneFeature (parámetro Features).
+    // Las funciones públicas equivalentes usan FEATURE_ALL.
+
+    /**
+     * @brief Busca la intersección más cercana con toda la escena o con las primitivas candidatas.
+     */
+    template <unsigned Features> bool closestHit(const Ray& ray, HitRecord& hit) const;
+    template <unsigned Features> bool closestHit(const Ray& ray, const PrimitiveList& candidates, HitRecord& hit) const;
+
+    /**
+     * @brief Completa el punto y la normal de una intersección ya encontrada.
+     */
+    template <unsigned Features> void finalizeHit(const Ray& ray, HitRecord& hit) const;
+
+    /**
+     * @brief Devuelve el material del objeto intersectado (ver la versión pública).
+     */
+    template <unsigned Features> SurfaceMaterial getMaterial(const HitRecord& hit, double footprint) const;
+
+    /**
+     * @brief Traza un rayo secundario dentro del árbol de rayos de un píxel.
+     * @param ray Rayo que se está trazando.
+     * @param depth Profundidad restante.
+     * @param weight Peso del rayo en el color final del píxel.
+     * @param raysLeft Rayos secundarios que le quedan al píxel (se descuentan al trazar).
+     * @return Color calculado.
+     */
+    template <unsigned Features> Vector3D traceRay(const Ray& ray, int depth, double weight, int& raysLeft) const;
+
+    /**
+     * @brief Calcula el color de una intersección repartiendo la luz entre color local, reflexión y refracción.
+     *
+     * Las ramas se trazan en orden de peso decreciente, de modo que si el presupuesto de rayos del píxel
+     * se agota se pierden primero las menos visibles. Una rama que no se traza (peso menor que
+     * MIN_RAY_CONTRIBUTION, presupuesto agotado o profundidad 0) se sustituye por el color local.
+     *
+     * @param ray Rayo que produjo la intersección.
+     * @param hit Intersección más cercana.
+     * @param depth Profundidad restante.
+     * @param weight Peso del rayo en el color final del píxel.
+     * @param raysLeft Rayos secundarios que le quedan al píxel.
+     * @return Color resultante.
+     */
+    template <unsigned Features> Vector3D shade(const Ray& ray, const HitRecord& hit, int depth, double weight, int& raysLeft) const;
+
+    /**
+     * @brief Reparto de la luz de shade(), con las ramas resueltas por traceBranch(rayo, peso de la rama, color local).
+     *
+     * shade() traza cada rama recursivamente; el kernel diferido la encola y devuelve negro.
+     */
+    template <unsigned Features, typename TraceBranch>
+    Vector3D shadeBranches(const Ray& ray, const HitRecord& hit, int depth, double weight, int& raysLeft, TraceBranch&& traceBranch) const;
+
+    /**
+     * @brief Parte de shadeBranches() que reparte la luz entre el color local ya calculado y las dos ramas.
+     */
+    template <typename TraceBranch>
+    Vector3D splitBranches(const Ray& ray, const HitRecord& hit, const SurfaceMaterial& material, const Vector3D& localColor,
+                           int depth, double weight, int& raysLeft, TraceBranch&& traceBranch) const;
+
+    /**
+     * @brief Calcula la iluminación directa en un punto (ver la versión pública).
+     */
+    template <unsigned Features> double computeLighting(const Vector3D& point, const Vector3D& normal, const Vector3D& viewDirection, int specular) const;
+    template <unsigned Features> double computeAreaLighting(const LightSource& light, const Vector3D& point, const Vector3D& normal,
+                                                            const Vector3D& viewDirection, int specular) const;
+    template <unsigned Features> bool isInShadow(const Vector3D& point, const Vector3D& lightDirection, double t_max) const;
+
+    /**
+     * @brief Kernel de render para un conjunto de características (ver TraceKernel).
+     */
+    template <unsigned Features> static Vector3D traceKernel(const Scene& scene, const Ray& ray, int depth, const PrimitiveList& candidates);
+
+    /**
+     * @brief Kernel diferido para un conjunto de características (ver DeferredKernel).
+     */
+    template <unsigned Features> static Vector3D deferredKernel(const Scene& scene, const Ray& ray, const PrimitiveList* candidates, int depth,
+                                                                double weight, std::uint32_t pixel, std::vector<DeferredRay>& spawned);
+
+    /**
+     * @brief Busca un kernel en la tabla con una instancia por cada conjunto de características.
+     */
+    template <unsigned... Features> static TraceKernel kernelFromTable(unsigned features, std::integer_sequence<unsigned, Features...>);
+    template <unsigned... Features> static DeferredKernel deferredKernelFromTable(unsigned features, std::integer_sequence<unsigned, Features...>);
+
     std::vector<Triangle> triangles;  ///< Lista de triángulos en la escena.
     std::vector<Plane> planes;        ///< Lista de planos en la escena.
     std::vector<LightSource> lights;  ///< Lista de fuentes de luz en la escena.
     std::vector<Sphere> spheres;      ///< Lista de esferas en la escena.
+    SphereGrid sphereGrid;            ///< Esferas pequeñas en la malla uniforme (puede estar vacía).
+    std::vector<CompressedMesh> meshes; ///< Mallas de triángulos comprimidas, cada una con su BVH.
+    std::shared_ptr<const PagedGeometry> pagedGeometry; ///< Geometría fuera de memoria (puede ser nula).
 };
 
 #endif // SCENE_H
@@ -2,8 +2,11 @@
 #ifndef SPHERE_H
 #define SPHERE_H
 
+#include <limits>
+#include <memory>
 #include "Vector3D.h"
 #include "Ray.h"
+#include "Texture.h"
 
 class Sphere {
 public:
@@ -15,17 +18,22 @@ public:
      * @param color Color de la esfera.
      * @param specular Coeficiente de reflexión especular.
      * @param reflectivity Coeficiente de reflectividad de la esfera.
+     * @param transparency Fracción de la luz que atraviesa el material (0 = opaco).
+     * @param refractiveIndex Índice de refracción del material (1.0 = aire, 1.5 = vidrio).
      */
-    Sphere(const Vector3D& center, double radius, const Vector3D& color, double specular, double reflectivity);
+    Sphere(const Vector3D& center, double radius, const Vector3D& color, double specular, double reflectivity,
+           double transparency = 0.0, double refractiveIndex = 1.0);
 
     /**
      * @brief Método para comprobar si un rayo intersecta la esfera.
      * 
      * @param ray Rayo con el que se verifica la intersección.
      * @param t Parámetro que indica la distancia a la intersección más cercana.
+     * @param tMax Distancia máxima a considerar (por defecto infinito). Permite descartar
+     *             esferas lejanas antes de resolver la ecuación cuadrática.
      * @return true si el rayo intersecta la esfera, false en caso contrario.
      */
-    bool intersects(const Ray& ray, double& t) const;
+    bool intersects(const Ray& ray, double& t, double tMax = std::numeric_limits<double>::infinity()) const;
 
     /**
      * @brief Método para obtener la normal en un punto específico de la esfera.
@@ -35,10 +43,31 @@ public:
      */
     Vector3D getNormal(const Vector3D& point) const;
 
+    /**
+     * @brief Asigna una textura a la esfera con proyección esférica (longitud, latitud).
+     *
+     * @param texture Textura (nullptr para volver al color constante).
+     */
+    void setTexture(std::shared_ptr<const Texture> texture);
+
+    /**
+     * @brief Color del material en un punto de la esfera.
+     *
+     * @param point Punto sobre la superficie de la esfera.
+     * @param footprint Ancho de la huella del rayo en el punto (para elegir el nivel mip).
+     * @return Color de la textura en el punto, o el color constante si no tiene textura.
+     */
+    Vector3D getColorAt(const Vector3D& point, double footprint) const;
+
     // Getters para las propiedades de la esfera
+    Vector3D getCenter() const;       // Obtener el centro de la esfera.
+    double getRadius() const;         // Obtener el radio de la esfera.
     Vector3D getColor() const;        // Obtener el color de la esfera.
     double getSpecular() const;       // Obtener el coeficiente especular.
     double getReflectivity() const;   // Obtener el coeficiente de reflectividad.
+    double getTransparency() const;   // Obtener la transparencia.
+    double getRefractiveIndex() const; // Obtener el índice de refracción.
+    const std::shared_ptr<const Texture>& getTexture() const; // Obtener la textura (nullptr si no tiene).
 
 private:
     Vector3D center;       // Centro de la esfera.
@@ -46,6 +75,9 @@ private:
     Vector3D color;        // Color de la esfera.
     double specular;       // Coeficiente de reflexión especular.
     double reflectivity;   // Coeficiente de reflectividad.
+    double transparency;   // Transparencia.
+    double refractiveIndex; // Índice de refracción.
+    std::shared_ptr<const Texture> texture; // Textura del material (opcional).
 };
 
 #endif // SPHERE_H
@@ -0,0 +1,160 @@
+#ifndef SPHERE_GRID_H
+#define SPHERE_GRID_H
+
+#include <cstdint>
+#include <vector>
+#include "Ray.h"
+#include "Vector3D.h"
+
+#define SPHERE_GRID_DENSITY 2.0        // Esferas por celda buscadas al elegir la resolución de la malla
+#define SPHERE_GRID_MAX_RESOLUTION 512 // Celdas máximas por eje
+#define SPHERE_GRID_MIN_EXTENT 1e-6     // Extensión de la malla por eje si todas las esferas son puntos en un mismo centro
+
+/**
+ * @brief Esfera compacta: centro y radio en float (16 bytes).
+ */
+struct PackedSphere {
+    float x, y, z;   ///< Centro.
+    float radius;    ///< Radio.
+};
+
+/**
+ * @brief Material compartido por las esferas de una SphereGrid.
+ */
+struct SphereMaterial {
+    Vector3D color;                ///< Color (escala 0-255).
+    double specular = -1;          ///< Exponente especular (-1 = sin brillo).
+    double reflectivity = 0.0;     ///< Reflectividad.
+    double transparency = 0.0;     ///< Fracción de la luz que atraviesa el material.
+    double refractiveIndex = 1.0;  ///< Índice de refracción.
+};
+
+/**
+ * @brief Conjunto de muchas esferas pequeñas (partículas, moléculas) con una malla uniforme de aceleración.
+ *
+ * Cada esfera ocupa 16 bytes más 2 del índice de su material (frente a los más de 100 de un Sphere),
+ * y se guarda en un arreglo contiguo. La malla divide la caja envolvente en celdas de tamaño uniforme;
+ * cada celda guarda los índices de las esferas cuya caja la toca, todas en un único arreglo (formato
+ * CSR). Los rayos recorren solo las celdas que atraviesan, en orden, con el algoritmo 3D-DDA de
+ * Amanatides y Woo, y se detienen en la primera celda que contiene un impacto.
+ *
+ * Las esferas muy grandes ocupan muchas celdas: conviene agregarlas a la escena como Sphere.
+ */
+class SphereGrid {
+public:
+    /**
+     * @brief Agrega un material.
+     * @param material Material.
+     * @return Índice del material (como máximo 65536 materiales).
+     */
+    std::uint16_t addMaterial(const SphereMaterial& material);
+
+    /**
+     * @brief Agrega una esfera. Hay que volver a llamar a build() antes de trazar rayos.
+     * @param center Centro.
+     * @param radius Radio.
+     * @param material Índice devuelto por addMaterial.
+     */
+    void addSphere(const Vector3D& center, double radius, std::uint16_t material);
+
+    /**
+     * @brief Reserva memoria para un número de esferas.
+     * @param count Número de esferas.
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Construye la malla (resolución elegida para tener unas SPHERE_GRID_DENSITY esferas por celda).
+     */
+    void build();
+
+    /**
+     * @brief Busca la esfera más cercana que intersecta un rayo.
+     * @param ray Rayo.
+     * @param tMax Solo se consideran impactos con t < tMax.
+     * @param t Distancia del impacto más cercano.
+     * @param index Índice de la esfera intersectada.
+     * @return true si hay impacto.
+     */
+    bool intersect(const Ray& ray, double tMax, double& t, std::uint32_t& index) const;
+
+    /**
+     * @brief Comprueba si alguna esfera bloquea un rayo de sombra (termina en el primer impacto).
+     * @param ray Rayo.
+     * @param tMax Distancia máxima de los impactos que cuentan.
+     * @return true si hay algún impacto antes de tMax.
+     */
+    bool occluded(const Ray& ray, double tMax) const;
+
+    /**
+     * @brief Devuelve la normal de una esfera en un punto de su superficie.
+     * @param index Índice de la esfera.
+     * @param point Punto de la superficie.
+     * @return Normal unitaria.
+     */
+    Vector3D getNormal(std::uint32_t index, const Vector3D& point) const;
+
+    /**
+     * @brief Devuelve el material de una esfera.
+     * @param index Índice de la esfera.
+     * @return Material.
+     */
+    const SphereMaterial& getMaterial(std::uint32_t index) const;
+
+    /**
+     * @brief Devuelve los datos de las esferas y de los materiales (para el hash de la escena).
+     */
+    const std::vector<PackedSphere>& getSpheres() const;
+    const std::vector<std::uint16_t>& getMaterialIndices() const;
+    const std::vector<SphereMaterial>& getMaterials() const;
+
+    /**
+     * @brief Indica si no hay esferas.
+     * @return true si la malla está vacía.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Devuelve el número de esferas.
+     * @return Número de esferas.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Devuelve el número de celdas de la malla.
+     * @return Celdas (0 antes de build()).
+     */
+    size_t getCellCount() const;
+
+    /**
+     * @brief Devuelve la memoria ocupada por las esferas, los índices de material y la malla.
+     * @return Bytes ocupados.
+     */
+    size_t getMemoryBytes() const;
+
+private:
+    /**
+     * @brief Recorre con 3D-DDA las celdas que atraviesa el rayo antes de tMax.
+     *
+     * visitCell(celda, tSalida) prueba las esferas de la celda y devuelve true para detener el recorrido.
+     */
+    template <typename Visitor>
+    void traverse(const Ray& ray, double tMax, Visitor&& visitCell) const;
+
+    /**
+     * @brief Intersección de un rayo con una esfera compacta (la positiva más cercana, como Sphere::intersects).
+     */
+    bool intersectSphere(const PackedSphere& sphere, const Ray& ray, double tMax, double& t) const;
+
+    std::vector<PackedSphere> spheres;           // Centro y radio de cada esfera
+    std::vector<std::uint16_t> materialIndices;  // Material de cada esfera
+    std::vector<SphereMaterial> materials;       // Materiales compartidos
+    double boundsMin[3] = { 0, 0, 0 };           // Esquina mínima de la malla
+    double boundsMax[3] = { 0, 0, 0 };           // Esquina máxima de la malla
+    int resolution[3] = { 0, 0, 0 };             // Celdas por eje
+    double cellSize[3] = { 0, 0, 0 };            // Tamaño de una celda por eje
+    std::vector<std::uint32_t> cellStart;        // Inicio de las esferas de cada celda en cellSpheres (una entrada más al final)
+    std::vector<std::uint32_t> cellSpheres;      // Índices de las esferas de todas las celdas
+};
+
+#endif // SPHERE_GRID_H
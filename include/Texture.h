@@ -0,0 +1,146 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Vector3D.h"
+
+/**
+ * @brief Coordenadas de textura (u, v). La textura se repite fuera del rango [0, 1).
+ */
+struct TexCoord {
+    double u = 0.0;  ///< Coordenada horizontal.
+    double v = 0.0;  ///< Coordenada vertical (0 es la fila superior de la imagen).
+};
+
+/**
+ * @brief Textura de imagen con niveles mip precalculados.
+ *
+ * Cada nivel se guarda en bloques de 8x8 texels (64 texels RGBA de 8 bits = 256 bytes) y, dentro de
+ * cada bloque, en orden de Morton. Así los texels vecinos que usa el filtrado bilineal caen casi
+ * siempre en la misma línea de caché, sin importar la orientación de la superficie.
+ */
+class Texture {
+public:
+    /**
+     * @brief Construye la textura y sus niveles mip a partir de píxeles RGB.
+     *
+     * @param width Ancho de la imagen.
+     * @param height Alto de la imagen.
+     * @param rgb width * height * 3 bytes, fila por fila, empezando por la fila superior.
+     */
+    Texture(int width, int height, const std::vector<unsigned char>& rgb);
+
+    /**
+     * @brief Carga una textura desde un archivo PPM (P3 o P6 con máximo 255).
+     *
+     * @param path Ruta del archivo.
+     * @return Textura cargada, o nullptr si el archivo no existe o no es un PPM válido.
+     */
+    static std::shared_ptr<Texture> loadPPM(const std::string& path);
+
+    /**
+     * @brief Muestrea la textura con filtrado bilineal en el nivel mip indicado.
+     *
+     * @param coord Coordenadas de textura.
+     * @param lod Nivel de detalle (log2 de texels por huella del rayo); se redondea al nivel más cercano.
+     * @return Color en la escala 0-255 usada por los materiales.
+     */
+    Vector3D sample(const TexCoord& coord, double lod) const;
+
+    /**
+     * @brief Calcula el nivel de detalle para una huella dada.
+     *
+     * @param footprint Ancho de la huella del rayo en unidades del mundo.
+     * @param texelsPerUnit Texels del nivel 0 por unidad del mundo sobre la superficie.
+     * @return Nivel de detalle (0 para el nivel de máxima resolución).
+     */
+    double levelOfDetail(double footprint, double texelsPerUnit) const;
+
+    int getWidth() const;                  ///< Ancho del nivel 0.
+    int getHeight() const;                 ///< Alto del nivel 0.
+    int getLevelCount() const;             ///< Número de niveles mip.
+    size_t getMemoryBytes() const;         ///< Memoria ocupada por los texels de todos los niveles.
+    std::uint64_t getContentHash() const;  ///< Hash de los píxeles originales.
+
+private:
+    /**
+     * @brief Descripción de un nivel mip dentro del arreglo de texels.
+     */
+    struct Level {
+        int width;       ///< Ancho en texels.
+        int height;      ///< Alto en texels.
+        int tilesX;      ///< Bloques de 8x8 por fila.
+        size_t offset;   ///< Posición del primer texel del nivel.
+    };
+
+    /**
+     * @brief Lee un texel con coordenadas enteras (repetidas fuera del nivel).
+     */
+    std::uint32_t fetch(const Level& level, int x, int y) const;
+
+    std::vector<Level> levels;          ///< Niveles mip, del 0 (original) al 1x1.
+    std::vector<std::uint32_t> texels;  ///< Texels RGBA de todos los niveles en bloques de Morton.
+    std::uint64_t contentHash;          ///< Hash de los píxeles originales.
+};
+
+/**
+ * @brief Caché compartida de texturas cargadas desde archivo, con límite de memoria.
+ *
+ * Una misma ruta se carga una sola vez y se comparte entre todos los objetos que la usan. Cuando la
+ * memoria residente supera el límite, se descartan las texturas usadas hace más tiempo que ningún
+ * objeto está usando; las que están en uso se conservan, ya que los objetos guardan un puntero
+ * directo a ellas para que el muestreo no pase por la caché.
+ */
+class TextureCache {
+public:
+    /**
+     * @brief Devuelve la caché compartida por todo el programa.
+     */
+    static TextureCache& shared();
+
+    /**
+     * @brief Obtiene una textura, cargándola desde disco si no está en la caché.
+     *
+     * @param path Ruta del archivo PPM.
+     * @return Textura, o nullptr si no se pudo cargar.
+     */
+    std::shared_ptr<const Texture> acquire(const std::string& path);
+
+    /**
+     * @brief Cambia el límite de memoria de la caché y descarta texturas si hace falta.
+     * @param bytes Límite en bytes.
+     */
+    void setCapacity(size_t bytes);
+
+    size_t getCapacity() const;       ///< Límite de memoria en bytes.
+    size_t getResidentBytes() const;  ///< Memoria ocupada por las texturas en la caché.
+
+private:
+    /**
+     * @brief Entrada de la caché.
+     */
+    struct Entry {
+        std::string path;
+        std::shared_ptr<const Texture> texture;
+    };
+
+    /**
+     * @brief Descarta las texturas sin uso menos recientes hasta respetar el límite (requiere el mutex).
+     */
+    void evict();
+
+    std::list<Entry> entries;   ///< Entradas de la más a la menos recientemente usada.
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;  ///< Entradas por ruta.
+    size_t capacity = 256u * 1024u * 1024u;  ///< Límite de memoria (256 MB por defecto).
+    size_t residentBytes = 0;                ///< Memoria ocupada por las entradas.
+    mutable std::mutex mutex;                ///< Protege la caché para cargas desde varios hilos.
+};
+
+#endif // TEXTURE_H
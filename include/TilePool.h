@@ -0,0 +1,132 @@
+#ifndef TILE_POOL_H
+#define TILE_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Conjunto fijo de hilos que reparte tareas indexadas (normalmente tiles de la imagen).
+ *
+ * Los hilos se crean una sola vez y esperan trabajo. run() publica un lote de tareas que los hilos
+ * (incluido el que llama) toman de un contador atómico, de modo que los tiles costosos no dejan a
+ * otros hilos sin trabajo. run() no debe llamarse desde dentro de una tarea del mismo pool.
+ *
+ * Con pinToNodes, los hilos se reparten en bloques consecutivos entre los nodos NUMA (ver
+ * readNumaTopology) y cada uno se fija a las CPUs de su nodo, de modo que la memoria que toca primero
+ * un hilo queda en su nodo y getThreadNode() indica qué copia local de los datos debe usar.
+ */
+class TilePool {
+public:
+    /**
+     * @brief Crea el pool.
+     * @param threadCount Número total de hilos, incluido el que llama a run() (0 = uno por núcleo).
+     * @param pinToNodes Fija cada hilo (también el que crea el pool) a las CPUs de un nodo NUMA.
+     */
+    explicit TilePool(int threadCount = 0, bool pinToNodes = false);
+
+    /**
+     * @brief Detiene y espera a los hilos.
+     */
+    ~TilePool();
+
+    TilePool(const TilePool&) = delete;
+    TilePool& operator=(const TilePool&) = delete;
+
+    /**
+     * @brief Ejecuta task(i, hilo) para cada i en [0, taskCount) y espera a que terminen todas.
+     *
+     * @param taskCount Número de tareas.
+     * @param task Función que recibe el índice de la tarea y el del hilo (en [0, getThreadCount())).
+     */
+    void run(int taskCount, const std::function<void(int, int)>& task);
+
+    /**
+     * @brief Ejecuta task(hilo) exactamente una vez en cada hilo del pool y espera a que terminen.
+     *
+     * Sirve para trabajo que depende del hilo que lo ejecuta, como tocar por primera vez la memoria de
+     * su nodo o repartir las tareas por nodo (ver generateImageNuma).
+     *
+     * @param task Función que recibe el índice del hilo.
+     */
+    void runPerThread(const std::function<void(int)>& task);
+
+    /**
+     * @brief Devuelve el número total de hilos, incluido el que llama a run().
+     * @return Número de hilos.
+     */
+    int getThreadCount() const;
+
+    /**
+     * @brief Devuelve el número de nodos NUMA entre los que se reparten los hilos.
+     * @return Nodos con al menos un hilo (1 si los hilos no están fijados).
+     */
+    int getNodeCount() const;
+
+    /**
+     * @brief Devuelve el nodo de un hilo.
+     * @param threadIndex Índice del hilo (en [0, getThreadCount())).
+     * @return Nodo en [0, getNodeCount()), en orden de readNumaTopology.
+     */
+    int getThreadNode(int threadIndex) const;
+
+    /**
+     * @brief Pool compartido por los renderizadores, creado en el primer uso.
+     * @return Referencia al pool compartido.
+     */
+    static TilePool& shared();
+
+    /**
+     * @brief Fija el número de hilos del pool compartido. Solo tiene efecto antes del primer uso de shared().
+     * @param threadCount Número de hilos (0 = uno por núcleo).
+     */
+    static void setSharedThreadCount(int threadCount);
+
+    /**
+     * @brief Fija los hilos del pool compartido a los nodos NUMA. Solo tiene efecto antes del primer uso de shared().
+     * @param pinToNodes true para fijar los hilos.
+     */
+    static void setSharedPinning(bool pinToNodes);
+
+private:
+    /**
+     * @brief Bucle de cada hilo auxiliar: espera un lote, procesa tareas y avisa al terminar.
+     * @param threadIndex Índice del hilo (1 en adelante; el 0 es el que llama a run()).
+     */
+    void workerLoop(int threadIndex);
+
+    /**
+     * @brief Publica un lote para los hilos auxiliares, procesa tareas en el hilo que llama y espera al resto.
+     * @param taskCount Número de tareas (con perThread, el de hilos).
+     * @param task Función del lote.
+     * @param perThread true si cada hilo ejecuta una sola tarea, la de su índice.
+     */
+    void dispatch(int taskCount, const std::function<void(int, int)>& task, bool perThread);
+
+    /**
+     * @brief Toma y ejecuta tareas del lote actual hasta que no queden.
+     * @param threadIndex Índice del hilo que las ejecuta.
+     */
+    void drainTasks(int threadIndex);
+
+    std::vector<std::thread> workers;             // Hilos auxiliares
+    std::vector<int> threadNodes;                 // Nodo NUMA de cada hilo (el 0 es el que llama a run())
+    std::vector<std::vector<int>> nodeCpus;       // CPUs de cada nodo (vacío si los hilos no están fijados)
+    std::mutex mutex;                             // Protege el estado del lote
+    std::mutex runMutex;                          // Serializa las llamadas a run()
+    std::condition_variable wake;                 // Avisa a los hilos de un lote nuevo
+    std::condition_variable done;                 // Avisa a run() de que los hilos terminaron
+    const std::function<void(int, int)>* job = nullptr; // Tarea del lote actual
+    int jobTaskCount = 0;                         // Número de tareas del lote actual
+    bool jobPerThread = false;                    // Cada hilo ejecuta solo la tarea de su índice
+    std::atomic<int> nextTask{0};                 // Siguiente tarea a tomar
+    int activeWorkers = 0;                        // Hilos auxiliares que no terminaron el lote
+    uint64_t generation = 0;                      // Número de lote, para detectar lotes nuevos
+    bool stopping = false;                        // Indica a los hilos que deben terminar
+};
+
+#endif // TILE_POOL_H
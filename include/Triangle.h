@@ -2,8 +2,11 @@
 #ifndef TRIANGLE_H
 #define TRIANGLE_H
 
+#include <limits>
+#include <memory>
 #include "Vector3D.h"
 #include "Ray.h"
+#include "Texture.h"
 
 class Triangle {
 public:
@@ -16,8 +19,11 @@ public:
      * @param color Color del triángulo.
      * @param specular Valor de la reflexión especular.
      * @param reflectivity Coeficiente de reflectividad del material.
+     * @param transparency Fracción de la luz que atraviesa el material (0 = opaco).
+     * @param refractiveIndex Índice de refracción del material (1.0 = aire, 1.5 = vidrio).
      */
-    Triangle(const Vector3D& a, const Vector3D& b, const Vector3D& c, const Vector3D& color, double specular, double reflectivity);
+    Triangle(const Vector3D& a, const Vector3D& b, const Vector3D& c, const Vector3D& color, double specular, double reflectivity,
+             double transparency = 0.0, double refractiveIndex = 1.0);
 
     /**
      * @brief Método para comprobar si un rayo intersecta el triángulo.
@@ -27,21 +33,53 @@ public:
      * @param ray Rayo con el que se verifica la intersección.
      * @param t Parámetro que indica la distancia a la intersección más cercana.
      * @param intersectionPoint Punto de intersección calculado si existe.
+     * @param tMax Distancia máxima a considerar (por defecto infinito).
      * @return true si el rayo intersecta el triángulo, false en caso contrario.
      */
-    bool intersects(const Ray& ray, double& t, Vector3D& intersectionPoint) const;
+    bool intersects(const Ray& ray, double& t, Vector3D& intersectionPoint, double tMax = std::numeric_limits<double>::infinity()) const;
+
+    /**
+     * @brief Asigna una textura al triángulo con coordenadas de textura por vértice.
+     *
+     * @param texture Textura (nullptr para volver al color constante).
+     * @param uvA Coordenadas de textura del primer vértice.
+     * @param uvB Coordenadas de textura del segundo vértice.
+     * @param uvC Coordenadas de textura del tercer vértice.
+     */
+    void setTexture(std::shared_ptr<const Texture> texture, const TexCoord& uvA, const TexCoord& uvB, const TexCoord& uvC);
+
+    /**
+     * @brief Color del material en un punto del triángulo.
+     *
+     * @param point Punto sobre el triángulo.
+     * @param footprint Ancho de la huella del rayo en el punto (para elegir el nivel mip).
+     * @return Color de la textura en el punto, o el color constante si no tiene textura.
+     */
+    Vector3D getColorAt(const Vector3D& point, double footprint) const;
 
     // Métodos para obtener propiedades del triángulo
+    Vector3D getVertexA() const;      // Obtener el primer vértice.
+    Vector3D getVertexB() const;      // Obtener el segundo vértice.
+    Vector3D getVertexC() const;      // Obtener el tercer vértice.
     Vector3D getNormal() const;       // Obtener el vector normal del triángulo.
     double getSpecular() const;       // Obtener el valor especular del material.
     Vector3D getColor() const;        // Obtener el color del triángulo.
     double getReflectivity() const;   // Obtener la reflectividad del material.
+    double getTransparency() const;   // Obtener la transparencia del material.
+    double getRefractiveIndex() const; // Obtener el índice de refracción del material.
+    const std::shared_ptr<const Texture>& getTexture() const; // Obtener la textura (nullptr si no tiene).
+    TexCoord getTexCoord(int vertex) const; // Obtener las coordenadas de textura de un vértice (0, 1 o 2).
 
 private:
     Vector3D a, b, c;                 // Vértices del triángulo.
     double specular;                  // Valor especular del material.
     Vector3D color;                   // Color del triángulo.
     double reflectivity;              // Reflectividad del material.
+    double transparency;              // Transparencia del material.
+    double refractiveIndex;           // Índice de refracción del material.
+    std::shared_ptr<const Texture> texture; // Textura del material (opcional).
+    TexCoord uv[3];                   // Coordenadas de textura de los vértices.
+    double texelsPerUnit = 0.0;       // Texels del nivel 0 por unidad del mundo sobre el triángulo.
 };
 
 #endif // TRIANGLE_H
@@ -0,0 +1,207 @@
+#ifndef WAVEFRONT_PIPELINE_H
+#define WAVEFRONT_PIPELINE_H
+
+#include <cstdint>
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+#include "Framebuffer.h"
+#include "PreviewStream.h"
+#include "wavefront.h"
+
+/**
+ * @brief Etapas del render por etapas, en el orden en que se ejecutan en cada frente de rayos.
+ */
+enum PipelineStage {
+    STAGE_GENERATE,     ///< Rayos primarios de la cámara y primitivas candidatas de cada tile.
+    STAGE_SORT,         ///< Ordenación de los rayos secundarios y copia al búfer de rayos.
+    STAGE_INTERSECT,    ///< Intersección más cercana de cada rayo.
+    STAGE_SHADOW_RAYS,  ///< Material de cada impacto y sus rayos de sombra (también los de las penumbras).
+    STAGE_OCCLUSION,    ///< Pruebas de oclusión de los rayos de sombra.
+    STAGE_SHADE,        ///< Iluminación directa, color local y rayos secundarios.
+    STAGE_ACCUMULATE,   ///< Suma de los colores en los píxeles, presupuesto de rayos y escritura del framebuffer.
+    STAGE_COUNT         ///< Número de etapas.
+};
+
+/**
+ * @brief Tiempo y elementos procesados por cada etapa de un render por etapas.
+ */
+struct PipelineStats {
+    double seconds[STAGE_COUNT] = {};    ///< Tiempo de cada etapa.
+    long long items[STAGE_COUNT] = {};   ///< Rayos (o rayos de sombra) que procesó cada etapa.
+    long long primaryRays = 0;           ///< Rayos primarios.
+    long long secondaryRays = 0;         ///< Rayos reflejados y refractados.
+    long long shadowRays = 0;            ///< Rayos de sombra trazados.
+    int waves = 0;                       ///< Mayor número de frentes de un lote (incluido el de los rayos primarios).
+};
+
+/**
+ * Devuelve el nombre de una etapa para los informes ("generate", "intersect", ...).
+ *
+ * @param stage: Etapa.
+ * @return const char*: Nombre.
+ */
+const char* pipelineStageName(PipelineStage stage);
+
+/**
+ * @brief Render del trazador de Whitted por etapas (wavefront) en vez de un kernel por píxel.
+ *
+ * generateImageRows calcula cada píxel de principio a fin dentro de un mismo kernel (generar, intersectar,
+ * sombrear, trazar las sombras y recursión). Aquí cada paso es una etapa que procesa en paralelo todos
+ * los rayos de un frente, guardados por componentes (structure of arrays) en búferes que se reutilizan
+ * entre frentes: generación, intersección, rayos de sombra, oclusión y sombreado. Cada etapa recorre un
+ * solo tipo de trabajo con el mismo código para todos los rayos, y su tiempo se mide por separado.
+ *
+ * Las luces de área conservan el muestreo adaptativo: se trazan las AREA_LIGHT_MIN_SAMPLES primeras
+ * muestras de todos los impactos y, en una segunda pasada de las etapas de sombra, las restantes solo de
+ * los puntos en la penumbra. El resultado es idéntico al de generateImageWavefront con el mismo orden.
+ */
+class WavefrontPipeline {
+public:
+    /**
+     * @brief Prepara el render de una escena desde una cámara.
+     * @param scene Escena (debe seguir viva mientras se use el pipeline).
+     * @param cam Cámara.
+     * @param width Ancho de la imagen completa en píxeles.
+     * @param height Alto de la imagen completa en píxeles.
+     * @param maxDepth Profundidad máxima de las reflexiones.
+     * @param viewportWidth Ancho del viewport en unidades del mundo.
+     * @param viewportHeight Alto del viewport en unidades del mundo.
+     * @param distanceToViewport Distancia entre la cámara y el viewport.
+     */
+    WavefrontPipeline(const Scene& scene, const Camera& cam, int width, int height, int maxDepth,
+                      double viewportWidth, double viewportHeight, double distanceToViewport);
+
+    /**
+     * @brief Genera un rango de filas de la imagen (ver generateImageWavefront para los lotes y el orden).
+     * @param framebuffer Framebuffer de width x (rowEnd - rowBegin) píxeles; la fila rowBegin se guarda al inicio.
+     * @param rowBegin Primera fila a renderizar.
+     * @param rowEnd Fila siguiente a la última a renderizar.
+     * @param sortRays true para ordenar los rayos secundarios con sortRaysByCoherence.
+     * @param batchPixels Píxeles aproximados de cada lote.
+     * @param preview Vista previa que recibe los tiles de cada lote terminado (nullptr = sin vista previa).
+     */
+    void render(Framebuffer& framebuffer, int rowBegin, int rowEnd, bool sortRays, int batchPixels = WAVEFRONT_BATCH_PIXELS,
+                PreviewStream* preview = nullptr);
+
+    /**
+     * @brief Devuelve las estadísticas acumuladas de los renders.
+     * @return Tiempo y elementos de cada etapa.
+     */
+    const PipelineStats& getStats() const;
+
+private:
+    /**
+     * @brief Rayos de un frente, por componentes.
+     */
+    struct RayBuffer {
+        std::vector<double> originX, originY, originZ;
+        std::vector<double> directionX, directionY, directionZ;
+        std::vector<double> coneWidth, spreadAngle;
+        std::vector<double> weight;          // Peso en el color final del píxel
+        std::vector<std::uint32_t> pixel;    // Píxel dentro del lote
+        std::vector<std::uint32_t> source;   // Posición del rayo en el orden en que se generó
+        std::vector<std::int32_t> tile;      // Tile del lote cuyas primitivas candidatas prueba (-1 = toda la escena)
+
+        void resize(size_t count);
+        void set(size_t i, const Ray& ray, double rayWeight, std::uint32_t rayPixel, std::uint32_t raySource, std::int32_t rayTile);
+        Ray get(size_t i) const;
+    };
+
+    /**
+     * @brief Rayos de sombra, por componentes. Salen del punto de impacto hit hacia una muestra de luz.
+     */
+    struct ShadowBuffer {
+        std::vector<double> directionX, directionY, directionZ;
+        std::vector<double> distance;         // Distancia hasta la luz (infinita en las direccionales)
+        std::vector<std::uint32_t> hit;       // Rayo del frente cuyo impacto se ilumina (NO_HIT = no se traza)
+        std::vector<unsigned char> occluded;  // Resultado de la etapa de oclusión
+
+        void resize(size_t count);
+        LightSample get(size_t i) const;
+    };
+
+    /**
+     * @brief Rayos secundarios que generó un rayo del frente, dentro de la lista de la tarea que lo sombreó.
+     */
+    struct SpawnedRange {
+        std::uint32_t task;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    /**
+     * @brief Ejecuta una etapa sobre count elementos repartidos en tareas de WAVEFRONT_TASK_RAYS y mide su tiempo.
+     */
+    template <typename StageTask>
+    void runStage(PipelineStage stage, size_t count, StageTask&& task);
+
+    /**
+     * @brief Genera los rayos primarios de un lote de filas de tiles y las primitivas candidatas de cada tile.
+     */
+    void generatePrimaryRays(int bandY, int y0, int y1);
+
+    /**
+     * @brief Ordena (o no) un frente de rayos secundarios y lo copia al búfer de rayos.
+     */
+    void loadWave(const std::vector<DeferredRay>& wave, bool sortRays);
+
+    /**
+     * @brief Busca la intersección más cercana de todos los rayos del frente.
+     */
+    void intersect();
+
+    /**
+     * @brief Evalúa los materiales y genera un rayo de sombra por luz puntual o direccional y las primeras muestras de las luces de área.
+     */
+    void generateShadowRays();
+
+    /**
+     * @brief Genera las muestras restantes de las luces de área en los impactos que quedaron en la penumbra.
+     */
+    void generatePenumbraRays();
+
+    /**
+     * @brief Traza los rayos de sombra de un búfer.
+     */
+    void traceShadowRays(ShadowBuffer& shadows);
+
+    /**
+     * @brief Calcula la iluminación directa y el color local de cada impacto y encola sus rayos secundarios.
+     */
+    void shade(int depth);
+
+    /**
+     * @brief Suma los colores del frente a sus píxeles y forma el frente siguiente en el orden en que se generaron los rayos.
+     */
+    void accumulate(bool primary, std::vector<DeferredRay>& next);
+
+    const Scene& scene;                  // Escena
+    const Camera& cam;                   // Cámara
+    int width, height, maxDepth;         // Resolución y profundidad
+    double viewportWidth, viewportHeight, distanceToViewport;
+    std::vector<int> lightSlots;         // Primer rayo de sombra de cada luz entre los de un impacto (-1 = luz ambiental)
+    int shadowRaysPerHit = 0;            // Rayos de sombra de la primera pasada por impacto
+    int areaLightCount = 0;              // Luces de área de la escena
+
+    // Estado del lote en curso
+    std::vector<PrimitiveList> candidates;   // Primitivas candidatas de cada tile del lote
+    std::vector<Vector3D> colors;            // Color acumulado de cada píxel del lote
+    std::vector<int> raysLeft;               // Rayos secundarios que le quedan a cada píxel del lote
+
+    // Búferes del frente en curso (indexados por la posición en el búfer de rayos, salvo los indicados)
+    RayBuffer rays;
+    std::vector<HitRecord> hits;
+    std::vector<unsigned char> found;
+    std::vector<SurfaceMaterial> materials;
+    ShadowBuffer shadows;                    // Primera pasada: shadowRaysPerHit rayos por impacto
+    ShadowBuffer penumbraShadows;            // Segunda pasada: muestras restantes de las penumbras
+    std::vector<std::uint32_t> penumbraFirst; // Primer rayo de cada impacto en penumbraShadows
+    std::vector<Vector3D> rayColors;          // Color que aporta cada rayo (por orden de generación)
+    std::vector<SpawnedRange> ranges;         // Rayos secundarios de cada rayo (por orden de generación)
+    std::vector<std::vector<DeferredRay>> taskSpawned; // Rayos secundarios generados por cada tarea
+
+    PipelineStats stats;                 // Estadísticas acumuladas
+};
+
+#endif // WAVEFRONT_PIPELINE_H
@@ -1,16 +1,37 @@
 #ifndef CREATEPPM_H
 #define CREATEPPM_H
 
-#include <vector>
-#include "Vector3D.h" // Incluir la clase Vector3D para representar los colores RGB
+#include <istream>
+#include <string>
+#include "Framebuffer.h" // Incluir el framebuffer con los colores de los píxeles
 
 /**
- * Genera un archivo PPM a partir de un framebuffer.
+ * Genera un archivo PPM binario (P6) a partir de un framebuffer.
  *
- * @param framebuffer: Un vector de objetos Vector3D que representan los colores de los píxeles.
- * @param width: Ancho de la imagen en píxeles.
- * @param height: Alto de la imagen en píxeles.
+ * Si el framebuffer está en PixelFormat::SRGB8, sus bytes se escriben directamente; en los demás
+ * formatos cada fila se codifica a 8 bits antes de escribirla.
+ *
+ * @param framebuffer: Framebuffer con la imagen completa (alto = framebuffer.getRows()).
+ * @param path: Ruta del archivo de salida (RenderConfig::outputPath).
+ */
+void createPPM(const Framebuffer& framebuffer, const std::string& path);
+
+/**
+ * Lee una imagen PPM binaria (P6) de 8 bits.
+ *
+ * @param path: Ruta del archivo.
+ * @param framebuffer: Framebuffer SRGB8 con la imagen leída.
+ * @return bool: true si el archivo es un P6 válido y completo.
+ */
+bool readPPM(const std::string& path, Framebuffer& framebuffer);
+
+/**
+ * Lee el siguiente entero de la cabecera de un PPM, ignorando espacios y comentarios.
+ *
+ * @param in: Flujo posicionado dentro de la cabecera.
+ * @param value: Valor leído.
+ * @return bool: true si se pudo leer un entero.
  */
-void createPPM(const std::vector<Vector3D>& framebuffer, int width, int height);
+bool readPPMHeaderValue(std::istream& in, int& value);
 
 #endif // CREATEPPM_H
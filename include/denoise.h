@@ -0,0 +1,70 @@
+#ifndef DENOISE_H
+#define DENOISE_H
+
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+#include "Vector3D.h"
+#include "Framebuffer.h"
+
+#define DENOISE_ITERATIONS 5        // Pasadas del filtro à-trous (separación de 1, 2, 4, 8 y 16 píxeles)
+#define DENOISE_SIGMA_COLOR 1.0f    // Tolerancia de color de la primera pasada (se reduce a la mitad en cada una)
+#define DENOISE_SIGMA_NORMAL 0.3f   // Tolerancia de la diferencia entre normales
+#define DENOISE_SIGMA_DEPTH 0.03f   // Tolerancia de la diferencia relativa de profundidad por píxel de separación
+#define DENOISE_NO_HIT_DEPTH 1.0e6f // Profundidad de los píxeles sin intersección
+
+/**
+ * @brief Búferes auxiliares del primer impacto de cada píxel, usados para guiar el filtro.
+ *
+ * Cada canal se guarda en un arreglo separado de floats (estructura de arreglos) para que los bucles
+ * del filtro recorran memoria contigua.
+ */
+struct GuideBuffers {
+    int width = 0;                  ///< Ancho de la imagen.
+    int rows = 0;                   ///< Filas guardadas.
+    std::vector<float> normalX;     ///< Componente x de la normal (0 si no hay impacto).
+    std::vector<float> normalY;     ///< Componente y de la normal.
+    std::vector<float> normalZ;     ///< Componente z de la normal.
+    std::vector<float> depth;       ///< Distancia desde la cámara (DENOISE_NO_HIT_DEPTH si no hay impacto).
+    std::vector<float> albedoR;     ///< Color del material en [0, 1] (1 si no hay impacto).
+    std::vector<float> albedoG;     ///< Componente verde del albedo.
+    std::vector<float> albedoB;     ///< Componente azul del albedo.
+};
+
+/**
+ * @brief Calcula los búferes de normal, profundidad y albedo con un rayo por el centro de cada píxel.
+ *
+ * En superficies reflectivas o transparentes el albedo se mezcla con blanco según su peso, porque el
+ * color del píxel viene sobre todo de los rayos secundarios.
+ *
+ * @param scene Escena.
+ * @param cam Cámara.
+ * @param width Ancho de la imagen completa.
+ * @param height Alto de la imagen completa.
+ * @param rowBegin Primera fila.
+ * @param rowEnd Fila siguiente a la última.
+ * @param viewportWidth Ancho del viewport en unidades del mundo.
+ * @param viewportHeight Alto del viewport en unidades del mundo.
+ * @param distanceToViewport Distancia entre la cámara y el viewport.
+ * @return Búferes de (rowEnd - rowBegin) * width píxeles.
+ */
+GuideBuffers computeGuideBuffers(const Scene& scene, const Camera& cam, int width, int height, int rowBegin, int rowEnd,
+                                 double viewportWidth, double viewportHeight, double distanceToViewport);
+
+/**
+ * @brief Elimina el ruido de un render con pocas muestras con un filtro à-trous que respeta los bordes.
+ *
+ * El color se divide por el albedo para filtrar solo la iluminación (así las texturas no se emborronan),
+ * se recortan los píxeles aislados mucho más brillantes que sus vecinos y se aplican DENOISE_ITERATIONS
+ * pasadas de un núcleo B-spline de 5x5 con separación creciente. El peso de cada vecino disminuye con
+ * la diferencia de color, normal y profundidad respecto al píxel central.
+ * Las filas se reparten entre los hilos de TilePool::shared().
+ *
+ * @param framebuffer Imagen a filtrar (conviene RGBA_F32 o RGB_F16 para no perder precisión); se sobrescribe con el resultado.
+ * @param guides Búferes auxiliares de la misma imagen.
+ * @param iterations Número de pasadas.
+ * @return Tiempo de filtrado en segundos.
+ */
+double denoiseImage(Framebuffer& framebuffer, const GuideBuffers& guides, int iterations = DENOISE_ITERATIONS);
+
+#endif // DENOISE_H
@@ -0,0 +1,27 @@
+#ifndef DISTRIBUTED_RENDER_H
+#define DISTRIBUTED_RENDER_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Renderiza una imagen repartiendo rangos de filas entre procesos trabajadores locales.
+ *
+ * La imagen se divide en trabajos de rowsPerJob filas que se asignan dinámicamente a workerCount
+ * procesos: cada proceso ejecuta workerArgs seguido de "--rows inicio:fin --partial archivo" y escribe
+ * una imagen parcial. Cuando ya no quedan trabajos pendientes, los procesos libres relanzan los trabajos
+ * que llevan más tiempo en ejecución (más que el promedio de los ya terminados); el primer intento en
+ * terminar gana y los demás se cancelan. Como el render es determinista, cualquier intento produce
+ * los mismos píxeles.
+ *
+ * @param workerArgs: Ejecutable y argumentos comunes de los trabajadores.
+ * @param workerCount: Número máximo de procesos simultáneos.
+ * @param height: Alto de la imagen en píxeles.
+ * @param rowsPerJob: Filas por trabajo (idealmente un múltiplo de getTileSize()).
+ * @param partsDirectory: Directorio donde se escriben las imágenes parciales.
+ * @param partPaths: Rutas de las imágenes parciales resultantes, una por trabajo.
+ * @return bool: true si todos los trabajos terminaron correctamente.
+ */
+bool renderDistributed(const std::vector<std::string>& workerArgs, int workerCount, int height, int rowsPerJob, const std::string& partsDirectory, std::vector<std::string>& partPaths);
+
+#endif // DISTRIBUTED_RENDER_H
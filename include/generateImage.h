@@ -5,13 +5,66 @@
 #include "Scene.h"
 #include "Camera.h"
 #include "Vector3D.h"
+#include "Framebuffer.h"
+#include "PreviewStream.h"
+
+#define DEFAULT_TILE_SIZE 32  // Tamaño por defecto (en píxeles) de los tiles en los que se divide la imagen
+
+/**
+ * Fija el tamaño de los tiles de todos los renderizadores. Debe llamarse antes de renderizar.
+ *
+ * @param tileSize: Lado de los tiles en píxeles (positivo).
+ */
+void setTileSize(int tileSize);
+
+/**
+ * Devuelve el tamaño de los tiles.
+ *
+ * @return int: Lado de los tiles en píxeles (DEFAULT_TILE_SIZE si no se fijó otro).
+ */
+int getTileSize();
+
+/**
+ * Activa o desactiva el descarte por frustum de cullPrimitivesForTile. Debe llamarse antes de renderizar.
+ *
+ * @param enabled: false para que cada tile reciba todas las primitivas de la escena.
+ */
+void setFrustumCulling(bool enabled);
+
+/**
+ * Calcula las primitivas que los rayos primarios de un tile pueden intersectar.
+ *
+ * Construye el frustum del tile a partir de los rayos de sus esquinas (ampliado un píxel por lado)
+ * y conserva los triángulos y esferas cuyo volumen no queda completamente fuera de él. Si el descarte
+ * está desactivado (setFrustumCulling), devuelve todas las primitivas.
+ *
+ * @param scene: Escena que contiene los objetos.
+ * @param cam: Cámara que genera los rayos primarios.
+ * @param x0: Primera columna del tile.
+ * @param y0: Primera fila del tile.
+ * @param x1: Columna siguiente a la última del tile.
+ * @param y1: Fila siguiente a la última del tile.
+ * @param width: Ancho de la imagen en píxeles.
+ * @param height: Alto de la imagen en píxeles.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia entre la cámara y el viewport.
+ * @return PrimitiveList: Triángulos y esferas candidatos para el tile.
+ */
+PrimitiveList cullPrimitivesForTile(const Scene& scene, const Camera& cam, int x0, int y0, int x1, int y1, int width, int height, double viewportWidth, double viewportHeight, double distanceToViewport);
 
 /**
  * Genera una imagen a partir de una escena y una cámara dadas.
  *
+ * La imagen se recorre por tiles de getTileSize() x getTileSize() píxeles; los rayos primarios de cada tile
+ * solo se prueban contra las primitivas que intersectan su frustum. Los tiles se reparten entre los
+ * hilos de TilePool::shared(); cada píxel se calcula de forma independiente, así que el resultado no
+ * depende del número de hilos. Cada hilo convierte sus píxeles al formato del framebuffer en cuanto
+ * los calcula.
+ *
  * @param scene: Escena que contiene los objetos y las luces.
  * @param cam: Cámara que genera los rayos para renderizar la imagen.
- * @param framebuffer: Vector que almacena los colores de cada píxel de la imagen.
+ * @param framebuffer: Framebuffer de width x height píxeles donde se guarda la imagen.
  * @param width: Ancho de la imagen en píxeles.
  * @param height: Alto de la imagen en píxeles.
  * @param maxDepth: Profundidad máxima de las reflexiones de los rayos.
@@ -19,6 +72,51 @@
  * @param viewportHeight: Alto del viewport en unidades del mundo.
  * @param distanceToViewport: Distancia entre la cámara y el viewport.
  */
-void generateImage(const Scene& scene, const Camera& cam, std::vector<Vector3D>& framebuffer, int width, int height, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport);
+void generateImage(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, int width, int height, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport);
+
+/**
+ * Genera solo un rango de filas de la imagen (usado por los procesos trabajadores del render distribuido).
+ *
+ * Los tiles siguen alineados a la cuadrícula global de getTileSize(), de modo que el resultado de cada píxel
+ * es idéntico al de un render completo.
+ *
+ * El kernel de trazado se elige una sola vez según las características de la escena (Scene::getFeatures),
+ * de modo que las ramas de las luces y materiales que la escena no usa no se evalúan en cada rayo.
+ *
+ * @param scene: Escena que contiene los objetos y las luces.
+ * @param cam: Cámara que genera los rayos para renderizar la imagen.
+ * @param framebuffer: Framebuffer de width x (rowEnd - rowBegin) píxeles; la fila rowBegin se guarda al inicio.
+ * @param width: Ancho de la imagen completa en píxeles.
+ * @param height: Alto de la imagen completa en píxeles.
+ * @param rowBegin: Primera fila a renderizar.
+ * @param rowEnd: Fila siguiente a la última a renderizar.
+ * @param maxDepth: Profundidad máxima de las reflexiones de los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia entre la cámara y el viewport.
+ * @param specializeKernel: false para usar siempre el kernel genérico (para comparar en los benchmarks).
+ * @param preview: Vista previa a la que se envía cada tile en cuanto termina (nullptr = sin vista previa).
+ */
+void generateImageRows(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, int width, int height, int rowBegin, int rowEnd, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport, bool specializeKernel = true, PreviewStream* preview = nullptr);
+
+/**
+ * Renderiza un tile de la cuadrícula global de getTileSize() (el trabajo de cada tarea de generateImageRows).
+ *
+ * @param scene: Escena que contiene los objetos y las luces.
+ * @param cam: Cámara que genera los rayos para renderizar la imagen.
+ * @param framebuffer: Framebuffer de width x (rowEnd - rowBegin) píxeles; la fila rowBegin se guarda al inicio.
+ * @param traceKernel: Kernel de trazado (ver Scene::selectKernel).
+ * @param tileX: Primera columna del tile.
+ * @param tileY: Primera fila del tile, alineada a la cuadrícula (puede ser anterior a rowBegin).
+ * @param width: Ancho de la imagen completa en píxeles.
+ * @param height: Alto de la imagen completa en píxeles.
+ * @param rowBegin: Primera fila guardada en el framebuffer.
+ * @param rowEnd: Fila siguiente a la última a renderizar.
+ * @param maxDepth: Profundidad máxima de las reflexiones de los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia entre la cámara y el viewport.
+ */
+void renderTile(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, Scene::TraceKernel traceKernel, int tileX, int tileY, int width, int height, int rowBegin, int rowEnd, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport);
 
 #endif // GENERATE_IMAGE_H
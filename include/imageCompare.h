@@ -0,0 +1,57 @@
+#ifndef IMAGE_COMPARE_H
+#define IMAGE_COMPARE_H
+
+#include <string>
+#include "Framebuffer.h"
+
+#define GOLDEN_TOLERANCE 2              // Diferencia máxima por canal (0-255, en sRGB) que no cuenta como cambio
+#define GOLDEN_MAX_CHANGED_FRACTION 0.001 // Fracción de píxeles que pueden superar la tolerancia (bordes de sombras, etc.)
+#define GOLDEN_MIN_PSNR 40.0            // PSNR mínimo (dB) frente a la imagen de referencia
+
+/**
+ * @brief Diferencias entre una imagen y su imagen de referencia.
+ *
+ * Las diferencias se miden sobre los valores de 8 bits con corrección gamma: la codificación sRGB es
+ * aproximadamente uniforme para la percepción, así que una misma diferencia se ve parecida en zonas
+ * claras y oscuras (al contrario que en color lineal).
+ */
+struct ImageDifference {
+    bool sameSize = false;        ///< Las dos imágenes tienen la misma resolución.
+    int maxDifference = 0;        ///< Mayor diferencia de un canal.
+    long long changedPixels = 0;  ///< Píxeles con algún canal por encima de la tolerancia.
+    double changedFraction = 0.0; ///< changedPixels sobre el total de píxeles.
+    double psnr = 0.0;            ///< Relación señal/ruido de pico en dB (infinita si son idénticas).
+};
+
+/**
+ * @brief Umbrales de una comprobación contra una imagen de referencia.
+ */
+struct GoldenThresholds {
+    int tolerance = GOLDEN_TOLERANCE;                           ///< Diferencia por canal tolerada.
+    double maxChangedFraction = GOLDEN_MAX_CHANGED_FRACTION;    ///< Fracción de píxeles que pueden superar la tolerancia.
+    double minPsnr = GOLDEN_MIN_PSNR;                           ///< PSNR mínimo.
+    double timeBudget = 0.0;                                    ///< Tiempo máximo de render en segundos (0 = sin límite).
+};
+
+/**
+ * Compara una imagen con su imagen de referencia.
+ *
+ * @param image: Imagen a comprobar (cualquier formato; se compara codificada en sRGB de 8 bits).
+ * @param reference: Imagen de referencia.
+ * @param tolerance: Diferencia por canal que no cuenta como cambio.
+ * @return ImageDifference: Diferencias encontradas.
+ */
+ImageDifference compareImages(const Framebuffer& image, const Framebuffer& reference, int tolerance);
+
+/**
+ * Compara un render con una imagen de referencia guardada e informa el resultado.
+ *
+ * @param image: Imagen renderizada.
+ * @param referencePath: Ruta del PPM de referencia.
+ * @param renderSeconds: Tiempo de render medido.
+ * @param thresholds: Umbrales de la comprobación.
+ * @return bool: true si la imagen y el tiempo cumplen los umbrales.
+ */
+bool checkGoldenImage(const Framebuffer& image, const std::string& referencePath, double renderSeconds, const GoldenThresholds& thresholds);
+
+#endif // IMAGE_COMPARE_H
@@ -0,0 +1,77 @@
+#ifndef MULTI_VIEW_H
+#define MULTI_VIEW_H
+
+#include <string>
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+#include "Framebuffer.h"
+
+/**
+ * @brief Una de las vistas de un render con varias cámaras y su lugar en la imagen compuesta.
+ */
+struct RenderView {
+    std::string name;                       ///< Nombre para los mensajes ("left", "+x", ...).
+    Camera camera;                          ///< Cámara de la vista.
+    int width = 0, height = 0;              ///< Resolución de la vista en píxeles.
+    double viewportWidth = 0.0;             ///< Ancho del viewport en unidades del mundo.
+    double viewportHeight = 0.0;            ///< Alto del viewport en unidades del mundo.
+    int offsetX = 0, offsetY = 0;           ///< Primer píxel de la vista en la imagen compuesta.
+};
+
+/**
+ * Calcula las dos vistas de una pareja estéreo lado a lado (izquierda y derecha).
+ *
+ * Las dos cámaras tienen la orientación de center y están separadas eyeSeparation a lo largo de su eje
+ * derecho, con los ejes de la vista paralelos.
+ *
+ * @param center: Cámara central.
+ * @param width: Ancho de cada vista en píxeles.
+ * @param height: Alto de cada vista en píxeles.
+ * @param viewportWidth: Ancho del viewport de cada vista.
+ * @param viewportHeight: Alto del viewport de cada vista.
+ * @param eyeSeparation: Distancia entre las dos cámaras.
+ * @return std::vector<RenderView>: Vista izquierda y derecha.
+ */
+std::vector<RenderView> stereoViews(const Camera& center, int width, int height, double viewportWidth, double viewportHeight, double eyeSeparation);
+
+/**
+ * Calcula las seis caras de un cubemap centrado en la posición de una cámara, en una tira horizontal.
+ *
+ * Cada cara es cuadrada y abarca 90 grados (viewport de 2 x distanceToViewport); el orden es +x, -x,
+ * +y, -y, +z, -z. La cara +z coincide con la vista de la cámara sin orientar.
+ *
+ * @param center: Cámara cuya posición es el centro del cubemap.
+ * @param faceSize: Lado de cada cara en píxeles.
+ * @param distanceToViewport: Distancia entre la cámara y el viewport.
+ * @return std::vector<RenderView>: Las seis caras.
+ */
+std::vector<RenderView> cubeMapViews(const Camera& center, int faceSize, double distanceToViewport);
+
+/**
+ * Calcula el tamaño de la imagen compuesta que contiene todas las vistas.
+ *
+ * @param views: Vistas.
+ * @param width: Ancho de la imagen.
+ * @param height: Alto de la imagen.
+ */
+void getViewsImageSize(const std::vector<RenderView>& views, int& width, int& height);
+
+/**
+ * Renderiza varias vistas de una misma escena a la vez.
+ *
+ * Los tiles de todas las vistas forman un único lote de TilePool::shared(), intercalados (el tile t de
+ * cada vista, después el t + 1): los hilos no esperan al final de cada vista y las vistas cercanas, como
+ * las de una pareja estéreo, recorren la misma geometría a la vez. La escena solo se lee, así que basta
+ * con una escena congelada (Scene::freeze) compartida por todas las cámaras. Cada vista es idéntica a
+ * la que genera generateImageRows con su cámara.
+ *
+ * @param scene: Escena que contiene los objetos y las luces.
+ * @param views: Vistas a renderizar.
+ * @param image: Imagen compuesta (ver getViewsImageSize); cada vista se copia en su posición.
+ * @param maxDepth: Profundidad máxima de las reflexiones de los rayos.
+ * @param distanceToViewport: Distancia entre las cámaras y el viewport.
+ */
+void generateImageViews(const Scene& scene, const std::vector<RenderView>& views, Framebuffer& image, int maxDepth, double distanceToViewport);
+
+#endif // MULTI_VIEW_H
@@ -0,0 +1,144 @@
+#ifndef NUMA_PLACEMENT_H
+#define NUMA_PLACEMENT_H
+
+#include <cstddef>
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+#include "Framebuffer.h"
+#include "PreviewStream.h"
+#include "RenderConfig.h"
+
+#define NUMA_TOUCH_CHUNK_BYTES 65536 // Bytes de cada tarea al tocar por primera vez una franja local de la imagen
+
+/**
+ * @brief Nodo NUMA: un socket (o una parte de él) con su memoria y las CPUs que acceden a ella sin cruzar la interconexión.
+ */
+struct NumaNode {
+    int id = 0;            ///< Número del nodo en el sistema.
+    std::vector<int> cpus; ///< CPUs del nodo que el proceso puede usar (vacío si no se conocen).
+};
+
+/**
+ * @brief Estadísticas de un render con colocación NUMA.
+ */
+struct NumaStats {
+    int nodes = 1;             ///< Nodos con hilos del pool.
+    int threads = 1;           ///< Hilos del pool.
+    int localTiles = 0;        ///< Tiles renderizados por un hilo del nodo que tiene su franja de la imagen.
+    int stolenTiles = 0;       ///< Tiles que un hilo tomó de la franja de otro nodo al terminar la suya.
+    double touchSeconds = 0.0; ///< Tiempo de la primera escritura de la imagen.
+};
+
+/**
+ * @brief Memoria anónima reservada sin tocar.
+ *
+ * El sistema operativo asigna cada página en el nodo del hilo que la escribe por primera vez, así que
+ * un Framebuffer construido sobre getData() queda donde lo coloque generateImageNuma y no en el nodo
+ * del hilo que lo reservó (como pasaría con un std::vector, que se llena de ceros al crearse).
+ */
+class FirstTouchBuffer {
+public:
+    FirstTouchBuffer() = default;
+
+    /**
+     * @brief Libera la memoria.
+     */
+    ~FirstTouchBuffer();
+
+    FirstTouchBuffer(const FirstTouchBuffer&) = delete;
+    FirstTouchBuffer& operator=(const FirstTouchBuffer&) = delete;
+
+    /**
+     * @brief Reserva memoria sin tocarla (libera la anterior).
+     * @param bytes Tamaño en bytes.
+     * @return true si la memoria quedó reservada.
+     */
+    bool allocate(size_t bytes);
+
+    /**
+     * @brief Libera la memoria.
+     */
+    void release();
+
+    /**
+     * @brief Devuelve el primer byte de la memoria, que se lee como ceros hasta que se escribe.
+     * @return Puntero a getSize() bytes, o nullptr si no hay memoria reservada.
+     */
+    unsigned char* getData() const;
+
+    /**
+     * @brief Devuelve el tamaño de la memoria reservada.
+     * @return Bytes.
+     */
+    size_t getSize() const;
+
+private:
+    unsigned char* data = nullptr; // Memoria reservada
+    size_t size = 0;               // Bytes reservados
+};
+
+/**
+ * Lee los nodos NUMA de /sys/devices/system/node.
+ *
+ * Solo se cuentan las CPUs que el proceso puede usar (por ejemplo, con taskset o en un contenedor) y
+ * se omiten los nodos que se quedan sin ninguna. Sin información de NUMA (otros sistemas, o Linux sin
+ * sysfs) se devuelve un único nodo con las CPUs del proceso.
+ *
+ * @return std::vector<NumaNode>: Al menos un nodo, en orden de número.
+ */
+std::vector<NumaNode> readNumaTopology();
+
+/**
+ * Fija el hilo actual a un conjunto de CPUs.
+ *
+ * @param cpus: CPUs permitidas (vacío = no se cambia nada).
+ * @return bool: true si el sistema aceptó la afinidad.
+ */
+bool pinCurrentThread(const std::vector<int>& cpus);
+
+/**
+ * Prepara una escena por nodo del pool compartido para generateImageNuma.
+ *
+ * Con NumaPlacement::LOCAL cada nodo recibe una copia de la escena (objetos, malla de esferas, mallas
+ * comprimidas y sus BVH) hecha por uno de sus hilos, de modo que sus páginas quedan en la memoria del
+ * nodo; las texturas y la geometría paginada se comparten entre las copias. Con las demás colocaciones
+ * todos los nodos usan la escena original, sin copias. Las escenas devueltas no poseen la original,
+ * que debe seguir viva mientras se usen.
+ *
+ * @param scene: Escena completa.
+ * @param placement: Colocación.
+ * @return std::vector<SceneSnapshot>: Escena de cada nodo de TilePool::shared().
+ */
+std::vector<SceneSnapshot> replicateScene(const Scene& scene, NumaPlacement placement);
+
+/**
+ * Genera las filas [rowBegin, rowEnd) de la imagen con los hilos y la memoria colocados por nodo NUMA.
+ *
+ * El pool compartido debe tener los hilos fijados (TilePool::setSharedPinning). Las filas de tiles se
+ * dividen en una franja consecutiva por nodo: los hilos de cada nodo renderizan primero los tiles de su
+ * franja con la escena de su nodo (replicateScene) y, al terminarla, ayudan con las de los demás. Antes
+ * del render se escribe por primera vez el framebuffer, que debe estar sin tocar (FirstTouchBuffer o el
+ * PPM mapeado de salida): con NumaPlacement::LOCAL cada franja la escriben los hilos de su nodo; con
+ * NumaPlacement::INTERLEAVED las páginas se reparten entre los nodos por turnos, como hace
+ * numactl --interleave. La imagen es idéntica a la de generateImageRows.
+ *
+ * @param scenes: Escena de cada nodo (ver replicateScene).
+ * @param cam: Cámara que genera los rayos para renderizar la imagen.
+ * @param framebuffer: Framebuffer de width x (rowEnd - rowBegin) píxeles; la fila rowBegin se guarda al inicio.
+ * @param width: Ancho de la imagen completa en píxeles.
+ * @param height: Alto de la imagen completa en píxeles.
+ * @param rowBegin: Primera fila a renderizar.
+ * @param rowEnd: Fila siguiente a la última a renderizar.
+ * @param maxDepth: Profundidad máxima de las reflexiones de los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia entre la cámara y el viewport.
+ * @param placement: Colocación de la memoria del framebuffer (LOCAL o INTERLEAVED).
+ * @param preview: Vista previa en vivo que recibe cada tile terminado (puede ser nullptr).
+ * @return NumaStats: Nodos, hilos y tiles locales y tomados de otros nodos.
+ */
+NumaStats generateImageNuma(const std::vector<SceneSnapshot>& scenes, const Camera& cam, Framebuffer& framebuffer, int width, int height, int rowBegin, int rowEnd,
+                            int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport, NumaPlacement placement, PreviewStream* preview = nullptr);
+
+#endif // NUMA_PLACEMENT_H
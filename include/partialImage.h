@@ -0,0 +1,54 @@
+#ifndef PARTIAL_IMAGE_H
+#define PARTIAL_IMAGE_H
+
+#include <string>
+#include <vector>
+#include "Framebuffer.h"
+
+/**
+ * @brief Rango de filas de una imagen renderizado por un proceso trabajador.
+ *
+ * Los píxeles se guardan en el formato del framebuffer del trabajador, tal cual, para que la imagen
+ * ensamblada sea idéntica, byte a byte, a la de un render en un solo proceso.
+ */
+struct PartialImage {
+    int width = 0;                  ///< Ancho de la imagen completa.
+    int height = 0;                 ///< Alto de la imagen completa.
+    int rowBegin = 0;               ///< Primera fila contenida.
+    int rowEnd = 0;                 ///< Fila siguiente a la última contenida.
+    Framebuffer pixels;             ///< width x (rowEnd - rowBegin) píxeles.
+};
+
+/**
+ * Escribe una imagen parcial en formato binario.
+ *
+ * @param path: Ruta del archivo.
+ * @param image: Imagen parcial a escribir.
+ * @return bool: true si el archivo se escribió correctamente.
+ */
+bool writePartialImage(const std::string& path, const PartialImage& image);
+
+/**
+ * Lee una imagen parcial escrita con writePartialImage.
+ *
+ * @param path: Ruta del archivo.
+ * @param image: Imagen parcial leída.
+ * @return bool: true si el archivo existe y tiene un formato válido.
+ */
+bool readPartialImage(const std::string& path, PartialImage& image);
+
+/**
+ * Ensambla varias imágenes parciales en un framebuffer completo.
+ *
+ * Todas las partes deben tener las mismas dimensiones y el mismo formato y, juntas, cubrir todas las
+ * filas de la imagen.
+ *
+ * @param paths: Rutas de las imágenes parciales.
+ * @param framebuffer: Framebuffer completo resultante (en el formato de las partes).
+ * @param width: Ancho de la imagen ensamblada.
+ * @param height: Alto de la imagen ensamblada.
+ * @return bool: true si las partes son consistentes y cubren toda la imagen.
+ */
+bool mergePartialImages(const std::vector<std::string>& paths, Framebuffer& framebuffer, int& width, int& height);
+
+#endif // PARTIAL_IMAGE_H
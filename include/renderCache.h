@@ -0,0 +1,99 @@
+#ifndef RENDER_CACHE_H
+#define RENDER_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+#include "Framebuffer.h"
+#include "PreviewStream.h"
+
+/**
+ * @brief Estadísticas de un render con caché.
+ */
+struct CacheStats {
+    bool frameHit = false;   ///< true si la imagen completa se obtuvo de la caché.
+    int tilesTotal = 0;      ///< Número de tiles de la imagen.
+    int tilesReused = 0;     ///< Tiles obtenidos de la caché.
+};
+
+/**
+ * @brief Caché en disco de imágenes completas y de tiles, indexada por hash de contenido.
+ *
+ * Cada entrada es un archivo <directorio>/<hash>.frame o <hash>.tile con los bytes del framebuffer; el
+ * formato de los píxeles forma parte del hash.
+ * Las entradas se escriben en un archivo temporal que luego se renombra, de modo que varios procesos
+ * pueden compartir el mismo directorio.
+ */
+class RenderCache {
+public:
+    /**
+     * @brief Crea la caché sobre un directorio (se crea si no existe).
+     * @param directory Directorio de la caché.
+     */
+    explicit RenderCache(const std::string& directory);
+
+    /**
+     * @brief Carga una imagen completa.
+     * @param key Hash de la escena, la cámara y los parámetros del render.
+     * @param pixels Framebuffer con las dimensiones y el formato esperados, donde se leen los píxeles.
+     * @return true si la entrada existe y es válida.
+     */
+    bool loadFrame(std::uint64_t key, Framebuffer& pixels) const;
+
+    /**
+     * @brief Guarda una imagen completa.
+     * @param key Hash de la escena, la cámara y los parámetros del render.
+     * @param pixels Píxeles a guardar.
+     */
+    void storeFrame(std::uint64_t key, const Framebuffer& pixels) const;
+
+    /**
+     * @brief Carga un tile.
+     * @param key Hash de las dependencias del tile.
+     * @param pixels Framebuffer con las dimensiones y el formato esperados, donde se leen los píxeles.
+     * @return true si la entrada existe y es válida.
+     */
+    bool loadTile(std::uint64_t key, Framebuffer& pixels) const;
+
+    /**
+     * @brief Guarda un tile.
+     * @param key Hash de las dependencias del tile.
+     * @param pixels Píxeles a guardar.
+     */
+    void storeTile(std::uint64_t key, const Framebuffer& pixels) const;
+
+private:
+    std::string pathFor(std::uint64_t key, const char* extension) const;
+    bool load(const std::string& path, std::uint64_t key, Framebuffer& pixels) const;
+    void store(const std::string& path, std::uint64_t key, const Framebuffer& pixels) const;
+
+    std::string directory;   ///< Directorio de la caché.
+};
+
+/**
+ * Genera una imagen reutilizando los resultados guardados en la caché.
+ *
+ * Si la escena, la cámara y los parámetros coinciden con un render anterior, la imagen se lee
+ * directamente. Si no, se hace una pasada primaria por tile (solo intersección) para obtener sus
+ * dependencias: el objeto visto en cada píxel, los posibles oclusores de sus rayos de sombra y,
+ * si algún píxel es reflectivo, la escena completa. Los tiles cuyas dependencias no cambiaron se
+ * leen de la caché y el resto se sombrea reutilizando las intersecciones de la pasada primaria.
+ *
+ * @param scene: Escena que contiene los objetos y las luces.
+ * @param cam: Cámara que genera los rayos para renderizar la imagen.
+ * @param framebuffer: Framebuffer de width x height píxeles donde se guarda la imagen.
+ * @param width: Ancho de la imagen en píxeles.
+ * @param height: Alto de la imagen en píxeles.
+ * @param maxDepth: Profundidad máxima de las reflexiones de los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia entre la cámara y el viewport.
+ * @param cache: Caché donde se buscan y guardan los resultados.
+ * @param preview: Vista previa a la que se envía cada tile terminado o leído (nullptr = sin vista previa).
+ * @return CacheStats: Aciertos de la caché.
+ */
+CacheStats generateImageCached(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, int width, int height, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport, const RenderCache& cache, PreviewStream* preview = nullptr);
+
+#endif // RENDER_CACHE_H
@@ -0,0 +1,119 @@
+#ifndef SCENE_HASH_H
+#define SCENE_HASH_H
+
+#include <cstdint>
+#include <cstddef>
+#include "Vector3D.h"
+#include "Triangle.h"
+#include "Plane.h"
+#include "Sphere.h"
+#include "SphereGrid.h"
+#include "CompressedMesh.h"
+#include "PagedGeometry.h"
+#include "LightSource.h"
+#include "Scene.h"
+#include "Camera.h"
+
+/**
+ * @brief Acumulador de hash de contenido (FNV-1a de 64 bits).
+ *
+ * Los valores se agregan en orden; dos secuencias iguales producen el mismo hash en cualquier ejecución.
+ */
+class Hasher {
+public:
+    /**
+     * @brief Agrega un bloque de bytes al hash.
+     * @param data Puntero a los datos.
+     * @param size Número de bytes.
+     */
+    void addBytes(const void* data, size_t size);
+
+    /**
+     * @brief Agrega un entero al hash.
+     * @param value Valor a agregar.
+     */
+    void add(std::uint64_t value);
+
+    /**
+     * @brief Agrega un double al hash (0.0 y -0.0 se consideran iguales).
+     * @param value Valor a agregar.
+     */
+    void add(double value);
+
+    /**
+     * @brief Agrega las tres componentes de un vector al hash.
+     * @param value Vector a agregar.
+     */
+    void add(const Vector3D& value);
+
+    /**
+     * @brief Devuelve el hash acumulado.
+     * @return Valor del hash.
+     */
+    std::uint64_t value() const;
+
+private:
+    std::uint64_t state = 14695981039346656037ULL; ///< Estado FNV-1a (inicializado con el offset basis).
+};
+
+/**
+ * @brief Hash del contenido de un triángulo (geometría y material).
+ */
+std::uint64_t hashTriangle(const Triangle& triangle);
+
+/**
+ * @brief Hash del contenido de un plano (geometría y material).
+ */
+std::uint64_t hashPlane(const Plane& plane);
+
+/**
+ * @brief Hash del contenido de una esfera (geometría y material).
+ */
+std::uint64_t hashSphere(const Sphere& sphere);
+
+/**
+ * @brief Hash de una esfera de una malla de esferas (geometría y material).
+ */
+std::uint64_t hashGridSphere(const SphereGrid& grid, std::uint32_t index);
+
+/**
+ * @brief Hash de todas las esferas y materiales de una malla de esferas.
+ */
+std::uint64_t hashSphereGrid(const SphereGrid& grid);
+
+/**
+ * @brief Hash de un triángulo de una malla comprimida (geometría y material).
+ */
+std::uint64_t hashMeshTriangle(const CompressedMesh& mesh, std::uint32_t index);
+
+/**
+ * @brief Hash de todos los vértices, triángulos y el material de una malla comprimida.
+ */
+std::uint64_t hashMesh(const CompressedMesh& mesh);
+
+/**
+ * @brief Hash de un triángulo de la geometría paginada (sin leer su chunk).
+ */
+std::uint64_t hashPagedTriangle(const PagedGeometry& geometry, std::uint32_t chunk, std::uint32_t index);
+
+/**
+ * @brief Hash de la tabla de chunks de la geometría paginada (contenido y material de cada chunk).
+ */
+std::uint64_t hashPagedGeometry(const PagedGeometry& geometry);
+
+/**
+ * @brief Hash de todas las luces de la escena.
+ */
+std::uint64_t hashLights(const Scene& scene);
+
+/**
+ * @brief Hash de toda la escena: primitivas, materiales y luces, en orden de inserción.
+ */
+std::uint64_t hashScene(const Scene& scene);
+
+/**
+ * @brief Hash de los parámetros de la cámara.
+ */
+std::uint64_t hashCamera(const Camera& camera);
+
+#endif // SCENE_HASH_H
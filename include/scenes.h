@@ -0,0 +1,164 @@
+#ifndef SCENES_H
+#define SCENES_H
+
+#include <cstdint>
+#include <string>
+#include "Scene.h"
+#include "Camera.h"
+#include "SphereGrid.h"
+#include "CompressedMesh.h"
+#include "PagedGeometry.h"
+
+#define PARTICLE_SCENE_COUNT 1000000  // Esferas de la escena "particles"
+#define PARTICLE_MATERIALS 16         // Materiales del degradado de las partículas
+#define MESH_SCENE_TRIANGLES 500000   // Triángulos de la escena "mesh"
+#define CITY_BLOCK_SIZE 40.0          // Lado de cada manzana de la ciudad (un chunk del archivo de geometría)
+#define CITY_STREET_WIDTH 10.0        // Ancho de las calles entre manzanas
+#define CITY_BLOCK_BUILDINGS 4        // Edificios por lado de cada manzana
+#define CITY_FLOOR_HEIGHT 3.0         // Altura de cada piso (una fila de ventanas)
+#define CITY_WINDOW_WIDTH 2.0         // Ancho de cada ventana de las fachadas
+
+/**
+ * @brief Construye la escena por defecto del proyecto (triángulos, esferas, "caja" de planos y cuatro luces).
+ *
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara con la posición adecuada para visualizar la escena.
+ */
+void buildDefaultScene(Scene& scene, Camera& camera);
+
+/**
+ * @brief Construye una escena de regresión para las sombras de luces puntuales.
+ *
+ * Un piso iluminado por una luz puntual con:
+ * - una esfera entre el piso y la luz, a más de una unidad del piso: debe proyectar sombra;
+ * - una esfera al otro lado de la luz (más lejos que ella): no debe proyectar sombra;
+ * - un triángulo muy cerca del piso: debe proyectar sombra.
+ *
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara que encuadra el piso y los oclusores.
+ */
+void buildShadowTestScene(Scene& scene, Camera& camera);
+
+/**
+ * @brief Construye una escena con muchos objetos texturizados (piso, pared, esferas y triángulos).
+ *
+ * Usa la textura textures/checker.ppm a través de la caché compartida de texturas; si no se puede
+ * cargar, los objetos conservan su color constante.
+ *
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildTexturedScene(Scene& scene, Camera& camera);
+
+/**
+ * @brief Construye una escena iluminada por luces de área (una rectangular y una esférica).
+ *
+ * Los oclusores están a distintas alturas sobre el piso para que se vea cómo la penumbra se
+ * ensancha con la distancia entre el oclusor y la superficie que recibe la sombra.
+ *
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildSoftShadowScene(Scene& scene, Camera& camera);
+
+/**
+ * @brief Construye una escena con muchas esferas de vidrio y una lámina transparente.
+ *
+ * Cada superficie de vidrio divide el rayo en uno reflejado y otro refractado, por lo que sirve
+ * para comprobar que el costo del árbol de rayos se mantiene acotado.
+ *
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildGlassScene(Scene& scene, Camera& camera);
+
+/**
+ * @brief Construye una escena simple: solo esferas difusas (sin brillo especular ni reflexión) y luces direccionales.
+ *
+ * No usa ninguna de las características opcionales de SceneFeature, así que se renderiza con el
+ * kernel más especializado; sirve de referencia para los benchmarks de los kernels.
+ *
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildSpheresScene(Scene& scene, Camera& camera);
+
+/**
+ * @brief Llena una malla con esferas pequeñas en posiciones aleatorias (deterministas) dentro de una bola.
+ *
+ * Reparte las esferas entre PARTICLE_MATERIALS materiales con un degradado de color según la altura.
+ * No llama a build().
+ *
+ * @param grid Malla (vacía) a la que se agregan las esferas y los materiales.
+ * @param count Número de esferas.
+ * @param center Centro de la bola.
+ * @param radius Radio de la bola.
+ * @param seed Semilla de las posiciones.
+ */
+void addRandomParticles(SphereGrid& grid, size_t count, const Vector3D& center, double radius, std::uint64_t seed = 1);
+
+/**
+ * @brief Construye una nube de PARTICLE_SCENE_COUNT esferas pequeñas (en una SphereGrid) sobre un suelo plano.
+ *
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildParticlesScene(Scene& scene, Camera& camera);
+
+/**
+ * @brief Llena una malla con una esfera con relieve (ondulaciones en latitud y longitud).
+ *
+ * Es una esfera UV con los polos cerrados en abanico; el número de anillos se elige para acercarse
+ * al número de triángulos pedido.
+ *
+ * @param mesh Malla (vacía) a la que se agregan los vértices y los triángulos.
+ * @param triangles Número aproximado de triángulos.
+ * @param center Centro de la esfera.
+ * @param radius Radio medio de la esfera.
+ */
+void addBumpySphere(TriangleMesh& mesh, size_t triangles, const Vector3D& center, double radius);
+
+/**
+ * @brief Construye una esfera con relieve de MESH_SCENE_TRIANGLES triángulos (una CompressedMesh) sobre un suelo plano.
+ *
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildMeshScene(Scene& scene, Camera& camera);
+
+/**
+ * @brief Genera el archivo de geometría de una ciudad de blocks x blocks manzanas.
+ *
+ * Cada manzana es un chunk con CITY_BLOCK_BUILDINGS x CITY_BLOCK_BUILDINGS edificios de altura
+ * aleatoria cuyas fachadas tienen una ventana hundida por piso y columna (unos 50000 triángulos por
+ * manzana). Las manzanas se generan y escriben de una en una, así que la ciudad puede ser mayor que
+ * la memoria. La avenida central (x entre -CITY_STREET_WIDTH / 2 y CITY_STREET_WIDTH / 2) empieza en
+ * z = 0 y se aleja de la cámara de la escena "city".
+ *
+ * @param path Ruta del archivo de geometría.
+ * @param blocks Manzanas por lado.
+ * @param writer Escritor que se usa (para consultar los chunks y triángulos escritos).
+ * @return true si el archivo se escribió completo.
+ */
+bool writeCityGeometry(const std::string& path, int blocks, GeometryFileWriter& writer);
+
+/**
+ * @brief Construye el suelo, las luces y la cámara de la ciudad; los edificios vienen de un archivo
+ * de geometría paginada (--geometry) generado con writeCityGeometry.
+ *
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara sobre la avenida central, mirando a lo largo de ella.
+ */
+void buildCityScene(Scene& scene, Camera& camera);
+
+/**
+ * @brief Construye una escena a partir de su nombre.
+ *
+ * @param name Nombre de la escena ("default", "shadows", "textured", "softshadows", "glass", "spheres", "particles", "mesh" o "city").
+ * @param scene Escena (vacía) a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ * @return true si el nombre corresponde a una escena conocida, false de lo contrario.
+ */
+bool buildScene(const std::string& name, Scene& scene, Camera& camera);
+
+#endif // SCENES_H
@@ -0,0 +1,82 @@
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#include <cstdint>
+#include <vector>
+#include "Scene.h"
+#include "Camera.h"
+#include "Framebuffer.h"
+#include "PreviewStream.h"
+
+#define WAVEFRONT_BATCH_PIXELS 262144  // Píxeles por defecto de cada lote del render por frentes de onda
+#define WAVEFRONT_TASK_RAYS 1024       // Rayos secundarios consecutivos (en el orden de trazado) de cada tarea del pool
+#define RAY_SORT_CELL_BITS 9           // Bits por eje de la celda del origen en la clave de Morton (512 celdas por eje)
+
+/**
+ * @brief Estadísticas de un render por frentes de onda.
+ */
+struct WavefrontStats {
+    long long secondaryRays = 0;  ///< Rayos secundarios trazados.
+    int waves = 0;                ///< Mayor número de frentes de rayos secundarios de un lote.
+    double sortSeconds = 0.0;     ///< Tiempo de ordenación de los rayos.
+    double traceSeconds = 0.0;    ///< Tiempo de trazado de los rayos secundarios (sin la ordenación).
+};
+
+/**
+ * Ordena rayos para que los consecutivos recorran la escena de forma coherente.
+ *
+ * La clave de cada rayo es el octante de su dirección seguido del código de Morton de la celda de su
+ * origen (RAY_SORT_CELL_BITS bits por eje, sobre la caja de todos los orígenes). La ordenación es
+ * estable (radix sort), de modo que los rayos con la misma clave conservan su orden.
+ *
+ * @param rays: Rayos a ordenar.
+ * @param order: Índices de rays en el orden de trazado.
+ */
+void sortRaysByCoherence(const std::vector<DeferredRay>& rays, std::vector<std::uint32_t>& order);
+
+/**
+ * Pasa al frente siguiente los rayos secundarios que caben en el presupuesto de su píxel.
+ *
+ * Los rayos se consideran en orden; cuando a un píxel ya no le quedan rayos, el rayo se sustituye por
+ * su color local (fallback por su peso), como una rama que el trazado recursivo no traza.
+ *
+ * @param rays: Rayos generados.
+ * @param count: Número de rayos.
+ * @param raysLeft: Rayos secundarios que le quedan a cada píxel del lote.
+ * @param colors: Color acumulado de cada píxel del lote.
+ * @param wave: Frente siguiente, al que se agregan los rayos aceptados.
+ */
+void enqueueDeferredRays(const DeferredRay* rays, size_t count, std::vector<int>& raysLeft, std::vector<Vector3D>& colors, std::vector<DeferredRay>& wave);
+
+/**
+ * Genera un rango de filas de la imagen trazando los rayos secundarios por frentes de onda.
+ *
+ * Las filas se procesan en lotes de tiles completos de unos batchPixels píxeles. En cada lote se trazan
+ * primero los rayos primarios por tiles (con el descarte por frustum, como generateImageRows) y los
+ * rayos reflejados y refractados se guardan en vez de trazarse. Después se traza cada profundidad como
+ * un frente: todos los rayos secundarios del lote juntos, ordenados con sortRaysByCoherence si sortRays
+ * es true, y los rayos que generan forman el frente siguiente. El color de cada rayo se suma a su píxel
+ * en el orden en que se generaron, así que la imagen no depende del número de hilos.
+ *
+ * El resultado equivale al de generateImageRows salvo por el redondeo y por el presupuesto de
+ * MAX_SECONDARY_RAYS_PER_PIXEL rayos, que aquí se reparte por profundidades y no rama a rama.
+ *
+ * @param scene: Escena que contiene los objetos y las luces.
+ * @param cam: Cámara que genera los rayos primarios.
+ * @param framebuffer: Framebuffer de width x (rowEnd - rowBegin) píxeles; la fila rowBegin se guarda al inicio.
+ * @param width: Ancho de la imagen completa en píxeles.
+ * @param height: Alto de la imagen completa en píxeles.
+ * @param rowBegin: Primera fila a renderizar.
+ * @param rowEnd: Fila siguiente a la última a renderizar.
+ * @param maxDepth: Profundidad máxima de las reflexiones de los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia entre la cámara y el viewport.
+ * @param sortRays: false para trazar cada frente en el orden en que se generaron los rayos.
+ * @param batchPixels: Píxeles aproximados de cada lote (como mínimo una fila de tiles).
+ * @param preview: Vista previa a la que se envían los tiles de cada lote terminado (nullptr = sin vista previa).
+ * @return WavefrontStats: Rayos secundarios y tiempos del render.
+ */
+WavefrontStats generateImageWavefront(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, int width, int height, int rowBegin, int rowEnd, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport, bool sortRays, int batchPixels = WAVEFRONT_BATCH_PIXELS, PreviewStream* preview = nullptr);
+
+#endif // WAVEFRONT_H
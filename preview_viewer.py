@@ -0,0 +1,185 @@
+"""
+@file preview_viewer.py
+@brief Visor de la vista previa en vivo del renderizador.
+
+Escucha en un puerto local y muestra los tiles que el renderizador envía con `--preview` a medida que
+terminan, sin esperar a que se escriba el PPM. En el trazado de caminos la imagen se refina en cada
+pasada; el renderizador solo reenvía los tiles que cambiaron.
+
+Uso:
+    python preview_viewer.py [puerto] [--save archivo.ppm] [--no-window]
+
+Primero se inicia el visor y después el renderizador:
+    ./bin/main softshadows --pathtrace --spp 64 --preview
+
+Solo usa la biblioteca estándar (tkinter muestra el PPM directamente).
+"""
+
+import socket
+import struct
+import sys
+import threading
+import time
+
+DEFAULT_PORT = 5599          # Debe coincidir con PREVIEW_DEFAULT_PORT (PreviewStream.h)
+MAGIC = b"RTPREVW1"          # Debe coincidir con PREVIEW_MAGIC
+TILE, PASS_END, FRAME_END = 1, 2, 3
+REFRESH_MS = 50              # Intervalo de refresco de la ventana
+
+
+def receive_exact(connection, size):
+    """
+    Lee exactamente size bytes del socket.
+
+    @param connection: Socket conectado.
+    @param size: Número de bytes.
+    @return: Bytes leídos, o None si la conexión se cerró antes.
+    """
+    chunks = bytearray()
+    while len(chunks) < size:
+        chunk = connection.recv(size - len(chunks))
+        if not chunk:
+            return None
+        chunks.extend(chunk)
+    return bytes(chunks)
+
+
+class PreviewImage:
+    """
+    Imagen RGB de 8 bits que se actualiza por tiles desde el hilo de red.
+    """
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.width = 0
+        self.height = 0
+        self.pixels = bytearray()
+        self.dirty = False
+        self.finished = False
+        self.status = "Esperando al renderizador..."
+
+    def reset(self, width, height):
+        with self.lock:
+            self.width, self.height = width, height
+            self.pixels = bytearray(width * height * 3)
+            self.dirty = True
+            self.finished = False
+
+    def paste(self, x, y, width, rows, data):
+        with self.lock:
+            for row in range(rows):
+                start = ((y + row) * self.width + x) * 3
+                self.pixels[start:start + width * 3] = data[row * width * 3:(row + 1) * width * 3]
+            self.dirty = True
+
+    def to_ppm(self):
+        with self.lock:
+            self.dirty = False
+            return b"P6\n%d %d\n255\n" % (self.width, self.height) + bytes(self.pixels)
+
+
+def serve(port, image, save_path, stop_after_frame):
+    """
+    Acepta renderizadores en el puerto y aplica sus mensajes a la imagen.
+
+    @param port: Puerto local en el que escuchar.
+    @param image: PreviewImage a actualizar.
+    @param save_path: Ruta donde guardar cada imagen terminada (o None).
+    @param stop_after_frame: Terminar tras el primer render completo.
+    """
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(("127.0.0.1", port))
+    server.listen(1)
+    print(f"Esperando al renderizador en 127.0.0.1:{port}")
+
+    while True:
+        connection, _ = server.accept()
+        with connection:
+            header = receive_exact(connection, len(MAGIC) + 8)
+            if header is None or header[:len(MAGIC)] != MAGIC:
+                print("Conexión ignorada: no es un renderizador")
+                continue
+            width, height = struct.unpack("<ii", header[len(MAGIC):])
+            image.reset(width, height)
+            start = time.time()
+            tiles = 0
+            first_tile = None
+
+            while True:
+                message = receive_exact(connection, 20)
+                if message is None:
+                    image.status = "Conexión perdida"
+                    break
+                kind, x, y, w, h = struct.unpack("<iiiii", message)
+                if kind == TILE:
+                    data = receive_exact(connection, w * h * 3)
+                    if data is None:
+                        image.status = "Conexión perdida"
+                        break
+                    image.paste(x, y, w, h, data)
+                    tiles += 1
+                    if first_tile is None:
+                        first_tile = time.time() - start
+                elif kind == PASS_END:
+                    image.status = f"Pasada {x} - {tiles} tiles recibidos - {time.time() - start:.1f} s"
+                elif kind == FRAME_END:
+                    image.status = f"Terminado: {tiles} tiles en {time.time() - start:.1f} s"
+                    image.finished = True
+                    break
+            print(image.status + (f" (primer tile a los {first_tile:.3f} s)" if first_tile is not None else ""))
+
+        if image.finished and save_path:
+            with open(save_path, "wb") as output:
+                output.write(image.to_ppm())
+            print(f"Imagen guardada como {save_path}")
+        if stop_after_frame:
+            return
+
+
+def main():
+    args = sys.argv[1:]
+    port = DEFAULT_PORT
+    save_path = None
+    window = True
+    i = 0
+    while i < len(args):
+        if args[i] == "--save" and i + 1 < len(args):
+            save_path = args[i + 1]
+            i += 1
+        elif args[i] == "--no-window":
+            window = False
+        else:
+            port = int(args[i])
+        i += 1
+
+    image = PreviewImage()
+    if not window:
+        # Sin ventana: recibir un render, guardarlo y terminar (útil para scripts)
+        serve(port, image, save_path, stop_after_frame=True)
+        return
+
+    import tkinter
+
+    threading.Thread(target=serve, args=(port, image, save_path, False), daemon=True).start()
+    root = tkinter.Tk()
+    root.title("Vista previa del render")
+    label = tkinter.Label(root)
+    label.pack()
+    status = tkinter.Label(root, anchor="w")
+    status.pack(fill="x")
+
+    def refresh():
+        if image.dirty and image.width > 0:
+            photo = tkinter.PhotoImage(data=image.to_ppm(), format="PPM")
+            label.configure(image=photo)
+            label.image = photo  # Mantener la referencia para que tkinter no la libere
+        status.configure(text=image.status)
+        root.after(REFRESH_MS, refresh)
+
+    refresh()
+    root.mainloop()
+
+
+if __name__ == '__main__':
+    main()
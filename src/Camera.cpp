@@ -11,11 +11,44 @@ Camera::Camera(double x, double y, double z) {
 // Constructor por defecto que inicializa la cámara en la posición (0, 0, 0)
 Camera::Camera() : p{0, 0, 0} { }
 
+/**
+ * Constructor de una cámara orientada.
+ *
+ * @param position: Posición de la cámara.
+ * @param forward: Dirección de la vista.
+ * @param up: Dirección aproximada hacia arriba.
+ */
+Camera::Camera(const Vector3D& position, const Vector3D& forward, const Vector3D& up)
+    : p{position.getX(), position.getY(), position.getZ()} {
+    // Base ortonormal con la misma orientación que la cámara sin rotar (derecha = arriba x vista)
+    this->forward = forward.normalize();
+    right = up.cross(this->forward).normalize();
+    this->up = this->forward.cross(right);
+
+    // Una base igual a los ejes conserva exactamente los rayos de la cámara sin orientar
+    oriented = !(right.getX() == 1 && right.getY() == 0 && right.getZ() == 0 &&
+                 this->up.getX() == 0 && this->up.getY() == 1 && this->up.getZ() == 0 &&
+                 this->forward.getX() == 0 && this->forward.getY() == 0 && this->forward.getZ() == 1);
+}
+
 // Getter para obtener la posición de la cámara como un objeto Vector3D
 Vector3D Camera::getPosition() const {
     return Vector3D(p[0], p[1], p[2]);
 }
 
+// Getters de la base de la cámara
+Vector3D Camera::getRight() const {
+    return right;
+}
+
+Vector3D Camera::getUp() const {
+    return up;
+}
+
+Vector3D Camera::getForward() const {
+    return forward;
+}
+
 /**
  * Genera un rayo que parte desde la cámara hacia un píxel específico en la pantalla.
  *
@@ -29,13 +62,32 @@ Vector3D Camera::getPosition() const {
  * @return Ray: Rayo generado desde la posición de la cámara hacia el píxel.
  */
 Ray Camera::generateRay(int pixelX, int pixelY, int imageWidth, int imageHeight, double viewportWidth, double viewportHeight, double distanceToViewport) const {
+    return generateRay(static_cast<double>(pixelX), static_cast<double>(pixelY), imageWidth, imageHeight, viewportWidth, viewportHeight, distanceToViewport);
+}
+
+/**
+ * Genera un rayo hacia una posición fraccionaria de la pantalla.
+ *
+ * @param pixelX: Coordenada x en píxeles.
+ * @param pixelY: Coordenada y en píxeles.
+ * @param imageWidth: Ancho de la imagen en píxeles.
+ * @param imageHeight: Alto de la imagen en píxeles.
+ * @param viewportWidth: Ancho del viewport.
+ * @param viewportHeight: Alto del viewport.
+ * @param distanceToViewport: Distancia de la cámara al viewport.
+ * @return Ray: Rayo generado desde la posición de la cámara hacia ese punto.
+ */
+Ray Camera::generateRay(double pixelX, double pixelY, int imageWidth, int imageHeight, double viewportWidth, double viewportHeight, double distanceToViewport) const {
     // Calcular la posición x e y en el plano del viewport basado en la posición del píxel
     double x = (pixelX - imageWidth / 2.0) * viewportWidth / imageWidth;
     double y = -(pixelY - imageHeight / 2.0) * viewportHeight / imageHeight; // Invertir y para la orientación correcta
 
-    // Crear la dirección del rayo hacia el viewport
-    Vector3D direction(x, y, distanceToViewport);
+    // Crear la dirección del rayo hacia el viewport, en la base de la cámara si está orientada
+    Vector3D direction = oriented ? right * x + up * y + forward * distanceToViewport : Vector3D(x, y, distanceToViewport);
+
+    // Apertura del cono del rayo: ángulo que abarca un píxel visto desde la cámara
+    double spreadAngle = viewportWidth / (imageWidth * distanceToViewport);
 
     // Devolver el rayo normalizado que comienza en la posición de la cámara y apunta en la dirección calculada
-    return Ray(Vector3D(p[0], p[1], p[2]), direction.normalize());
+    return Ray(Vector3D(p[0], p[1], p[2]), direction.normalize(), 0.0, spreadAngle);
 }
@@ -0,0 +1,842 @@
+#include "CompressedMesh.h"
+#include <algorithm> // Para std::min, std::max, std::swap y std::nth_element
+#include <cmath>     // Para std::fabs y std::lround
+#include <cstring>   // Para std::memcpy
+#include <limits>    // Para std::numeric_limits
+#include <stdexcept> // Para std::length_error
+
+namespace {
+
+const std::uint32_t MESH_LEAF_FLAG = 1u << 31;           // La referencia es una hoja
+const int LEAF_COUNT_SHIFT = 27;                         // Posición del número de triángulos de la hoja
+const std::uint32_t LEAF_FIRST_MASK = (1u << 27) - 1;    // Bits del primer triángulo de la hoja
+const size_t MAX_TRIANGLES = size_t(1) << 27;            // Triángulos que caben en una referencia de hoja
+const double BOX_PADDING = 1e-3;                         // Margen de las cajas (en pasos de la rejilla) que absorbe el redondeo del rayo
+const int SERIALIZED_DOUBLES = 13;                       // Rejilla (origen y paso) y material en la cabecera serializada
+
+// Caja en la rejilla cuantizada
+struct GridBox {
+    int min[3] = { MESH_QUANTIZATION_LEVELS, MESH_QUANTIZATION_LEVELS, MESH_QUANTIZATION_LEVELS };
+    int max[3] = { 0, 0, 0 };
+
+    void expand(const GridBox& other) {
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], other.min[axis]);
+            max[axis] = std::max(max[axis], other.max[axis]);
+        }
+    }
+
+    // Mitad del área de la superficie (el factor 2 no cambia la comparación del SAH)
+    double halfArea() const {
+        double dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+        return dx * dy + dy * dz + dz * dx;
+    }
+};
+
+// Caja en coordenadas del mundo (BVH en precisión completa); vacía al crearse
+struct WorldBox {
+    double min[3] = { std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+    double max[3] = { -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+
+    void expand(const WorldBox& other) {
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], other.min[axis]);
+            max[axis] = std::max(max[axis], other.max[axis]);
+        }
+    }
+
+    double halfArea() const {
+        double dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+        return dx * dy + dy * dz + dz * dx;
+    }
+};
+
+// Guarda la caja y la referencia de un hijo en un nodo de cada tipo de BVH
+void setChild(CompressedBVHNode& node, int side, const GridBox& box, std::uint32_t reference) {
+    for (int axis = 0; axis < 3; ++axis) {
+        node.childMin[side][axis] = static_cast<std::uint16_t>(box.min[axis]);
+        node.childMax[side][axis] = static_cast<std::uint16_t>(box.max[axis]);
+    }
+    node.child[side] = reference;
+}
+
+void setChild(MeshBVHNode& node, int side, const WorldBox& box, std::uint32_t reference) {
+    for (int axis = 0; axis < 3; ++axis) {
+        node.childMin[side][axis] = box.min[axis];
+        node.childMax[side][axis] = box.max[axis];
+    }
+    node.child[side] = reference;
+}
+
+// Triángulo durante la construcción del BVH
+template <typename Box>
+struct BuildTriangle {
+    Box box;               // Caja de sus vértices
+    double centroid[3];    // Centro de la caja
+    std::uint32_t index;   // Índice del triángulo en la malla de entrada
+};
+
+// Construye el BVH de forma recursiva sobre un rango de triángulos
+template <typename Box, typename Node>
+class BVHBuilder {
+public:
+    BVHBuilder(std::vector<BuildTriangle<Box>>& triangles, std::vector<Node>& nodes)
+        : triangles(triangles), nodes(nodes) {}
+
+    // Devuelve la referencia (nodo u hoja) del rango [begin, end) y su caja
+    std::uint32_t build(size_t begin, size_t end, int depth, Box& box) {
+        box = Box();
+        double centroidMin[3], centroidMax[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            centroidMin[axis] = std::numeric_limits<double>::infinity();
+            centroidMax[axis] = -std::numeric_limits<double>::infinity();
+        }
+        for (size_t i = begin; i < end; ++i) {
+            box.expand(triangles[i].box);
+            for (int axis = 0; axis < 3; ++axis) {
+                centroidMin[axis] = std::min(centroidMin[axis], triangles[i].centroid[axis]);
+                centroidMax[axis] = std::max(centroidMax[axis], triangles[i].centroid[axis]);
+            }
+        }
+
+        size_t count = end - begin;
+        if (count <= MESH_LEAF_TRIANGLES) {
+            return MESH_LEAF_FLAG | static_cast<std::uint32_t>((count - 1) << LEAF_COUNT_SHIFT) | static_cast<std::uint32_t>(begin);
+        }
+
+        size_t middle = split(begin, end, depth, centroidMin, centroidMax);
+
+        size_t nodeIndex = nodes.size();
+        nodes.emplace_back();
+        Box childBoxes[2];
+        std::uint32_t children[2];
+        children[0] = build(begin, middle, depth + 1, childBoxes[0]);
+        children[1] = build(middle, end, depth + 1, childBoxes[1]);
+
+        Node& node = nodes[nodeIndex];
+        for (int side = 0; side < 2; ++side) {
+            setChild(node, side, childBoxes[side], children[side]);
+        }
+        return static_cast<std::uint32_t>(nodeIndex);
+    }
+
+private:
+    // Reordena el rango y devuelve el punto de división: SAH con MESH_BVH_BINS cubetas por eje, o la
+    // mediana del eje más largo si los centros coinciden o el árbol se acerca a MESH_BVH_MAX_DEPTH
+    size_t split(size_t begin, size_t end, int depth, const double centroidMin[3], const double centroidMax[3]) {
+        int longest = 0;
+        for (int axis = 1; axis < 3; ++axis) {
+            if (centroidMax[axis] - centroidMin[axis] > centroidMax[longest] - centroidMin[longest]) {
+                longest = axis;
+            }
+        }
+
+        if (centroidMax[longest] > centroidMin[longest] && depth < MESH_BVH_MAX_DEPTH / 2) {
+            double bestCost = std::numeric_limits<double>::infinity();
+            int bestAxis = -1, bestBin = 0;
+            for (int axis = 0; axis < 3; ++axis) {
+                double extent = centroidMax[axis] - centroidMin[axis];
+                if (extent <= 0) {
+                    continue;
+                }
+                Box binBoxes[MESH_BVH_BINS];
+                size_t binCounts[MESH_BVH_BINS] = {};
+                for (size_t i = begin; i < end; ++i) {
+                    int bin = binIndex(triangles[i].centroid[axis], centroidMin[axis], extent);
+                    binBoxes[bin].expand(triangles[i].box);
+                    ++binCounts[bin];
+                }
+
+                // Costo de cada división: área por número de triángulos a cada lado
+                double rightArea[MESH_BVH_BINS];
+                size_t rightCount[MESH_BVH_BINS];
+                Box accumulated;
+                size_t accumulatedCount = 0;
+                for (int bin = MESH_BVH_BINS - 1; bin > 0; --bin) {
+                    accumulated.expand(binBoxes[bin]);
+                    accumulatedCount += binCounts[bin];
+                    rightArea[bin] = accumulated.halfArea();
+                    rightCount[bin] = accumulatedCount;
+                }
+                accumulated = Box();
+                accumulatedCount = 0;
+                for (int bin = 1; bin < MESH_BVH_BINS; ++bin) {
+                    accumulated.expand(binBoxes[bin - 1]);
+                    accumulatedCount += binCounts[bin - 1];
+                    if (accumulatedCount == 0 || rightCount[bin] == 0) {
+                        continue;
+                    }
+                    double cost = accumulated.halfArea() * accumulatedCount + rightArea[bin] * rightCount[bin];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestBin = bin;
+                    }
+                }
+            }
+
+            if (bestAxis >= 0) {
+                double extent = centroidMax[bestAxis] - centroidMin[bestAxis];
+                auto middle = std::partition(triangles.begin() + begin, triangles.begin() + end, [&](const BuildTriangle<Box>& triangle) {
+                    return binIndex(triangle.centroid[bestAxis], centroidMin[bestAxis], extent) < bestBin;
+                });
+                return static_cast<size_t>(middle - triangles.begin());
+            }
+        }
+
+        size_t middle = begin + (end - begin) / 2;
+        std::nth_element(triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end,
+                         [&](const BuildTriangle<Box>& a, const BuildTriangle<Box>& b) { return a.centroid[longest] < b.centroid[longest]; });
+        return middle;
+    }
+
+    static int binIndex(double centroid, double minimum, double extent) {
+        int bin = static_cast<int>((centroid - minimum) / extent * MESH_BVH_BINS);
+        return std::min(bin, MESH_BVH_BINS - 1);
+    }
+
+    std::vector<BuildTriangle<Box>>& triangles;
+    std::vector<Node>& nodes;
+};
+
+// Construye el BVH sobre los triángulos (con sus cajas ya calculadas) y copia sus índices de vértice
+// en el orden de las hojas. La raíz siempre es un nodo: si toda la malla cabe en una hoja, el segundo
+// hijo es una caja vacía (mínimo mayor que el máximo) que ningún rayo atraviesa
+template <typename Box, typename Node>
+void buildTree(std::vector<BuildTriangle<Box>>& triangles, const std::vector<std::uint32_t>& meshIndices, std::vector<Node>& nodes, std::vector<std::uint32_t>& indices) {
+    BVHBuilder<Box, Node> builder(triangles, nodes);
+    Box rootBox;
+    std::uint32_t root = builder.build(0, triangles.size(), 0, rootBox);
+    if (root & MESH_LEAF_FLAG) {
+        Node node;
+        setChild(node, 0, rootBox, root);
+        setChild(node, 1, Box(), root);
+        nodes.push_back(node);
+    }
+
+    indices.reserve(triangles.size() * 3);
+    for (const BuildTriangle<Box>& triangle : triangles) {
+        for (int corner = 0; corner < 3; ++corner) {
+            indices.push_back(meshIndices[triangle.index * 3 + corner]);
+        }
+    }
+    nodes.shrink_to_fit();
+}
+
+// Intersección de un rayo con un triángulo (Möller-Trumbore, con los mismos umbrales que Triangle::intersects)
+bool intersectCorners(const Vector3D& a, const Vector3D& b, const Vector3D& c, const Ray& ray, double tMin, double tMax, double& t) {
+    Vector3D edge1 = b - a;
+    Vector3D edge2 = c - a;
+
+    Vector3D h = ray.getDirection().cross(edge2);
+    double det = edge1.dot(h);
+    if (std::fabs(det) < 1e-5) {
+        return false;
+    }
+
+    double invDet = 1.0 / det;
+    Vector3D s = ray.getOrigin() - a;
+    double u = invDet * s.dot(h);
+    if (u < 0.0 || u > 1.0) {
+        return false;
+    }
+
+    Vector3D q = s.cross(edge1);
+    double v = invDet * ray.getDirection().dot(q);
+    if (v < 0.0 || u + v > 1.0) {
+        return false;
+    }
+
+    double tHit = invDet * edge2.dot(q);
+    if (tHit > tMin && tHit < tMax) {
+        t = tHit;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * @brief Devuelve el número de triángulos.
+ * @return indices.size() / 3.
+ */
+size_t TriangleMesh::triangleCount() const {
+    return indices.size() / 3;
+}
+
+/**
+ * @brief Devuelve la memoria ocupada por los vértices y los índices.
+ * @return Bytes ocupados.
+ */
+size_t TriangleMesh::getMemoryBytes() const {
+    return vertices.size() * sizeof(Vector3D) + indices.size() * sizeof(std::uint32_t);
+}
+
+/**
+ * @brief Comprime una malla y construye su BVH.
+ *
+ * Los vértices se redondean al punto más cercano de la rejilla de 16 bits sobre la caja de la malla.
+ * El BVH se construye después sobre las cajas de los triángulos ya cuantizados; los triángulos se
+ * reordenan para que cada hoja sea un rango contiguo.
+ *
+ * @param mesh Malla en precisión completa.
+ * @param material Material de todos los triángulos.
+ */
+void CompressedMesh::build(const TriangleMesh& mesh, const MeshMaterial& material) {
+    this->material = material;
+    vertices.clear();
+    indices.clear();
+    nodes.clear();
+    size_t triangleCount = mesh.triangleCount();
+    if (triangleCount == 0) {
+        return;
+    }
+    if (triangleCount > MAX_TRIANGLES) {
+        throw std::length_error("CompressedMesh: demasiados triángulos");
+    }
+
+    // Rejilla de cuantización sobre la caja de la malla (un eje de extensión nula se guarda como 0)
+    double boundsMin[3], boundsMax[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        boundsMin[axis] = std::numeric_limits<double>::infinity();
+        boundsMax[axis] = -std::numeric_limits<double>::infinity();
+    }
+    for (const Vector3D& vertex : mesh.vertices) {
+        const double position[3] = { vertex.getX(), vertex.getY(), vertex.getZ() };
+        for (int axis = 0; axis < 3; ++axis) {
+            boundsMin[axis] = std::min(boundsMin[axis], position[axis]);
+            boundsMax[axis] = std::max(boundsMax[axis], position[axis]);
+        }
+    }
+    double inverseScale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        double extent = boundsMax[axis] - boundsMin[axis];
+        origin[axis] = boundsMin[axis];
+        scale[axis] = extent / MESH_QUANTIZATION_LEVELS;
+        inverseScale[axis] = extent > 0 ? MESH_QUANTIZATION_LEVELS / extent : 0.0;
+    }
+
+    vertices.reserve(mesh.vertices.size());
+    for (const Vector3D& vertex : mesh.vertices) {
+        const double position[3] = { vertex.getX(), vertex.getY(), vertex.getZ() };
+        std::uint16_t quantized[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            long level = std::lround((position[axis] - origin[axis]) * inverseScale[axis]);
+            quantized[axis] = static_cast<std::uint16_t>(std::max(0L, std::min(level, static_cast<long>(MESH_QUANTIZATION_LEVELS))));
+        }
+        vertices.push_back(QuantizedVertex{ quantized[0], quantized[1], quantized[2] });
+    }
+
+    std::vector<BuildTriangle<GridBox>> buildTriangles(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i) {
+        BuildTriangle<GridBox>& triangle = buildTriangles[i];
+        triangle.index = static_cast<std::uint32_t>(i);
+        for (int corner = 0; corner < 3; ++corner) {
+            const QuantizedVertex& vertex = vertices[mesh.indices[i * 3 + corner]];
+            const int position[3] = { vertex.x, vertex.y, vertex.z };
+            for (int axis = 0; axis < 3; ++axis) {
+                triangle.box.min[axis] = std::min(triangle.box.min[axis], position[axis]);
+                triangle.box.max[axis] = std::max(triangle.box.max[axis], position[axis]);
+            }
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            triangle.centroid[axis] = 0.5 * (triangle.box.min[axis] + triangle.box.max[axis]);
+        }
+    }
+
+    buildTree(buildTriangles, mesh.indices, nodes, indices);
+}
+
+/**
+ * @brief Escribe la malla en formato binario.
+ *
+ * Cabecera: número de vértices, de triángulos y de nodos (enteros de 32 bits), origen y paso de la
+ * rejilla y material (13 double). Después, los vértices, los índices y los nodos con su formato en
+ * memoria, en el orden de bytes de la máquina.
+ *
+ * @param out Flujo binario.
+ * @return true si se escribió correctamente.
+ */
+bool CompressedMesh::write(std::ostream& out) const {
+    const std::uint32_t counts[3] = { static_cast<std::uint32_t>(vertices.size()), static_cast<std::uint32_t>(size()), static_cast<std::uint32_t>(nodes.size()) };
+    const double header[SERIALIZED_DOUBLES] = { origin[0], origin[1], origin[2], scale[0], scale[1], scale[2],
+                                                material.color.getX(), material.color.getY(), material.color.getZ(),
+                                                material.specular, material.reflectivity, material.transparency, material.refractiveIndex };
+    out.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(QuantizedVertex));
+    out.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(std::uint32_t));
+    out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(CompressedBVHNode));
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Lee una malla escrita con write().
+ *
+ * Los nodos siempre se escriben después de su padre, así que basta una pasada para comprobar que
+ * cada referencia apunta hacia adelante (sin ciclos) y que ninguna rama supera MESH_BVH_MAX_DEPTH
+ * (el tamaño de la pila de traverse()).
+ *
+ * @param data Bytes de la malla.
+ * @param size Número de bytes.
+ * @return true si el bloque es válido.
+ */
+bool CompressedMesh::read(const unsigned char* data, size_t size) {
+    vertices.clear();
+    indices.clear();
+    nodes.clear();
+
+    std::uint32_t counts[3];
+    double header[SERIALIZED_DOUBLES];
+    size_t headerSize = sizeof(counts) + sizeof(header);
+    if (size < headerSize) {
+        return false;
+    }
+    std::memcpy(counts, data, sizeof(counts));
+    std::memcpy(header, data + sizeof(counts), sizeof(header));
+    size_t vertexBytes = static_cast<size_t>(counts[0]) * sizeof(QuantizedVertex);
+    size_t indexBytes = static_cast<size_t>(counts[1]) * 3 * sizeof(std::uint32_t);
+    size_t nodeBytes = static_cast<size_t>(counts[2]) * sizeof(CompressedBVHNode);
+    if (counts[1] > MAX_TRIANGLES || (counts[1] == 0) != (counts[2] == 0) || size != headerSize + vertexBytes + indexBytes + nodeBytes) {
+        return false;
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        origin[axis] = header[axis];
+        scale[axis] = header[3 + axis];
+    }
+    material.color = Vector3D(header[6], header[7], header[8]);
+    material.specular = header[9];
+    material.reflectivity = header[10];
+    material.transparency = header[11];
+    material.refractiveIndex = header[12];
+
+    const unsigned char* body = data + headerSize;
+    vertices.resize(counts[0]);
+    indices.resize(static_cast<size_t>(counts[1]) * 3);
+    nodes.resize(counts[2]);
+    std::memcpy(vertices.data(), body, vertexBytes);
+    std::memcpy(indices.data(), body + vertexBytes, indexBytes);
+    std::memcpy(nodes.data(), body + vertexBytes + indexBytes, nodeBytes);
+
+    bool valid = true;
+    for (std::uint32_t index : indices) {
+        valid = valid && index < counts[0];
+    }
+    std::vector<int> depth(nodes.size(), 0);
+    for (size_t i = 0; i < nodes.size() && valid; ++i) {
+        for (int side = 0; side < 2; ++side) {
+            std::uint32_t reference = nodes[i].child[side];
+            if (reference & MESH_LEAF_FLAG) {
+                size_t first = reference & LEAF_FIRST_MASK;
+                size_t count = ((reference >> LEAF_COUNT_SHIFT) & 0xF) + 1;
+                valid = valid && first + count <= counts[1];
+            } else if (reference <= i || reference >= nodes.size() || depth[i] + 1 > MESH_BVH_MAX_DEPTH) {
+                valid = false;
+            } else {
+                depth[reference] = std::max(depth[reference], depth[i] + 1);
+            }
+        }
+    }
+    if (!valid) {
+        vertices.clear();
+        indices.clear();
+        nodes.clear();
+    }
+    return valid;
+}
+
+/**
+ * @brief Recorre el BVH en orden de cercanía.
+ *
+ * El rayo se pasa una vez a la rejilla de cuantización (el parámetro t no cambia con una
+ * transformación afín por eje), así que las cajas de los hijos se prueban directamente con sus
+ * enteros de 16 bits. La pila guarda la distancia de entrada de cada referencia para descartar las
+ * que quedan detrás del impacto más cercano encontrado después de apilarlas.
+ *
+ * @param ray Rayo.
+ * @param tMax Distancia máxima inicial.
+ * @param visitLeaf Función que prueba los triángulos de una hoja.
+ */
+template <typename Visitor>
+void CompressedMesh::traverse(const Ray& ray, double tMax, Visitor&& visitLeaf) const {
+    if (nodes.empty()) {
+        return;
+    }
+
+    const double rayOrigin[3] = { ray.getOrigin().getX(), ray.getOrigin().getY(), ray.getOrigin().getZ() };
+    const double rayDirection[3] = { ray.getDirection().getX(), ray.getDirection().getY(), ray.getDirection().getZ() };
+    double gridOrigin[3], inverseDirection[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        double inverseScale = scale[axis] > 0 ? 1.0 / scale[axis] : 0.0;
+        gridOrigin[axis] = (rayOrigin[axis] - origin[axis]) * inverseScale;
+        inverseDirection[axis] = 1.0 / (rayDirection[axis] * inverseScale);
+    }
+
+    struct StackEntry {
+        std::uint32_t reference;
+        double tNear;
+    };
+    StackEntry stack[MESH_BVH_MAX_DEPTH + 2];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, 0.0 };
+
+    while (stackSize > 0) {
+        StackEntry entry = stack[--stackSize];
+        if (entry.tNear >= tMax) {
+            continue;
+        }
+        if (entry.reference & MESH_LEAF_FLAG) {
+            std::uint32_t first = entry.reference & LEAF_FIRST_MASK;
+            std::uint32_t count = ((entry.reference >> LEAF_COUNT_SHIFT) & 0xF) + 1;
+            if (visitLeaf(first, count, tMax)) {
+                return;
+            }
+            continue;
+        }
+
+        const CompressedBVHNode& node = nodes[entry.reference];
+        double tNear[2];
+        bool hit[2];
+        for (int side = 0; side < 2; ++side) {
+            double tEnter = 0.0, tExit = tMax;
+            for (int axis = 0; axis < 3; ++axis) {
+                double t0 = (node.childMin[side][axis] - BOX_PADDING - gridOrigin[axis]) * inverseDirection[axis];
+                double t1 = (node.childMax[side][axis] + BOX_PADDING - gridOrigin[axis]) * inverseDirection[axis];
+                if (inverseDirection[axis] < 0) {
+                    std::swap(t0, t1);
+                }
+                // Las comparaciones con NaN (rayo paralelo sobre el borde) no restringen el intervalo
+                tEnter = t0 > tEnter ? t0 : tEnter;
+                tExit = t1 < tExit ? t1 : tExit;
+            }
+            hit[side] = tEnter <= tExit;
+            tNear[side] = tEnter;
+        }
+
+        // Apilar primero el hijo más lejano para visitar antes el más cercano
+        int nearSide = (hit[0] && hit[1] && tNear[1] < tNear[0]) ? 1 : 0;
+        for (int k = 1; k >= 0; --k) {
+            int side = k == 0 ? nearSide : 1 - nearSide;
+            if (hit[side]) {
+                stack[stackSize++] = { node.child[side], tNear[side] };
+            }
+        }
+    }
+}
+
+/**
+ * @brief Busca el triángulo más cercano que intersecta un rayo.
+ * @param ray Rayo.
+ * @param tMax Solo se consideran impactos con t < tMax.
+ * @param t Distancia del impacto más cercano.
+ * @param index Índice del triángulo intersectado.
+ * @return true si hay impacto.
+ */
+bool CompressedMesh::intersect(const Ray& ray, double tMax, double& t, std::uint32_t& index) const {
+    bool found = false;
+    traverse(ray, tMax, [&](std::uint32_t first, std::uint32_t count, double& limit) {
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            double tHit;
+            if (intersectTriangle(i, ray, 1e-6, limit, tHit)) {
+                limit = tHit;
+                t = tHit;
+                index = i;
+                found = true;
+            }
+        }
+        return false;
+    });
+    return found;
+}
+
+/**
+ * @brief Comprueba si algún triángulo bloquea un rayo de sombra.
+ * @param ray Rayo.
+ * @param tMin Distancia mínima de los impactos que cuentan.
+ * @param tMax Distancia máxima de los impactos que cuentan.
+ * @return true si hay algún impacto entre tMin y tMax.
+ */
+bool CompressedMesh::occluded(const Ray& ray, double tMin, double tMax) const {
+    bool blocked = false;
+    traverse(ray, tMax, [&](std::uint32_t first, std::uint32_t count, double& limit) {
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            double tHit;
+            if (intersectTriangle(i, ray, tMin, limit, tHit)) {
+                blocked = true;
+                return true;
+            }
+        }
+        return false;
+    });
+    return blocked;
+}
+
+/**
+ * @brief Intersección de un rayo con un triángulo descomprimido.
+ *
+ * Usa los mismos umbrales que Triangle::intersects.
+ *
+ * @param index Índice del triángulo.
+ * @param ray Rayo.
+ * @param tMin Distancia mínima del impacto.
+ * @param tMax Distancia máxima del impacto (excluida).
+ * @param t Distancia del impacto.
+ * @return true si hay impacto.
+ */
+bool CompressedMesh::intersectTriangle(std::uint32_t index, const Ray& ray, double tMin, double tMax, double& t) const {
+    Vector3D a, b, c;
+    getTriangle(index, a, b, c);
+    return intersectCorners(a, b, c, ray, tMin, tMax, t);
+}
+
+/**
+ * @brief Descomprime un vértice cuantizado.
+ * @param vertex Vértice cuantizado.
+ * @return Posición en coordenadas del mundo.
+ */
+Vector3D CompressedMesh::decode(const QuantizedVertex& vertex) const {
+    return Vector3D(origin[0] + vertex.x * scale[0], origin[1] + vertex.y * scale[1], origin[2] + vertex.z * scale[2]);
+}
+
+/**
+ * @brief Descomprime los vértices de un triángulo.
+ * @param index Índice del triángulo.
+ * @param a Primer vértice.
+ * @param b Segundo vértice.
+ * @param c Tercer vértice.
+ */
+void CompressedMesh::getTriangle(std::uint32_t index, Vector3D& a, Vector3D& b, Vector3D& c) const {
+    const std::uint32_t* corners = &indices[static_cast<size_t>(index) * 3];
+    a = decode(vertices[corners[0]]);
+    b = decode(vertices[corners[1]]);
+    c = decode(vertices[corners[2]]);
+}
+
+/**
+ * @brief Devuelve la normal de un triángulo.
+ * @param index Índice del triángulo.
+ * @return Normal unitaria.
+ */
+Vector3D CompressedMesh::getNormal(std::uint32_t index) const {
+    Vector3D a, b, c;
+    getTriangle(index, a, b, c);
+    return (b - a).cross(c - a).normalize();
+}
+
+/**
+ * @brief Devuelve el material de la malla.
+ * @return Material.
+ */
+const MeshMaterial& CompressedMesh::getMaterial() const {
+    return material;
+}
+
+/**
+ * @brief Devuelve los vértices cuantizados.
+ * @return Vértices.
+ */
+const std::vector<QuantizedVertex>& CompressedMesh::getVertices() const {
+    return vertices;
+}
+
+/**
+ * @brief Devuelve los índices de los triángulos.
+ * @return Tres índices por triángulo.
+ */
+const std::vector<std::uint32_t>& CompressedMesh::getIndices() const {
+    return indices;
+}
+
+/**
+ * @brief Devuelve la caja envolvente de la malla.
+ * @param minimum Esquina mínima.
+ * @param maximum Esquina máxima.
+ */
+void CompressedMesh::getBounds(Vector3D& minimum, Vector3D& maximum) const {
+    minimum = Vector3D(origin[0], origin[1], origin[2]);
+    maximum = decode(QuantizedVertex{ MESH_QUANTIZATION_LEVELS, MESH_QUANTIZATION_LEVELS, MESH_QUANTIZATION_LEVELS });
+}
+
+/**
+ * @brief Devuelve el mayor paso de la rejilla de cuantización.
+ * @return Paso en unidades del mundo.
+ */
+double CompressedMesh::getQuantizationStep() const {
+    return std::max(scale[0], std::max(scale[1], scale[2]));
+}
+
+/**
+ * @brief Indica si no hay triángulos.
+ * @return true si la malla está vacía.
+ */
+bool CompressedMesh::empty() const {
+    return indices.empty();
+}
+
+/**
+ * @brief Devuelve el número de triángulos.
+ * @return Número de triángulos.
+ */
+size_t CompressedMesh::size() const {
+    return indices.size() / 3;
+}
+
+/**
+ * @brief Devuelve el número de nodos del BVH.
+ * @return Nodos internos.
+ */
+size_t CompressedMesh::getNodeCount() const {
+    return nodes.size();
+}
+
+/**
+ * @brief Devuelve la memoria ocupada por los vértices, los índices y el BVH.
+ * @return Bytes ocupados.
+ */
+size_t CompressedMesh::getMemoryBytes() const {
+    return vertices.size() * sizeof(QuantizedVertex) + indices.size() * sizeof(std::uint32_t) + nodes.size() * sizeof(CompressedBVHNode);
+}
+
+/**
+ * @brief Copia la malla y construye su BVH.
+ *
+ * Las cajas de los triángulos son las de sus vértices sin cuantizar; por lo demás el árbol se
+ * construye como el de CompressedMesh::build.
+ *
+ * @param mesh Malla en precisión completa.
+ */
+void MeshBVH::build(const TriangleMesh& mesh) {
+    vertices = mesh.vertices;
+    indices.clear();
+    nodes.clear();
+    size_t triangleCount = mesh.triangleCount();
+    if (triangleCount == 0) {
+        return;
+    }
+    if (triangleCount > MAX_TRIANGLES) {
+        throw std::length_error("MeshBVH: demasiados triángulos");
+    }
+
+    std::vector<BuildTriangle<WorldBox>> buildTriangles(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i) {
+        BuildTriangle<WorldBox>& triangle = buildTriangles[i];
+        triangle.index = static_cast<std::uint32_t>(i);
+        for (int corner = 0; corner < 3; ++corner) {
+            const Vector3D& vertex = vertices[mesh.indices[i * 3 + corner]];
+            const double position[3] = { vertex.getX(), vertex.getY(), vertex.getZ() };
+            for (int axis = 0; axis < 3; ++axis) {
+                triangle.box.min[axis] = std::min(triangle.box.min[axis], position[axis]);
+                triangle.box.max[axis] = std::max(triangle.box.max[axis], position[axis]);
+            }
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            triangle.centroid[axis] = 0.5 * (triangle.box.min[axis] + triangle.box.max[axis]);
+        }
+    }
+    buildTree(buildTriangles, mesh.indices, nodes, indices);
+}
+
+/**
+ * @brief Busca el triángulo más cercano que intersecta un rayo.
+ *
+ * Recorre el BVH como CompressedMesh::traverse (primero el hijo más cercano, descartando las entradas
+ * de la pila que quedan detrás del impacto), con las cajas en coordenadas del mundo.
+ *
+ * @param ray Rayo.
+ * @param tMax Solo se consideran impactos con t < tMax.
+ * @param t Distancia del impacto más cercano.
+ * @param index Índice del triángulo intersectado.
+ * @return true si hay impacto.
+ */
+bool MeshBVH::intersect(const Ray& ray, double tMax, double& t, std::uint32_t& index) const {
+    if (nodes.empty()) {
+        return false;
+    }
+
+    const double rayOrigin[3] = { ray.getOrigin().getX(), ray.getOrigin().getY(), ray.getOrigin().getZ() };
+    double inverseDirection[3] = { 1.0 / ray.getDirection().getX(), 1.0 / ray.getDirection().getY(), 1.0 / ray.getDirection().getZ() };
+
+    struct StackEntry {
+        std::uint32_t reference;
+        double tNear;
+    };
+    StackEntry stack[MESH_BVH_MAX_DEPTH + 2];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, 0.0 };
+    bool found = false;
+
+    while (stackSize > 0) {
+        StackEntry entry = stack[--stackSize];
+        if (entry.tNear >= tMax) {
+            continue;
+        }
+        if (entry.reference & MESH_LEAF_FLAG) {
+            std::uint32_t first = entry.reference & LEAF_FIRST_MASK;
+            std::uint32_t count = ((entry.reference >> LEAF_COUNT_SHIFT) & 0xF) + 1;
+            for (std::uint32_t i = first; i < first + count; ++i) {
+                const std::uint32_t* corners = &indices[static_cast<size_t>(i) * 3];
+                double tHit;
+                if (intersectCorners(vertices[corners[0]], vertices[corners[1]], vertices[corners[2]], ray, 1e-6, tMax, tHit)) {
+                    tMax = tHit;
+                    t = tHit;
+                    index = i;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        const MeshBVHNode& node = nodes[entry.reference];
+        double tNear[2];
+        bool hit[2];
+        for (int side = 0; side < 2; ++side) {
+            double tEnter = 0.0, tExit = tMax;
+            for (int axis = 0; axis < 3; ++axis) {
+                double t0 = (node.childMin[side][axis] - rayOrigin[axis]) * inverseDirection[axis];
+                double t1 = (node.childMax[side][axis] - rayOrigin[axis]) * inverseDirection[axis];
+                if (inverseDirection[axis] < 0) {
+                    std::swap(t0, t1);
+                }
+                tEnter = t0 > tEnter ? t0 : tEnter;
+                tExit = t1 < tExit ? t1 : tExit;
+            }
+            hit[side] = tEnter <= tExit;
+            tNear[side] = tEnter;
+        }
+
+        int nearSide = (hit[0] && hit[1] && tNear[1] < tNear[0]) ? 1 : 0;
+        for (int k = 1; k >= 0; --k) {
+            int side = k == 0 ? nearSide : 1 - nearSide;
+            if (hit[side]) {
+                stack[stackSize++] = { node.child[side], tNear[side] };
+            }
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Devuelve el número de triángulos.
+ * @return Número de triángulos.
+ */
+size_t MeshBVH::size() const {
+    return indices.size() / 3;
+}
+
+/**
+ * @brief Devuelve el número de nodos del BVH.
+ * @return Nodos internos.
+ */
+size_t MeshBVH::getNodeCount() const {
+    return nodes.size();
+}
+
+/**
+ * @brief Devuelve la memoria ocupada por los vértices, los índices y el BVH.
+ * @return Bytes ocupados.
+ */
+size_t MeshBVH::getMemoryBytes() const {
+    return vertices.size() * sizeof(Vector3D) + indices.size() * sizeof(std::uint32_t) + nodes.size() * sizeof(MeshBVHNode);
+}
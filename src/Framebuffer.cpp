@@ -0,0 +1,363 @@
+#include "Framebuffer.h"
+#include <algorithm> // Para std::min
+#include <cmath>     // Para std::pow y std::ldexp
+#include <cstring>   // Para std::memcpy
+#include <utility>   // Para std::move
+
+/**
+ * @brief Crea un framebuffer vacío.
+ */
+Framebuffer::Framebuffer() : width(0), rows(0), format(PixelFormat::SRGB8), bytesPerPixel(pixelFormatSize(PixelFormat::SRGB8)), pixels(nullptr) {}
+
+/**
+ * @brief Crea un framebuffer en negro.
+ * @param width Ancho en píxeles.
+ * @param rows Número de filas.
+ * @param format Formato de los píxeles.
+ */
+Framebuffer::Framebuffer(int width, int rows, PixelFormat format)
+    : width(width), rows(rows), format(format), bytesPerPixel(pixelFormatSize(format)),
+      data(static_cast<size_t>(width) * rows * pixelFormatSize(format), 0), pixels(data.data()) {
+    if (format == PixelFormat::RGBA_F32) {
+        // Alfa = 1 en todos los píxeles
+        for (size_t i = 0; i < static_cast<size_t>(width) * rows; ++i) {
+            float alpha = 1.0f;
+            std::memcpy(&data[i * bytesPerPixel + 3 * sizeof(float)], &alpha, sizeof(float));
+        }
+    }
+}
+
+/**
+ * @brief Crea un framebuffer sobre memoria externa.
+ * @param width Ancho en píxeles.
+ * @param rows Número de filas.
+ * @param format Formato de los píxeles.
+ * @param external Memoria de los píxeles.
+ */
+Framebuffer::Framebuffer(int width, int rows, PixelFormat format, unsigned char* external)
+    : width(width), rows(rows), format(format), bytesPerPixel(pixelFormatSize(format)), pixels(external) {}
+
+// Las copias siempre son dueñas de sus píxeles, aunque el original sea externo
+Framebuffer::Framebuffer(const Framebuffer& other)
+    : width(other.width), rows(other.rows), format(other.format), bytesPerPixel(other.bytesPerPixel),
+      data(other.pixels, other.pixels + other.getByteSize()), pixels(data.data()) {}
+
+Framebuffer::Framebuffer(Framebuffer&& other) noexcept
+    : width(other.width), rows(other.rows), format(other.format), bytesPerPixel(other.bytesPerPixel),
+      data(std::move(other.data)), pixels(other.isExternal() ? other.pixels : data.data()) {
+    other.width = other.rows = 0;
+    other.pixels = nullptr;
+}
+
+Framebuffer& Framebuffer::operator=(const Framebuffer& other) {
+    if (this != &other) {
+        *this = Framebuffer(other);
+    }
+    return *this;
+}
+
+Framebuffer& Framebuffer::operator=(Framebuffer&& other) noexcept {
+    if (this != &other) {
+        bool external = other.isExternal();
+        width = other.width;
+        rows = other.rows;
+        format = other.format;
+        bytesPerPixel = other.bytesPerPixel;
+        data = std::move(other.data);
+        pixels = external ? other.pixels : data.data();
+        other.width = other.rows = 0;
+        other.pixels = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * @brief Convierte un color y lo guarda en un píxel.
+ * @param x Columna.
+ * @param y Fila.
+ * @param color Color lineal.
+ */
+void Framebuffer::setPixel(int x, int y, const Vector3D& color) {
+    unsigned char* pixel = &pixels[(static_cast<size_t>(y) * width + x) * bytesPerPixel];
+    switch (format) {
+    case PixelFormat::SRGB8:
+        pixel[0] = encodeSRGB8(color.getX());
+        pixel[1] = encodeSRGB8(color.getY());
+        pixel[2] = encodeSRGB8(color.getZ());
+        break;
+    case PixelFormat::RGB_F16: {
+        std::uint16_t half[3] = { floatToHalf(static_cast<float>(color.getX())),
+                                  floatToHalf(static_cast<float>(color.getY())),
+                                  floatToHalf(static_cast<float>(color.getZ())) };
+        std::memcpy(pixel, half, sizeof(half));
+        break;
+    }
+    case PixelFormat::RGBA_F32: {
+        float rgba[4] = { static_cast<float>(color.getX()), static_cast<float>(color.getY()), static_cast<float>(color.getZ()), 1.0f };
+        std::memcpy(pixel, rgba, sizeof(rgba));
+        break;
+    }
+    }
+}
+
+/**
+ * @brief Lee un píxel como color lineal.
+ * @param x Columna.
+ * @param y Fila.
+ * @return Color lineal.
+ */
+Vector3D Framebuffer::getPixel(int x, int y) const {
+    const unsigned char* pixel = &pixels[(static_cast<size_t>(y) * width + x) * bytesPerPixel];
+    switch (format) {
+    case PixelFormat::SRGB8:
+        return Vector3D(decodeSRGB8(pixel[0]), decodeSRGB8(pixel[1]), decodeSRGB8(pixel[2]));
+    case PixelFormat::RGB_F16: {
+        std::uint16_t half[3];
+        std::memcpy(half, pixel, sizeof(half));
+        return Vector3D(halfToFloat(half[0]), halfToFloat(half[1]), halfToFloat(half[2]));
+    }
+    case PixelFormat::RGBA_F32: {
+        float rgba[4];
+        std::memcpy(rgba, pixel, sizeof(rgba));
+        return Vector3D(rgba[0], rgba[1], rgba[2]);
+    }
+    }
+    return Vector3D(0, 0, 0);
+}
+
+/**
+ * @brief Escribe una fila codificada en 8 bits con corrección gamma.
+ * @param y Fila.
+ * @param out Destino de getWidth() * 3 bytes.
+ */
+void Framebuffer::encodeRowSRGB8(int y, unsigned char* out) const {
+    if (format == PixelFormat::SRGB8) {
+        std::memcpy(out, getRow(y), getRowBytes());
+        return;
+    }
+    for (int x = 0; x < width; ++x) {
+        Vector3D color = getPixel(x, y);
+        out[x * 3 + 0] = encodeSRGB8(color.getX());
+        out[x * 3 + 1] = encodeSRGB8(color.getY());
+        out[x * 3 + 2] = encodeSRGB8(color.getZ());
+    }
+}
+
+/**
+ * @brief Copia otro framebuffer del mismo formato en una posición de este.
+ * @param source Framebuffer de origen.
+ * @param x Columna de destino.
+ * @param y Fila de destino.
+ */
+void Framebuffer::copyFrom(const Framebuffer& source, int x, int y) {
+    for (int row = 0; row < source.rows; ++row) {
+        std::memcpy(getRow(y + row) + static_cast<size_t>(x) * bytesPerPixel, source.getRow(row), source.getRowBytes());
+    }
+}
+
+/**
+ * @brief Devuelve una copia convertida a otro formato.
+ * @param format Formato de la copia.
+ * @return Framebuffer convertido.
+ */
+Framebuffer Framebuffer::convertTo(PixelFormat format) const {
+    if (format == this->format) {
+        return *this;
+    }
+    Framebuffer converted(width, rows, format);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < width; ++x) {
+            converted.setPixel(x, y, getPixel(x, y));
+        }
+    }
+    return converted;
+}
+
+int Framebuffer::getWidth() const {
+    return width;
+}
+
+int Framebuffer::getRows() const {
+    return rows;
+}
+
+PixelFormat Framebuffer::getFormat() const {
+    return format;
+}
+
+size_t Framebuffer::getBytesPerPixel() const {
+    return bytesPerPixel;
+}
+
+size_t Framebuffer::getRowBytes() const {
+    return static_cast<size_t>(width) * bytesPerPixel;
+}
+
+size_t Framebuffer::getByteSize() const {
+    return static_cast<size_t>(width) * rows * bytesPerPixel;
+}
+
+bool Framebuffer::isExternal() const {
+    return pixels != nullptr && pixels != data.data();
+}
+
+unsigned char* Framebuffer::getRow(int y) {
+    return pixels + static_cast<size_t>(y) * getRowBytes();
+}
+
+const unsigned char* Framebuffer::getRow(int y) const {
+    return pixels + static_cast<size_t>(y) * getRowBytes();
+}
+
+unsigned char* Framebuffer::getData() {
+    return pixels;
+}
+
+const unsigned char* Framebuffer::getData() const {
+    return pixels;
+}
+
+/**
+ * Devuelve el tamaño en bytes de un píxel de un formato.
+ *
+ * @param format: Formato de los píxeles.
+ * @return size_t: Bytes por píxel.
+ */
+size_t pixelFormatSize(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::RGB_F16:
+        return 3 * sizeof(std::uint16_t);
+    case PixelFormat::RGBA_F32:
+        return 4 * sizeof(float);
+    case PixelFormat::SRGB8:
+        return 3;
+    }
+    return 0;
+}
+
+/**
+ * Devuelve el nombre de un formato.
+ *
+ * @param format: Formato de los píxeles.
+ * @return const char*: Nombre del formato.
+ */
+const char* pixelFormatName(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::RGB_F16:
+        return "rgb16f";
+    case PixelFormat::RGBA_F32:
+        return "rgba32f";
+    case PixelFormat::SRGB8:
+        return "srgb8";
+    }
+    return "";
+}
+
+/**
+ * Interpreta el nombre de un formato.
+ *
+ * @param name: Nombre del formato.
+ * @param format: Formato leído.
+ * @return bool: true si el nombre es válido.
+ */
+bool parsePixelFormat(const std::string& name, PixelFormat& format) {
+    for (PixelFormat candidate : { PixelFormat::RGB_F16, PixelFormat::RGBA_F32, PixelFormat::SRGB8 }) {
+        if (name == pixelFormatName(candidate)) {
+            format = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Convierte un float a media precisión redondeando al par más cercano.
+ *
+ * @param value: Valor a convertir.
+ * @return std::uint16_t: Bits del valor en media precisión.
+ */
+std::uint16_t floatToHalf(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    std::uint32_t sign = (bits >> 16) & 0x8000u;
+    std::uint32_t magnitude = bits & 0x7fffffffu;
+
+    if (magnitude >= 0x7f800000u) {
+        // Infinito o NaN (el NaN conserva un bit de mantisa para no convertirse en infinito)
+        return static_cast<std::uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+    }
+    if (magnitude >= 0x477ff000u) {
+        // A partir de 65520 el redondeo supera el máximo representable (65504)
+        return static_cast<std::uint16_t>(sign | 0x7c00u);
+    }
+    if (magnitude < 0x38800000u) {
+        // Menor que 2^-14: subnormal en media precisión (o cero por debajo de 2^-25)
+        if (magnitude < 0x33000000u) {
+            return static_cast<std::uint16_t>(sign);
+        }
+        std::uint32_t exponent = magnitude >> 23;
+        std::uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+        std::uint32_t shift = 126 - exponent;
+        std::uint32_t half = mantissa >> shift;
+        std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+        std::uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<std::uint16_t>(sign | half);
+    }
+
+    // Normal: reajustar el sesgo del exponente (127 -> 15) y redondear los 13 bits descartados
+    std::uint32_t rounded = magnitude + 0xfffu + ((magnitude >> 13) & 1u);
+    return static_cast<std::uint16_t>(sign | ((rounded - 0x38000000u) >> 13));
+}
+
+/**
+ * Convierte un valor en media precisión a float.
+ *
+ * @param bits: Bits del valor en media precisión.
+ * @return float: Valor convertido.
+ */
+float halfToFloat(std::uint16_t bits) {
+    std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000u) << 16;
+    std::uint32_t exponent = (bits >> 10) & 0x1fu;
+    std::uint32_t mantissa = bits & 0x3ffu;
+
+    std::uint32_t result;
+    if (exponent == 0) {
+        // Cero o subnormal: mantisa * 2^-24
+        float value = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -value : value;
+    } else if (exponent == 0x1f) {
+        result = sign | 0x7f800000u | (mantissa << 13);
+    } else {
+        result = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &result, sizeof(value));
+    return value;
+}
+
+/**
+ * Codifica un canal lineal en 8 bits con corrección gamma.
+ *
+ * @param linear: Valor lineal.
+ * @return unsigned char: Valor codificado.
+ */
+unsigned char encodeSRGB8(double linear) {
+    double encoded = std::pow(linear, 1.0 / FRAMEBUFFER_GAMMA) * 255;
+    if (!(encoded > 0.0)) {
+        return 0; // También descarta el NaN de los valores negativos
+    }
+    return static_cast<unsigned char>(std::min(encoded, 255.0));
+}
+
+/**
+ * Decodifica un canal de 8 bits con corrección gamma.
+ *
+ * @param value: Valor codificado.
+ * @return double: Valor lineal.
+ */
+double decodeSRGB8(unsigned char value) {
+    return std::pow(value / 255.0, FRAMEBUFFER_GAMMA);
+}
@@ -0,0 +1,72 @@
+#include "Frustum.h"
+
+// Margen para absorber errores de redondeo: es preferible incluir un objeto de más que perder uno
+static const double FRUSTUM_EPSILON = 1e-6;
+
+/**
+ * @brief Construye el frustum a partir de su vértice y las direcciones de sus cuatro esquinas.
+ *
+ * Cada plano lateral contiene el vértice y dos esquinas consecutivas. Su normal se orienta hacia
+ * la dirección central del frustum, de modo que el orden de las esquinas puede ser cualquiera de los dos.
+ *
+ * @param apex Vértice del frustum.
+ * @param corner0 Dirección de la primera esquina.
+ * @param corner1 Dirección de la segunda esquina.
+ * @param corner2 Dirección de la tercera esquina.
+ * @param corner3 Dirección de la cuarta esquina.
+ */
+Frustum::Frustum(const Vector3D& apex, const Vector3D& corner0, const Vector3D& corner1, const Vector3D& corner2, const Vector3D& corner3)
+    : apex(apex) {
+    const Vector3D corners[4] = { corner0, corner1, corner2, corner3 };
+    Vector3D center = corner0 + corner1 + corner2 + corner3;
+
+    for (int i = 0; i < 4; ++i) {
+        Vector3D normal = corners[i].cross(corners[(i + 1) % 4]).normalize();
+        if (normal.dot(center) < 0) {
+            normal = -normal;
+        }
+        normals[i] = normal;
+    }
+}
+
+double Frustum::signedDistance(int i, const Vector3D& point) const {
+    return normals[i].dot(point - apex);
+}
+
+/**
+ * @brief Determina si una esfera puede intersectar el frustum.
+ *
+ * @param center Centro de la esfera.
+ * @param radius Radio de la esfera.
+ * @return true si la esfera no está completamente fuera de ningún plano lateral.
+ */
+bool Frustum::intersectsSphere(const Vector3D& center, double radius) const {
+    for (int i = 0; i < 4; ++i) {
+        if (signedDistance(i, center) < -radius - FRUSTUM_EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Determina si un triángulo puede intersectar el frustum.
+ *
+ * Como el triángulo es convexo, basta con que sus tres vértices estén fuera de un mismo plano
+ * lateral para descartarlo.
+ *
+ * @param a Primer vértice.
+ * @param b Segundo vértice.
+ * @param c Tercer vértice.
+ * @return true si el triángulo no está completamente fuera de ningún plano lateral.
+ */
+bool Frustum::intersectsTriangle(const Vector3D& a, const Vector3D& b, const Vector3D& c) const {
+    for (int i = 0; i < 4; ++i) {
+        if (signedDistance(i, a) < -FRUSTUM_EPSILON &&
+            signedDistance(i, b) < -FRUSTUM_EPSILON &&
+            signedDistance(i, c) < -FRUSTUM_EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -1,4 +1,5 @@
 #include "LightSource.h"
+#include <cmath> // Para std::sqrt, std::cos y std::sin
 
 /**
  * Constructor que inicializa el tipo, intensidad, posición y dirección de la luz.
@@ -11,6 +12,27 @@
 LightSource::LightSource(Type type, double intensity, const Vector3D& position, const Vector3D& direction)
     : type(type), intensity(intensity), position(position), direction(direction) {}
 
+/**
+ * Constructor de una luz de área rectangular.
+ *
+ * @param intensity: Intensidad total de la luz.
+ * @param center: Centro del rectángulo.
+ * @param edgeU: Vector de un lado del rectángulo.
+ * @param edgeV: Vector del otro lado del rectángulo.
+ */
+LightSource::LightSource(double intensity, const Vector3D& center, const Vector3D& edgeU, const Vector3D& edgeV)
+    : type(RECTANGLE), intensity(intensity), position(center), edgeU(edgeU), edgeV(edgeV) {}
+
+/**
+ * Constructor de una luz de área esférica.
+ *
+ * @param intensity: Intensidad total de la luz.
+ * @param center: Centro de la esfera.
+ * @param radius: Radio de la esfera.
+ */
+LightSource::LightSource(double intensity, const Vector3D& center, double radius)
+    : type(SPHERE), intensity(intensity), position(center), radius(radius) {}
+
 /**
  * @brief Obtiene el tipo de la luz.
  * @return Tipo de la luz.
@@ -42,3 +64,60 @@ Vector3D LightSource::getPosition() const {
 Vector3D LightSource::getDirection() const {
     return direction;
 }
+
+/**
+ * @brief Indica si la luz es de área.
+ * @return true para RECTANGLE y SPHERE.
+ */
+bool LightSource::isAreaLight() const {
+    return type == RECTANGLE || type == SPHERE;
+}
+
+/**
+ * @brief Obtiene los lados de una luz rectangular.
+ * @return Vector del lado correspondiente.
+ */
+Vector3D LightSource::getEdgeU() const {
+    return edgeU;
+}
+
+Vector3D LightSource::getEdgeV() const {
+    return edgeV;
+}
+
+/**
+ * @brief Obtiene el radio de una luz esférica.
+ * @return Radio de la esfera.
+ */
+double LightSource::getRadius() const {
+    return radius;
+}
+
+/**
+ * @brief Calcula un punto de muestreo sobre una luz de área.
+ *
+ * @param s: Primera coordenada en [0, 1).
+ * @param t: Segunda coordenada en [0, 1).
+ * @param from: Punto iluminado.
+ * @return Punto sobre la luz.
+ */
+Vector3D LightSource::samplePoint(double s, double t, const Vector3D& from) const {
+    if (type == RECTANGLE) {
+        return position + edgeU * (s - 0.5) + edgeV * (t - 0.5);
+    }
+
+    // Disco perpendicular a la dirección hacia el punto iluminado (mapeo polar que conserva el área)
+    Vector3D axis = from - position;
+    double axisLength = axis.norm();
+    if (axisLength == 0) {
+        return position;
+    }
+    axis = axis * (1.0 / axisLength);
+    Vector3D helper = std::fabs(axis.getX()) < 0.9 ? Vector3D(1, 0, 0) : Vector3D(0, 1, 0);
+    Vector3D tangent = axis.cross(helper).normalize();
+    Vector3D bitangent = axis.cross(tangent);
+
+    double r = radius * std::sqrt(s);
+    double angle = 2 * M_PI * t;
+    return position + tangent * (r * std::cos(angle)) + bitangent * (r * std::sin(angle));
+}
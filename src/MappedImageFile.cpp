@@ -0,0 +1,106 @@
+#include "MappedImageFile.h"
+#include <string> // Para std::to_string
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+MappedImageFile::~MappedImageFile() {
+    close();
+}
+
+/**
+ * @brief Crea el archivo con su tamaño final, escribe la cabecera y lo mapea.
+ *
+ * El cuerpo no se escribe: el archivo se agranda sin llenar, así que las páginas solo ocupan memoria
+ * cuando los hilos de render escriben en ellas.
+ *
+ * @param path Ruta del archivo.
+ * @param width Ancho de la imagen.
+ * @param height Alto de la imagen.
+ * @return true si el archivo quedó mapeado.
+ */
+bool MappedImageFile::open(const std::string& path, int width, int height) {
+    close();
+    std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    size_t size = header.size() + static_cast<size_t>(width) * height * 3;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    // El objeto de mapeo con el tamaño final agranda el archivo
+    HANDLE mappingObject = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32),
+                                              static_cast<DWORD>(size & 0xFFFFFFFFu), nullptr);
+    void* view = mappingObject ? MapViewOfFile(mappingObject, FILE_MAP_WRITE, 0, 0, size) : nullptr;
+    if (!view) {
+        if (mappingObject) {
+            CloseHandle(mappingObject);
+        }
+        CloseHandle(file);
+        DeleteFileA(path.c_str());
+        return false;
+    }
+    fileHandle = reinterpret_cast<std::intptr_t>(file);
+    mappingHandle = reinterpret_cast<std::intptr_t>(mappingObject);
+#else
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        return false;
+    }
+    void* view = ftruncate(file, static_cast<off_t>(size)) == 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0) : MAP_FAILED;
+    if (view == MAP_FAILED) {
+        ::close(file);
+        unlink(path.c_str());
+        return false;
+    }
+    fileHandle = file;
+#endif
+
+    mapping = static_cast<unsigned char*>(view);
+    mappedSize = size;
+    headerSize = header.size();
+    header.copy(reinterpret_cast<char*>(mapping), headerSize);
+    return true;
+}
+
+/**
+ * @brief Desmapea y cierra el archivo.
+ */
+void MappedImageFile::close() {
+#ifdef _WIN32
+    if (mapping) {
+        UnmapViewOfFile(mapping);
+    }
+    if (mappingHandle) {
+        CloseHandle(reinterpret_cast<HANDLE>(mappingHandle));
+    }
+    if (fileHandle != -1) {
+        CloseHandle(reinterpret_cast<HANDLE>(fileHandle));
+    }
+#else
+    if (mapping) {
+        munmap(mapping, mappedSize);
+    }
+    if (fileHandle != -1) {
+        ::close(static_cast<int>(fileHandle));
+    }
+#endif
+    mapping = nullptr;
+    mappedSize = headerSize = 0;
+    fileHandle = -1;
+    mappingHandle = 0;
+}
+
+bool MappedImageFile::isOpen() const {
+    return mapping != nullptr;
+}
+
+unsigned char* MappedImageFile::getPixels() const {
+    return mapping ? mapping + headerSize : nullptr;
+}
@@ -0,0 +1,657 @@
+#include "PagedGeometry.h"
+#include "sceneHash.h"  // Para Hasher
+#include <algorithm>    // Para std::min, std::max, std::sort y std::nth_element
+#include <cmath>        // Para std::fabs
+#include <cstring>      // Para std::memcmp y std::memcpy
+#include <iostream>     // Para std::cerr
+#include <limits>       // Para std::numeric_limits
+#include <sstream>      // Para std::ostringstream
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Identificador al inicio de cada archivo de geometría
+const char GEOMETRY_MAGIC[8] = { 'R', 'T', 'G', 'E', 'O', 'M', '1', '\n' };
+
+// Cabecera: identificador, número de chunks y posición de la tabla
+const size_t HEADER_SIZE = sizeof(GEOMETRY_MAGIC) + 2 * sizeof(std::uint64_t);
+
+// Entrada de la tabla: posición, tamaño, hash y triángulos (64 bits), caja y material (13 double)
+const int ENTRY_INTEGERS = 4;
+const int ENTRY_DOUBLES = 13;
+const size_t ENTRY_SIZE = ENTRY_INTEGERS * sizeof(std::uint64_t) + ENTRY_DOUBLES * sizeof(double);
+
+const size_t MAX_TRIANGLES_PER_CHUNK = size_t(1) << 27;  // Límite de CompressedMesh
+const double CHUNK_BOX_PADDING = 1e-7;                   // Margen relativo de las cajas de los chunks
+
+} // namespace
+
+/**
+ * @brief Crea el archivo y escribe una cabecera provisional (se completa en close()).
+ * @param path Ruta del archivo.
+ * @return true si el archivo se pudo crear.
+ */
+bool GeometryFileWriter::open(const std::string& path) {
+    this->path = path;
+    chunks.clear();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo abrir " << path << " para escritura." << std::endl;
+        return false;
+    }
+    const char header[HEADER_SIZE] = {};
+    file.write(header, sizeof(header));
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief Comprime un trozo de geometría y lo agrega como un chunk.
+ *
+ * El chunk se serializa primero en memoria para calcular su tamaño y su hash.
+ *
+ * @param mesh Malla del chunk.
+ * @param material Material de sus triángulos.
+ * @return true si se escribió.
+ */
+bool GeometryFileWriter::addChunk(const TriangleMesh& mesh, const MeshMaterial& material) {
+    if (mesh.triangleCount() == 0) {
+        return static_cast<bool>(file);
+    }
+    CompressedMesh compressed;
+    compressed.build(mesh, material);
+    std::ostringstream bytes(std::ios::binary);
+    compressed.write(bytes);
+    std::string data = bytes.str();
+
+    GeometryChunkInfo info;
+    info.offset = static_cast<std::uint64_t>(file.tellp());
+    info.size = data.size();
+    Hasher hasher;
+    hasher.addBytes(data.data(), data.size());
+    info.hash = hasher.value();
+    info.triangles = compressed.size();
+    compressed.getBounds(info.boundsMin, info.boundsMax);
+    info.material = material;
+    chunks.push_back(info);
+
+    file.write(data.data(), data.size());
+    if (!file) {
+        std::cerr << "Error: No se pudo escribir en " << path << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Escribe la tabla de chunks y completa la cabecera.
+ * @return true si el archivo quedó completo.
+ */
+bool GeometryFileWriter::close() {
+    if (!file.is_open()) {
+        return false;
+    }
+    std::uint64_t tableOffset = static_cast<std::uint64_t>(file.tellp());
+    for (const GeometryChunkInfo& info : chunks) {
+        const std::uint64_t integers[ENTRY_INTEGERS] = { info.offset, info.size, info.hash, info.triangles };
+        const double doubles[ENTRY_DOUBLES] = { info.boundsMin.getX(), info.boundsMin.getY(), info.boundsMin.getZ(),
+                                                info.boundsMax.getX(), info.boundsMax.getY(), info.boundsMax.getZ(),
+                                                info.material.color.getX(), info.material.color.getY(), info.material.color.getZ(),
+                                                info.material.specular, info.material.reflectivity, info.material.transparency,
+                                                info.material.refractiveIndex };
+        file.write(reinterpret_cast<const char*>(integers), sizeof(integers));
+        file.write(reinterpret_cast<const char*>(doubles), sizeof(doubles));
+    }
+
+    const std::uint64_t header[2] = { chunks.size(), tableOffset };
+    file.seekp(0);
+    file.write(GEOMETRY_MAGIC, sizeof(GEOMETRY_MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    bool written = static_cast<bool>(file);
+    file.close();
+    if (!written) {
+        std::cerr << "Error: No se pudo completar " << path << "." << std::endl;
+    }
+    return written;
+}
+
+size_t GeometryFileWriter::getChunkCount() const {
+    return chunks.size();
+}
+
+size_t GeometryFileWriter::getTriangleCount() const {
+    size_t total = 0;
+    for (const GeometryChunkInfo& info : chunks) {
+        total += info.triangles;
+    }
+    return total;
+}
+
+PagedGeometry::~PagedGeometry() {
+    close();
+}
+
+/**
+ * @brief Mapea el archivo en solo lectura, valida la tabla de chunks y construye el BVH de chunks.
+ *
+ * Los chunks no se leen: el contenido de cada uno se valida (CompressedMesh::read) la primera vez
+ * que se carga.
+ *
+ * @param path Ruta del archivo.
+ * @param cacheBytes Memoria máxima de los chunks residentes.
+ * @return true si el archivo es válido.
+ */
+bool PagedGeometry::open(const std::string& path, size_t cacheBytes) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: No se pudo abrir " << path << "." << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE mappingObject = GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= static_cast<LONGLONG>(HEADER_SIZE)
+                               ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+                               : nullptr;
+    void* view = mappingObject ? MapViewOfFile(mappingObject, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mappingObject) {
+            CloseHandle(mappingObject);
+        }
+        CloseHandle(file);
+        std::cerr << "Error: " << path << " no es un archivo de geometría válido." << std::endl;
+        return false;
+    }
+    fileHandle = reinterpret_cast<std::intptr_t>(file);
+    mappingHandle = reinterpret_cast<std::intptr_t>(mappingObject);
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        std::cerr << "Error: No se pudo abrir " << path << "." << std::endl;
+        return false;
+    }
+    struct stat status;
+    void* view = fstat(file, &status) == 0 && status.st_size >= static_cast<off_t>(HEADER_SIZE)
+                     ? mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0)
+                     : MAP_FAILED;
+    if (view == MAP_FAILED) {
+        ::close(file);
+        std::cerr << "Error: " << path << " no es un archivo de geometría válido." << std::endl;
+        return false;
+    }
+    fileHandle = file;
+    mappedSize = static_cast<size_t>(status.st_size);
+#endif
+    mapping = static_cast<unsigned char*>(view);
+    this->cacheBytes = cacheBytes;
+
+    // Cabecera y tabla de chunks
+    std::uint64_t header[2];
+    std::memcpy(header, mapping + sizeof(GEOMETRY_MAGIC), sizeof(header));
+    std::uint64_t chunkCount = header[0], tableOffset = header[1];
+    bool valid = std::memcmp(mapping, GEOMETRY_MAGIC, sizeof(GEOMETRY_MAGIC)) == 0 && chunkCount < std::numeric_limits<std::uint32_t>::max() &&
+                 tableOffset >= HEADER_SIZE && tableOffset <= mappedSize && chunkCount <= (mappedSize - tableOffset) / ENTRY_SIZE;
+    for (std::uint64_t i = 0; valid && i < chunkCount; ++i) {
+        std::uint64_t integers[ENTRY_INTEGERS];
+        double doubles[ENTRY_DOUBLES];
+        const unsigned char* entry = mapping + tableOffset + i * ENTRY_SIZE;
+        std::memcpy(integers, entry, sizeof(integers));
+        std::memcpy(doubles, entry + sizeof(integers), sizeof(doubles));
+
+        GeometryChunkInfo info;
+        info.offset = integers[0];
+        info.size = integers[1];
+        info.hash = integers[2];
+        info.triangles = integers[3];
+        info.boundsMin = Vector3D(doubles[0], doubles[1], doubles[2]);
+        info.boundsMax = Vector3D(doubles[3], doubles[4], doubles[5]);
+        info.material.color = Vector3D(doubles[6], doubles[7], doubles[8]);
+        info.material.specular = doubles[9];
+        info.material.reflectivity = doubles[10];
+        info.material.transparency = doubles[11];
+        info.material.refractiveIndex = doubles[12];
+        valid = info.offset >= HEADER_SIZE && info.offset <= tableOffset && info.size <= tableOffset - info.offset &&
+                info.triangles > 0 && info.triangles <= MAX_TRIANGLES_PER_CHUNK;
+        chunks.push_back(info);
+        triangleCount += info.triangles;
+    }
+    if (!valid) {
+        std::cerr << "Error: " << path << " no es un archivo de geometría válido." << std::endl;
+        close();
+        return false;
+    }
+
+    if (!chunks.empty()) {
+        std::vector<std::uint32_t> order(chunks.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = static_cast<std::uint32_t>(i);
+        }
+        buildNode(order, 0, order.size());
+    }
+    resident.assign(chunks.size(), ResidentChunk());
+    return true;
+}
+
+/**
+ * @brief Vacía la caché, desmapea y cierra el archivo.
+ */
+void PagedGeometry::close() {
+    resetCache();
+    resident.clear();
+    chunks.clear();
+    nodes.clear();
+    triangleCount = 0;
+#ifdef _WIN32
+    if (mapping) {
+        UnmapViewOfFile(mapping);
+    }
+    if (mappingHandle) {
+        CloseHandle(reinterpret_cast<HANDLE>(mappingHandle));
+    }
+    if (fileHandle != -1) {
+        CloseHandle(reinterpret_cast<HANDLE>(fileHandle));
+    }
+#else
+    if (mapping) {
+        munmap(mapping, mappedSize);
+    }
+    if (fileHandle != -1) {
+        ::close(static_cast<int>(fileHandle));
+    }
+#endif
+    mapping = nullptr;
+    mappedSize = 0;
+    fileHandle = -1;
+    mappingHandle = 0;
+}
+
+/**
+ * @brief Construye el BVH de chunks dividiendo por la mediana de los centros en el eje más largo.
+ *
+ * Con una hoja por chunk la profundidad es log2 del número de chunks, muy por debajo de
+ * GEOMETRY_TOP_MAX_DEPTH.
+ *
+ * @param order Índices de los chunks (se reordenan).
+ * @param begin Primer chunk del rango.
+ * @param end Chunk siguiente al último del rango.
+ * @return Índice del nodo construido.
+ */
+std::uint32_t PagedGeometry::buildNode(std::vector<std::uint32_t>& order, size_t begin, size_t end) {
+    ChunkNode node;
+    for (int axis = 0; axis < 3; ++axis) {
+        node.min[axis] = std::numeric_limits<double>::infinity();
+        node.max[axis] = -std::numeric_limits<double>::infinity();
+    }
+    for (size_t i = begin; i < end; ++i) {
+        const GeometryChunkInfo& info = chunks[order[i]];
+        const double minimum[3] = { info.boundsMin.getX(), info.boundsMin.getY(), info.boundsMin.getZ() };
+        const double maximum[3] = { info.boundsMax.getX(), info.boundsMax.getY(), info.boundsMax.getZ() };
+        for (int axis = 0; axis < 3; ++axis) {
+            // El margen absorbe el redondeo entre la caja guardada y los vértices descomprimidos
+            double padding = CHUNK_BOX_PADDING * (maximum[axis] - minimum[axis] + std::max(std::fabs(minimum[axis]), std::fabs(maximum[axis])) + 1.0);
+            node.min[axis] = std::min(node.min[axis], minimum[axis] - padding);
+            node.max[axis] = std::max(node.max[axis], maximum[axis] + padding);
+        }
+    }
+
+    std::uint32_t nodeIndex = static_cast<std::uint32_t>(nodes.size());
+    nodes.push_back(node);
+    if (end - begin == 1) {
+        nodes[nodeIndex].leaf = true;
+        nodes[nodeIndex].left = order[begin];
+        nodes[nodeIndex].right = 0;
+        return nodeIndex;
+    }
+
+    int longest = 0;
+    for (int axis = 1; axis < 3; ++axis) {
+        if (node.max[axis] - node.min[axis] > node.max[longest] - node.min[longest]) {
+            longest = axis;
+        }
+    }
+    auto center = [&](std::uint32_t chunk) {
+        const GeometryChunkInfo& info = chunks[chunk];
+        const double sum[3] = { info.boundsMin.getX() + info.boundsMax.getX(), info.boundsMin.getY() + info.boundsMax.getY(),
+                                info.boundsMin.getZ() + info.boundsMax.getZ() };
+        return sum[longest];
+    };
+    size_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                     [&](std::uint32_t a, std::uint32_t b) { return center(a) < center(b); });
+
+    std::uint32_t left = buildNode(order, begin, middle);
+    std::uint32_t right = buildNode(order, middle, end);
+    nodes[nodeIndex].leaf = false;
+    nodes[nodeIndex].left = left;
+    nodes[nodeIndex].right = right;
+    return nodeIndex;
+}
+
+/**
+ * @brief Agrega los chunks cuya caja atraviesa el rayo antes de tMax.
+ * @param ray Rayo.
+ * @param tMax Distancia máxima.
+ * @param entries Chunks encontrados con su distancia de entrada (sin ordenar).
+ */
+void PagedGeometry::findChunks(const Ray& ray, double tMax, std::vector<ChunkEntry>& entries) const {
+    if (nodes.empty()) {
+        return;
+    }
+    const double origin[3] = { ray.getOrigin().getX(), ray.getOrigin().getY(), ray.getOrigin().getZ() };
+    const double inverseDirection[3] = { 1.0 / ray.getDirection().getX(), 1.0 / ray.getDirection().getY(), 1.0 / ray.getDirection().getZ() };
+
+    std::uint32_t stack[GEOMETRY_TOP_MAX_DEPTH + 2];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const ChunkNode& node = nodes[stack[--stackSize]];
+        double tEnter = 0.0, tExit = tMax;
+        for (int axis = 0; axis < 3; ++axis) {
+            double t0 = (node.min[axis] - origin[axis]) * inverseDirection[axis];
+            double t1 = (node.max[axis] - origin[axis]) * inverseDirection[axis];
+            if (inverseDirection[axis] < 0) {
+                std::swap(t0, t1);
+            }
+            // Las comparaciones con NaN (rayo paralelo sobre el borde) no restringen el intervalo
+            tEnter = t0 > tEnter ? t0 : tEnter;
+            tExit = t1 < tExit ? t1 : tExit;
+        }
+        if (tEnter > tExit) {
+            continue;
+        }
+        if (node.leaf) {
+            entries.push_back({ node.left, tEnter });
+        } else {
+            stack[stackSize++] = node.left;
+            stack[stackSize++] = node.right;
+        }
+    }
+}
+
+/**
+ * @brief Devuelve un chunk residente y lo marca como el usado más recientemente.
+ *
+ * La lectura se hace fuera del cerrojo para no detener a los hilos que usan otros chunks; si dos
+ * hilos leen el mismo chunk a la vez, se conserva el primero. Al agregar un chunk se descartan los
+ * menos usados hasta volver al límite de memoria.
+ *
+ * @param chunk Índice del chunk.
+ * @param load Si es false y el chunk no está residente, devuelve nullptr sin leerlo.
+ * @return Chunk residente.
+ */
+std::shared_ptr<const CompressedMesh> PagedGeometry::acquire(std::uint32_t chunk, bool load) const {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        ResidentChunk& slot = resident[chunk];
+        if (slot.mesh) {
+            lru.splice(lru.begin(), lru, slot.position);
+            stats.cacheHits++;
+            return slot.mesh;
+        }
+        if (!load) {
+            return nullptr;
+        }
+    }
+
+    const GeometryChunkInfo& info = chunks[chunk];
+    std::shared_ptr<CompressedMesh> mesh = std::make_shared<CompressedMesh>();
+    if (!mesh->read(mapping + info.offset, static_cast<size_t>(info.size))) {
+        std::cerr << "Aviso: el chunk " << chunk << " del archivo de geometría está dañado y se ignora" << std::endl;
+    }
+    releasePages(info);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    ResidentChunk& slot = resident[chunk];
+    if (slot.mesh) {
+        lru.splice(lru.begin(), lru, slot.position);
+        stats.cacheHits++;
+        return slot.mesh;
+    }
+    lru.push_front(chunk);
+    slot.mesh = mesh;
+    slot.position = lru.begin();
+    stats.pageIns++;
+    stats.residentBytes += mesh->getMemoryBytes();
+    stats.peakResidentBytes = std::max(stats.peakResidentBytes, stats.residentBytes);
+    while (stats.residentBytes > cacheBytes && lru.size() > 1) {
+        ResidentChunk& victim = resident[lru.back()];
+        stats.residentBytes -= victim.mesh->getMemoryBytes();
+        stats.evictions++;
+        victim.mesh.reset();
+        lru.pop_back();
+    }
+    return mesh;
+}
+
+/**
+ * @brief Libera las páginas del archivo mapeado que ocupa un chunk ya copiado a la caché.
+ *
+ * Las páginas son de solo lectura y no se modificaron, así que el sistema solo las descarta; si
+ * comparten página con un chunk vecino, este vuelve a leerla del archivo cuando la necesite.
+ *
+ * @param info Chunk.
+ */
+void PagedGeometry::releasePages(const GeometryChunkInfo& info) const {
+#ifdef _WIN32
+    // Desbloquear un rango no bloqueado lo quita del conjunto de trabajo del proceso
+    VirtualUnlock(mapping + info.offset, static_cast<SIZE_T>(info.size));
+#else
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = static_cast<size_t>(info.offset) / pageSize * pageSize;
+    madvise(mapping + begin, static_cast<size_t>(info.offset + info.size) - begin, MADV_DONTNEED);
+#endif
+}
+
+/**
+ * @brief Busca el triángulo más cercano que intersecta un rayo.
+ * @param ray Rayo.
+ * @param tMax Solo se consideran impactos con t < tMax.
+ * @param hit Impacto más cercano.
+ * @return true si hay impacto.
+ */
+bool PagedGeometry::intersect(const Ray& ray, double tMax, PagedHit& hit) const {
+    std::vector<ChunkEntry> entries;
+    findChunks(ray, tMax, entries);
+    std::sort(entries.begin(), entries.end(), [](const ChunkEntry& a, const ChunkEntry& b) { return a.tNear < b.tNear; });
+
+    hit.found = false;
+    double limit = tMax;
+    for (const ChunkEntry& entry : entries) {
+        if (entry.tNear >= limit) {
+            break;
+        }
+        std::shared_ptr<const CompressedMesh> mesh = acquire(entry.chunk);
+        double t;
+        std::uint32_t index;
+        if (mesh->intersect(ray, limit, t, index)) {
+            limit = t;
+            hit.found = true;
+            hit.t = t;
+            hit.chunk = entry.chunk;
+            hit.triangle = index;
+            hit.normal = mesh->getNormal(index);
+        }
+    }
+    return hit.found;
+}
+
+/**
+ * @brief Comprueba si algún triángulo bloquea un rayo de sombra.
+ *
+ * Primero se prueban los chunks ya residentes: cualquier oclusor sirve, así que un impacto en ellos
+ * evita leer los demás.
+ *
+ * @param ray Rayo.
+ * @param tMin Distancia mínima de los impactos que cuentan.
+ * @param tMax Distancia máxima de los impactos que cuentan.
+ * @return true si hay algún impacto entre tMin y tMax.
+ */
+bool PagedGeometry::occluded(const Ray& ray, double tMin, double tMax) const {
+    std::vector<ChunkEntry> entries;
+    findChunks(ray, tMax, entries);
+    std::vector<ChunkEntry> missing;
+    for (const ChunkEntry& entry : entries) {
+        std::shared_ptr<const CompressedMesh> mesh = acquire(entry.chunk, false);
+        if (!mesh) {
+            missing.push_back(entry);
+        } else if (mesh->occluded(ray, tMin, tMax)) {
+            return true;
+        }
+    }
+    for (const ChunkEntry& entry : missing) {
+        if (acquire(entry.chunk)->occluded(ray, tMin, tMax)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Intersecta un lote de rayos leyendo cada chunk a lo sumo una vez.
+ * @param rays Rayos del lote.
+ * @param tMax Solo se consideran impactos con t < tMax.
+ * @param hits Impacto más cercano de cada rayo.
+ */
+void PagedGeometry::intersectBatch(const std::vector<Ray>& rays, double tMax, std::vector<PagedHit>& hits) const {
+    intersectBatch(rays, std::vector<double>(rays.size(), tMax), hits);
+}
+
+/**
+ * @brief Intersecta un lote de rayos con una distancia máxima por rayo, leyendo cada chunk a lo sumo una vez.
+ * @param rays Rayos del lote.
+ * @param tMax Distancia máxima de cada rayo.
+ * @param hits Impacto más cercano de cada rayo.
+ */
+void PagedGeometry::intersectBatch(const std::vector<Ray>& rays, const std::vector<double>& tMax, std::vector<PagedHit>& hits) const {
+    hits.assign(rays.size(), PagedHit());
+
+    // Cola de (chunk, rayo) y distancia de entrada más cercana de cada chunk
+    struct QueuedRay {
+        std::uint32_t chunk;
+        std::uint32_t ray;
+        double tNear;
+    };
+    std::vector<QueuedRay> queue;
+    std::vector<ChunkEntry> entries;
+    std::vector<double> chunkNear(chunks.size(), std::numeric_limits<double>::infinity());
+    for (size_t i = 0; i < rays.size(); ++i) {
+        entries.clear();
+        findChunks(rays[i], tMax[i], entries);
+        for (const ChunkEntry& entry : entries) {
+            queue.push_back({ entry.chunk, static_cast<std::uint32_t>(i), entry.tNear });
+            chunkNear[entry.chunk] = std::min(chunkNear[entry.chunk], entry.tNear);
+        }
+    }
+
+    // Primero los chunks residentes (no cuestan una lectura) y después los más cercanos, que acortan
+    // los rayos y permiten descartar entradas de los chunks lejanos sin leerlos
+    std::vector<char> isResident(chunks.size(), 0);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        for (const QueuedRay& entry : queue) {
+            isResident[entry.chunk] = resident[entry.chunk].mesh != nullptr;
+        }
+        stats.batches++;
+    }
+    std::sort(queue.begin(), queue.end(), [&](const QueuedRay& a, const QueuedRay& b) {
+        if (isResident[a.chunk] != isResident[b.chunk]) {
+            return isResident[a.chunk] > isResident[b.chunk];
+        }
+        if (chunkNear[a.chunk] != chunkNear[b.chunk]) {
+            return chunkNear[a.chunk] < chunkNear[b.chunk];
+        }
+        return a.chunk != b.chunk ? a.chunk < b.chunk : a.ray < b.ray;
+    });
+
+    std::vector<double> limit(tMax);
+    for (size_t begin = 0; begin < queue.size();) {
+        size_t end = begin;
+        while (end < queue.size() && queue[end].chunk == queue[begin].chunk) {
+            ++end;
+        }
+        std::shared_ptr<const CompressedMesh> mesh;
+        for (size_t k = begin; k < end; ++k) {
+            const QueuedRay& entry = queue[k];
+            if (entry.tNear >= limit[entry.ray]) {
+                continue;
+            }
+            if (!mesh) {
+                mesh = acquire(entry.chunk);
+            }
+            double t;
+            std::uint32_t index;
+            if (mesh->intersect(rays[entry.ray], limit[entry.ray], t, index)) {
+                limit[entry.ray] = t;
+                PagedHit& hit = hits[entry.ray];
+                hit.found = true;
+                hit.t = t;
+                hit.chunk = entry.chunk;
+                hit.triangle = index;
+                hit.normal = mesh->getNormal(index);
+            }
+        }
+        begin = end;
+    }
+}
+
+bool PagedGeometry::isOpen() const {
+    return mapping != nullptr;
+}
+
+const std::vector<GeometryChunkInfo>& PagedGeometry::getChunks() const {
+    return chunks;
+}
+
+const MeshMaterial& PagedGeometry::getMaterial(std::uint32_t chunk) const {
+    return chunks[chunk].material;
+}
+
+size_t PagedGeometry::getTriangleCount() const {
+    return triangleCount;
+}
+
+size_t PagedGeometry::getFileBytes() const {
+    return mappedSize;
+}
+
+size_t PagedGeometry::getCacheBytes() const {
+    return cacheBytes;
+}
+
+/**
+ * @brief Devuelve los contadores de la caché.
+ * @return Copia de los contadores.
+ */
+PagedGeometryStats PagedGeometry::getStats() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    PagedGeometryStats current = stats;
+    current.residentChunks = lru.size();
+    return current;
+}
+
+/**
+ * @brief Descarta todos los chunks residentes y pone los contadores a cero.
+ */
+void PagedGeometry::resetCache() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    for (ResidentChunk& slot : resident) {
+        slot.mesh.reset();
+    }
+    lru.clear();
+    stats = PagedGeometryStats();
+}
+
+void writePagedGeometryStats(std::ostream& out, const PagedGeometryStats& stats) {
+    out << stats.pageIns << " chunks leídos del archivo, " << stats.cacheHits << " aciertos de la caché, " << stats.evictions
+        << " descartados; residentes " << stats.residentChunks << " chunks, " << stats.residentBytes / (1024.0 * 1024.0)
+        << " MB (máximo " << stats.peakResidentBytes / (1024.0 * 1024.0) << " MB)";
+}
@@ -0,0 +1,279 @@
+#include "PathTracer.h"
+#include "generateImage.h"
+#include "TilePool.h"
+#include "utils.h"
+#include <algorithm> // Para std::min, std::max y std::swap
+#include <chrono>    // Para medir el tiempo de render
+#include <cmath>     // Para std::sqrt, std::cos y std::sin
+#include <limits>    // Para std::numeric_limits
+
+namespace {
+
+// Producto componente a componente
+Vector3D multiply(const Vector3D& a, const Vector3D& b) {
+    return Vector3D(a.getX() * b.getX(), a.getY() * b.getY(), a.getZ() * b.getZ());
+}
+
+// Dirección con distribución coseno alrededor de la normal
+Vector3D sampleCosineHemisphere(const Vector3D& normal, double u1, double u2) {
+    Vector3D helper = std::fabs(normal.getX()) < 0.9 ? Vector3D(1, 0, 0) : Vector3D(0, 1, 0);
+    Vector3D tangent = normal.cross(helper).normalize();
+    Vector3D bitangent = normal.cross(tangent);
+
+    double r = std::sqrt(u1);
+    double angle = 2 * M_PI * u2;
+    double z = std::sqrt(std::max(0.0, 1 - u1));
+    return (tangent * (r * std::cos(angle)) + bitangent * (r * std::sin(angle)) + normal * z).normalize();
+}
+
+} // namespace
+
+/**
+ * @brief Crea el integrador y precalcula la radiancia del entorno.
+ * @param scene Escena a renderizar.
+ * @param maxBounces Rebotes máximos por camino.
+ */
+PathTracer::PathTracer(const Scene& scene, int maxBounces)
+    : scene(scene), maxBounces(maxBounces), environment(0.0) {
+    for (const auto& light : scene.getLights()) {
+        if (light.getType() == LightSource::AMBIENT) {
+            environment += light.getIntensity();
+        }
+    }
+}
+
+/**
+ * @brief Estima la irradiancia directa en un punto con un rayo de sombra por luz.
+ *
+ * @param point Punto de la superficie.
+ * @param normal Normal orientada hacia el lado del que llega el camino.
+ * @param random Secuencia aleatoria de la muestra.
+ * @return Irradiancia directa.
+ */
+double PathTracer::directLighting(const Vector3D& point, const Vector3D& normal, RandomSequence& random) const {
+    double irradiance = 0.0;
+    for (const auto& light : scene.getLights()) {
+        Vector3D lightDirection;
+        double distance;
+
+        if (light.getType() == LightSource::AMBIENT) {
+            continue; // Se incluye como radiancia del entorno
+        } else if (light.getType() == LightSource::DIRECTIONAL) {
+            lightDirection = light.getDirection().normalize();
+            distance = std::numeric_limits<double>::infinity();
+        } else {
+            // Luz puntual o un punto aleatorio de una luz de área
+            Vector3D target = light.getPosition();
+            if (light.isAreaLight()) {
+                double s = random.next();
+                double t = random.next();
+                target = light.samplePoint(s, t, point);
+            }
+            Vector3D toLight = target - point;
+            distance = toLight.norm();
+            if (distance == 0) {
+                continue;
+            }
+            lightDirection = toLight * (1.0 / distance);
+        }
+
+        double cosine = normal.dot(lightDirection);
+        if (cosine <= 0 || scene.isInShadow(point, lightDirection, distance)) {
+            continue;
+        }
+        irradiance += light.getIntensity() * cosine;
+    }
+    return irradiance;
+}
+
+/**
+ * @brief Traza un camino completo y devuelve la radiancia estimada.
+ *
+ * @param ray Rayo primario.
+ * @param candidates Primitivas candidatas para el primer impacto (nullptr = toda la escena).
+ * @param random Secuencia aleatoria de la muestra.
+ * @return Radiancia estimada.
+ */
+Vector3D PathTracer::tracePath(const Ray& ray, const PrimitiveList* candidates, RandomSequence& random) const {
+    Vector3D radiance(0, 0, 0);
+    Vector3D throughput(1, 1, 1);
+    Ray current = ray;
+
+    for (int bounce = 0; bounce <= maxBounces; ++bounce) {
+        HitRecord hit;
+        bool found = (bounce == 0 && candidates) ? scene.closestHit(current, *candidates, hit) : scene.closestHit(current, hit);
+        if (!found) {
+            radiance = radiance + throughput * environment;
+            break;
+        }
+
+        // Normal orientada hacia el lado por el que llega el camino
+        Vector3D direction = current.getDirection();
+        Vector3D normal = hit.normal;
+        bool entering = normal.dot(direction) < 0;
+        if (!entering) {
+            normal = normal * -1;
+        }
+
+        double footprint = current.getConeWidth(hit.t) / std::max(std::fabs(normal.dot(direction)), 0.2);
+        SurfaceMaterial material = scene.getMaterial(hit, footprint);
+
+        // Elegir el lóbulo: transparencia, espejo o difuso, con probabilidad igual a su peso
+        double lobe = random.next();
+        if (lobe < material.transparency) {
+            double etaIncident = entering ? 1.0 : material.refractiveIndex;
+            double etaTransmitted = entering ? material.refractiveIndex : 1.0;
+            double eta = etaIncident / etaTransmitted;
+            double cosIncident = -normal.dot(direction);
+            double sinTransmitted2 = eta * eta * (1 - cosIncident * cosIncident);
+
+            double fresnel = 1.0; // Reflexión interna total si no hay dirección refractada
+            double cosTransmitted = 0.0;
+            if (sinTransmitted2 < 1) {
+                cosTransmitted = std::sqrt(1 - sinTransmitted2);
+                double rs = (etaTransmitted * cosIncident - etaIncident * cosTransmitted) /
+                            (etaTransmitted * cosIncident + etaIncident * cosTransmitted);
+                double rp = (etaIncident * cosIncident - etaTransmitted * cosTransmitted) /
+                            (etaIncident * cosIncident + etaTransmitted * cosTransmitted);
+                fresnel = (rs * rs + rp * rp) / 2;
+            }
+
+            if (random.next() < fresnel) {
+                current = Ray(hit.point + normal * 1e-4, reflectRay(direction, normal));
+            } else {
+                Vector3D refracted = (direction * eta + normal * (eta * cosIncident - cosTransmitted)).normalize();
+                current = Ray(hit.point - normal * 1e-4, refracted);
+            }
+        } else if (lobe < material.transparency + (1 - material.transparency) * material.reflectivity) {
+            current = Ray(hit.point + normal * 1e-4, reflectRay(direction, normal));
+        } else {
+            // Luz directa (next-event estimation) y rebote difuso con distribución coseno:
+            // el coseno y la densidad se cancelan, así que el peso solo se multiplica por el albedo
+            Vector3D albedo = material.color * (1.0 / 255.0);
+            radiance = radiance + multiply(throughput, albedo) * directLighting(hit.point, normal, random);
+            throughput = multiply(throughput, albedo);
+            double u1 = random.next();
+            double u2 = random.next();
+            current = Ray(hit.point + normal * 1e-4, sampleCosineHemisphere(normal, u1, u2));
+        }
+
+        // Ruleta rusa: los caminos con poco peso terminan antes, sin sesgo
+        if (bounce >= PATH_MIN_BOUNCES) {
+            double survival = std::min(0.95, std::max({ throughput.getX(), throughput.getY(), throughput.getZ() }));
+            if (random.next() >= survival) {
+                break;
+            }
+            throughput = throughput * (1.0 / survival);
+        }
+    }
+
+    return radiance;
+}
+
+/**
+ * @brief Renderiza un rango de filas con samplesPerPixel caminos por píxel.
+ *
+ * @param cam Cámara.
+ * @param framebuffer Framebuffer de (rowEnd - rowBegin) filas.
+ * @param width Ancho de la imagen completa.
+ * @param height Alto de la imagen completa.
+ * @param rowBegin Primera fila a renderizar.
+ * @param rowEnd Fila siguiente a la última a renderizar.
+ * @param samplesPerPixel Muestras por píxel.
+ * @param viewportWidth Ancho del viewport.
+ * @param viewportHeight Alto del viewport.
+ * @param distanceToViewport Distancia entre la cámara y el viewport.
+ * @return Estadísticas del render.
+ */
+PathTraceStats PathTracer::render(const Camera& cam, Framebuffer& framebuffer, int width, int height, int rowBegin, int rowEnd,
+                                  int samplesPerPixel, double viewportWidth, double viewportHeight, double distanceToViewport,
+                                  PreviewStream* preview) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    TilePool& pool = TilePool::shared();
+
+    // Tiles alineados a la cuadrícula global, con sus primitivas candidatas calculadas una sola vez
+    int tileSize = getTileSize();
+    int firstTileY = (rowBegin / tileSize) * tileSize;
+    int tileColumns = (width + tileSize - 1) / tileSize;
+    int tileRows = (rowEnd - firstTileY + tileSize - 1) / tileSize;
+    int tileCount = tileColumns * tileRows;
+    std::vector<PrimitiveList> tileCandidates(tileCount);
+    pool.run(tileCount, [&](int tile, int) {
+        int tileX = (tile % tileColumns) * tileSize;
+        int tileY = firstTileY + (tile / tileColumns) * tileSize;
+        tileCandidates[tile] = cullPrimitivesForTile(scene, cam, tileX, tileY, std::min(tileX + tileSize, width), std::min(tileY + tileSize, height),
+                                                     width, height, viewportWidth, viewportHeight, distanceToViewport);
+    });
+
+    // Búfer de acumulación (RGB en float por píxel)
+    std::vector<float> accumulation(static_cast<size_t>(rowEnd - rowBegin) * width * 3, 0.0f);
+
+    for (int firstSample = 0; firstSample < samplesPerPixel; firstSample += PATH_SAMPLES_PER_PASS) {
+        int lastSample = std::min(firstSample + PATH_SAMPLES_PER_PASS, samplesPerPixel);
+
+        pool.run(tileCount, [&](int tile, int) {
+            int tileX = (tile % tileColumns) * tileSize;
+            int tileY = firstTileY + (tile / tileColumns) * tileSize;
+            int x1 = std::min(tileX + tileSize, width);
+            int y0 = std::max(tileY, rowBegin);
+            int y1 = std::min(tileY + tileSize, rowEnd);
+
+            for (int y = y0; y < y1; ++y) {
+                for (int x = tileX; x < x1; ++x) {
+                    uint64_t pixelIndex = static_cast<uint64_t>(y) * width + x;
+                    float* pixel = &accumulation[(static_cast<size_t>(y - rowBegin) * width + x) * 3];
+
+                    for (int sample = firstSample; sample < lastSample; ++sample) {
+                        // Posición aleatoria dentro del píxel (antialiasing)
+                        RandomSequence random(pixelIndex, static_cast<uint32_t>(sample));
+                        double offsetX = random.next();
+                        double offsetY = random.next();
+                        Ray ray = cam.generateRay(x + offsetX, y + offsetY, width, height, viewportWidth, viewportHeight, distanceToViewport);
+
+                        Vector3D radiance = tracePath(ray, &tileCandidates[tile], random);
+                        pixel[0] += static_cast<float>(radiance.getX());
+                        pixel[1] += static_cast<float>(radiance.getY());
+                        pixel[2] += static_cast<float>(radiance.getZ());
+                    }
+                }
+            }
+
+            if (preview) {
+                // Promedio provisional del tile con las muestras acumuladas hasta esta pasada
+                double passScale = 1.0 / lastSample;
+                std::vector<unsigned char> encoded;
+                encoded.reserve(static_cast<size_t>(x1 - tileX) * (y1 - y0) * 3);
+                for (int y = y0; y < y1; ++y) {
+                    const float* pixel = &accumulation[(static_cast<size_t>(y - rowBegin) * width + tileX) * 3];
+                    for (int i = 0; i < (x1 - tileX) * 3; ++i) {
+                        encoded.push_back(encodeSRGB8(pixel[i] * passScale));
+                    }
+                }
+                preview->publishTile(tileX, y0, x1 - tileX, y1 - y0, encoded.data());
+            }
+        });
+        if (preview) {
+            preview->endPass(firstSample / PATH_SAMPLES_PER_PASS + 1);
+        }
+    }
+
+    // Promedio de las muestras, convertido al formato del framebuffer por filas en paralelo
+    double scale = 1.0 / samplesPerPixel;
+    int rowCount = rowEnd - rowBegin;
+    pool.run((rowCount + tileSize - 1) / tileSize, [&](int task, int) {
+        int y1 = std::min((task + 1) * tileSize, rowCount);
+        for (int y = task * tileSize; y < y1; ++y) {
+            const float* pixel = &accumulation[static_cast<size_t>(y) * width * 3];
+            for (int x = 0; x < width; ++x, pixel += 3) {
+                framebuffer.setPixel(x, y, Vector3D(pixel[0] * scale, pixel[1] * scale, pixel[2] * scale));
+            }
+        }
+    });
+
+    PathTraceStats stats;
+    stats.samples = static_cast<long long>(rowEnd - rowBegin) * width * samplesPerPixel;
+    stats.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    stats.samplesPerSecond = stats.seconds > 0 ? stats.samples / stats.seconds : 0.0;
+    stats.threads = pool.getThreadCount();
+    return stats;
+}
@@ -1,6 +1,7 @@
 #include "Plane.h"
 #include <limits> // Para std::numeric_limits
 #include <cmath>  // Para fabs
+#include <utility> // Para std::move
 
 /**
  * @brief Constructor para inicializar el plano con un punto, normal, color, valor especular y reflectividad.
@@ -10,9 +11,13 @@
  * @param color Color del plano.
  * @param specular Valor especular del plano.
  * @param reflectivity Reflectividad del plano.
+ * @param transparency Transparencia del material.
+ * @param refractiveIndex Índice de refracción del material.
  */
-Plane::Plane(const Vector3D& point, const Vector3D& normal, const Vector3D& color, double specular, double reflectivity)
-    : point(point), normal(normal.normalize()), color(color), specular(specular), reflectivity(reflectivity) {}
+Plane::Plane(const Vector3D& point, const Vector3D& normal, const Vector3D& color, double specular, double reflectivity,
+             double transparency, double refractiveIndex)
+    : point(point), normal(normal.normalize()), color(color), specular(specular), reflectivity(reflectivity),
+      transparency(transparency), refractiveIndex(refractiveIndex) {}
 
 /**
  * @brief Método para comprobar si un rayo intersecta con el plano y calcular el punto de intersección.
@@ -20,10 +25,11 @@ Plane::Plane(const Vector3D& point, const Vector3D& normal, const Vector3D& colo
  * @param ray Rayo a comprobar.
  * @param t Distancia desde el origen del rayo hasta el punto de intersección.
  * @param intersectionPoint Punto de intersección si existe.
+ * @param tMax Distancia máxima a considerar; intersecciones en o más allá de ella se descartan.
  * @return true Si el rayo intersecta el plano.
  * @return false Si el rayo no intersecta el plano.
  */
-bool Plane::intersects(const Ray& ray, double& t, Vector3D& intersectionPoint) const {
+bool Plane::intersects(const Ray& ray, double& t, Vector3D& intersectionPoint, double tMax) const {
     double denom = normal.dot(ray.getDirection());
 
     // Si el denominador es cercano a cero, el rayo es paralelo al plano
@@ -38,6 +44,11 @@ bool Plane::intersects(const Ray& ray, double& t, Vector3D& intersectionPoint) c
         return false;
     }
 
+    // Si la intersección está más allá de tMax no interesa (p. ej. detrás de la luz en un rayo de sombra)
+    if (t_temp >= tMax) {
+        return false;
+    }
+
     t = t_temp;
     intersectionPoint = ray.getOrigin() + ray.getDirection() * t;
     return true;
@@ -67,6 +78,30 @@ double Plane::getReflectivity() const {
     return reflectivity;
 }
 
+/**
+ * @brief Getter para obtener la transparencia del plano.
+ * @return Transparencia del plano.
+ */
+double Plane::getTransparency() const {
+    return transparency;
+}
+
+/**
+ * @brief Getter para obtener el índice de refracción del plano.
+ * @return Índice de refracción del plano.
+ */
+double Plane::getRefractiveIndex() const {
+    return refractiveIndex;
+}
+
+/**
+ * @brief Getter para obtener el punto de referencia del plano.
+ * @return Punto sobre el plano.
+ */
+Vector3D Plane::getPoint() const {
+    return point;
+}
+
 /**
  * @brief Getter para obtener el vector normal del plano.
  * @return Vector normal del plano.
@@ -74,3 +109,56 @@ double Plane::getReflectivity() const {
 Vector3D Plane::getNormal() const {
     return normal;
 }
+
+/**
+ * @brief Asigna una textura al plano.
+ * 
+ * Los ejes u y v se eligen perpendiculares a la normal, partiendo del eje del mundo menos alineado con ella.
+ * 
+ * @param texture Textura del material.
+ * @param scale Tamaño en unidades del mundo de una repetición de la textura.
+ */
+void Plane::setTexture(std::shared_ptr<const Texture> texture, double scale) {
+    this->texture = std::move(texture);
+    textureScale = scale;
+
+    Vector3D helper = fabs(normal.getX()) < 0.9 ? Vector3D(1, 0, 0) : Vector3D(0, 0, 1);
+    vAxis = normal.cross(helper).normalize();
+    uAxis = vAxis.cross(normal);
+}
+
+/**
+ * @brief Color del material en un punto del plano.
+ * 
+ * @param point Punto sobre el plano.
+ * @param footprint Ancho de la huella del rayo en el punto.
+ * @return Color en el punto.
+ */
+Vector3D Plane::getColorAt(const Vector3D& point, double footprint) const {
+    if (!texture) {
+        return color;
+    }
+
+    Vector3D local = point - this->point;
+    TexCoord coord;
+    coord.u = local.dot(uAxis) / textureScale;
+    coord.v = local.dot(vAxis) / textureScale;
+    double texelsPerUnit = texture->getWidth() / textureScale;
+    return texture->sample(coord, texture->levelOfDetail(footprint, texelsPerUnit));
+}
+
+/**
+ * @brief Getter para obtener la textura del plano.
+ * @return Textura del material.
+ */
+const std::shared_ptr<const Texture>& Plane::getTexture() const {
+    return texture;
+}
+
+/**
+ * @brief Getter para obtener el tamaño de una repetición de la textura.
+ * @return Tamaño en unidades del mundo.
+ */
+double Plane::getTextureScale() const {
+    return textureScale;
+}
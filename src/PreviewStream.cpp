@@ -0,0 +1,310 @@
+#include "PreviewStream.h"
+#include "sceneHash.h"
+#include <algorithm> // Para std::min
+#include <cstring>   // Para std::memcpy
+#include <utility>   // Para std::move
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+
+// Winsock debe inicializarse una vez por proceso antes de crear sockets
+bool initializeSockets() {
+    static bool initialized = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return initialized;
+}
+
+void closeSocket(std::intptr_t handle) {
+    closesocket(static_cast<SOCKET>(handle));
+}
+#else
+using NativeSocket = int;
+
+bool initializeSockets() {
+    return true;
+}
+
+void closeSocket(std::intptr_t handle) {
+    close(static_cast<int>(handle));
+}
+#endif
+
+// Agrega un entero de 32 bits en little-endian
+void appendInt32(std::vector<unsigned char>& message, std::int32_t value) {
+    std::uint32_t bits = static_cast<std::uint32_t>(value);
+    for (int i = 0; i < 4; ++i) {
+        message.push_back(static_cast<unsigned char>(bits >> (8 * i)));
+    }
+}
+
+// Cabecera común de los mensajes: tipo, x, y, ancho y alto
+std::vector<unsigned char> messageHeader(std::int32_t type, int x, int y, int width, int rows, size_t payload) {
+    std::vector<unsigned char> message;
+    message.reserve(5 * 4 + payload);
+    appendInt32(message, type);
+    appendInt32(message, x);
+    appendInt32(message, y);
+    appendInt32(message, width);
+    appendInt32(message, rows);
+    return message;
+}
+
+} // namespace
+
+/**
+ * @brief Crea una vista previa sin conexión.
+ * @param width Ancho de la imagen completa.
+ * @param height Alto de la imagen completa.
+ * @param tileSize Tamaño de los tiles del render.
+ */
+PreviewStream::PreviewStream(int width, int height, int tileSize)
+    : width(width), height(height), tileSize(tileSize), tileColumns((width + tileSize - 1) / tileSize),
+      tileHashes(static_cast<size_t>(tileColumns) * ((height + tileSize - 1) / tileSize), 0) {}
+
+PreviewStream::~PreviewStream() {
+    close();
+}
+
+/**
+ * @brief Envía el fin del render, espera a que se vacíe la cola y cierra la conexión.
+ */
+void PreviewStream::close() {
+    if (sender.joinable()) {
+        enqueue(messageHeader(PREVIEW_FRAME_END, 0, 0, width, height, 0));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        queued.notify_one();
+        sender.join();
+    }
+    if (socketHandle != -1) {
+        closeSocket(socketHandle);
+        socketHandle = -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    connected = false;
+}
+
+/**
+ * @brief Conecta con el visor y envía la cabecera.
+ * @param host Dirección IPv4 del visor.
+ * @param port Puerto del visor.
+ * @return true si la conexión se estableció.
+ */
+bool PreviewStream::connect(const std::string& host, int port) {
+    if (sender.joinable() || !initializeSockets()) {
+        return false;
+    }
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<unsigned short>(port));
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        return false;
+    }
+
+    NativeSocket native = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+#ifdef _WIN32
+    if (native == INVALID_SOCKET) {
+        return false;
+    }
+#else
+    if (native < 0) {
+        return false;
+    }
+#endif
+    std::intptr_t handle = static_cast<std::intptr_t>(native);
+    if (::connect(native, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        closeSocket(handle);
+        return false;
+    }
+    // Los tiles son mensajes pequeños: enviarlos sin esperar a llenar un paquete
+    int noDelay = 1;
+    setsockopt(native, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+    socketHandle = handle;
+    connected = true;
+
+    std::vector<unsigned char> header(PREVIEW_MAGIC, PREVIEW_MAGIC + std::strlen(PREVIEW_MAGIC));
+    appendInt32(header, width);
+    appendInt32(header, height);
+    enqueue(std::move(header));
+    sender = std::thread(&PreviewStream::senderLoop, this);
+    return true;
+}
+
+bool PreviewStream::isConnected() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return connected;
+}
+
+/**
+ * @brief Publica un tile ya codificado en RGB de 8 bits.
+ *
+ * Se compara el hash del contenido con el del último envío del mismo tile y solo se encola si cambió.
+ *
+ * @param x Primera columna del tile.
+ * @param y Primera fila del tile.
+ * @param width Ancho del tile.
+ * @param rows Filas del tile.
+ * @param pixels Píxeles del tile.
+ */
+void PreviewStream::publishTile(int x, int y, int width, int rows, const unsigned char* pixels) {
+    if (!isConnected()) {
+        return;
+    }
+    size_t size = static_cast<size_t>(width) * rows * 3;
+
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(y));
+    hasher.add(static_cast<std::uint64_t>(rows));
+    hasher.addBytes(pixels, size);
+    std::uint64_t hash = hasher.value() | 1; // 0 queda reservado para "nunca enviado"
+    std::uint64_t& lastHash = tileHashes[static_cast<size_t>(y / tileSize) * tileColumns + x / tileSize];
+    if (lastHash == hash) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.tilesSkipped++;
+        return;
+    }
+    lastHash = hash;
+
+    std::vector<unsigned char> message = messageHeader(PREVIEW_TILE, x, y, width, rows, size);
+    message.insert(message.end(), pixels, pixels + size);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.tilesSent++;
+    }
+    enqueue(std::move(message));
+}
+
+/**
+ * @brief Publica un rectángulo de un framebuffer, convertido a RGB de 8 bits.
+ * @param framebuffer Framebuffer de origen.
+ * @param x0 Primera columna.
+ * @param y0 Primera fila.
+ * @param x1 Columna siguiente a la última.
+ * @param y1 Fila siguiente a la última.
+ * @param rowOffset Fila de la imagen completa guardada en la fila 0 del framebuffer.
+ */
+void PreviewStream::publishTile(const Framebuffer& framebuffer, int x0, int y0, int x1, int y1, int rowOffset) {
+    if (!isConnected()) {
+        return;
+    }
+    int tileWidth = x1 - x0;
+    std::vector<unsigned char> pixels(static_cast<size_t>(tileWidth) * (y1 - y0) * 3);
+    unsigned char* out = pixels.data();
+    for (int y = y0; y < y1; ++y) {
+        if (framebuffer.getFormat() == PixelFormat::SRGB8) {
+            std::memcpy(out, framebuffer.getRow(y - rowOffset) + static_cast<size_t>(x0) * 3, static_cast<size_t>(tileWidth) * 3);
+            out += static_cast<size_t>(tileWidth) * 3;
+        } else {
+            for (int x = x0; x < x1; ++x) {
+                Vector3D color = framebuffer.getPixel(x, y - rowOffset);
+                *out++ = encodeSRGB8(color.getX());
+                *out++ = encodeSRGB8(color.getY());
+                *out++ = encodeSRGB8(color.getZ());
+            }
+        }
+    }
+    publishTile(x0, y0, tileWidth, y1 - y0, pixels.data());
+}
+
+/**
+ * @brief Indica al visor que terminó una pasada progresiva.
+ * @param pass Número de la pasada.
+ */
+void PreviewStream::endPass(int pass) {
+    if (isConnected()) {
+        enqueue(messageHeader(PREVIEW_PASS_END, pass, 0, width, height, 0));
+    }
+}
+
+PreviewStats PreviewStream::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+/**
+ * @brief Encola un mensaje para el hilo de envío.
+ * @param message Mensaje completo.
+ */
+void PreviewStream::enqueue(std::vector<unsigned char> message) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!connected) {
+            return;
+        }
+        queue.push_back(std::move(message));
+    }
+    queued.notify_one();
+}
+
+/**
+ * @brief Bucle del hilo de envío.
+ *
+ * Envía los mensajes en el orden en que se encolaron; al perder la conexión descarta la cola y deja de
+ * aceptar mensajes nuevos.
+ */
+void PreviewStream::senderLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queued.wait(lock, [this] { return !queue.empty() || closing; });
+        if (queue.empty()) {
+            return; // closing y sin mensajes pendientes
+        }
+        std::vector<unsigned char> message = std::move(queue.front());
+        queue.pop_front();
+
+        lock.unlock();
+        bool sent = sendAll(message.data(), message.size());
+        lock.lock();
+
+        if (!sent) {
+            connected = false;
+            queue.clear();
+            return;
+        }
+        stats.bytesSent += static_cast<long long>(message.size());
+    }
+}
+
+/**
+ * @brief Envía un bloque completo por el socket.
+ * @param data Datos.
+ * @param size Número de bytes.
+ * @return false si la conexión se perdió.
+ */
+bool PreviewStream::sendAll(const unsigned char* data, size_t size) {
+    while (size > 0) {
+        int chunk = static_cast<int>(std::min<size_t>(size, 1 << 20));
+#ifdef _WIN32
+        int written = send(static_cast<NativeSocket>(socketHandle), reinterpret_cast<const char*>(data), chunk, 0);
+#else
+        // MSG_NOSIGNAL: si el visor se cierra, send devuelve error en lugar de terminar el proceso con SIGPIPE
+        int written = static_cast<int>(send(static_cast<NativeSocket>(socketHandle), data, chunk, MSG_NOSIGNAL));
+#endif
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#include "Random.h"
+
+/**
+ * @brief Mezcla los bits de un entero de 64 bits (finalizador de SplitMix64).
+ * @param x Valor de entrada.
+ * @return Valor mezclado.
+ */
+uint64_t hashMix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief Convierte 64 bits aleatorios en un número en [0, 1).
+ * @param bits Bits de entrada.
+ * @return Número en [0, 1).
+ */
+double hashToUnit(uint64_t bits) {
+    return (bits >> 11) * (1.0 / 9007199254740992.0); // 2^53
+}
+
+/**
+ * @brief Crea la secuencia de una muestra a partir del píxel y del índice de la muestra.
+ * @param pixelIndex Índice global del píxel.
+ * @param sampleIndex Índice de la muestra.
+ */
+RandomSequence::RandomSequence(uint64_t pixelIndex, uint32_t sampleIndex)
+    : key(hashMix(hashMix(pixelIndex) ^ (static_cast<uint64_t>(sampleIndex) * 0x9e3779b97f4a7c15ULL))), counter(0) {}
+
+/**
+ * @brief Devuelve el siguiente número de la secuencia.
+ * @return Número en [0, 1).
+ */
+double RandomSequence::next() {
+    // Incremento de Weyl de SplitMix64: claves consecutivas quedan bien separadas antes de mezclar
+    return hashToUnit(hashMix(key + (++counter) * 0x9e3779b97f4a7c15ULL));
+}
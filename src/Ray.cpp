@@ -7,12 +7,32 @@
  * 
  * @param origin Punto de origen del rayo.
  * @param direction Dirección del rayo. Se normaliza automáticamente para que siempre tenga magnitud 1.
+ * @param coneWidth Ancho del cono del rayo en su origen.
+ * @param spreadAngle Ángulo de apertura del cono.
  */
-Ray::Ray(const Vector3D& origin, const Vector3D& direction) 
-    : origin(origin), direction(direction.normalize()) {
+Ray::Ray(const Vector3D& origin, const Vector3D& direction, double coneWidth, double spreadAngle)
+    : origin(origin), direction(direction.normalize()), coneWidth(coneWidth), spreadAngle(spreadAngle) {
     // Se normaliza la dirección para asegurarse de que siempre tenga una magnitud de 1.
 }
 
+/**
+ * @brief Crea un rayo cuya dirección ya está normalizada, sin volver a normalizarla.
+ *
+ * @param origin Punto de origen del rayo.
+ * @param direction Dirección de magnitud 1.
+ * @param coneWidth Ancho del cono del rayo en su origen.
+ * @param spreadAngle Ángulo de apertura del cono.
+ * @return Rayo.
+ */
+Ray Ray::withUnitDirection(const Vector3D& origin, const Vector3D& direction, double coneWidth, double spreadAngle) {
+    Ray ray;
+    ray.origin = origin;
+    ray.direction = direction;
+    ray.coneWidth = coneWidth;
+    ray.spreadAngle = spreadAngle;
+    return ray;
+}
+
 /**
  * @brief Método para obtener el origen del rayo.
  * 
@@ -30,3 +50,22 @@ Vector3D Ray::getOrigin() const {
 Vector3D Ray::getDirection() const {
     return direction;
 }
+
+/**
+ * @brief Ancho del cono del rayo a una distancia dada de su origen.
+ * 
+ * @param t Distancia desde el origen.
+ * @return Ancho de la huella del rayo.
+ */
+double Ray::getConeWidth(double t) const {
+    return coneWidth + t * spreadAngle;
+}
+
+/**
+ * @brief Ángulo de apertura del cono del rayo.
+ * 
+ * @return Ángulo en radianes.
+ */
+double Ray::getSpreadAngle() const {
+    return spreadAngle;
+}
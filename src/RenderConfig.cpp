@@ -0,0 +1,494 @@
+#include "RenderConfig.h"
+#include <cerrno>   // Para errno
+#include <cstdlib>  // Para std::strtol y std::strtod
+#include <fstream>  // Para std::ifstream
+#include <sstream>  // Para std::ostringstream
+
+namespace {
+
+// Elimina los espacios al inicio y al final
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Convierte un entero completo (sin texto sobrante)
+bool parseInt(const std::string& text, int& value) {
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || errno != 0 || parsed < -2147483647L || parsed > 2147483647L) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// Convierte un número real completo (sin texto sobrante)
+bool parseDouble(const std::string& text, double& value) {
+    char* end = nullptr;
+    errno = 0;
+    double parsed = std::strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || errno != 0) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// Convierte un real a texto sin perder precisión (para reenviarlo a los trabajadores)
+std::string formatDouble(double value) {
+    std::ostringstream out;
+    out.precision(17);
+    out << value;
+    return out.str();
+}
+
+} // namespace
+
+double RenderConfig::getViewportHeight() const {
+    return viewportHeight > 0.0 ? viewportHeight : viewportWidth * height / width;
+}
+
+/**
+ * Devuelve las opciones de configuración conocidas.
+ *
+ * @return const std::vector<RenderConfigOption>&: Opciones.
+ */
+const std::vector<RenderConfigOption>& renderConfigOptions() {
+    static const std::vector<RenderConfigOption> options = {
+        { "width", "--width", "Ancho de la imagen en píxeles" },
+        { "height", "--height", "Alto de la imagen en píxeles" },
+        { "viewport_width", "--viewport-width", "Ancho del viewport en unidades del mundo" },
+        { "viewport_height", "--viewport-height", "Alto del viewport (0 = según la proporción de la imagen)" },
+        { "distance", "--distance", "Distancia entre la cámara y el viewport" },
+        { "max_depth", "--depth", "Profundidad máxima de reflexión y refracción" },
+        { "threads", "--threads", "Hilos de render (0 = uno por núcleo)" },
+        { "tile_size", "--tile-size", "Lado de los tiles en píxeles" },
+        { "spp", "--spp", "Muestras por píxel del trazado de caminos" },
+        { "max_bounces", "--bounces", "Rebotes máximos de cada camino" },
+        { "format", "--format", "Formato del framebuffer: srgb8, rgb16f o rgba32f" },
+        { "output", "--output", "Ruta del PPM de salida" },
+        { "accel", "--accel", "Estructura de aceleración: frustum, grid o none" },
+        { "geometry", "--geometry", "Archivo de geometría paginada que se agrega a la escena" },
+        { "geometry_cache", "--geometry-cache", "Memoria de los chunks residentes de la geometría paginada (MB)" },
+        { "secondary", "--secondary", "Rayos secundarios: recursive, wavefront o sorted (frentes de onda ordenados)" },
+        { "wavefront_batch", "--wavefront-batch", "Píxeles de cada lote del render por frentes de onda" },
+        { "pipeline", "--pipeline", "Render del trazador de Whitted: megakernel o wavefront (por etapas)" },
+        { "views", "--views", "Vistas desde la cámara: single, stereo o cubemap" },
+        { "eye_separation", "--eye-separation", "Distancia entre las cámaras de la vista estéreo" },
+        { "numa", "--numa", "Colocación NUMA de hilos y memoria: off, local o interleaved" },
+    };
+    return options;
+}
+
+/**
+ * Busca la opción de configuración que corresponde a una opción de la línea de comandos.
+ *
+ * @param flag: Opción de la línea de comandos.
+ * @return const RenderConfigOption*: Opción encontrada o nullptr.
+ */
+const RenderConfigOption* findRenderConfigFlag(const std::string& flag) {
+    for (const RenderConfigOption& option : renderConfigOptions()) {
+        if (flag == option.flag) {
+            return &option;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Asigna un valor de la configuración a partir de su clave.
+ *
+ * Solo se comprueba que el valor tenga el tipo correcto; los rangos los comprueba validateRenderConfig.
+ *
+ * @param config: Configuración a modificar.
+ * @param key: Clave.
+ * @param value: Valor como texto.
+ * @param error: Descripción del error.
+ * @return bool: true si se asignó el valor.
+ */
+bool setRenderConfigValue(RenderConfig& config, const std::string& key, const std::string& value, std::string& error) {
+    bool valid = true;
+    if (key == "width") {
+        valid = parseInt(value, config.width);
+    } else if (key == "height") {
+        valid = parseInt(value, config.height);
+    } else if (key == "viewport_width") {
+        valid = parseDouble(value, config.viewportWidth);
+    } else if (key == "viewport_height") {
+        valid = parseDouble(value, config.viewportHeight);
+    } else if (key == "distance") {
+        valid = parseDouble(value, config.distanceToViewport);
+    } else if (key == "max_depth") {
+        valid = parseInt(value, config.maxDepth);
+    } else if (key == "threads") {
+        valid = parseInt(value, config.threads);
+    } else if (key == "tile_size") {
+        valid = parseInt(value, config.tileSize);
+    } else if (key == "spp") {
+        valid = parseInt(value, config.samplesPerPixel);
+    } else if (key == "max_bounces") {
+        valid = parseInt(value, config.maxBounces);
+    } else if (key == "format") {
+        valid = parsePixelFormat(value, config.format);
+    } else if (key == "output") {
+        valid = !value.empty();
+        config.outputPath = valid ? value : config.outputPath;
+    } else if (key == "accel") {
+        valid = parseAcceleration(value, config.acceleration);
+    } else if (key == "geometry") {
+        config.geometryPath = value;
+    } else if (key == "geometry_cache") {
+        valid = parseInt(value, config.geometryCacheMB);
+    } else if (key == "secondary") {
+        valid = parseSecondaryRays(value, config.secondaryRays);
+    } else if (key == "wavefront_batch") {
+        valid = parseInt(value, config.wavefrontBatch);
+    } else if (key == "pipeline") {
+        valid = parseRenderPipeline(value, config.pipeline);
+    } else if (key == "views") {
+        valid = parseViewLayout(value, config.views);
+    } else if (key == "eye_separation") {
+        valid = parseDouble(value, config.eyeSeparation);
+    } else if (key == "numa") {
+        valid = parseNumaPlacement(value, config.numa);
+    } else {
+        error = "opción de configuración desconocida '" + key + "'";
+        return false;
+    }
+    if (!valid) {
+        error = "valor inválido '" + value + "' para " + key;
+    }
+    return valid;
+}
+
+/**
+ * Devuelve un valor de la configuración como texto.
+ *
+ * @param config: Configuración.
+ * @param key: Clave.
+ * @return std::string: Valor, o una cadena vacía si la clave no existe.
+ */
+std::string getRenderConfigValue(const RenderConfig& config, const std::string& key) {
+    if (key == "width") {
+        return std::to_string(config.width);
+    } else if (key == "height") {
+        return std::to_string(config.height);
+    } else if (key == "viewport_width") {
+        return formatDouble(config.viewportWidth);
+    } else if (key == "viewport_height") {
+        return formatDouble(config.viewportHeight);
+    } else if (key == "distance") {
+        return formatDouble(config.distanceToViewport);
+    } else if (key == "max_depth") {
+        return std::to_string(config.maxDepth);
+    } else if (key == "threads") {
+        return std::to_string(config.threads);
+    } else if (key == "tile_size") {
+        return std::to_string(config.tileSize);
+    } else if (key == "spp") {
+        return std::to_string(config.samplesPerPixel);
+    } else if (key == "max_bounces") {
+        return std::to_string(config.maxBounces);
+    } else if (key == "format") {
+        return pixelFormatName(config.format);
+    } else if (key == "output") {
+        return config.outputPath;
+    } else if (key == "accel") {
+        return accelerationName(config.acceleration);
+    } else if (key == "geometry") {
+        return config.geometryPath;
+    } else if (key == "geometry_cache") {
+        return std::to_string(config.geometryCacheMB);
+    } else if (key == "secondary") {
+        return secondaryRaysName(config.secondaryRays);
+    } else if (key == "wavefront_batch") {
+        return std::to_string(config.wavefrontBatch);
+    } else if (key == "pipeline") {
+        return renderPipelineName(config.pipeline);
+    } else if (key == "views") {
+        return viewLayoutName(config.views);
+    } else if (key == "eye_separation") {
+        return formatDouble(config.eyeSeparation);
+    } else if (key == "numa") {
+        return numaPlacementName(config.numa);
+    }
+    return std::string();
+}
+
+/**
+ * Lee un archivo de configuración con líneas "clave = valor".
+ *
+ * Solo son comentarios las líneas que empiezan por '#', así que los valores (por ejemplo, una ruta
+ * de salida) pueden contener '#'.
+ *
+ * @param path: Ruta del archivo.
+ * @param config: Configuración a modificar.
+ * @param error: Descripción del error.
+ * @return bool: true si se leyó el archivo completo.
+ */
+bool loadRenderConfig(const std::string& path, RenderConfig& config, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "no se pudo abrir " + path;
+        return false;
+    }
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t equals = line.find('=');
+        std::string valueError;
+        if (equals == std::string::npos) {
+            valueError = "se esperaba 'clave = valor'";
+        } else if (setRenderConfigValue(config, trim(line.substr(0, equals)), trim(line.substr(equals + 1)), valueError)) {
+            continue;
+        }
+        error = path + ":" + std::to_string(lineNumber) + ": " + valueError;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Escribe la configuración en el formato de loadRenderConfig.
+ *
+ * @param out: Flujo de salida.
+ * @param config: Configuración.
+ */
+void writeRenderConfig(std::ostream& out, const RenderConfig& config) {
+    for (const RenderConfigOption& option : renderConfigOptions()) {
+        out << "# " << option.description << "\n" << option.key << " = " << getRenderConfigValue(config, option.key) << "\n";
+    }
+}
+
+/**
+ * Comprueba que los valores de la configuración sean coherentes.
+ *
+ * @param config: Configuración.
+ * @param error: Descripción del primer problema encontrado.
+ * @return bool: true si la configuración es válida.
+ */
+bool validateRenderConfig(const RenderConfig& config, std::string& error) {
+    if (config.width <= 0 || config.height <= 0) {
+        error = "la resolución debe ser positiva";
+    } else if (!(config.viewportWidth > 0.0) || config.viewportHeight < 0.0 || !(config.distanceToViewport > 0.0)) {
+        error = "el viewport y su distancia deben ser positivos";
+    } else if (config.maxDepth < 0 || config.maxBounces < 0) {
+        error = "la profundidad y los rebotes no pueden ser negativos";
+    } else if (config.threads < 0) {
+        error = "el número de hilos no puede ser negativo";
+    } else if (config.tileSize <= 0) {
+        error = "el tamaño de los tiles debe ser positivo";
+    } else if (config.samplesPerPixel <= 0) {
+        error = "el número de muestras por píxel debe ser positivo";
+    } else if (config.geometryCacheMB <= 0) {
+        error = "la memoria de la geometría paginada debe ser positiva";
+    } else if (config.wavefrontBatch <= 0) {
+        error = "el lote del render por frentes de onda debe ser positivo";
+    } else if (!(config.eyeSeparation >= 0.0)) {
+        error = "la distancia entre las cámaras estéreo no puede ser negativa";
+    } else {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Convierte en opciones de la línea de comandos los parámetros que afectan a los píxeles.
+ *
+ * @param config: Configuración.
+ * @return std::vector<std::string>: Opciones y valores alternados.
+ */
+std::vector<std::string> renderConfigArguments(const RenderConfig& config) {
+    std::vector<std::string> arguments;
+    for (const RenderConfigOption& option : renderConfigOptions()) {
+        std::string key = option.key;
+        if (key != "threads" && key != "format" && key != "output" && (key != "geometry" || !config.geometryPath.empty())) {
+            arguments.push_back(option.flag);
+            arguments.push_back(getRenderConfigValue(config, key));
+        }
+    }
+    return arguments;
+}
+
+/**
+ * Devuelve el nombre de una estructura de aceleración.
+ *
+ * @param acceleration: Estructura de aceleración.
+ * @return const char*: Nombre.
+ */
+const char* accelerationName(Acceleration acceleration) {
+    switch (acceleration) {
+    case Acceleration::FRUSTUM:
+        return "frustum";
+    case Acceleration::GRID:
+        return "grid";
+    case Acceleration::NONE:
+        return "none";
+    }
+    return "";
+}
+
+/**
+ * Convierte un nombre en una estructura de aceleración.
+ *
+ * @param name: Nombre.
+ * @param acceleration: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseAcceleration(const std::string& name, Acceleration& acceleration) {
+    for (Acceleration candidate : { Acceleration::FRUSTUM, Acceleration::GRID, Acceleration::NONE }) {
+        if (name == accelerationName(candidate)) {
+            acceleration = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Devuelve el nombre de una forma de trazar los rayos secundarios.
+ *
+ * @param secondaryRays: Forma de trazar los rayos secundarios.
+ * @return const char*: Nombre.
+ */
+const char* secondaryRaysName(SecondaryRays secondaryRays) {
+    switch (secondaryRays) {
+    case SecondaryRays::RECURSIVE:
+        return "recursive";
+    case SecondaryRays::WAVEFRONT:
+        return "wavefront";
+    case SecondaryRays::SORTED:
+        return "sorted";
+    }
+    return "";
+}
+
+/**
+ * Convierte un nombre en una forma de trazar los rayos secundarios.
+ *
+ * @param name: Nombre.
+ * @param secondaryRays: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseSecondaryRays(const std::string& name, SecondaryRays& secondaryRays) {
+    for (SecondaryRays candidate : { SecondaryRays::RECURSIVE, SecondaryRays::WAVEFRONT, SecondaryRays::SORTED }) {
+        if (name == secondaryRaysName(candidate)) {
+            secondaryRays = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Devuelve el nombre de una organización del render.
+ *
+ * @param pipeline: Organización del render.
+ * @return const char*: Nombre.
+ */
+const char* renderPipelineName(RenderPipeline pipeline) {
+    switch (pipeline) {
+    case RenderPipeline::MEGAKERNEL:
+        return "megakernel";
+    case RenderPipeline::WAVEFRONT:
+        return "wavefront";
+    }
+    return "";
+}
+
+/**
+ * Convierte un nombre en una organización del render.
+ *
+ * @param name: Nombre.
+ * @param pipeline: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseRenderPipeline(const std::string& name, RenderPipeline& pipeline) {
+    for (RenderPipeline candidate : { RenderPipeline::MEGAKERNEL, RenderPipeline::WAVEFRONT }) {
+        if (name == renderPipelineName(candidate)) {
+            pipeline = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Devuelve el nombre de un conjunto de vistas.
+ *
+ * @param views: Conjunto de vistas.
+ * @return const char*: Nombre.
+ */
+const char* viewLayoutName(ViewLayout views) {
+    switch (views) {
+    case ViewLayout::SINGLE:
+        return "single";
+    case ViewLayout::STEREO:
+        return "stereo";
+    case ViewLayout::CUBEMAP:
+        return "cubemap";
+    }
+    return "";
+}
+
+/**
+ * Convierte un nombre en un conjunto de vistas.
+ *
+ * @param name: Nombre.
+ * @param views: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseViewLayout(const std::string& name, ViewLayout& views) {
+    for (ViewLayout candidate : { ViewLayout::SINGLE, ViewLayout::STEREO, ViewLayout::CUBEMAP }) {
+        if (name == viewLayoutName(candidate)) {
+            views = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Devuelve el nombre de una colocación NUMA.
+ *
+ * @param placement: Colocación.
+ * @return const char*: Nombre.
+ */
+const char* numaPlacementName(NumaPlacement placement) {
+    switch (placement) {
+    case NumaPlacement::OFF:
+        return "off";
+    case NumaPlacement::LOCAL:
+        return "local";
+    case NumaPlacement::INTERLEAVED:
+        return "interleaved";
+    }
+    return "";
+}
+
+/**
+ * Convierte un nombre en una colocación NUMA.
+ *
+ * @param name: Nombre.
+ * @param placement: Resultado si el nombre es válido.
+ * @return bool: true si el nombre es válido.
+ */
+bool parseNumaPlacement(const std::string& name, NumaPlacement& placement) {
+    for (NumaPlacement candidate : { NumaPlacement::OFF, NumaPlacement::LOCAL, NumaPlacement::INTERLEAVED }) {
+        if (name == numaPlacementName(candidate)) {
+            placement = candidate;
+            return true;
+        }
+    }
+    return false;
+}
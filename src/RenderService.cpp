@@ -0,0 +1,230 @@
+#include "RenderService.h"
+#include "generateImage.h"
+#include <algorithm> // Para std::min
+
+/**
+ * @brief Crea el servicio y sus hilos.
+ * @param threadCount Número de hilos (0 = uno por núcleo).
+ */
+RenderService::RenderService(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threadCount <= 0) {
+        threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&RenderService::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Detiene los hilos y completa como cancelados los trabajos que no terminaron.
+ */
+RenderService::~RenderService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Sin hilos no quedan tiles en curso: los trabajos de la cola se completan con lo renderizado
+    for (auto& job : queue) {
+        job->cancel();
+        if (!job->finished) {
+            job->finished = true;
+            job->finish();
+        }
+    }
+}
+
+/**
+ * @brief Encola un trabajo y despierta a los hilos.
+ * @param request Trabajo.
+ * @return Trabajo encolado.
+ */
+std::shared_ptr<RenderService::Job> RenderService::submit(RenderRequest request) {
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job.reset(new Job(std::move(request), submitted++));
+        queue.push_back(job);
+    }
+    wake.notify_all();
+    return job;
+}
+
+/**
+ * @brief Devuelve el número de hilos del servicio.
+ * @return Número de hilos.
+ */
+int RenderService::getThreadCount() const {
+    return static_cast<int>(workers.size());
+}
+
+/**
+ * @brief Bucle de un hilo: reparte los tiles de uno en uno para que un trabajo prioritario no espere a un render completo.
+ */
+void RenderService::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (stopping) {
+            return;
+        }
+
+        std::vector<std::shared_ptr<Job>> finished;
+        std::shared_ptr<Job> job = nextJob(finished);
+        int tile = -1;
+        if (job) {
+            tile = job->nextTile++;
+            ++job->tilesInFlight;
+        }
+        lock.unlock();
+
+        for (auto& done : finished) {
+            done->finish();
+        }
+        if (job) {
+            job->renderTile(tile);
+        }
+
+        lock.lock();
+        if (job && --job->tilesInFlight == 0 && !job->finished && (job->nextTile == job->tileCount || job->isCancelled())) {
+            job->finished = true;
+            lock.unlock();
+            job->finish();
+            lock.lock();
+        }
+    }
+}
+
+/**
+ * @brief Elige el trabajo del siguiente tile.
+ *
+ * Quita de la cola los trabajos con todos sus tiles repartidos y los cancelados; los cancelados sin
+ * tiles en curso se devuelven en finished para completarlos fuera del mutex (los que tienen tiles en
+ * curso los completa el hilo que termina el último).
+ *
+ * @param finished Trabajos que se pueden completar.
+ * @return Trabajo de mayor prioridad y más antiguo con tiles pendientes, o nullptr.
+ */
+std::shared_ptr<RenderService::Job> RenderService::nextJob(std::vector<std::shared_ptr<Job>>& finished) {
+    std::shared_ptr<Job> best;
+    for (size_t i = 0; i < queue.size();) {
+        std::shared_ptr<Job>& job = queue[i];
+        if (job->nextTile == job->tileCount || job->isCancelled() || job->finished) {
+            if (!job->finished && job->tilesInFlight == 0) {
+                job->finished = true;
+                finished.push_back(job);
+            }
+            queue.erase(queue.begin() + i);
+            continue;
+        }
+        if (!best || job->getPriority() > best->getPriority() ||
+            (job->getPriority() == best->getPriority() && job->sequence < best->sequence)) {
+            best = job;
+        }
+        ++i;
+    }
+    return best;
+}
+
+/**
+ * @brief Prepara un trabajo: kernel especializado, cuadrícula de tiles e imagen en negro.
+ * @param request Trabajo enviado.
+ * @param sequence Orden de envío.
+ */
+RenderService::Job::Job(RenderRequest request, std::uint64_t sequence)
+    : request(std::move(request)), sequence(sequence) {
+    const RenderConfig& config = this->request.config;
+    int tileSize = getTileSize();
+    traceKernel = Scene::selectKernel(this->request.scene->getFeatures(config.maxDepth));
+    viewportHeight = config.getViewportHeight();
+    tileColumns = (config.width + tileSize - 1) / tileSize;
+    tileCount = tileColumns * ((config.height + tileSize - 1) / tileSize);
+    image = Framebuffer(config.width, config.height, config.format);
+    start = std::chrono::high_resolution_clock::now();
+    result = promise.get_future().share();
+}
+
+/**
+ * @brief Devuelve el future del resultado.
+ * @return Future compartido.
+ */
+std::shared_future<RenderResult> RenderService::Job::getResult() const {
+    return result;
+}
+
+/**
+ * @brief Pide cancelar el trabajo.
+ */
+void RenderService::Job::cancel() {
+    cancelled.store(true);
+}
+
+/**
+ * @brief Indica si se pidió cancelar el trabajo.
+ * @return true tras cancel().
+ */
+bool RenderService::Job::isCancelled() const {
+    return cancelled.load();
+}
+
+/**
+ * @brief Devuelve el avance del trabajo.
+ * @return Tiles terminados y totales.
+ */
+RenderProgress RenderService::Job::getProgress() const {
+    RenderProgress progress;
+    progress.tilesDone = tilesDone.load();
+    progress.tilesTotal = tileCount;
+    return progress;
+}
+
+/**
+ * @brief Devuelve la prioridad del trabajo.
+ * @return Prioridad.
+ */
+RenderPriority RenderService::Job::getPriority() const {
+    return request.priority;
+}
+
+/**
+ * @brief Renderiza un tile y llama a la función de progreso.
+ * @param tile Índice del tile en la cuadrícula de la imagen.
+ */
+void RenderService::Job::renderTile(int tile) {
+    const RenderConfig& config = request.config;
+    int tileSize = getTileSize();
+    int tileX = (tile % tileColumns) * tileSize;
+    int tileY = (tile / tileColumns) * tileSize;
+    ::renderTile(*request.scene, request.camera, image, traceKernel, tileX, tileY, config.width, config.height, 0, config.height,
+                 config.maxDepth, config.viewportWidth, viewportHeight, config.distanceToViewport);
+
+    RenderProgress progress;
+    progress.tilesDone = ++tilesDone;
+    progress.tilesTotal = tileCount;
+    progress.x0 = tileX;
+    progress.y0 = tileY;
+    progress.x1 = std::min(tileX + tileSize, config.width);
+    progress.y1 = std::min(tileY + tileSize, config.height);
+    if (request.progress) {
+        request.progress(progress);
+    }
+}
+
+/**
+ * @brief Cumple el future con la imagen y el tiempo del trabajo.
+ */
+void RenderService::Job::finish() {
+    RenderResult done;
+    done.tilesDone = tilesDone.load();
+    done.cancelled = done.tilesDone < tileCount;
+    done.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    done.image = std::move(image);
+    promise.set_value(std::move(done));
+}
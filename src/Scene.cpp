@@ -5,8 +5,103 @@
 #include "Vector3D.h"
 #include "Sphere.h"
 #include "utils.h"
+#include "Random.h"
 #include <limits> // Para std::numeric_limits
 #include <cmath> // Para std::pow
+#include <algorithm> // Para std::max y std::swap
+#include <cstdint> // Para uint64_t
+#include <cstring> // Para std::memcpy
+#include <utility> // Para std::make_integer_sequence y std::move
+
+namespace {
+
+// Orden de recorrido de la rejilla 4x4 de estratos de una luz de área: cada grupo de cuatro
+// índices cubre los cuatro cuadrantes, así las primeras AREA_LIGHT_MIN_SAMPLES muestras ya
+// están repartidas por toda la luz.
+const int AREA_LIGHT_STRATA_ORDER[AREA_LIGHT_MAX_SAMPLES][2] = {
+    {0, 0}, {2, 2}, {2, 0}, {0, 2},
+    {1, 1}, {3, 3}, {3, 1}, {1, 3},
+    {1, 0}, {3, 2}, {3, 0}, {1, 2},
+    {0, 1}, {2, 3}, {2, 1}, {0, 3}
+};
+
+// Desplazamiento pseudoaleatorio pero determinista en [0, 1)^2 a partir de las coordenadas de un punto.
+// Rota la rejilla de estratos de forma distinta en cada punto, de modo que el error de muestreo
+// aparece como ruido fino en vez de bandas repetidas en la penumbra.
+void pointJitter(const Vector3D& point, double& s, double& t) {
+    double coords[3] = {point.getX(), point.getY(), point.getZ()};
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (double c : coords) {
+        uint64_t bits;
+        std::memcpy(&bits, &c, sizeof(bits));
+        h = hashMix(h ^ bits);
+    }
+    s = hashToUnit(h);
+    t = hashToUnit(hashMix(h));
+}
+
+// Contribución difusa y especular de una muestra de luz visible (Specular = false omite el término especular)
+template <bool Specular>
+double lightSampleIntensity(double intensity, const Vector3D& lightDirection, const Vector3D& normal,
+                            const Vector3D& viewDirection, int specular) {
+    double result = 0.0;
+
+    // Componente difusa
+    double n_dot_l = normal.dot(lightDirection);
+    if (n_dot_l > 0) {
+        result += intensity * n_dot_l;
+    }
+
+    // Componente especular
+    if (Specular && specular != -1) {
+        Vector3D reflectDir = reflectRay(lightDirection * -1, normal);
+        double r_dot_v = reflectDir.dot(viewDirection);
+        if (r_dot_v > 0) {
+            result += intensity * std::pow(r_dot_v, specular);
+        }
+    }
+
+    return result;
+}
+
+// Muestra index de la rejilla de estratos de una luz de área vista desde point, rotada por (offsetS, offsetT).
+// Devuelve la distancia a la muestra; si es 0 (la muestra coincide con el punto) direction no se modifica.
+double areaLightSample(const LightSource& light, const Vector3D& point, int index, double offsetS, double offsetT, Vector3D& direction) {
+    double s = (AREA_LIGHT_STRATA_ORDER[index][0] + 0.5) / 4.0 + offsetS;
+    double t = (AREA_LIGHT_STRATA_ORDER[index][1] + 0.5) / 4.0 + offsetT;
+    s -= std::floor(s);
+    t -= std::floor(t);
+
+    Vector3D toLight = light.samplePoint(s, t, point) - point;
+    double distance = toLight.norm();
+    if (distance != 0) {
+        direction = toLight * (1.0 / distance);
+    }
+    return distance;
+}
+
+// Dirección hacia una luz puntual (si PointLights) o direccional; devuelve la distancia (infinita para las direccionales).
+// Si la luz puntual coincide con el punto devuelve 0 y direction no se modifica: la luz no tiene dirección y se omite.
+template <bool PointLights>
+double pointLightSample(const LightSource& light, const Vector3D& point, Vector3D& direction) {
+    if (PointLights && light.getType() == LightSource::POINT) {
+        // La dirección del rayo de sombra está normalizada, así que la distancia debe ser la real a la luz
+        Vector3D toLight = light.getPosition() - point;
+        double squaredDistance = toLight.dot(toLight);
+        if (squaredDistance < POINT_LIGHT_MIN_DISTANCE * POINT_LIGHT_MIN_DISTANCE) {
+            return 0.0;
+        }
+        double distance = std::sqrt(squaredDistance);
+        direction = toLight * (1.0 / distance);
+        return distance;
+    }
+
+    // Luz direccional: la fuente está en el infinito
+    direction = light.getDirection().normalize();
+    return std::numeric_limits<double>::infinity();
+}
+
+} // namespace
 
 // Método para agregar un triángulo a la escena
 void Scene::addTriangle(const Triangle& triangle) {
@@ -28,57 +123,422 @@ void Scene::addSphere(const Sphere& sphere) {
     spheres.push_back(sphere);
 }
 
+// Método para asignar la malla de esferas pequeñas de la escena
+void Scene::setSphereGrid(SphereGrid grid) {
+    sphereGrid = std::move(grid);
+}
+
+// Método para agregar una malla de triángulos comprimida a la escena
+void Scene::addMesh(CompressedMesh mesh) {
+    meshes.push_back(std::move(mesh));
+}
+
+// Método para asignar la geometría paginada de la escena
+void Scene::setPagedGeometry(std::shared_ptr<const PagedGeometry> geometry) {
+    pagedGeometry = std::move(geometry);
+}
+
+// Método para congelar la escena: se mueve a un objeto constante compartido, sin copiar sus primitivas
+SceneSnapshot Scene::freeze(Scene&& scene) {
+    return std::make_shared<const Scene>(std::move(scene));
+}
+
+// Método para mover las esferas sin textura a la malla (la malla no guarda texturas)
+size_t Scene::moveSpheresToGrid() {
+    std::vector<Sphere> kept;
+    size_t moved = 0;
+    for (const Sphere& sphere : spheres) {
+        if (sphere.getTexture()) {
+            kept.push_back(sphere);
+            continue;
+        }
+        SphereMaterial material;
+        material.color = sphere.getColor();
+        material.specular = sphere.getSpecular();
+        material.reflectivity = sphere.getReflectivity();
+        material.transparency = sphere.getTransparency();
+        material.refractiveIndex = sphere.getRefractiveIndex();
+        sphereGrid.addSphere(sphere.getCenter(), sphere.getRadius(), sphereGrid.addMaterial(material));
+        ++moved;
+    }
+    spheres = std::move(kept);
+    sphereGrid.build();
+    return moved;
+}
+
+// Getters para obtener los objetos de la escena
+const std::vector<Triangle>& Scene::getTriangles() const {
+    return triangles;
+}
+
+const std::vector<Plane>& Scene::getPlanes() const {
+    return planes;
+}
+
+const std::vector<LightSource>& Scene::getLights() const {
+    return lights;
+}
+
+const std::vector<Sphere>& Scene::getSpheres() const {
+    return spheres;
+}
+
+const SphereGrid& Scene::getSphereGrid() const {
+    return sphereGrid;
+}
+
+const std::vector<CompressedMesh>& Scene::getMeshes() const {
+    return meshes;
+}
+
+const PagedGeometry* Scene::getPagedGeometry() const {
+    return pagedGeometry.get();
+}
+
+// Prueba un triángulo y actualiza la intersección más cercana si está más cerca
+static inline void testTriangle(const Triangle& triangle, const Ray& ray, HitRecord& hit) {
+    double t;
+    Vector3D intersectionPoint;
+    if (triangle.intersects(ray, t, intersectionPoint, hit.t)) {
+        hit.t = t;
+        hit.triangle = &triangle;
+        hit.plane = nullptr;
+        hit.sphere = nullptr;
+        hit.sphereGrid = nullptr;
+        hit.mesh = nullptr;
+        hit.paged = nullptr;
+    }
+}
+
+// Prueba un plano y actualiza la intersección más cercana si está más cerca
+static inline void testPlane(const Plane& plane, const Ray& ray, HitRecord& hit) {
+    double t;
+    Vector3D intersectionPoint;
+    if (plane.intersects(ray, t, intersectionPoint, hit.t)) {
+        hit.t = t;
+        hit.plane = &plane;
+        hit.triangle = nullptr;
+        hit.sphere = nullptr;
+        hit.sphereGrid = nullptr;
+        hit.mesh = nullptr;
+        hit.paged = nullptr;
+    }
+}
+
+// Prueba una esfera y actualiza la intersección más cercana si está más cerca
+static inline void testSphere(const Sphere& sphere, const Ray& ray, HitRecord& hit) {
+    double t;
+    if (sphere.intersects(ray, t, hit.t)) {
+        hit.t = t;
+        hit.sphere = &sphere;
+        hit.triangle = nullptr;
+        hit.plane = nullptr;
+        hit.sphereGrid = nullptr;
+        hit.mesh = nullptr;
+        hit.paged = nullptr;
+    }
+}
+
+// Prueba la malla de esferas y actualiza la intersección más cercana si está más cerca
+static inline void testSphereGrid(const SphereGrid& grid, const Ray& ray, HitRecord& hit) {
+    double t;
+    std::uint32_t index;
+    if (grid.intersect(ray, hit.t, t, index)) {
+        hit.t = t;
+        hit.sphereGrid = &grid;
+        hit.gridSphere = index;
+        hit.triangle = nullptr;
+        hit.plane = nullptr;
+        hit.sphere = nullptr;
+        hit.mesh = nullptr;
+        hit.paged = nullptr;
+    }
+}
+
+// Prueba una malla de triángulos y actualiza la intersección más cercana si está más cerca
+static inline void testMesh(const CompressedMesh& mesh, const Ray& ray, HitRecord& hit) {
+    double t;
+    std::uint32_t index;
+    if (mesh.intersect(ray, hit.t, t, index)) {
+        hit.t = t;
+        hit.mesh = &mesh;
+        hit.meshTriangle = index;
+        hit.triangle = nullptr;
+        hit.plane = nullptr;
+        hit.sphere = nullptr;
+        hit.sphereGrid = nullptr;
+        hit.paged = nullptr;
+    }
+}
+
+// Guarda un impacto con la geometría paginada como la intersección más cercana
+static inline void setPagedHit(const PagedGeometry& geometry, const PagedHit& pagedHit, HitRecord& hit) {
+    hit.t = pagedHit.t;
+    hit.normal = pagedHit.normal;
+    hit.paged = &geometry;
+    hit.pagedChunk = pagedHit.chunk;
+    hit.pagedTriangle = pagedHit.triangle;
+    hit.triangle = nullptr;
+    hit.plane = nullptr;
+    hit.sphere = nullptr;
+    hit.sphereGrid = nullptr;
+    hit.mesh = nullptr;
+}
+
+// Prueba la geometría paginada y actualiza la intersección más cercana si está más cerca
+static inline void testPaged(const PagedGeometry& geometry, const Ray& ray, HitRecord& hit) {
+    PagedHit pagedHit;
+    if (geometry.intersect(ray, hit.t, pagedHit)) {
+        setPagedHit(geometry, pagedHit, hit);
+    }
+}
+
 /**
- * @brief Método para determinar si un rayo intersecta algún objeto en la escena.
- * 
- * Este método evalúa si un rayo intersecta con cualquiera de los objetos en la escena
- * (triángulos, planos o esferas) y determina el punto de intersección más cercano.
- * 
+ * @brief Busca la intersección más cercana de un rayo con todos los objetos de la escena.
+ *
  * @param ray Rayo que se está evaluando.
- * @param hitPoint Punto donde el rayo intersecta el objeto más cercano.
- * @param normal Normal en el punto de intersección.
+ * @param hit Información de la intersección más cercana.
  * @return true si hay una intersección, false si no.
  */
-bool Scene::intersects(const Ray& ray, Vector3D& hitPoint, Vector3D& normal) const {
-    double closest_t = std::numeric_limits<double>::infinity();
-    bool hit = false;
+template <unsigned Features>
+bool Scene::closestHit(const Ray& ray, HitRecord& hit) const {
+    hit = HitRecord();
+    hit.t = std::numeric_limits<double>::infinity();
 
-    // Verificar intersección con todos los triángulos
-    for (const auto& triangle : triangles) {
-        double t;
-        Vector3D intersectionPoint;
-        if (triangle.intersects(ray, t, intersectionPoint) && t < closest_t) {
-            closest_t = t;
-            hitPoint = intersectionPoint;
-            normal = triangle.getNormal();
-            hit = true;
+    if (Features & FEATURE_FLAT_PRIMITIVES) {
+        for (const auto& triangle : triangles) {
+            testTriangle(triangle, ray, hit);
+        }
+        for (const auto& plane : planes) {
+            testPlane(plane, ray, hit);
+        }
+    }
+    for (const auto& sphere : spheres) {
+        testSphere(sphere, ray, hit);
+    }
+    if (!sphereGrid.empty()) {
+        testSphereGrid(sphereGrid, ray, hit);
+    }
+    for (const auto& mesh : meshes) {
+        testMesh(mesh, ray, hit);
+    }
+    if (pagedGeometry) {
+        testPaged(*pagedGeometry, ray, hit);
+    }
+
+    if (!hit.triangle && !hit.plane && !hit.sphere && !hit.sphereGrid && !hit.mesh && !hit.paged) {
+        return false;
+    }
+    finalizeHit<Features>(ray, hit);
+    return true;
+}
+
+bool Scene::closestHit(const Ray& ray, HitRecord& hit) const {
+    return closestHit<FEATURE_ALL>(ray, hit);
+}
+
+/**
+ * @brief Busca la intersección más cercana de un rayo con las primitivas candidatas y los planos.
+ *
+ * @param ray Rayo que se está evaluando.
+ * @param candidates Triángulos y esferas a probar.
+ * @param hit Información de la intersección más cercana.
+ * @return true si hay una intersección, false si no.
+ */
+template <unsigned Features>
+bool Scene::closestHit(const Ray& ray, const PrimitiveList& candidates, HitRecord& hit) const {
+    hit = HitRecord();
+    hit.t = std::numeric_limits<double>::infinity();
+
+    if (Features & FEATURE_FLAT_PRIMITIVES) {
+        for (const Triangle* triangle : candidates.triangles) {
+            testTriangle(*triangle, ray, hit);
+        }
+        for (const auto& plane : planes) {
+            testPlane(plane, ray, hit);
         }
     }
+    for (const Sphere* sphere : candidates.spheres) {
+        testSphere(*sphere, ray, hit);
+    }
+    if (!sphereGrid.empty()) {
+        // La malla ya limita la búsqueda a las celdas que atraviesa el rayo
+        testSphereGrid(sphereGrid, ray, hit);
+    }
+    for (const auto& mesh : meshes) {
+        // Igual que la malla de esferas, el BVH ya descarta los triángulos fuera del rayo
+        testMesh(mesh, ray, hit);
+    }
+    if (pagedGeometry) {
+        // Los chunks que no atraviesa el rayo no se prueban ni se leen
+        testPaged(*pagedGeometry, ray, hit);
+    }
 
-    // Verificar intersección con todos los planos
-    for (const auto& plane : planes) {
-        double t;
-        Vector3D intersectionPoint;
-        if (plane.intersects(ray, t, intersectionPoint) && t < closest_t) {
-            closest_t = t;
-            hitPoint = intersectionPoint;
-            normal = plane.getNormal();
-            hit = true;
+    if (!hit.triangle && !hit.plane && !hit.sphere && !hit.sphereGrid && !hit.mesh && !hit.paged) {
+        return false;
+    }
+    finalizeHit<Features>(ray, hit);
+    return true;
+}
+
+bool Scene::closestHit(const Ray& ray, const PrimitiveList& candidates, HitRecord& hit) const {
+    return closestHit<FEATURE_ALL>(ray, candidates, hit);
+}
+
+/**
+ * @brief Busca la intersección más cercana de un lote de rayos.
+ *
+ * La geometría en memoria se prueba rayo a rayo como en closestHit; después la geometría paginada
+ * recibe todo el lote en una llamada a PagedGeometry::intersectBatch, con el impacto más cercano de
+ * cada rayo como límite, así que cada chunk se lee a lo sumo una vez por lote en lugar de una vez por
+ * cada rayo que lo encuentra fuera de la caché.
+ *
+ * @param rays Rayos del lote.
+ * @param candidates Primitivas candidatas de cada rayo (nullptr = toda la escena).
+ * @param hits Intersección más cercana de cada rayo (solo válida si found es 1).
+ * @param found 1 si el rayo tiene intersección, 0 si no.
+ */
+void Scene::closestHitBatch(const std::vector<Ray>& rays, const std::vector<const PrimitiveList*>& candidates, std::vector<HitRecord>& hits,
+                            std::vector<unsigned char>& found) const {
+    hits.resize(rays.size());
+    found.resize(rays.size());
+    for (size_t i = 0; i < rays.size(); ++i) {
+        HitRecord& hit = hits[i];
+        hit = HitRecord();
+        hit.t = std::numeric_limits<double>::infinity();
+        if (candidates[i]) {
+            for (const Triangle* triangle : candidates[i]->triangles) {
+                testTriangle(*triangle, rays[i], hit);
+            }
+        } else {
+            for (const auto& triangle : triangles) {
+                testTriangle(triangle, rays[i], hit);
+            }
+        }
+        for (const auto& plane : planes) {
+            testPlane(plane, rays[i], hit);
+        }
+        if (candidates[i]) {
+            for (const Sphere* sphere : candidates[i]->spheres) {
+                testSphere(*sphere, rays[i], hit);
+            }
+        } else {
+            for (const auto& sphere : spheres) {
+                testSphere(sphere, rays[i], hit);
+            }
+        }
+        if (!sphereGrid.empty()) {
+            testSphereGrid(sphereGrid, rays[i], hit);
+        }
+        for (const auto& mesh : meshes) {
+            testMesh(mesh, rays[i], hit);
         }
     }
 
-    // Verificar intersección con todas las esferas
-    for (const auto& sphere : spheres) {
-        double t;
-        if (sphere.intersects(ray, t) && t < closest_t) {
-            closest_t = t;
-            hitPoint = ray.getOrigin() + ray.getDirection() * t;  // Calcular el punto de intersección
-            normal = sphere.getNormal(hitPoint);  // Calcular la normal en el punto de intersección
-            hit = true;
+    if (pagedGeometry) {
+        std::vector<double> limits(rays.size());
+        for (size_t i = 0; i < rays.size(); ++i) {
+            limits[i] = hits[i].t;
+        }
+        std::vector<PagedHit> pagedHits;
+        pagedGeometry->intersectBatch(rays, limits, pagedHits);
+        for (size_t i = 0; i < rays.size(); ++i) {
+            if (pagedHits[i].found) {
+                setPagedHit(*pagedGeometry, pagedHits[i], hits[i]);
+            }
         }
     }
 
-    return hit;
+    for (size_t i = 0; i < rays.size(); ++i) {
+        HitRecord& hit = hits[i];
+        found[i] = hit.triangle || hit.plane || hit.sphere || hit.sphereGrid || hit.mesh || hit.paged;
+        if (found[i]) {
+            finalizeHit<FEATURE_ALL>(rays[i], hit);
+        }
+    }
+}
+
+/**
+ * @brief Calcula el punto de intersección y la normal del objeto más cercano.
+ *
+ * Se hace una sola vez al final de la búsqueda en lugar de para cada candidato.
+ *
+ * @param ray Rayo que se está evaluando.
+ * @param hit Intersección con la distancia y el objeto ya determinados.
+ */
+template <unsigned Features>
+void Scene::finalizeHit(const Ray& ray, HitRecord& hit) const {
+    hit.point = ray.getOrigin() + ray.getDirection() * hit.t;
+    if ((Features & FEATURE_FLAT_PRIMITIVES) && hit.triangle) {
+        hit.normal = hit.triangle->getNormal();
+    } else if ((Features & FEATURE_FLAT_PRIMITIVES) && hit.plane) {
+        hit.normal = hit.plane->getNormal();
+    } else if (hit.sphereGrid) {
+        hit.normal = hit.sphereGrid->getNormal(hit.gridSphere, hit.point);
+    } else if (hit.mesh) {
+        hit.normal = hit.mesh->getNormal(hit.meshTriangle);
+    } else if (hit.paged) {
+        // La normal se calculó al encontrar el impacto, con el chunk residente
+    } else {
+        hit.normal = hit.sphere->getNormal(hit.point);
+    }
+}
+
+/**
+ * @brief Devuelve el material del objeto intersectado evaluado en el punto de impacto.
+ *
+ * @param hit Intersección.
+ * @param footprint Ancho de la huella del rayo en el punto.
+ * @return Material en el punto.
+ */
+template <unsigned Features>
+SurfaceMaterial Scene::getMaterial(const HitRecord& hit, double footprint) const {
+    if ((Features & FEATURE_FLAT_PRIMITIVES) && hit.triangle) {
+        const Triangle& triangle = *hit.triangle;
+        return { triangle.getColorAt(hit.point, footprint), triangle.getSpecular(), triangle.getReflectivity(),
+                 triangle.getTransparency(), triangle.getRefractiveIndex() };
+    } else if ((Features & FEATURE_FLAT_PRIMITIVES) && hit.plane) {
+        const Plane& plane = *hit.plane;
+        return { plane.getColorAt(hit.point, footprint), plane.getSpecular(), plane.getReflectivity(),
+                 plane.getTransparency(), plane.getRefractiveIndex() };
+    } else if (hit.sphereGrid) {
+        const SphereMaterial& material = hit.sphereGrid->getMaterial(hit.gridSphere);
+        return { material.color, material.specular, material.reflectivity, material.transparency, material.refractiveIndex };
+    } else if (hit.mesh) {
+        const MeshMaterial& material = hit.mesh->getMaterial();
+        return { material.color, material.specular, material.reflectivity, material.transparency, material.refractiveIndex };
+    } else if (hit.paged) {
+        const MeshMaterial& material = hit.paged->getMaterial(hit.pagedChunk);
+        return { material.color, material.specular, material.reflectivity, material.transparency, material.refractiveIndex };
+    }
+    const Sphere& sphere = *hit.sphere;
+    return { sphere.getColorAt(hit.point, footprint), sphere.getSpecular(), sphere.getReflectivity(),
+             sphere.getTransparency(), sphere.getRefractiveIndex() };
+}
+
+SurfaceMaterial Scene::getMaterial(const HitRecord& hit, double footprint) const {
+    return getMaterial<FEATURE_ALL>(hit, footprint);
+}
+
+/**
+ * @brief Método para determinar si un rayo intersecta algún objeto en la escena.
+ * 
+ * Este método evalúa si un rayo intersecta con cualquiera de los objetos en la escena
+ * (triángulos, planos o esferas) y determina el punto de intersección más cercano.
+ * 
+ * @param ray Rayo que se está evaluando.
+ * @param hitPoint Punto donde el rayo intersecta el objeto más cercano.
+ * @param normal Normal en el punto de intersección.
+ * @return true si hay una intersección, false si no.
+ */
+bool Scene::intersects(const Ray& ray, Vector3D& hitPoint, Vector3D& normal) const {
+    HitRecord hit;
+    if (!closestHit(ray, hit)) {
+        return false;
+    }
+    hitPoint = hit.point;
+    normal = hit.normal;
+    return true;
 }
 
 /**
@@ -93,88 +553,393 @@ bool Scene::intersects(const Ray& ray, Vector3D& hitPoint, Vector3D& normal) con
  * @return Color calculado del píxel (Vector3D).
  */
 Vector3D Scene::traceRay(const Ray& ray, int depth) const {
-    Vector3D closestPoint, normal;
-    double closestT = std::numeric_limits<double>::infinity();
-    const Triangle* closestTriangle = nullptr;
-    const Plane* closestPlane = nullptr;
-    const Sphere* closestSphere = nullptr;
+    HitRecord hit;
 
-    // Buscar la intersección más cercana con los triángulos
-    for (const auto& triangle : triangles) {
-        double t;
-        Vector3D intersectionPoint;
-        if (triangle.intersects(ray, t, intersectionPoint) && t < closestT) {
-            closestT = t;
-            closestPoint = intersectionPoint;
-            normal = triangle.getNormal();
-            closestTriangle = &triangle;
-            closestPlane = nullptr;
-            closestSphere = nullptr;
-        }
+    // Si no hay ninguna intersección, devolvemos el color de fondo (negro)
+    if (!closestHit(ray, hit)) {
+        return Vector3D(0, 0, 0);
     }
+    return shade(ray, hit, depth);
+}
 
-    // Buscar la intersección más cercana con los planos
-    for (const auto& plane : planes) {
-        double t;
-        Vector3D intersectionPoint;
-        if (plane.intersects(ray, t, intersectionPoint) && t < closestT) {
-            closestT = t;
-            closestPoint = intersectionPoint;
-            normal = plane.getNormal();
-            closestPlane = &plane;
-            closestTriangle = nullptr;
-            closestSphere = nullptr;
-        }
+/**
+ * @brief Traza un rayo secundario con su peso y el presupuesto de rayos restante del píxel.
+ *
+ * @param ray Rayo que se está trazando.
+ * @param depth Profundidad restante.
+ * @param weight Peso del rayo en el color final del píxel.
+ * @param raysLeft Rayos secundarios restantes del píxel.
+ * @return Color calculado.
+ */
+template <unsigned Features>
+Vector3D Scene::traceRay(const Ray& ray, int depth, double weight, int& raysLeft) const {
+    HitRecord hit;
+    if (!closestHit<Features>(ray, hit)) {
+        return Vector3D(0, 0, 0);
     }
+    return shade<Features>(ray, hit, depth, weight, raysLeft);
+}
+
+/**
+ * @brief Traza un rayo primario probando solo las primitivas candidatas de su tile.
+ *
+ * @param ray Rayo que se está trazando.
+ * @param depth Profundidad de reflexión máxima permitida.
+ * @param candidates Primitivas cuyo volumen envolvente intersecta el frustum del tile.
+ * @return Color calculado del píxel (Vector3D).
+ */
+Vector3D Scene::traceRay(const Ray& ray, int depth, const PrimitiveList& candidates) const {
+    return traceKernel<FEATURE_ALL>(*this, ray, depth, candidates);
+}
+
+/**
+ * @brief Kernel de render compilado para un conjunto de características.
+ *
+ * @param scene Escena (sus características deben estar contenidas en Features).
+ * @param ray Rayo primario.
+ * @param depth Profundidad de reflexión máxima permitida.
+ * @param candidates Primitivas candidatas del tile.
+ * @return Color calculado del píxel.
+ */
+template <unsigned Features>
+Vector3D Scene::traceKernel(const Scene& scene, const Ray& ray, int depth, const PrimitiveList& candidates) {
+    HitRecord hit;
+    if (!scene.closestHit<Features>(ray, candidates, hit)) {
+        return Vector3D(0, 0, 0);
+    }
+    int raysLeft = MAX_SECONDARY_RAYS_PER_PIXEL;
+    return scene.shade<Features>(ray, hit, depth, 1.0, raysLeft);
+}
+
+/**
+ * @brief Kernel diferido compilado para un conjunto de características.
+ *
+ * @param scene Escena (sus características deben estar contenidas en Features).
+ * @param ray Rayo a sombrear.
+ * @param candidates Primitivas candidatas del tile (nullptr = toda la escena).
+ * @param depth Profundidad restante.
+ * @param weight Peso del rayo en el color final del píxel.
+ * @param pixel Píxel del rayo.
+ * @param spawned Rayos secundarios que se trazarán después.
+ * @return Color que aporta el punto de impacto (sin multiplicar por weight).
+ */
+template <unsigned Features>
+Vector3D Scene::deferredKernel(const Scene& scene, const Ray& ray, const PrimitiveList* candidates, int depth,
+                               double weight, std::uint32_t pixel, std::vector<DeferredRay>& spawned) {
+    HitRecord hit;
+    bool found = candidates ? scene.closestHit<Features>(ray, *candidates, hit) : scene.closestHit<Features>(ray, hit);
+    if (!found) {
+        return Vector3D(0, 0, 0);
+    }
+
+    // El presupuesto de rayos del píxel lo aplica quien traza los rayos diferidos: aquí cada rama puede encolarse
+    int raysLeft = 2;
+    return scene.shadeBranches<Features>(ray, hit, depth, weight, raysLeft, [&](const Ray& branchRay, double branchWeight, const Vector3D& localColor) {
+        spawned.push_back({ branchRay, localColor, weight * branchWeight, pixel });
+        return Vector3D(0, 0, 0);
+    });
+}
+
+/**
+ * @brief Reparte la luz de una intersección ya sombreada y encola sus rayos secundarios (ver DeferredKernel).
+ *
+ * @param ray Rayo que produjo la intersección.
+ * @param hit Intersección más cercana.
+ * @param material Material en el punto de impacto.
+ * @param localColor Color local (material por iluminación directa).
+ * @param depth Profundidad restante.
+ * @param weight Peso del rayo en el color final del píxel.
+ * @param pixel Píxel del rayo.
+ * @param spawned Rayos secundarios que se trazarán después.
+ * @return Color que aporta el punto de impacto (sin multiplicar por weight).
+ */
+Vector3D Scene::shadeDeferred(const Ray& ray, const HitRecord& hit, const SurfaceMaterial& material, const Vector3D& localColor,
+                              int depth, double weight, std::uint32_t pixel, std::vector<DeferredRay>& spawned) const {
+    int raysLeft = 2;
+    return splitBranches(ray, hit, material, localColor, depth, weight, raysLeft, [&](const Ray& branchRay, double branchWeight, const Vector3D& fallback) {
+        spawned.push_back({ branchRay, fallback, weight * branchWeight, pixel });
+        return Vector3D(0, 0, 0);
+    });
+}
+
+/**
+ * @brief Devuelve la entrada features de una tabla con un kernel por cada conjunto de características.
+ *
+ * @param features Conjunto de características.
+ * @return Kernel compilado para ese conjunto.
+ */
+template <unsigned... Features>
+Scene::TraceKernel Scene::kernelFromTable(unsigned features, std::integer_sequence<unsigned, Features...>) {
+    static const TraceKernel table[] = { &Scene::traceKernel<Features>... };
+    return table[features];
+}
+
+/**
+ * @brief Devuelve el kernel compilado para un conjunto de características.
+ *
+ * @param features Combinación de valores de SceneFeature.
+ * @return Kernel especializado.
+ */
+Scene::TraceKernel Scene::selectKernel(unsigned features) {
+    return kernelFromTable(features & FEATURE_ALL, std::make_integer_sequence<unsigned, FEATURE_ALL + 1>());
+}
+
+/**
+ * @brief Devuelve la entrada features de una tabla con un kernel diferido por cada conjunto de características.
+ *
+ * @param features Conjunto de características.
+ * @return Kernel diferido compilado para ese conjunto.
+ */
+template <unsigned... Features>
+Scene::DeferredKernel Scene::deferredKernelFromTable(unsigned features, std::integer_sequence<unsigned, Features...>) {
+    static const DeferredKernel table[] = { &Scene::deferredKernel<Features>... };
+    return table[features];
+}
 
-    // Buscar la intersección más cercana con las esferas
+/**
+ * @brief Devuelve el kernel diferido compilado para un conjunto de características.
+ *
+ * @param features Combinación de valores de SceneFeature.
+ * @return Kernel diferido especializado.
+ */
+Scene::DeferredKernel Scene::selectDeferredKernel(unsigned features) {
+    return deferredKernelFromTable(features & FEATURE_ALL, std::make_integer_sequence<unsigned, FEATURE_ALL + 1>());
+}
+
+/**
+ * @brief Calcula las características que usa la escena.
+ *
+ * @param maxDepth Profundidad máxima de reflexión del render.
+ * @return Combinación de valores de SceneFeature.
+ */
+unsigned Scene::getFeatures(int maxDepth) const {
+    unsigned features = 0;
+    auto addMaterial = [&](double reflectivity, double transparency, int specular) {
+        if (maxDepth > 0 && (reflectivity > 0 || transparency > 0)) {
+            features |= FEATURE_SECONDARY_RAYS;
+        }
+        if (specular != -1) {
+            features |= FEATURE_SPECULAR;
+        }
+    };
+    for (const auto& triangle : triangles) {
+        addMaterial(triangle.getReflectivity(), triangle.getTransparency(), triangle.getSpecular());
+    }
+    for (const auto& plane : planes) {
+        addMaterial(plane.getReflectivity(), plane.getTransparency(), plane.getSpecular());
+    }
     for (const auto& sphere : spheres) {
-        double t;
-        if (sphere.intersects(ray, t) && t < closestT) {
-            closestT = t;
-            closestPoint = ray.getOrigin() + ray.getDirection() * t;  // Calcular el punto de intersección
-            normal = sphere.getNormal(closestPoint);  // Calcular la normal en el punto de intersección
-            closestSphere = &sphere;
-            closestTriangle = nullptr;
-            closestPlane = nullptr;
+        addMaterial(sphere.getReflectivity(), sphere.getTransparency(), sphere.getSpecular());
+    }
+    for (const auto& material : sphereGrid.getMaterials()) {
+        addMaterial(material.reflectivity, material.transparency, material.specular);
+    }
+    for (const auto& mesh : meshes) {
+        addMaterial(mesh.getMaterial().reflectivity, mesh.getMaterial().transparency, mesh.getMaterial().specular);
+    }
+    if (pagedGeometry) {
+        for (const auto& chunk : pagedGeometry->getChunks()) {
+            addMaterial(chunk.material.reflectivity, chunk.material.transparency, chunk.material.specular);
         }
     }
+    if (!triangles.empty() || !planes.empty()) {
+        features |= FEATURE_FLAT_PRIMITIVES;
+    }
+    for (const auto& light : lights) {
+        if (light.isAreaLight()) {
+            features |= FEATURE_AREA_LIGHTS;
+        } else if (light.getType() == LightSource::POINT) {
+            features |= FEATURE_POINT_LIGHTS;
+        }
+    }
+    return features;
+}
 
-    // Si no hay ninguna intersección, devolvemos el color de fondo (negro)
-    if (!closestTriangle && !closestPlane && !closestSphere) {
-        return Vector3D(0, 0, 0);
+/**
+ * @brief Describe un conjunto de características.
+ *
+ * @param features Combinación de valores de SceneFeature.
+ * @return Nombres de las características separados por '+'.
+ */
+std::string Scene::describeFeatures(unsigned features) {
+    static const struct {
+        unsigned feature;
+        const char* name;
+    } names[] = {
+        { FEATURE_SECONDARY_RAYS, "rayos secundarios" },
+        { FEATURE_SPECULAR, "especular" },
+        { FEATURE_AREA_LIGHTS, "luces de área" },
+        { FEATURE_POINT_LIGHTS, "luces puntuales" },
+        { FEATURE_FLAT_PRIMITIVES, "triángulos/planos" }
+    };
+    std::string description;
+    for (const auto& entry : names) {
+        if (features & entry.feature) {
+            description += (description.empty() ? "" : "+") + std::string(entry.name);
+        }
     }
+    return description.empty() ? "ninguna" : description;
+}
+
+/**
+ * @brief Calcula el color de una intersección como raíz del árbol de rayos de un píxel.
+ *
+ * @param ray Rayo que produjo la intersección.
+ * @param hit Intersección más cercana.
+ * @param depth Profundidad de reflexión restante.
+ * @return Color resultante.
+ */
+Vector3D Scene::shade(const Ray& ray, const HitRecord& hit, int depth) const {
+    int raysLeft = MAX_SECONDARY_RAYS_PER_PIXEL;
+    return shade<FEATURE_ALL>(ray, hit, depth, 1.0, raysLeft);
+}
+
+/**
+ * @brief Calcula el color local de una intersección y traza los rayos reflejado y refractado que aporten.
+ *
+ * La luz que llega a la superficie se reparte así (T = transparencia, R = reflectividad):
+ * - color local: (1 - T) * (1 - R);
+ * - reflexión: (1 - T) * R + T * Fr, donde Fr es el coeficiente de Fresnel del dieléctrico;
+ * - refracción: T * (1 - Fr).
+ * Con T = 0 se obtiene la mezcla original entre color local y reflexión especular.
+ *
+ * @param ray Rayo que produjo la intersección.
+ * @param hit Intersección más cercana.
+ * @param depth Profundidad restante.
+ * @param weight Peso del rayo en el color final del píxel.
+ * @param raysLeft Rayos secundarios restantes del píxel.
+ * @return Color resultante.
+ */
+template <unsigned Features>
+Vector3D Scene::shade(const Ray& ray, const HitRecord& hit, int depth, double weight, int& raysLeft) const {
+    return shadeBranches<Features>(ray, hit, depth, weight, raysLeft, [&](const Ray& branchRay, double branchWeight, const Vector3D&) {
+        return traceRay<Features>(branchRay, depth - 1, weight * branchWeight, raysLeft);
+    });
+}
+
+/**
+ * @brief Reparte la luz de una intersección entre color local, reflexión y refracción (ver shade()).
+ *
+ * @param ray Rayo que produjo la intersección.
+ * @param hit Intersección más cercana.
+ * @param depth Profundidad restante.
+ * @param weight Peso del rayo en el color final del píxel.
+ * @param raysLeft Rayos secundarios restantes del píxel.
+ * @param traceBranch Devuelve el color de una rama a partir de su rayo, su peso y el color local.
+ * @return Color resultante.
+ */
+template <unsigned Features, typename TraceBranch>
+Vector3D Scene::shadeBranches(const Ray& ray, const HitRecord& hit, int depth, double weight, int& raysLeft, TraceBranch&& traceBranch) const {
+    const Vector3D& closestPoint = hit.point;
+    const Vector3D& normal = hit.normal;
 
-    // Determinar cuál fue el objeto intersectado y calcular el color local
+    // Material del objeto intersectado y color local
     Vector3D viewDirection = ray.getDirection() * -1;
     double intensity;
     Vector3D localColor;
 
-    if (closestTriangle) {
-        intensity = computeLighting(closestPoint, normal, viewDirection, closestTriangle->getSpecular());
-        localColor = closestTriangle->getColor() * intensity;
-    } else if (closestPlane) {
-        intensity = computeLighting(closestPoint, normal, viewDirection, closestPlane->getSpecular());
-        localColor = closestPlane->getColor() * intensity;
-    } else if (closestSphere) {
-        intensity = computeLighting(closestPoint, normal, viewDirection, closestSphere->getSpecular());
-        localColor = closestSphere->getColor() * intensity;
+    // Huella del rayo sobre la superficie, para el nivel mip de las texturas (más ancha en ángulos rasantes)
+    double footprint = ray.getConeWidth(hit.t) / std::max(std::fabs(normal.dot(viewDirection)), 0.2);
+
+    SurfaceMaterial material = getMaterial<Features>(hit, footprint);
+    intensity = computeLighting<Features>(closestPoint, normal, viewDirection, material.specular);
+    localColor = material.color * intensity;
+
+    if (!(Features & FEATURE_SECONDARY_RAYS)) {
+        return localColor;
     }
+    return splitBranches(ray, hit, material, localColor, depth, weight, raysLeft, traceBranch);
+}
 
-    // Manejar la reflexión
-    double reflectivity = closestTriangle ? closestTriangle->getReflectivity() :
-                          closestPlane ? closestPlane->getReflectivity() : closestSphere->getReflectivity();
+/**
+ * @brief Reparte la luz de una intersección ya sombreada entre su color local y las ramas reflejada y refractada.
+ *
+ * @param ray Rayo que produjo la intersección.
+ * @param hit Intersección más cercana.
+ * @param material Material en el punto de impacto.
+ * @param localColor Color local (material por iluminación directa).
+ * @param depth Profundidad restante.
+ * @param weight Peso del rayo en el color final del píxel.
+ * @param raysLeft Rayos secundarios restantes del píxel.
+ * @param traceBranch Devuelve el color de una rama a partir de su rayo, su peso y el color local.
+ * @return Color resultante.
+ */
+template <typename TraceBranch>
+Vector3D Scene::splitBranches(const Ray& ray, const HitRecord& hit, const SurfaceMaterial& material, const Vector3D& localColor,
+                              int depth, double weight, int& raysLeft, TraceBranch&& traceBranch) const {
+    const Vector3D& closestPoint = hit.point;
+    const Vector3D& normal = hit.normal;
+    Vector3D viewDirection = ray.getDirection() * -1;
 
-    if (depth <= 0 || reflectivity <= 0) {
+    // Manejar la reflexión y la refracción
+    double reflectivity = material.reflectivity;
+    double transparency = material.transparency;
+
+    if (depth <= 0 || (reflectivity <= 0 && transparency <= 0)) {
         return localColor;
     }
 
-    // Calcular el rayo reflejado
-    Vector3D reflectionDirection = reflectRay(viewDirection, normal);
-    Ray reflectedRay(closestPoint + normal * 1e-4, reflectionDirection); // Pequeño desplazamiento para evitar la auto-intersección
+    // Orientar la normal hacia el lado por el que llega el rayo (el rayo puede venir del interior del objeto)
+    Vector3D facingNormal = normal;
+    double cosIncident = normal.dot(viewDirection);
+    double etaIncident = 1.0;
+    double etaTransmitted = material.refractiveIndex;
+    if (cosIncident < 0) {
+        facingNormal = normal * -1;
+        cosIncident = -cosIncident;
+        std::swap(etaIncident, etaTransmitted);
+    }
 
-    Vector3D reflectedColor = traceRay(reflectedRay, depth - 1);
-    Vector3D finalColor = localColor * (1 - reflectivity) + reflectedColor * reflectivity;
+    // Coeficiente de Fresnel y dirección refractada (ley de Snell)
+    double fresnel = 0.0;
+    Vector3D refractionDirection;
+    if (transparency > 0) {
+        double eta = etaIncident / etaTransmitted;
+        double sinTransmitted2 = eta * eta * (1 - cosIncident * cosIncident);
+        if (sinTransmitted2 >= 1) {
+            fresnel = 1.0; // Reflexión interna total
+        } else {
+            double cosTransmitted = std::sqrt(1 - sinTransmitted2);
+            double rs = (etaTransmitted * cosIncident - etaIncident * cosTransmitted) /
+                        (etaTransmitted * cosIncident + etaIncident * cosTransmitted);
+            double rp = (etaIncident * cosIncident - etaTransmitted * cosTransmitted) /
+                        (etaIncident * cosIncident + etaTransmitted * cosTransmitted);
+            fresnel = (rs * rs + rp * rp) / 2;
+            refractionDirection = ray.getDirection() * eta + facingNormal * (eta * cosIncident - cosTransmitted);
+        }
+    }
+
+    double localWeight = (1 - transparency) * (1 - reflectivity);
+    double reflectionWeight = (1 - transparency) * reflectivity + transparency * fresnel;
+    double refractionWeight = transparency * (1 - fresnel);
+
+    // Trazar las ramas en orden de peso decreciente; las que no se trazan toman el color local
+    Vector3D reflectedColor = localColor;
+    Vector3D refractedColor = localColor;
+    bool reflectionFirst = reflectionWeight >= refractionWeight;
+    for (int branch = 0; branch < 2; ++branch) {
+        bool isReflection = (branch == 0) == reflectionFirst;
+        double branchWeight = isReflection ? reflectionWeight : refractionWeight;
+        if (branchWeight <= 0 || weight * branchWeight < MIN_RAY_CONTRIBUTION || raysLeft <= 0) {
+            continue;
+        }
+        --raysLeft;
+
+        // Pequeño desplazamiento para evitar la auto-intersección, hacia el lado por el que sale el rayo
+        if (isReflection) {
+            Vector3D reflectionDirection = reflectRay(ray.getDirection(), facingNormal);
+            Ray reflectedRay(closestPoint + facingNormal * 1e-4, reflectionDirection, ray.getConeWidth(hit.t), ray.getSpreadAngle());
+            reflectedColor = traceBranch(reflectedRay, branchWeight, localColor);
+        } else {
+            Ray refractedRay(closestPoint - facingNormal * 1e-4, refractionDirection.normalize(), ray.getConeWidth(hit.t), ray.getSpreadAngle());
+            refractedColor = traceBranch(refractedRay, branchWeight, localColor);
+        }
+    }
+
+    Vector3D finalColor = localColor * localWeight + reflectedColor * reflectionWeight;
+    if (refractionWeight > 0) {
+        finalColor = finalColor + refractedColor * refractionWeight;
+    }
 
     return finalColor;
 }
@@ -191,6 +956,7 @@ Vector3D Scene::traceRay(const Ray& ray, int depth) const {
  * @param specular Valor especular del material.
  * @return Intensidad de la iluminación en el punto (0.0 a 1.0).
  */
+template <unsigned Features>
 double Scene::computeLighting(const Vector3D& point, const Vector3D& normal, const Vector3D& viewDirection, int specular) const {
     double totalIntensity = 0.0;
 
@@ -202,78 +968,186 @@ double Scene::computeLighting(const Vector3D& point, const Vector3D& normal, con
         if (light.getType() == LightSource::AMBIENT) {
             totalIntensity += light.getIntensity();
             continue;
-        } else if (light.getType() == LightSource::POINT) {
-            lightDirection = (light.getPosition() - point).normalize();
-            t_max = 1.0;
-        } else if (light.getType() == LightSource::DIRECTIONAL) {
-            lightDirection = light.getDirection().normalize();
-            t_max = std::numeric_limits<double>::infinity();
+        } else if ((Features & FEATURE_AREA_LIGHTS) && light.isAreaLight()) {
+            totalIntensity += computeAreaLighting<Features>(light, point, normal, viewDirection, specular);
+            continue;
+        } else {
+            t_max = pointLightSample<(Features & FEATURE_POINT_LIGHTS) != 0>(light, point, lightDirection);
+            if (t_max == 0) {
+                continue;
+            }
         }
 
         // Comprobar si el punto está en sombra
-        if (isInShadow(point, lightDirection, t_max)) {
+        if (isInShadow<Features>(point, lightDirection, t_max)) {
             continue;
         }
 
-        // Componente difusa
-        double n_dot_l = normal.dot(lightDirection);
-        if (n_dot_l > 0) {
-            totalIntensity += light.getIntensity() * n_dot_l;
+        totalIntensity += lightSampleIntensity<(Features & FEATURE_SPECULAR) != 0>(light.getIntensity(), lightDirection, normal, viewDirection, specular);
+    }
+
+    return std::min(totalIntensity, 1.0); // Limitar la intensidad a un máximo de 1.0
+}
+
+double Scene::computeLighting(const Vector3D& point, const Vector3D& normal, const Vector3D& viewDirection, int specular) const {
+    return computeLighting<FEATURE_ALL>(point, normal, viewDirection, specular);
+}
+
+/**
+ * @brief Calcula la iluminación de una luz de área con muestreo estratificado adaptativo.
+ *
+ * Cada muestra toma un estrato de la rejilla 4x4 sobre la luz, rotada por un desplazamiento que depende
+ * del punto (determinista, así dos renders de la misma escena son idénticos). Con AREA_LIGHT_MIN_SAMPLES
+ * muestras se decide si el punto está en la penumbra; solo entonces se trazan las restantes.
+ *
+ * @param light Luz de área.
+ * @param point Punto donde se calcula la iluminación.
+ * @param normal Normal en el punto.
+ * @param viewDirection Dirección hacia la cámara.
+ * @param specular Valor especular del material.
+ * @return Intensidad aportada por la luz.
+ */
+template <unsigned Features>
+double Scene::computeAreaLighting(const LightSource& light, const Vector3D& point, const Vector3D& normal,
+                                  const Vector3D& viewDirection, int specular) const {
+    double offsetS, offsetT;
+    pointJitter(point, offsetS, offsetT);
+
+    double sum = 0.0;
+    int visibleCount = 0;
+    int sampleCount = 0;
+
+    for (int i = 0; i < AREA_LIGHT_MAX_SAMPLES; ++i) {
+        // Tras las primeras muestras, parar si todas coinciden: el punto no está en la penumbra
+        if (i == AREA_LIGHT_MIN_SAMPLES && (visibleCount == 0 || visibleCount == sampleCount)) {
+            break;
+        }
+
+        ++sampleCount;
+        Vector3D lightDirection;
+        double distance = areaLightSample(light, point, i, offsetS, offsetT, lightDirection);
+        if (distance == 0) {
+            continue;
         }
 
-        // Componente especular
-        if (specular != -1) {
-            Vector3D reflectDir = reflectRay(lightDirection * -1, normal);
-            double r_dot_v = reflectDir.dot(viewDirection);
-            if (r_dot_v > 0) {
-                totalIntensity += light.getIntensity() * std::pow(r_dot_v, specular);
-            }
+        if (isInShadow<Features>(point, lightDirection, distance)) {
+            continue;
         }
+        ++visibleCount;
+        sum += lightSampleIntensity<(Features & FEATURE_SPECULAR) != 0>(light.getIntensity(), lightDirection, normal, viewDirection, specular);
     }
 
-    return std::min(totalIntensity, 1.0); // Limitar la intensidad a un máximo de 1.0
+    return sum / sampleCount;
+}
+
+double Scene::computeAreaLighting(const LightSource& light, const Vector3D& point, const Vector3D& normal,
+                                  const Vector3D& viewDirection, int specular) const {
+    return computeAreaLighting<FEATURE_ALL>(light, point, normal, viewDirection, specular);
+}
+
+/**
+ * @brief Calcula la muestra index de una luz vista desde un punto.
+ *
+ * @param light Luz (no ambiental).
+ * @param point Punto iluminado.
+ * @param index Número de muestra de las luces de área (se ignora en las demás).
+ * @return Dirección y distancia de la muestra.
+ */
+LightSample Scene::sampleLight(const LightSource& light, const Vector3D& point, int index) {
+    LightSample sample;
+    if (light.isAreaLight()) {
+        double offsetS, offsetT;
+        pointJitter(point, offsetS, offsetT);
+        sample.distance = areaLightSample(light, point, index, offsetS, offsetT, sample.direction);
+    } else {
+        sample.distance = pointLightSample<true>(light, point, sample.direction);
+    }
+    return sample;
+}
+
+/**
+ * @brief Calcula la contribución difusa y especular de una muestra de luz visible.
+ *
+ * @param light Luz de la muestra.
+ * @param sample Muestra (obtenida con sampleLight).
+ * @param normal Normal en el punto.
+ * @param viewDirection Dirección hacia la cámara.
+ * @param specular Valor especular del material.
+ * @return Intensidad aportada por la muestra.
+ */
+double Scene::sampleIntensity(const LightSource& light, const LightSample& sample, const Vector3D& normal, const Vector3D& viewDirection, int specular) {
+    return lightSampleIntensity<true>(light.getIntensity(), sample.direction, normal, viewDirection, specular);
 }
 
 /**
  * @brief Determina si un punto está en sombra.
  * 
  * Este método traza un rayo desde el punto hacia la fuente de luz para determinar si hay
- * algún objeto bloqueando la luz, en cuyo caso el punto estaría en sombra.
+ * algún objeto bloqueando la luz, en cuyo caso el punto estaría en sombra. Solo cuentan los
+ * oclusores situados entre el punto y la luz: t_max se pasa a cada primitiva para que descarte
+ * las intersecciones más lejanas sin calcular el punto de impacto.
  * 
  * @param point Punto a evaluar.
- * @param lightDirection Dirección hacia la fuente de luz.
- * @param t_max Máxima distancia para buscar intersección.
+ * @param lightDirection Dirección (normalizada) hacia la fuente de luz.
+ * @param t_max Distancia desde el punto hasta la luz (infinito para luces direccionales).
  * @return true si el punto está en sombra, false si no lo está.
  */
+template <unsigned Features>
 bool Scene::isInShadow(const Vector3D& point, const Vector3D& lightDirection, double t_max) const {
     Vector3D offsetPoint = point + lightDirection * 1e-4; // Pequeño desplazamiento para evitar auto-sombreado
     Ray shadowRay(offsetPoint, lightDirection);
+    // Distancia restante hasta la luz desde el punto desplazado, con el mismo margen en el extremo de la luz
+    // para que una superficie que toca la luz (p. ej. una luz sobre el techo) no se cuente como oclusor
+    double limit = t_max - 2e-4;
 
-    // Verificar intersección con triángulos
-    for (const auto& triangle : triangles) {
-        double t;
-        Vector3D intersectionPoint;
-        if (triangle.intersects(shadowRay, t, intersectionPoint) && t > 1e-4 && t < t_max) {
-            return true; // Si se encuentra una intersección, el punto está en sombra
+    if (Features & FEATURE_FLAT_PRIMITIVES) {
+        // Verificar intersección con triángulos
+        for (const auto& triangle : triangles) {
+            double t;
+            Vector3D intersectionPoint;
+            if (triangle.intersects(shadowRay, t, intersectionPoint, limit) && t > 1e-4) {
+                return true; // Si se encuentra una intersección, el punto está en sombra
+            }
         }
-    }
 
-    // Verificar intersección con planos
-    for (const auto& plane : planes) {
-        double t;
-        Vector3D intersectionPoint;
-        if (plane.intersects(shadowRay, t, intersectionPoint) && t > 1e-4 && t < t_max) {
-            return true; // Si se encuentra una intersección, el punto está en sombra
+        // Verificar intersección con planos
+        for (const auto& plane : planes) {
+            double t;
+            Vector3D intersectionPoint;
+            if (plane.intersects(shadowRay, t, intersectionPoint, limit) && t > 1e-4) {
+                return true; // Si se encuentra una intersección, el punto está en sombra
+            }
         }
     }
 
     // Verificar intersección con esferas
     for (const auto& sphere : spheres) {
         double t;
-        if (sphere.intersects(shadowRay, t) && t > 1e-4 && t < t_max) {
+        if (sphere.intersects(shadowRay, t, limit) && t > 1e-4) {
             return true; // Si se encuentra una intersección, el punto está en sombra
         }
     }
 
+    // Verificar intersección con la malla de esferas (se detiene en el primer oclusor)
+    if (!sphereGrid.empty() && sphereGrid.occluded(shadowRay, limit)) {
+        return true;
+    }
+
+    // Verificar intersección con las mallas de triángulos (con el mismo margen que los triángulos sueltos)
+    for (const auto& mesh : meshes) {
+        if (mesh.occluded(shadowRay, 1e-4, limit)) {
+            return true;
+        }
+    }
+
+    // Verificar intersección con la geometría paginada (lee los chunks que atraviesa el rayo si no están residentes)
+    if (pagedGeometry && pagedGeometry->occluded(shadowRay, 1e-4, limit)) {
+        return true;
+    }
+
     return false; // No se encontraron intersecciones, el punto no está en sombra
 }
+
+bool Scene::isInShadow(const Vector3D& point, const Vector3D& lightDirection, double t_max) const {
+    return isInShadow<FEATURE_ALL>(point, lightDirection, t_max);
+}
@@ -1,6 +1,7 @@
 // Sphere.cpp
 #include "Sphere.h"
 #include <cmath> // Para la función sqrt
+#include <utility> // Para std::move
 
 /**
  * @brief Constructor que inicializa el centro, radio, color, valor especular y reflectividad de la esfera.
@@ -10,9 +11,13 @@
  * @param color Color de la esfera.
  * @param specular Coeficiente de reflexión especular.
  * @param reflectivity Coeficiente de reflectividad de la esfera.
+ * @param transparency Transparencia del material.
+ * @param refractiveIndex Índice de refracción del material.
  */
-Sphere::Sphere(const Vector3D& center, double radius, const Vector3D& color, double specular, double reflectivity)
-    : center(center), radius(radius), color(color), specular(specular), reflectivity(reflectivity) {}
+Sphere::Sphere(const Vector3D& center, double radius, const Vector3D& color, double specular, double reflectivity,
+               double transparency, double refractiveIndex)
+    : center(center), radius(radius), color(color), specular(specular), reflectivity(reflectivity),
+      transparency(transparency), refractiveIndex(refractiveIndex) {}
 
 /**
  * @brief Método para comprobar si un rayo intersecta la esfera.
@@ -22,15 +27,24 @@ Sphere::Sphere(const Vector3D& center, double radius, const Vector3D& color, dou
  * 
  * @param ray Rayo con el que se verifica la intersección.
  * @param t Parámetro que indica la distancia a la intersección más cercana.
+ * @param tMax Distancia máxima a considerar; las intersecciones en o más allá de ella se descartan.
  * @return true si el rayo intersecta la esfera, false en caso contrario.
  */
-bool Sphere::intersects(const Ray& ray, double& t) const {
+bool Sphere::intersects(const Ray& ray, double& t, double tMax) const {
     Vector3D originToCenter = ray.getOrigin() - center;
+    double centerDistanceSq = originToCenter.dot(originToCenter);
+
+    // Rechazo temprano: si la superficie de la esfera está más lejos que tMax no hace falta resolver
+    // la cuadrática (|oc| - r >= tMax  <=>  |oc|^2 >= (tMax + r)^2, sin raíz cuadrada)
+    double reach = tMax + radius;
+    if (centerDistanceSq >= reach * reach) {
+        return false;
+    }
 
     // Coeficientes de la ecuación cuadrática
     double a = ray.getDirection().dot(ray.getDirection());
     double b = 2 * originToCenter.dot(ray.getDirection());
-    double c = originToCenter.dot(originToCenter) - radius * radius;
+    double c = centerDistanceSq - radius * radius;
 
     // Calcular el discriminante para verificar la existencia de soluciones
     double discriminant = b * b - 4 * a * c;
@@ -45,10 +59,13 @@ bool Sphere::intersects(const Ray& ray, double& t) const {
 
     // Queremos la intersección positiva más cercana
     if (t1 > 1e-4) { // Verificar si t1 es válida
+        if (t1 >= tMax) {
+            return false; // t2 >= t1, por lo que tampoco estaría dentro del rango
+        }
         t = t1;
         return true;
     }
-    if (t2 > 1e-4) { // Si t1 no es válida, verificar t2
+    if (t2 > 1e-4 && t2 < tMax) { // Si t1 no es válida, verificar t2
         t = t2;
         return true;
     }
@@ -69,6 +86,24 @@ Vector3D Sphere::getNormal(const Vector3D& point) const {
     return (point - center).normalize();
 }
 
+/**
+ * @brief Getter para obtener el centro de la esfera.
+ * 
+ * @return Centro de la esfera.
+ */
+Vector3D Sphere::getCenter() const {
+    return center;
+}
+
+/**
+ * @brief Getter para obtener el radio de la esfera.
+ * 
+ * @return Radio de la esfera.
+ */
+double Sphere::getRadius() const {
+    return radius;
+}
+
 /**
  * @brief Getter para obtener el color de la esfera.
  * 
@@ -95,3 +130,62 @@ double Sphere::getSpecular() const {
 double Sphere::getReflectivity() const {
     return reflectivity;
 }
+
+/**
+ * @brief Getter para obtener la transparencia de la esfera.
+ * 
+ * @return Fracción de la luz que atraviesa la esfera.
+ */
+double Sphere::getTransparency() const {
+    return transparency;
+}
+
+/**
+ * @brief Getter para obtener el índice de refracción de la esfera.
+ * 
+ * @return Índice de refracción del material.
+ */
+double Sphere::getRefractiveIndex() const {
+    return refractiveIndex;
+}
+
+/**
+ * @brief Asigna una textura a la esfera.
+ * 
+ * @param texture Textura del material.
+ */
+void Sphere::setTexture(std::shared_ptr<const Texture> texture) {
+    this->texture = std::move(texture);
+}
+
+/**
+ * @brief Color del material en un punto de la esfera.
+ * 
+ * La textura se proyecta por longitud (u) y latitud (v); el ecuador recorre el ancho completo de la
+ * textura, por lo que hay getWidth() / (2 * pi * radio) texels por unidad del mundo.
+ * 
+ * @param point Punto sobre la superficie de la esfera.
+ * @param footprint Ancho de la huella del rayo en el punto.
+ * @return Color en el punto.
+ */
+Vector3D Sphere::getColorAt(const Vector3D& point, double footprint) const {
+    if (!texture) {
+        return color;
+    }
+
+    Vector3D n = (point - center) * (1.0 / radius);
+    TexCoord coord;
+    coord.u = 0.5 + atan2(n.getZ(), n.getX()) / (2 * M_PI);
+    coord.v = 0.5 - asin(std::fmax(-1.0, std::fmin(1.0, n.getY()))) / M_PI;
+    double texelsPerUnit = texture->getWidth() / (2 * M_PI * radius);
+    return texture->sample(coord, texture->levelOfDetail(footprint, texelsPerUnit));
+}
+
+/**
+ * @brief Getter para obtener la textura de la esfera.
+ * 
+ * @return Textura del material, o nullptr si usa un color constante.
+ */
+const std::shared_ptr<const Texture>& Sphere::getTexture() const {
+    return texture;
+}
@@ -0,0 +1,368 @@
+#include "SphereGrid.h"
+#include <algorithm> // Para std::min, std::max y std::swap
+#include <cmath>     // Para std::sqrt, std::cbrt, std::ceil, std::floor y std::isfinite
+#include <limits>    // Para std::numeric_limits
+#include <stdexcept> // Para std::length_error
+
+/**
+ * @brief Agrega un material.
+ * @param material Material.
+ * @return Índice del material.
+ */
+std::uint16_t SphereGrid::addMaterial(const SphereMaterial& material) {
+    if (materials.size() > std::numeric_limits<std::uint16_t>::max()) {
+        throw std::length_error("SphereGrid: demasiados materiales");
+    }
+    materials.push_back(material);
+    return static_cast<std::uint16_t>(materials.size() - 1);
+}
+
+/**
+ * @brief Agrega una esfera.
+ * @param center Centro.
+ * @param radius Radio.
+ * @param material Índice del material.
+ */
+void SphereGrid::addSphere(const Vector3D& center, double radius, std::uint16_t material) {
+    spheres.push_back(PackedSphere{ static_cast<float>(center.getX()), static_cast<float>(center.getY()),
+                                    static_cast<float>(center.getZ()), static_cast<float>(radius) });
+    materialIndices.push_back(material);
+}
+
+/**
+ * @brief Reserva memoria para un número de esferas.
+ * @param count Número de esferas.
+ */
+void SphereGrid::reserve(size_t count) {
+    spheres.reserve(count);
+    materialIndices.reserve(count);
+}
+
+/**
+ * @brief Construye la malla uniforme.
+ *
+ * El tamaño de celda se elige para que el volumen de la caja envolvente, repartido entre las celdas,
+ * dé unas SPHERE_GRID_DENSITY esferas por celda. Las referencias se ordenan por celda en dos pasadas
+ * (conteo y llenado), sin listas por celda.
+ */
+void SphereGrid::build() {
+    cellStart.clear();
+    cellSpheres.clear();
+    if (spheres.empty()) {
+        resolution[0] = resolution[1] = resolution[2] = 0;
+        return;
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        boundsMin[axis] = std::numeric_limits<double>::infinity();
+        boundsMax[axis] = -std::numeric_limits<double>::infinity();
+    }
+    for (const PackedSphere& sphere : spheres) {
+        const float center[3] = { sphere.x, sphere.y, sphere.z };
+        for (int axis = 0; axis < 3; ++axis) {
+            boundsMin[axis] = std::min(boundsMin[axis], static_cast<double>(center[axis] - sphere.radius));
+            boundsMax[axis] = std::max(boundsMax[axis], static_cast<double>(center[axis] + sphere.radius));
+        }
+    }
+
+    // Evitar ejes de extensión nula (todas las esferas en un plano)
+    double extent[3];
+    double largest = 0.0;
+    for (int axis = 0; axis < 3; ++axis) {
+        extent[axis] = boundsMax[axis] - boundsMin[axis];
+        largest = std::max(largest, extent[axis]);
+    }
+    // Todas las esferas son puntos en un mismo centro: no hay ninguna extensión que tomar como escala
+    if (!(largest > 0.0)) {
+        largest = SPHERE_GRID_MIN_EXTENT;
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        if (extent[axis] < largest * 1e-3) {
+            double pad = (largest * 1e-3 - extent[axis]) / 2;
+            boundsMin[axis] -= pad;
+            boundsMax[axis] += pad;
+            extent[axis] = boundsMax[axis] - boundsMin[axis];
+        }
+    }
+
+    double cellSide = std::cbrt(extent[0] * extent[1] * extent[2] * SPHERE_GRID_DENSITY / spheres.size());
+    size_t cellCount = 1;
+    for (int axis = 0; axis < 3; ++axis) {
+        // Sin un lado de celda válido, una sola celda por eje
+        int cells = cellSide > 0.0 && std::isfinite(cellSide) ? static_cast<int>(std::min(std::ceil(extent[axis] / cellSide), static_cast<double>(SPHERE_GRID_MAX_RESOLUTION))) : 1;
+        resolution[axis] = std::max(1, std::min(cells, SPHERE_GRID_MAX_RESOLUTION));
+        cellSize[axis] = extent[axis] / resolution[axis];
+        cellCount *= resolution[axis];
+    }
+
+    // Rango de celdas que toca la caja de cada esfera
+    auto cellRange = [&](const PackedSphere& sphere, int first[3], int last[3]) {
+        const float center[3] = { sphere.x, sphere.y, sphere.z };
+        for (int axis = 0; axis < 3; ++axis) {
+            double low = (center[axis] - sphere.radius - boundsMin[axis]) / cellSize[axis];
+            double high = (center[axis] + sphere.radius - boundsMin[axis]) / cellSize[axis];
+            first[axis] = std::max(0, std::min(static_cast<int>(low), resolution[axis] - 1));
+            last[axis] = std::max(0, std::min(static_cast<int>(high), resolution[axis] - 1));
+        }
+    };
+
+    // Primera pasada: número de esferas por celda
+    cellStart.assign(cellCount + 1, 0);
+    int first[3], last[3];
+    size_t references = 0;
+    for (const PackedSphere& sphere : spheres) {
+        cellRange(sphere, first, last);
+        for (int z = first[2]; z <= last[2]; ++z) {
+            for (int y = first[1]; y <= last[1]; ++y) {
+                for (int x = first[0]; x <= last[0]; ++x) {
+                    ++cellStart[(static_cast<size_t>(z) * resolution[1] + y) * resolution[0] + x + 1];
+                    ++references;
+                }
+            }
+        }
+    }
+    if (references > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("SphereGrid: demasiadas referencias de esferas en la malla");
+    }
+    for (size_t cell = 0; cell < cellCount; ++cell) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+
+    // Segunda pasada: índices de las esferas ordenados por celda
+    cellSpheres.resize(references);
+    std::vector<std::uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    for (std::uint32_t index = 0; index < spheres.size(); ++index) {
+        cellRange(spheres[index], first, last);
+        for (int z = first[2]; z <= last[2]; ++z) {
+            for (int y = first[1]; y <= last[1]; ++y) {
+                for (int x = first[0]; x <= last[0]; ++x) {
+                    cellSpheres[cursor[(static_cast<size_t>(z) * resolution[1] + y) * resolution[0] + x]++] = index;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Recorre con 3D-DDA las celdas que atraviesa el rayo antes de tMax.
+ *
+ * @param ray Rayo.
+ * @param tMax Distancia máxima del recorrido.
+ * @param visitCell Función (celda, distancia de salida de la celda) que devuelve true para detenerse.
+ */
+template <typename Visitor>
+void SphereGrid::traverse(const Ray& ray, double tMax, Visitor&& visitCell) const {
+    if (cellStart.empty()) {
+        return;
+    }
+    const double origin[3] = { ray.getOrigin().getX(), ray.getOrigin().getY(), ray.getOrigin().getZ() };
+    const double direction[3] = { ray.getDirection().getX(), ray.getDirection().getY(), ray.getDirection().getZ() };
+
+    // Tramo del rayo dentro de la caja de la malla (prueba de las tres franjas)
+    double tEnter = 0.0;
+    double tExit = tMax;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (direction[axis] != 0) {
+            double inverse = 1.0 / direction[axis];
+            double t0 = (boundsMin[axis] - origin[axis]) * inverse;
+            double t1 = (boundsMax[axis] - origin[axis]) * inverse;
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            tEnter = std::max(tEnter, t0);
+            tExit = std::min(tExit, t1);
+        } else if (origin[axis] < boundsMin[axis] || origin[axis] > boundsMax[axis]) {
+            return;
+        }
+    }
+    if (tEnter > tExit) {
+        return;
+    }
+
+    // Celda inicial, paso por eje y distancias a los siguientes bordes de celda
+    int cell[3], step[3];
+    double tNext[3], tDelta[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        double position = origin[axis] + direction[axis] * tEnter;
+        int index = static_cast<int>(std::floor((position - boundsMin[axis]) / cellSize[axis]));
+        cell[axis] = std::max(0, std::min(index, resolution[axis] - 1));
+        if (direction[axis] > 0) {
+            step[axis] = 1;
+            tNext[axis] = (boundsMin[axis] + (cell[axis] + 1) * cellSize[axis] - origin[axis]) / direction[axis];
+            tDelta[axis] = cellSize[axis] / direction[axis];
+        } else if (direction[axis] < 0) {
+            step[axis] = -1;
+            tNext[axis] = (boundsMin[axis] + cell[axis] * cellSize[axis] - origin[axis]) / direction[axis];
+            tDelta[axis] = -cellSize[axis] / direction[axis];
+        } else {
+            step[axis] = 0;
+            tNext[axis] = std::numeric_limits<double>::infinity();
+            tDelta[axis] = std::numeric_limits<double>::infinity();
+        }
+    }
+
+    while (true) {
+        int axis = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+        size_t index = (static_cast<size_t>(cell[2]) * resolution[1] + cell[1]) * resolution[0] + cell[0];
+        if (visitCell(index, std::min(tNext[axis], tExit))) {
+            return;
+        }
+        if (tNext[axis] > tExit) {
+            return;
+        }
+        cell[axis] += step[axis];
+        if (cell[axis] < 0 || cell[axis] >= resolution[axis]) {
+            return;
+        }
+        tNext[axis] += tDelta[axis];
+    }
+}
+
+/**
+ * @brief Intersección de un rayo con una esfera compacta.
+ *
+ * @param sphere Esfera.
+ * @param ray Rayo.
+ * @param tMax Distancia máxima.
+ * @param t Distancia del impacto.
+ * @return true si hay un impacto en (1e-4, tMax).
+ */
+bool SphereGrid::intersectSphere(const PackedSphere& sphere, const Ray& ray, double tMax, double& t) const {
+    const Vector3D& origin = ray.getOrigin();
+    const Vector3D& direction = ray.getDirection();
+    double ox = origin.getX() - sphere.x;
+    double oy = origin.getY() - sphere.y;
+    double oz = origin.getZ() - sphere.z;
+    double radius = sphere.radius;
+
+    double centerDistanceSq = ox * ox + oy * oy + oz * oz;
+    double reach = tMax + radius;
+    if (centerDistanceSq >= reach * reach) {
+        return false;
+    }
+
+    double a = direction.dot(direction);
+    double halfB = ox * direction.getX() + oy * direction.getY() + oz * direction.getZ();
+    double c = centerDistanceSq - radius * radius;
+    double discriminant = halfB * halfB - a * c;
+    if (discriminant < 0) {
+        return false;
+    }
+
+    double sqrtDiscriminant = std::sqrt(discriminant);
+    double t1 = (-halfB - sqrtDiscriminant) / a;
+    if (t1 > 1e-4) {
+        if (t1 >= tMax) {
+            return false;
+        }
+        t = t1;
+        return true;
+    }
+    double t2 = (-halfB + sqrtDiscriminant) / a;
+    if (t2 > 1e-4 && t2 < tMax) {
+        t = t2;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Busca la esfera más cercana que intersecta un rayo.
+ *
+ * Un impacto encontrado en una celda puede estar en una celda posterior (la esfera ocupa varias), así
+ * que el recorrido solo se detiene cuando el impacto más cercano está antes de la salida de la celda:
+ * cualquier esfera no probada todavía solo ocupa celdas posteriores.
+ *
+ * @param ray Rayo.
+ * @param tMax Distancia máxima.
+ * @param t Distancia del impacto más cercano.
+ * @param index Índice de la esfera intersectada.
+ * @return true si hay impacto.
+ */
+bool SphereGrid::intersect(const Ray& ray, double tMax, double& t, std::uint32_t& index) const {
+    double closest = tMax;
+    bool found = false;
+    traverse(ray, tMax, [&](size_t cell, double cellExit) {
+        for (std::uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+            std::uint32_t candidate = cellSpheres[k];
+            double hitT;
+            if (intersectSphere(spheres[candidate], ray, closest, hitT)) {
+                closest = hitT;
+                index = candidate;
+                found = true;
+            }
+        }
+        return found && closest <= cellExit;
+    });
+    if (found) {
+        t = closest;
+    }
+    return found;
+}
+
+/**
+ * @brief Comprueba si alguna esfera bloquea un rayo de sombra.
+ *
+ * @param ray Rayo.
+ * @param tMax Distancia máxima.
+ * @return true si hay algún impacto antes de tMax.
+ */
+bool SphereGrid::occluded(const Ray& ray, double tMax) const {
+    bool blocked = false;
+    traverse(ray, tMax, [&](size_t cell, double) {
+        for (std::uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+            double t;
+            if (intersectSphere(spheres[cellSpheres[k]], ray, tMax, t)) {
+                blocked = true;
+                return true;
+            }
+        }
+        return false;
+    });
+    return blocked;
+}
+
+/**
+ * @brief Devuelve la normal de una esfera en un punto de su superficie.
+ * @param index Índice de la esfera.
+ * @param point Punto de la superficie.
+ * @return Normal unitaria.
+ */
+Vector3D SphereGrid::getNormal(std::uint32_t index, const Vector3D& point) const {
+    const PackedSphere& sphere = spheres[index];
+    return (point - Vector3D(sphere.x, sphere.y, sphere.z)).normalize();
+}
+
+const SphereMaterial& SphereGrid::getMaterial(std::uint32_t index) const {
+    return materials[materialIndices[index]];
+}
+
+const std::vector<PackedSphere>& SphereGrid::getSpheres() const {
+    return spheres;
+}
+
+const std::vector<std::uint16_t>& SphereGrid::getMaterialIndices() const {
+    return materialIndices;
+}
+
+const std::vector<SphereMaterial>& SphereGrid::getMaterials() const {
+    return materials;
+}
+
+bool SphereGrid::empty() const {
+    return spheres.empty();
+}
+
+size_t SphereGrid::size() const {
+    return spheres.size();
+}
+
+size_t SphereGrid::getCellCount() const {
+    return cellStart.empty() ? 0 : cellStart.size() - 1;
+}
+
+size_t SphereGrid::getMemoryBytes() const {
+    return spheres.size() * sizeof(PackedSphere) + materialIndices.size() * sizeof(std::uint16_t) +
+           materials.size() * sizeof(SphereMaterial) + cellStart.size() * sizeof(std::uint32_t) +
+           cellSpheres.size() * sizeof(std::uint32_t);
+}
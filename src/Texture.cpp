@@ -0,0 +1,290 @@
+#include "Texture.h"
+#include "sceneHash.h"
+#include "createPPM.h" // Para readPPMHeaderValue
+#include <fstream>    // Para std::ifstream
+#include <iostream>   // Para std::cerr
+#include <cmath>      // Para std::floor y std::log2
+#include <algorithm>  // Para std::min, std::max y std::clamp
+#include <string>     // Para std::string
+
+#define TEXTURE_TILE_SHIFT 3                          // Bloques de 2^3 = 8 texels por lado
+#define TEXTURE_TILE_TEXELS 64                        // Texels por bloque
+#define TEXTURE_TILE_MASK ((1 << TEXTURE_TILE_SHIFT) - 1)
+
+namespace {
+
+/**
+ * Posición dentro de un bloque de 8x8 en orden de Morton, indexada por (y << 3) | x.
+ */
+struct MortonTable {
+    unsigned char offset[TEXTURE_TILE_TEXELS];
+
+    MortonTable() {
+        for (int y = 0; y < 8; ++y) {
+            for (int x = 0; x < 8; ++x) {
+                int morton = 0;
+                for (int bit = 0; bit < TEXTURE_TILE_SHIFT; ++bit) {
+                    morton |= ((x >> bit) & 1) << (2 * bit);
+                    morton |= ((y >> bit) & 1) << (2 * bit + 1);
+                }
+                offset[(y << TEXTURE_TILE_SHIFT) | x] = static_cast<unsigned char>(morton);
+            }
+        }
+    }
+};
+
+const MortonTable MORTON;
+
+inline std::uint32_t packRGB(int r, int g, int b) {
+    return static_cast<std::uint32_t>(r) | (static_cast<std::uint32_t>(g) << 8) | (static_cast<std::uint32_t>(b) << 16) | 0xFF000000u;
+}
+
+} // namespace
+
+/**
+ * @brief Construye la textura y sus niveles mip a partir de píxeles RGB.
+ *
+ * Cada nivel se obtiene promediando bloques de 2x2 texels del anterior (con los bordes repetidos
+ * en dimensiones impares) hasta llegar a 1x1.
+ *
+ * @param width Ancho de la imagen.
+ * @param height Alto de la imagen.
+ * @param rgb Píxeles RGB fila por fila.
+ */
+Texture::Texture(int width, int height, const std::vector<unsigned char>& rgb) {
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(width));
+    hasher.add(static_cast<std::uint64_t>(height));
+    hasher.addBytes(rgb.data(), rgb.size());
+    contentHash = hasher.value();
+
+    // Nivel actual en orden lineal (3 canales) mientras se construye la cadena
+    std::vector<unsigned char> current(rgb.begin(), rgb.begin() + static_cast<size_t>(width) * height * 3);
+    int levelWidth = width, levelHeight = height;
+
+    while (true) {
+        Level level;
+        level.width = levelWidth;
+        level.height = levelHeight;
+        level.tilesX = (levelWidth + TEXTURE_TILE_MASK) >> TEXTURE_TILE_SHIFT;
+        int tilesY = (levelHeight + TEXTURE_TILE_MASK) >> TEXTURE_TILE_SHIFT;
+        level.offset = texels.size();
+        texels.resize(texels.size() + static_cast<size_t>(level.tilesX) * tilesY * TEXTURE_TILE_TEXELS, 0);
+
+        // Reordenar el nivel en bloques de Morton
+        for (int y = 0; y < levelHeight; ++y) {
+            for (int x = 0; x < levelWidth; ++x) {
+                const unsigned char* p = &current[(static_cast<size_t>(y) * levelWidth + x) * 3];
+                size_t tile = static_cast<size_t>(y >> TEXTURE_TILE_SHIFT) * level.tilesX + (x >> TEXTURE_TILE_SHIFT);
+                size_t inner = MORTON.offset[((y & TEXTURE_TILE_MASK) << TEXTURE_TILE_SHIFT) | (x & TEXTURE_TILE_MASK)];
+                texels[level.offset + tile * TEXTURE_TILE_TEXELS + inner] = packRGB(p[0], p[1], p[2]);
+            }
+        }
+        levels.push_back(level);
+
+        if (levelWidth == 1 && levelHeight == 1) {
+            break;
+        }
+
+        // Reducir a la mitad con un filtro de caja de 2x2
+        int nextWidth = std::max(1, levelWidth / 2);
+        int nextHeight = std::max(1, levelHeight / 2);
+        std::vector<unsigned char> next(static_cast<size_t>(nextWidth) * nextHeight * 3);
+        for (int y = 0; y < nextHeight; ++y) {
+            for (int x = 0; x < nextWidth; ++x) {
+                int sx0 = std::min(2 * x, levelWidth - 1), sx1 = std::min(2 * x + 1, levelWidth - 1);
+                int sy0 = std::min(2 * y, levelHeight - 1), sy1 = std::min(2 * y + 1, levelHeight - 1);
+                for (int channel = 0; channel < 3; ++channel) {
+                    int sum = current[(static_cast<size_t>(sy0) * levelWidth + sx0) * 3 + channel] +
+                              current[(static_cast<size_t>(sy0) * levelWidth + sx1) * 3 + channel] +
+                              current[(static_cast<size_t>(sy1) * levelWidth + sx0) * 3 + channel] +
+                              current[(static_cast<size_t>(sy1) * levelWidth + sx1) * 3 + channel];
+                    next[(static_cast<size_t>(y) * nextWidth + x) * 3 + channel] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+        current.swap(next);
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+}
+
+/**
+ * @brief Carga una textura desde un archivo PPM.
+ *
+ * @param path Ruta del archivo.
+ * @return Textura cargada, o nullptr si hubo un error.
+ */
+std::shared_ptr<Texture> Texture::loadPPM(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo abrir la textura " << path << std::endl;
+        return nullptr;
+    }
+
+    std::string magic;
+    file >> magic;
+    int width = 0, height = 0, maxValue = 0;
+    if ((magic != "P3" && magic != "P6") || !readPPMHeaderValue(file, width) || !readPPMHeaderValue(file, height) ||
+        !readPPMHeaderValue(file, maxValue) || width <= 0 || height <= 0 || maxValue != 255) {
+        std::cerr << "Error: " << path << " no es un PPM de 8 bits válido." << std::endl;
+        return nullptr;
+    }
+
+    std::vector<unsigned char> rgb(static_cast<size_t>(width) * height * 3);
+    if (magic == "P6") {
+        file.get(); // Un único espacio separa la cabecera de los datos binarios
+        file.read(reinterpret_cast<char*>(rgb.data()), rgb.size());
+    } else {
+        for (auto& value : rgb) {
+            int component;
+            file >> component;
+            value = static_cast<unsigned char>(std::clamp(component, 0, 255));
+        }
+    }
+    if (!file) {
+        std::cerr << "Error: la textura " << path << " está incompleta." << std::endl;
+        return nullptr;
+    }
+    return std::make_shared<Texture>(width, height, rgb);
+}
+
+std::uint32_t Texture::fetch(const Level& level, int x, int y) const {
+    size_t tile = static_cast<size_t>(y >> TEXTURE_TILE_SHIFT) * level.tilesX + (x >> TEXTURE_TILE_SHIFT);
+    size_t inner = MORTON.offset[((y & TEXTURE_TILE_MASK) << TEXTURE_TILE_SHIFT) | (x & TEXTURE_TILE_MASK)];
+    return texels[level.offset + tile * TEXTURE_TILE_TEXELS + inner];
+}
+
+/**
+ * @brief Muestrea la textura con filtrado bilineal.
+ *
+ * @param coord Coordenadas de textura (se repiten fuera de [0, 1)).
+ * @param lod Nivel de detalle.
+ * @return Color en la escala 0-255.
+ */
+Vector3D Texture::sample(const TexCoord& coord, double lod) const {
+    int levelIndex = std::clamp(static_cast<int>(lod + 0.5), 0, static_cast<int>(levels.size()) - 1);
+    const Level& level = levels[levelIndex];
+
+    // Repetir la textura y pasar a coordenadas de texel (centros en +0.5)
+    double u = coord.u - std::floor(coord.u);
+    double v = coord.v - std::floor(coord.v);
+    double x = u * level.width - 0.5;
+    double y = v * level.height - 0.5;
+    int x0 = static_cast<int>(std::floor(x));
+    int y0 = static_cast<int>(std::floor(y));
+    double fx = x - x0;
+    double fy = y - y0;
+
+    // x0 e y0 están en [-1, tamaño - 1]; basta con corregir los dos extremos
+    int x1 = x0 + 1 == level.width ? 0 : x0 + 1;
+    int y1 = y0 + 1 == level.height ? 0 : y0 + 1;
+    if (x0 < 0) x0 = level.width - 1;
+    if (y0 < 0) y0 = level.height - 1;
+
+    std::uint32_t t00 = fetch(level, x0, y0);
+    std::uint32_t t10 = fetch(level, x1, y0);
+    std::uint32_t t01 = fetch(level, x0, y1);
+    std::uint32_t t11 = fetch(level, x1, y1);
+
+    double w00 = (1 - fx) * (1 - fy), w10 = fx * (1 - fy), w01 = (1 - fx) * fy, w11 = fx * fy;
+    double channels[3];
+    for (int c = 0; c < 3; ++c) {
+        int shift = 8 * c;
+        channels[c] = w00 * ((t00 >> shift) & 0xFF) + w10 * ((t10 >> shift) & 0xFF) +
+                      w01 * ((t01 >> shift) & 0xFF) + w11 * ((t11 >> shift) & 0xFF);
+    }
+    return Vector3D(channels[0], channels[1], channels[2]);
+}
+
+/**
+ * @brief Calcula el nivel de detalle para una huella dada.
+ *
+ * @param footprint Ancho de la huella del rayo en unidades del mundo.
+ * @param texelsPerUnit Texels del nivel 0 por unidad del mundo.
+ * @return log2 del número de texels cubiertos por la huella (0 como mínimo).
+ */
+double Texture::levelOfDetail(double footprint, double texelsPerUnit) const {
+    double texelsCovered = footprint * texelsPerUnit;
+    return texelsCovered > 1.0 ? std::log2(texelsCovered) : 0.0;
+}
+
+int Texture::getWidth() const {
+    return levels[0].width;
+}
+
+int Texture::getHeight() const {
+    return levels[0].height;
+}
+
+int Texture::getLevelCount() const {
+    return static_cast<int>(levels.size());
+}
+
+size_t Texture::getMemoryBytes() const {
+    return texels.size() * sizeof(std::uint32_t);
+}
+
+std::uint64_t Texture::getContentHash() const {
+    return contentHash;
+}
+
+TextureCache& TextureCache::shared() {
+    static TextureCache cache;
+    return cache;
+}
+
+/**
+ * @brief Obtiene una textura de la caché o la carga desde disco.
+ *
+ * @param path Ruta del archivo PPM.
+ * @return Textura, o nullptr si no se pudo cargar.
+ */
+std::shared_ptr<const Texture> TextureCache::acquire(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto found = index.find(path);
+    if (found != index.end()) {
+        entries.splice(entries.begin(), entries, found->second); // Marcar como la más reciente
+        return found->second->texture;
+    }
+
+    std::shared_ptr<const Texture> texture = Texture::loadPPM(path);
+    if (!texture) {
+        return nullptr;
+    }
+    entries.push_front(Entry{ path, texture });
+    index[path] = entries.begin();
+    residentBytes += texture->getMemoryBytes();
+    evict();
+    return texture;
+}
+
+void TextureCache::setCapacity(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = bytes;
+    evict();
+}
+
+size_t TextureCache::getCapacity() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+}
+
+size_t TextureCache::getResidentBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return residentBytes;
+}
+
+void TextureCache::evict() {
+    // Recorrer desde la menos reciente; solo se descartan las texturas que nadie más referencia
+    auto it = entries.end();
+    while (residentBytes > capacity && it != entries.begin()) {
+        --it;
+        if (it->texture.use_count() == 1) {
+            residentBytes -= it->texture->getMemoryBytes();
+            index.erase(it->path);
+            it = entries.erase(it);
+        }
+    }
+}
@@ -0,0 +1,204 @@
+#include "TilePool.h"
+#include "numaPlacement.h"
+#include <algorithm> // Para std::min
+
+// Número de hilos del pool compartido (0 = uno por núcleo)
+static int sharedThreadCount = 0;
+// Fijar los hilos del pool compartido a los nodos NUMA
+static bool sharedPinning = false;
+
+/**
+ * @brief Crea el pool y sus hilos auxiliares.
+ * @param threadCount Número total de hilos (0 = uno por núcleo).
+ * @param pinToNodes Fija los hilos a los nodos NUMA.
+ */
+TilePool::TilePool(int threadCount, bool pinToNodes) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (threadCount <= 0) {
+        threadCount = 1;
+    }
+
+    // Bloques consecutivos de hilos por nodo; con menos hilos que nodos solo se usan los primeros nodos
+    threadNodes.assign(threadCount, 0);
+    if (pinToNodes) {
+        std::vector<NumaNode> topology = readNumaTopology();
+        int nodeCount = std::min(static_cast<int>(topology.size()), threadCount);
+        for (int node = 0; node < nodeCount; ++node) {
+            nodeCpus.push_back(topology[node].cpus);
+        }
+        for (int i = 0; i < threadCount; ++i) {
+            threadNodes[i] = i * nodeCount / threadCount;
+        }
+        pinCurrentThread(nodeCpus[0]);
+    }
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&TilePool::workerLoop, this, i);
+    }
+}
+
+/**
+ * @brief Detiene y espera a los hilos auxiliares.
+ */
+TilePool::~TilePool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Ejecuta un lote de tareas repartido entre todos los hilos y espera a que termine.
+ *
+ * @param taskCount Número de tareas.
+ * @param task Función que recibe el índice de la tarea y el del hilo.
+ */
+void TilePool::run(int taskCount, const std::function<void(int, int)>& task) {
+    std::lock_guard<std::mutex> runLock(runMutex);
+
+    // Sin hilos auxiliares o con una sola tarea no vale la pena despertar a nadie
+    if (workers.empty() || taskCount <= 1) {
+        for (int i = 0; i < taskCount; ++i) {
+            task(i, 0);
+        }
+        return;
+    }
+    dispatch(taskCount, task, false);
+}
+
+/**
+ * @brief Ejecuta una tarea en cada hilo del pool y espera a que terminen.
+ * @param task Función que recibe el índice del hilo.
+ */
+void TilePool::runPerThread(const std::function<void(int)>& task) {
+    std::lock_guard<std::mutex> runLock(runMutex);
+    if (workers.empty()) {
+        task(0);
+        return;
+    }
+    dispatch(getThreadCount(), [&task](int, int threadIndex) { task(threadIndex); }, true);
+}
+
+/**
+ * @brief Publica un lote y lo procesa junto con los hilos auxiliares (con runMutex tomado).
+ * @param taskCount Número de tareas.
+ * @param task Función del lote.
+ * @param perThread Cada hilo ejecuta solo la tarea de su índice.
+ */
+void TilePool::dispatch(int taskCount, const std::function<void(int, int)>& task, bool perThread) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &task;
+        jobTaskCount = taskCount;
+        jobPerThread = perThread;
+        nextTask.store(0);
+        activeWorkers = static_cast<int>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    // El hilo que llama también procesa tareas
+    drainTasks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return activeWorkers == 0; });
+    job = nullptr;
+}
+
+/**
+ * @brief Devuelve el número total de hilos.
+ * @return Hilos auxiliares más el que llama a run().
+ */
+int TilePool::getThreadCount() const {
+    return static_cast<int>(workers.size()) + 1;
+}
+
+/**
+ * @brief Devuelve el número de nodos NUMA con hilos del pool.
+ * @return Nodos (1 si los hilos no están fijados).
+ */
+int TilePool::getNodeCount() const {
+    return nodeCpus.empty() ? 1 : static_cast<int>(nodeCpus.size());
+}
+
+/**
+ * @brief Devuelve el nodo de un hilo.
+ * @param threadIndex Índice del hilo.
+ * @return Nodo del hilo.
+ */
+int TilePool::getThreadNode(int threadIndex) const {
+    return threadNodes[threadIndex];
+}
+
+/**
+ * @brief Devuelve el pool compartido, creándolo en el primer uso.
+ * @return Pool compartido.
+ */
+TilePool& TilePool::shared() {
+    static TilePool pool(sharedThreadCount, sharedPinning);
+    return pool;
+}
+
+/**
+ * @brief Fija el número de hilos del pool compartido antes de su creación.
+ * @param threadCount Número de hilos (0 = uno por núcleo).
+ */
+void TilePool::setSharedThreadCount(int threadCount) {
+    sharedThreadCount = threadCount;
+}
+
+/**
+ * @brief Fija los hilos del pool compartido a los nodos NUMA antes de su creación.
+ * @param pinToNodes true para fijar los hilos.
+ */
+void TilePool::setSharedPinning(bool pinToNodes) {
+    sharedPinning = pinToNodes;
+}
+
+/**
+ * @brief Bucle de un hilo auxiliar.
+ * @param threadIndex Índice del hilo.
+ */
+void TilePool::workerLoop(int threadIndex) {
+    if (!nodeCpus.empty()) {
+        pinCurrentThread(nodeCpus[threadNodes[threadIndex]]);
+    }
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        drainTasks(threadIndex);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--activeWorkers == 0) {
+            done.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief Toma tareas del contador compartido hasta agotarlas.
+ * @param threadIndex Índice del hilo que las ejecuta.
+ */
+void TilePool::drainTasks(int threadIndex) {
+    // job, jobTaskCount y jobPerThread no cambian hasta que todos los hilos terminan el lote
+    if (jobPerThread) {
+        (*job)(threadIndex, threadIndex);
+        return;
+    }
+    for (int i = nextTask.fetch_add(1); i < jobTaskCount; i = nextTask.fetch_add(1)) {
+        (*job)(i, threadIndex);
+    }
+}
@@ -3,6 +3,7 @@
 #include "Vector3D.h"
 #include "Ray.h"
 #include <cmath> // Para fabs y otras funciones matemáticas
+#include <utility> // Para std::move
 
 /**
  * @brief Constructor que inicializa los vértices del triángulo, color, valor especular y reflectividad.
@@ -13,9 +14,13 @@
  * @param color Color del triángulo.
  * @param specular Valor de reflexión especular.
  * @param reflectivity Coeficiente de reflectividad del material.
+ * @param transparency Transparencia del material.
+ * @param refractiveIndex Índice de refracción del material.
  */
-Triangle::Triangle(const Vector3D& a, const Vector3D& b, const Vector3D& c, const Vector3D& color, double specular, double reflectivity)
-    : a(a), b(b), c(c), specular(specular), color(color), reflectivity(reflectivity) {}
+Triangle::Triangle(const Vector3D& a, const Vector3D& b, const Vector3D& c, const Vector3D& color, double specular, double reflectivity,
+                   double transparency, double refractiveIndex)
+    : a(a), b(b), c(c), specular(specular), color(color), reflectivity(reflectivity),
+      transparency(transparency), refractiveIndex(refractiveIndex) {}
 
 /**
  * @brief Método para comprobar si un rayo intersecta con el triángulo.
@@ -26,9 +31,10 @@ Triangle::Triangle(const Vector3D& a, const Vector3D& b, const Vector3D& c, cons
  * @param ray Rayo con el que se verifica la intersección.
  * @param t Parámetro que indica la distancia al punto de intersección más cercano.
  * @param intersectionPoint Punto de intersección calculado si existe.
+ * @param tMax Distancia máxima a considerar; intersecciones en o más allá de ella se descartan.
  * @return true si el rayo intersecta el triángulo, false en caso contrario.
  */
-bool Triangle::intersects(const Ray& ray, double& t, Vector3D& intersectionPoint) const {
+bool Triangle::intersects(const Ray& ray, double& t, Vector3D& intersectionPoint, double tMax) const {
     Vector3D edge1 = b - a;
     Vector3D edge2 = c - a;
 
@@ -58,10 +64,11 @@ bool Triangle::intersects(const Ray& ray, double& t, Vector3D& intersectionPoint
         return false;
     }
 
-    t = invDet * edge2.dot(q);
+    double tHit = invDet * edge2.dot(q);
 
-    // Si t es mayor que un pequeño umbral, la intersección es válida
-    if (t > 1e-6) {
+    // Si t es mayor que un pequeño umbral y no supera tMax, la intersección es válida
+    if (tHit > 1e-6 && tHit < tMax) {
+        t = tHit;
         intersectionPoint = ray.getOrigin() + ray.getDirection() * t; // Calcular el punto de intersección real
         return true;
     }
@@ -69,6 +76,23 @@ bool Triangle::intersects(const Ray& ray, double& t, Vector3D& intersectionPoint
     return false; // No hay intersección válida
 }
 
+/**
+ * @brief Métodos para obtener los vértices del triángulo.
+ * 
+ * @return Vértice correspondiente.
+ */
+Vector3D Triangle::getVertexA() const {
+    return a;
+}
+
+Vector3D Triangle::getVertexB() const {
+    return b;
+}
+
+Vector3D Triangle::getVertexC() const {
+    return c;
+}
+
 /**
  * @brief Método para obtener el vector normal del triángulo.
  * 
@@ -110,3 +134,97 @@ Vector3D Triangle::getColor() const {
 double Triangle::getReflectivity() const {
     return reflectivity;
 }
+
+/**
+ * @brief Método para obtener la transparencia del triángulo.
+ * 
+ * @return Fracción de la luz que atraviesa el triángulo.
+ */
+double Triangle::getTransparency() const {
+    return transparency;
+}
+
+/**
+ * @brief Método para obtener el índice de refracción del triángulo.
+ * 
+ * @return Índice de refracción del material.
+ */
+double Triangle::getRefractiveIndex() const {
+    return refractiveIndex;
+}
+
+/**
+ * @brief Asigna una textura al triángulo.
+ * 
+ * Precalcula la densidad de texels por unidad del mundo a partir de la relación entre el área del
+ * triángulo en coordenadas de textura y su área real.
+ * 
+ * @param texture Textura del material.
+ * @param uvA Coordenadas de textura del primer vértice.
+ * @param uvB Coordenadas de textura del segundo vértice.
+ * @param uvC Coordenadas de textura del tercer vértice.
+ */
+void Triangle::setTexture(std::shared_ptr<const Texture> texture, const TexCoord& uvA, const TexCoord& uvB, const TexCoord& uvC) {
+    this->texture = std::move(texture);
+    uv[0] = uvA;
+    uv[1] = uvB;
+    uv[2] = uvC;
+
+    texelsPerUnit = 0.0;
+    if (this->texture) {
+        double worldArea = 0.5 * (b - a).cross(c - a).norm();
+        double uvArea = 0.5 * fabs((uvB.u - uvA.u) * (uvC.v - uvA.v) - (uvC.u - uvA.u) * (uvB.v - uvA.v));
+        if (worldArea > 0) {
+            texelsPerUnit = sqrt(uvArea * this->texture->getWidth() * this->texture->getHeight() / worldArea);
+        }
+    }
+}
+
+/**
+ * @brief Color del material en un punto del triángulo.
+ * 
+ * Las coordenadas de textura se interpolan con las coordenadas baricéntricas del punto.
+ * 
+ * @param point Punto sobre el triángulo.
+ * @param footprint Ancho de la huella del rayo en el punto.
+ * @return Color en el punto.
+ */
+Vector3D Triangle::getColorAt(const Vector3D& point, double footprint) const {
+    if (!texture) {
+        return color;
+    }
+
+    Vector3D v0 = b - a;
+    Vector3D v1 = c - a;
+    Vector3D v2 = point - a;
+    double d00 = v0.dot(v0), d01 = v0.dot(v1), d11 = v1.dot(v1);
+    double d20 = v2.dot(v0), d21 = v2.dot(v1);
+    double denom = d00 * d11 - d01 * d01;
+    double beta = (d11 * d20 - d01 * d21) / denom;
+    double gamma = (d00 * d21 - d01 * d20) / denom;
+    double alpha = 1.0 - beta - gamma;
+
+    TexCoord coord;
+    coord.u = alpha * uv[0].u + beta * uv[1].u + gamma * uv[2].u;
+    coord.v = alpha * uv[0].v + beta * uv[1].v + gamma * uv[2].v;
+    return texture->sample(coord, texture->levelOfDetail(footprint, texelsPerUnit));
+}
+
+/**
+ * @brief Método para obtener la textura del triángulo.
+ * 
+ * @return Textura del material, o nullptr si usa un color constante.
+ */
+const std::shared_ptr<const Texture>& Triangle::getTexture() const {
+    return texture;
+}
+
+/**
+ * @brief Método para obtener las coordenadas de textura de un vértice.
+ * 
+ * @param vertex Índice del vértice (0, 1 o 2).
+ * @return Coordenadas de textura del vértice.
+ */
+TexCoord Triangle::getTexCoord(int vertex) const {
+    return uv[vertex];
+}
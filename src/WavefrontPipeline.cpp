@@ -0,0 +1,559 @@
+#include "WavefrontPipeline.h"
+#include "generateImage.h"
+#include "TilePool.h"
+#include <algorithm> // Para std::min, std::max y std::copy
+#include <chrono>    // Para medir cada etapa
+#include <cmath>     // Para std::fabs
+
+namespace {
+
+// Rayo de sombra que no se traza (impacto inexistente o muestra sobre el propio punto)
+const std::uint32_t NO_HIT = 0xffffffffu;
+
+// Muestras de la segunda pasada de una luz de área en la penumbra
+const int PENUMBRA_SAMPLES = AREA_LIGHT_MAX_SAMPLES - AREA_LIGHT_MIN_SAMPLES;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+} // namespace
+
+/**
+ * Devuelve el nombre de una etapa para los informes.
+ *
+ * @param stage: Etapa.
+ * @return const char*: Nombre.
+ */
+const char* pipelineStageName(PipelineStage stage) {
+    switch (stage) {
+    case STAGE_GENERATE:
+        return "generate";
+    case STAGE_SORT:
+        return "sort";
+    case STAGE_INTERSECT:
+        return "intersect";
+    case STAGE_SHADOW_RAYS:
+        return "shadow-rays";
+    case STAGE_OCCLUSION:
+        return "occlusion";
+    case STAGE_SHADE:
+        return "shade";
+    case STAGE_ACCUMULATE:
+        return "accumulate";
+    case STAGE_COUNT:
+        break;
+    }
+    return "";
+}
+
+/**
+ * @brief Cambia el número de rayos del búfer.
+ * @param count Número de rayos.
+ */
+void WavefrontPipeline::RayBuffer::resize(size_t count) {
+    for (std::vector<double>* component : { &originX, &originY, &originZ, &directionX, &directionY, &directionZ, &coneWidth, &spreadAngle, &weight }) {
+        component->resize(count);
+    }
+    pixel.resize(count);
+    source.resize(count);
+    tile.resize(count);
+}
+
+/**
+ * @brief Guarda un rayo en la posición i.
+ * @param i Posición.
+ * @param ray Rayo.
+ * @param rayWeight Peso del rayo.
+ * @param rayPixel Píxel del rayo.
+ * @param raySource Posición del rayo en el orden de generación.
+ * @param rayTile Tile de las primitivas candidatas (-1 = toda la escena).
+ */
+void WavefrontPipeline::RayBuffer::set(size_t i, const Ray& ray, double rayWeight, std::uint32_t rayPixel, std::uint32_t raySource, std::int32_t rayTile) {
+    Vector3D origin = ray.getOrigin();
+    Vector3D direction = ray.getDirection();
+    originX[i] = origin.getX();
+    originY[i] = origin.getY();
+    originZ[i] = origin.getZ();
+    directionX[i] = direction.getX();
+    directionY[i] = direction.getY();
+    directionZ[i] = direction.getZ();
+    coneWidth[i] = ray.getConeWidth(0.0);
+    spreadAngle[i] = ray.getSpreadAngle();
+    weight[i] = rayWeight;
+    pixel[i] = rayPixel;
+    source[i] = raySource;
+    tile[i] = rayTile;
+}
+
+/**
+ * @brief Reconstruye el rayo de la posición i.
+ * @param i Posición.
+ * @return Rayo idéntico al guardado.
+ */
+Ray WavefrontPipeline::RayBuffer::get(size_t i) const {
+    return Ray::withUnitDirection(Vector3D(originX[i], originY[i], originZ[i]), Vector3D(directionX[i], directionY[i], directionZ[i]), coneWidth[i], spreadAngle[i]);
+}
+
+/**
+ * @brief Cambia el número de rayos de sombra del búfer (los nuevos no se trazan hasta asignarles un impacto).
+ * @param count Número de rayos.
+ */
+void WavefrontPipeline::ShadowBuffer::resize(size_t count) {
+    directionX.resize(count);
+    directionY.resize(count);
+    directionZ.resize(count);
+    distance.resize(count);
+    hit.assign(count, NO_HIT);
+    occluded.assign(count, 0);
+}
+
+/**
+ * @brief Devuelve la muestra de luz del rayo de sombra i.
+ * @param i Posición.
+ * @return Dirección y distancia.
+ */
+LightSample WavefrontPipeline::ShadowBuffer::get(size_t i) const {
+    LightSample sample;
+    sample.direction = Vector3D(directionX[i], directionY[i], directionZ[i]);
+    sample.distance = distance[i];
+    return sample;
+}
+
+/**
+ * @brief Prepara el render y calcula cuántos rayos de sombra genera cada impacto.
+ *
+ * @param scene Escena.
+ * @param cam Cámara.
+ * @param width Ancho de la imagen.
+ * @param height Alto de la imagen.
+ * @param maxDepth Profundidad máxima.
+ * @param viewportWidth Ancho del viewport.
+ * @param viewportHeight Alto del viewport.
+ * @param distanceToViewport Distancia al viewport.
+ */
+WavefrontPipeline::WavefrontPipeline(const Scene& scene, const Camera& cam, int width, int height, int maxDepth,
+                                     double viewportWidth, double viewportHeight, double distanceToViewport)
+    : scene(scene), cam(cam), width(width), height(height), maxDepth(maxDepth),
+      viewportWidth(viewportWidth), viewportHeight(viewportHeight), distanceToViewport(distanceToViewport) {
+    for (const LightSource& light : scene.getLights()) {
+        if (light.getType() == LightSource::AMBIENT) {
+            lightSlots.push_back(-1);
+        } else if (light.isAreaLight()) {
+            lightSlots.push_back(shadowRaysPerHit);
+            shadowRaysPerHit += AREA_LIGHT_MIN_SAMPLES;
+            ++areaLightCount;
+        } else {
+            lightSlots.push_back(shadowRaysPerHit);
+            ++shadowRaysPerHit;
+        }
+    }
+}
+
+/**
+ * @brief Ejecuta una etapa repartida en tareas de WAVEFRONT_TASK_RAYS elementos y acumula su tiempo.
+ *
+ * @param stage Etapa.
+ * @param count Número de elementos.
+ * @param task Función que recibe el primer elemento, el siguiente al último y el índice de la tarea.
+ */
+template <typename StageTask>
+void WavefrontPipeline::runStage(PipelineStage stage, size_t count, StageTask&& task) {
+    auto start = Clock::now();
+    int taskCount = static_cast<int>((count + WAVEFRONT_TASK_RAYS - 1) / WAVEFRONT_TASK_RAYS);
+    TilePool::shared().run(taskCount, [&](int taskIndex, int) {
+        size_t begin = static_cast<size_t>(taskIndex) * WAVEFRONT_TASK_RAYS;
+        task(begin, std::min(count, begin + WAVEFRONT_TASK_RAYS), taskIndex);
+    });
+    stats.seconds[stage] += std::chrono::duration<double>(Clock::now() - start).count();
+    stats.items[stage] += static_cast<long long>(count);
+}
+
+/**
+ * @brief Genera un rango de filas de la imagen por etapas.
+ *
+ * @param framebuffer Framebuffer de (rowEnd - rowBegin) filas.
+ * @param rowBegin Primera fila a renderizar.
+ * @param rowEnd Fila siguiente a la última a renderizar.
+ * @param sortRays true para ordenar los rayos secundarios.
+ * @param batchPixels Píxeles aproximados de cada lote.
+ * @param preview Vista previa (puede ser nullptr).
+ */
+void WavefrontPipeline::render(Framebuffer& framebuffer, int rowBegin, int rowEnd, bool sortRays, int batchPixels, PreviewStream* preview) {
+    // Lotes de filas de tiles alineadas a la cuadrícula global, como en generateImageWavefront
+    int tileSize = getTileSize();
+    int bandRows = std::max(1, batchPixels / (width * tileSize)) * tileSize;
+    int firstTileY = (rowBegin / tileSize) * tileSize;
+
+    for (int bandY = firstTileY; bandY < rowEnd; bandY += bandRows) {
+        int y0 = std::max(bandY, rowBegin);
+        int y1 = std::min(bandY + bandRows, rowEnd);
+        colors.assign(static_cast<size_t>(y1 - y0) * width, Vector3D(0, 0, 0));
+        raysLeft.assign(colors.size(), MAX_SECONDARY_RAYS_PER_PIXEL);
+
+        generatePrimaryRays(bandY, y0, y1);
+        std::vector<DeferredRay> wave;
+        for (int depth = maxDepth, waveIndex = 1; ; --depth, ++waveIndex) {
+            stats.waves = std::max(stats.waves, waveIndex);
+            intersect();
+            generateShadowRays();
+            traceShadowRays(shadows);
+            generatePenumbraRays();
+            traceShadowRays(penumbraShadows);
+            shade(depth);
+            wave.clear();
+            accumulate(depth == maxDepth, wave);
+            if (wave.empty()) {
+                break;
+            }
+            stats.secondaryRays += static_cast<long long>(wave.size());
+            loadWave(wave, sortRays);
+        }
+
+        auto start = Clock::now();
+        TilePool::shared().run(y1 - y0, [&](int row, int) {
+            for (int x = 0; x < width; ++x) {
+                framebuffer.setPixel(x, y0 + row - rowBegin, colors[static_cast<size_t>(row) * width + x] * (1.0 / 255.0));
+            }
+        });
+        if (preview) {
+            for (int tileY = bandY; tileY < y1; tileY += tileSize) {
+                for (int tileX = 0; tileX < width; tileX += tileSize) {
+                    preview->publishTile(framebuffer, tileX, std::max(tileY, y0), std::min(tileX + tileSize, width), std::min(tileY + tileSize, y1), rowBegin);
+                }
+            }
+        }
+        stats.seconds[STAGE_ACCUMULATE] += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    if (preview) {
+        preview->endPass(1);
+    }
+}
+
+const PipelineStats& WavefrontPipeline::getStats() const {
+    return stats;
+}
+
+/**
+ * @brief Genera los rayos primarios de un lote, tile a tile, y las primitivas candidatas de cada tile.
+ *
+ * @param bandY Primera fila (alineada a los tiles) del lote.
+ * @param y0 Primera fila a renderizar del lote.
+ * @param y1 Fila siguiente a la última del lote.
+ */
+void WavefrontPipeline::generatePrimaryRays(int bandY, int y0, int y1) {
+    auto start = Clock::now();
+    int tileSize = getTileSize();
+    int tileColumns = (width + tileSize - 1) / tileSize;
+    int tileCount = tileColumns * ((y1 - bandY + tileSize - 1) / tileSize);
+
+    // Los rayos de cada tile quedan contiguos, en el mismo orden que recorre generateImageWavefront
+    std::vector<size_t> tileFirst(tileCount + 1, 0);
+    for (int tile = 0; tile < tileCount; ++tile) {
+        int tileX = (tile % tileColumns) * tileSize;
+        int tileY = bandY + (tile / tileColumns) * tileSize;
+        int columns = std::min(tileX + tileSize, width) - tileX;
+        int rows = std::min(tileY + tileSize, y1) - std::max(tileY, y0);
+        tileFirst[tile + 1] = tileFirst[tile] + static_cast<size_t>(columns) * std::max(rows, 0);
+    }
+    rays.resize(tileFirst[tileCount]);
+    candidates.assign(tileCount, PrimitiveList());
+
+    TilePool::shared().run(tileCount, [&](int tile, int) {
+        int tileX = (tile % tileColumns) * tileSize;
+        int tileY = bandY + (tile / tileColumns) * tileSize;
+        int x1 = std::min(tileX + tileSize, width);
+        candidates[tile] = cullPrimitivesForTile(scene, cam, tileX, tileY, x1, std::min(tileY + tileSize, height), width, height, viewportWidth, viewportHeight, distanceToViewport);
+        size_t i = tileFirst[tile];
+        for (int y = std::max(tileY, y0); y < std::min(tileY + tileSize, y1); ++y) {
+            for (int x = tileX; x < x1; ++x, ++i) {
+                Ray ray = cam.generateRay(x, y, width, height, viewportWidth, viewportHeight, distanceToViewport);
+                rays.set(i, ray, 1.0, static_cast<std::uint32_t>((y - y0) * width + x), static_cast<std::uint32_t>(i), tile);
+            }
+        }
+    });
+    stats.seconds[STAGE_GENERATE] += std::chrono::duration<double>(Clock::now() - start).count();
+    stats.items[STAGE_GENERATE] += static_cast<long long>(rays.pixel.size());
+    stats.primaryRays += static_cast<long long>(rays.pixel.size());
+}
+
+/**
+ * @brief Copia un frente de rayos secundarios al búfer de rayos, ordenado si sortRays es true.
+ *
+ * @param wave Rayos en el orden en que se generaron.
+ * @param sortRays true para ordenarlos con sortRaysByCoherence.
+ */
+void WavefrontPipeline::loadWave(const std::vector<DeferredRay>& wave, bool sortRays) {
+    auto start = Clock::now();
+    std::vector<std::uint32_t> order;
+    if (sortRays) {
+        sortRaysByCoherence(wave, order);
+    }
+    stats.seconds[STAGE_SORT] += std::chrono::duration<double>(Clock::now() - start).count();
+
+    rays.resize(wave.size());
+    runStage(STAGE_SORT, wave.size(), [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            std::uint32_t index = sortRays ? order[i] : static_cast<std::uint32_t>(i);
+            const DeferredRay& ray = wave[index];
+            rays.set(i, ray.ray, ray.weight, ray.pixel, index, -1);
+        }
+    });
+}
+
+/**
+ * @brief Etapa de intersección: el impacto más cercano de cada rayo del frente (por lotes si hay geometría paginada).
+ */
+void WavefrontPipeline::intersect() {
+    size_t count = rays.pixel.size();
+    hits.resize(count);
+    found.resize(count);
+    if (!scene.getPagedGeometry()) {
+        runStage(STAGE_INTERSECT, count, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; ++i) {
+                Ray ray = rays.get(i);
+                std::int32_t tile = rays.tile[i];
+                found[i] = tile >= 0 ? scene.closestHit(ray, candidates[tile], hits[i]) : scene.closestHit(ray, hits[i]);
+            }
+        });
+        return;
+    }
+
+    // Con geometría paginada cada tarea intersecta sus rayos como un lote, que lee cada chunk una sola vez
+    runStage(STAGE_INTERSECT, count, [&](size_t begin, size_t end, int) {
+        std::vector<Ray> batch;
+        std::vector<const PrimitiveList*> batchCandidates;
+        batch.reserve(end - begin);
+        batchCandidates.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            batch.push_back(rays.get(i));
+            batchCandidates.push_back(rays.tile[i] >= 0 ? &candidates[rays.tile[i]] : nullptr);
+        }
+        std::vector<HitRecord> batchHits;
+        std::vector<unsigned char> batchFound;
+        scene.closestHitBatch(batch, batchCandidates, batchHits, batchFound);
+        std::copy(batchHits.begin(), batchHits.end(), hits.begin() + begin);
+        std::copy(batchFound.begin(), batchFound.end(), found.begin() + begin);
+    });
+}
+
+/**
+ * @brief Etapa de rayos de sombra: material de cada impacto y shadowRaysPerHit rayos de sombra por impacto.
+ */
+void WavefrontPipeline::generateShadowRays() {
+    size_t count = rays.pixel.size();
+    const std::vector<LightSource>& lights = scene.getLights();
+    materials.resize(count);
+    shadows.resize(count * shadowRaysPerHit);
+    runStage(STAGE_SHADOW_RAYS, count, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!found[i]) {
+                continue;
+            }
+            const HitRecord& hit = hits[i];
+
+            // Huella del rayo sobre la superficie, como en Scene::shade
+            Vector3D viewDirection = Vector3D(rays.directionX[i], rays.directionY[i], rays.directionZ[i]) * -1;
+            double footprint = rays.get(i).getConeWidth(hit.t) / std::max(std::fabs(hit.normal.dot(viewDirection)), 0.2);
+            materials[i] = scene.getMaterial(hit, footprint);
+
+            for (size_t light = 0; light < lights.size(); ++light) {
+                if (lightSlots[light] < 0) {
+                    continue;
+                }
+                int samples = lights[light].isAreaLight() ? AREA_LIGHT_MIN_SAMPLES : 1;
+                for (int sampleIndex = 0; sampleIndex < samples; ++sampleIndex) {
+                    size_t slot = i * shadowRaysPerHit + lightSlots[light] + sampleIndex;
+                    LightSample sample = Scene::sampleLight(lights[light], hit.point, sampleIndex);
+                    shadows.directionX[slot] = sample.direction.getX();
+                    shadows.directionY[slot] = sample.direction.getY();
+                    shadows.directionZ[slot] = sample.direction.getZ();
+                    shadows.distance[slot] = sample.distance;
+                    // Una muestra sobre el propio punto no se traza: en las luces de área cuenta como muestra y
+                    // una luz puntual en el punto se omite
+                    shadows.hit[slot] = sample.distance == 0 ? NO_HIT : static_cast<std::uint32_t>(i);
+                }
+            }
+        }
+    });
+}
+
+/**
+ * @brief Etapa de rayos de sombra (segunda pasada): muestras restantes de las luces de área en la penumbra.
+ *
+ * Un impacto está en la penumbra de una luz si solo algunas de sus AREA_LIGHT_MIN_SAMPLES primeras
+ * muestras son visibles, el mismo criterio que Scene::computeAreaLighting.
+ */
+void WavefrontPipeline::generatePenumbraRays() {
+    size_t count = rays.pixel.size();
+    const std::vector<LightSource>& lights = scene.getLights();
+    std::vector<unsigned char> penumbra(count * areaLightCount, 0);
+    penumbraFirst.assign(count + 1, 0);
+    if (areaLightCount == 0) {
+        penumbraShadows.resize(0);
+        return;
+    }
+
+    runStage(STAGE_SHADOW_RAYS, count, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!found[i]) {
+                continue;
+            }
+            int areaLight = 0;
+            for (size_t light = 0; light < lights.size(); ++light) {
+                if (lightSlots[light] < 0 || !lights[light].isAreaLight()) {
+                    continue;
+                }
+                size_t slot = i * shadowRaysPerHit + lightSlots[light];
+                int visible = 0;
+                for (int sampleIndex = 0; sampleIndex < AREA_LIGHT_MIN_SAMPLES; ++sampleIndex) {
+                    visible += shadows.hit[slot + sampleIndex] != NO_HIT && !shadows.occluded[slot + sampleIndex];
+                }
+                penumbra[i * areaLightCount + areaLight++] = visible > 0 && visible < AREA_LIGHT_MIN_SAMPLES;
+            }
+        }
+    });
+    for (size_t i = 0; i < count; ++i) {
+        std::uint32_t lightsInPenumbra = 0;
+        for (int areaLight = 0; areaLight < areaLightCount; ++areaLight) {
+            lightsInPenumbra += penumbra[i * areaLightCount + areaLight];
+        }
+        penumbraFirst[i + 1] = penumbraFirst[i] + lightsInPenumbra * PENUMBRA_SAMPLES;
+    }
+
+    penumbraShadows.resize(penumbraFirst[count]);
+    runStage(STAGE_SHADOW_RAYS, count, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            size_t slot = penumbraFirst[i];
+            int areaLight = 0;
+            for (size_t light = 0; light < lights.size() && slot < penumbraFirst[i + 1]; ++light) {
+                if (lightSlots[light] < 0 || !lights[light].isAreaLight() || !penumbra[i * areaLightCount + areaLight++]) {
+                    continue;
+                }
+                for (int sampleIndex = AREA_LIGHT_MIN_SAMPLES; sampleIndex < AREA_LIGHT_MAX_SAMPLES; ++sampleIndex, ++slot) {
+                    LightSample sample = Scene::sampleLight(lights[light], hits[i].point, sampleIndex);
+                    penumbraShadows.directionX[slot] = sample.direction.getX();
+                    penumbraShadows.directionY[slot] = sample.direction.getY();
+                    penumbraShadows.directionZ[slot] = sample.direction.getZ();
+                    penumbraShadows.distance[slot] = sample.distance;
+                    penumbraShadows.hit[slot] = sample.distance == 0 ? NO_HIT : static_cast<std::uint32_t>(i);
+                }
+            }
+        }
+    });
+    // Las dos pasadas recorren los mismos impactos que generateShadowRays
+    stats.items[STAGE_SHADOW_RAYS] -= 2 * static_cast<long long>(count);
+}
+
+/**
+ * @brief Etapa de oclusión: traza los rayos de sombra de un búfer.
+ *
+ * @param shadowBuffer Rayos de sombra (se escribe occluded).
+ */
+void WavefrontPipeline::traceShadowRays(ShadowBuffer& shadowBuffer) {
+    size_t count = shadowBuffer.hit.size();
+    runStage(STAGE_OCCLUSION, count, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; ++i) {
+            if (shadowBuffer.hit[i] != NO_HIT) {
+                LightSample sample = shadowBuffer.get(i);
+                shadowBuffer.occluded[i] = scene.isInShadow(hits[shadowBuffer.hit[i]].point, sample.direction, sample.distance);
+            }
+        }
+    });
+    for (std::uint32_t hit : shadowBuffer.hit) {
+        stats.shadowRays += hit != NO_HIT;
+    }
+}
+
+/**
+ * @brief Etapa de sombreado: suma la luz de las muestras visibles (en el orden de Scene::computeLighting),
+ * calcula el color local y encola los rayos secundarios.
+ *
+ * @param depth Profundidad restante de los rayos del frente.
+ */
+void WavefrontPipeline::shade(int depth) {
+    size_t count = rays.pixel.size();
+    const std::vector<LightSource>& lights = scene.getLights();
+    rayColors.assign(count, Vector3D(0, 0, 0));
+    ranges.assign(count, SpawnedRange{ 0, 0, 0 });
+    taskSpawned.assign((count + WAVEFRONT_TASK_RAYS - 1) / WAVEFRONT_TASK_RAYS, std::vector<DeferredRay>());
+
+    runStage(STAGE_SHADE, count, [&](size_t begin, size_t end, int task) {
+        std::vector<DeferredRay>& spawned = taskSpawned[task];
+        for (size_t i = begin; i < end; ++i) {
+            if (!found[i]) {
+                continue;
+            }
+            const HitRecord& hit = hits[i];
+            const SurfaceMaterial& material = materials[i];
+            Vector3D viewDirection = Vector3D(rays.directionX[i], rays.directionY[i], rays.directionZ[i]) * -1;
+
+            double totalIntensity = 0.0;
+            size_t penumbraSlot = penumbraFirst[i];
+            for (size_t light = 0; light < lights.size(); ++light) {
+                if (lightSlots[light] < 0) {
+                    totalIntensity += lights[light].getIntensity();
+                    continue;
+                }
+                size_t slot = i * shadowRaysPerHit + lightSlots[light];
+                if (!lights[light].isAreaLight()) {
+                    if (shadows.hit[slot] != NO_HIT && !shadows.occluded[slot]) {
+                        totalIntensity += Scene::sampleIntensity(lights[light], shadows.get(slot), hit.normal, viewDirection, material.specular);
+                    }
+                    continue;
+                }
+
+                double sum = 0.0;
+                int visible = 0;
+                for (int sampleIndex = 0; sampleIndex < AREA_LIGHT_MIN_SAMPLES; ++sampleIndex, ++slot) {
+                    if (shadows.hit[slot] != NO_HIT && !shadows.occluded[slot]) {
+                        ++visible;
+                        sum += Scene::sampleIntensity(lights[light], shadows.get(slot), hit.normal, viewDirection, material.specular);
+                    }
+                }
+                int sampleCount = AREA_LIGHT_MIN_SAMPLES;
+                if (visible > 0 && visible < AREA_LIGHT_MIN_SAMPLES) {
+                    for (int sampleIndex = 0; sampleIndex < PENUMBRA_SAMPLES; ++sampleIndex, ++penumbraSlot) {
+                        if (penumbraShadows.hit[penumbraSlot] != NO_HIT && !penumbraShadows.occluded[penumbraSlot]) {
+                            sum += Scene::sampleIntensity(lights[light], penumbraShadows.get(penumbraSlot), hit.normal, viewDirection, material.specular);
+                        }
+                    }
+                    sampleCount = AREA_LIGHT_MAX_SAMPLES;
+                }
+                totalIntensity += sum / sampleCount;
+            }
+
+            Vector3D localColor = material.color * std::min(totalIntensity, 1.0);
+            std::uint32_t first = static_cast<std::uint32_t>(spawned.size());
+            std::uint32_t source = rays.source[i];
+            rayColors[source] = scene.shadeDeferred(rays.get(i), hit, material, localColor, depth, rays.weight[i], rays.pixel[i], spawned);
+            ranges[source] = { static_cast<std::uint32_t>(task), first, static_cast<std::uint32_t>(spawned.size()) - first };
+        }
+    });
+}
+
+/**
+ * @brief Etapa de acumulación: suma el color de cada rayo a su píxel y encola sus rayos secundarios,
+ * en el orden en que se generaron los rayos (no depende del orden de trazado ni de los hilos).
+ *
+ * @param primary true si el frente es el de los rayos primarios (su color se asigna al píxel).
+ * @param next Frente siguiente.
+ */
+void WavefrontPipeline::accumulate(bool primary, std::vector<DeferredRay>& next) {
+    auto start = Clock::now();
+    size_t count = rays.pixel.size();
+    std::vector<std::uint32_t> pixels(count);
+    std::vector<double> weights(count);
+    for (size_t i = 0; i < count; ++i) {
+        pixels[rays.source[i]] = rays.pixel[i];
+        weights[rays.source[i]] = rays.weight[i];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        Vector3D& color = colors[pixels[i]];
+        color = primary ? rayColors[i] : color + rayColors[i] * weights[i];
+        const SpawnedRange& range = ranges[i];
+        if (range.count > 0) {
+            enqueueDeferredRays(taskSpawned[range.task].data() + range.first, range.count, raysLeft, colors, next);
+        }
+    }
+    stats.seconds[STAGE_ACCUMULATE] += std::chrono::duration<double>(Clock::now() - start).count();
+    stats.items[STAGE_ACCUMULATE] += static_cast<long long>(count);
+}
@@ -1,48 +1,22 @@
 #include "createPPM.h"
-#include "Vector3D.h"  // Para manejar los colores usando Vector3D
 #include <iostream>    // Para std::cerr
-#include <fstream>     // Para std::ofstream
+#include <fstream>     // Para std::ofstream y std::ifstream
+#include <cctype>      // Para std::isspace
 #include <vector>      // Para std::vector
-#include <algorithm>   // Para std::clamp
+#include <utility>     // Para std::move
 #include <filesystem>  // Para std::filesystem::create_directories (C++17)
 
 namespace fs = std::filesystem;
 
 /**
- * Aplica corrección gamma a un color dado.
+ * Crea un archivo de imagen en formato PPM binario a partir de un framebuffer.
  *
- * @param color: Color como un Vector3D con valores de los componentes R, G, B.
- * @param gamma: Valor gamma (por defecto 2.2) para la corrección.
- * @return Vector3D: Color corregido con gamma.
+ * @param framebuffer: Framebuffer con la imagen completa.
+ * @param path: Ruta del archivo de salida.
  */
-Vector3D applyGammaCorrection(const Vector3D& color, double gamma = 2.2) {
-    return Vector3D(
-        pow(color.getX() / 255.0, 1.0 / gamma) * 255,
-        pow(color.getY() / 255.0, 1.0 / gamma) * 255,
-        pow(color.getZ() / 255.0, 1.0 / gamma) * 255
-    );
-}
-
-/**
- * Limita un valor a un rango entre 0 y 255.
- *
- * @param value: Valor que se va a limitar.
- * @return int: Valor limitado entre 0 y 255.
- */
-int clamp(double value) {
-    return static_cast<int>(std::clamp(value, 0.0, 255.0));
-}
-
-/**
- * Crea un archivo de imagen en formato PPM a partir de un framebuffer.
- *
- * @param framebuffer: Vector de píxeles representados como objetos Vector3D (RGB).
- * @param width: Ancho de la imagen.
- * @param height: Alto de la imagen.
- */
-void createPPM(const std::vector<Vector3D>& framebuffer, int width, int height) {
+void createPPM(const Framebuffer& framebuffer, const std::string& path) {
     std::cout << "Intentando crear el archivo PPM en la ruta especificada...\n";
-    std::ofstream file("./output/output.ppm");
+    std::ofstream file(path, std::ios::binary);
     
     if (!file.is_open()) {
         std::cerr << "Error: No se pudo abrir el archivo para escritura." << std::endl;
@@ -51,18 +25,74 @@ void createPPM(const std::vector<Vector3D>& framebuffer, int width, int height)
 
     std::cout << "Archivo PPM creado correctamente. Escribiendo datos...\n";
 
-    file << "P3\n" << width << " " << height << "\n255\n";
+    int width = framebuffer.getWidth();
+    int height = framebuffer.getRows();
+    file << "P6\n" << width << " " << height << "\n255\n";
 
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            Vector3D color = applyGammaCorrection(framebuffer[i * width + j]);
-            file << clamp(color.getX()) << " "
-                 << clamp(color.getY()) << " "
-                 << clamp(color.getZ()) << " ";
+    if (framebuffer.getFormat() == PixelFormat::SRGB8) {
+        // Los bytes del framebuffer ya son el cuerpo del PPM
+        file.write(reinterpret_cast<const char*>(framebuffer.getData()), framebuffer.getByteSize());
+    } else {
+        std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+        for (int i = 0; i < height; ++i) {
+            framebuffer.encodeRowSRGB8(i, row.data());
+            file.write(reinterpret_cast<const char*>(row.data()), row.size());
         }
-        file << "\n";
     }
 
     file.close();
     std::cout << "Datos escritos correctamente. Archivo cerrado.\n";
 }
+
+/**
+ * Lee una imagen PPM binaria (P6) de 8 bits.
+ *
+ * @param path: Ruta del archivo.
+ * @param framebuffer: Framebuffer SRGB8 con la imagen leída.
+ * @return bool: true si el archivo es un P6 válido y completo.
+ */
+bool readPPM(const std::string& path, Framebuffer& framebuffer) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string magic;
+    file >> magic;
+    int width = 0, height = 0, maxValue = 0;
+    if (magic != "P6" || !readPPMHeaderValue(file, width) || !readPPMHeaderValue(file, height) ||
+        !readPPMHeaderValue(file, maxValue) || width <= 0 || height <= 0 || maxValue != 255) {
+        return false;
+    }
+    file.get(); // Un único espacio separa la cabecera de los datos binarios
+
+    Framebuffer image(width, height, PixelFormat::SRGB8);
+    file.read(reinterpret_cast<char*>(image.getData()), image.getByteSize());
+    if (!file) {
+        return false;
+    }
+    framebuffer = std::move(image);
+    return true;
+}
+
+/**
+ * Lee el siguiente entero de la cabecera de un PPM, ignorando espacios y comentarios.
+ *
+ * @param in: Flujo posicionado dentro de la cabecera.
+ * @param value: Valor leído.
+ * @return bool: true si se pudo leer un entero.
+ */
+bool readPPMHeaderValue(std::istream& in, int& value) {
+    while (true) {
+        int c = in.peek();
+        if (c == '#') {
+            std::string comment;
+            std::getline(in, comment);
+        } else if (std::isspace(c)) {
+            in.get();
+        } else {
+            break;
+        }
+    }
+    return static_cast<bool>(in >> value);
+}
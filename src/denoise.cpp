@@ -0,0 +1,313 @@
+#include "denoise.h"
+#include "generateImage.h"
+#include "TilePool.h"
+#include "Ray.h"
+#include <algorithm> // Para std::min y std::max
+#include <chrono>    // Para medir el tiempo de filtrado
+#include <cmath>     // Para std::fabs
+
+#define DENOISE_ROWS_PER_TASK 16     // Filas que procesa cada tarea del pool
+#define DENOISE_MIN_ALBEDO 0.01f     // Albedo mínimo al dividir el color (evita amplificar el ruido sin límite)
+
+namespace {
+
+// Pesos del núcleo B-spline cúbico de 5 muestras
+const float KERNEL[5] = { 1.0f / 16, 1.0f / 4, 3.0f / 8, 1.0f / 4, 1.0f / 16 };
+
+// Aproximación de exp(-x) para x >= 0, sin ramas ni llamadas a la biblioteca para que el bucle
+// interno del filtro se pueda vectorizar. Los pesos de borde no necesitan más precisión.
+inline float approxNegExp(float x) {
+    return 1.0f / (1.0f + x + x * x * (1.0f / 2) + x * x * x * (1.0f / 6));
+}
+
+/**
+ * Suma la contribución de un vecino del núcleo a una fila de píxeles.
+ *
+ * center y neighbor contienen, en este orden, los canales r, g, b, normal x, y, z y profundidad del píxel
+ * central y de su vecino. Todos los punteros son __restrict: sin eso el compilador tendría que comprobar
+ * en tiempo de ejecución que no se solapan (más comprobaciones de las que acepta) y no vectorizaría el bucle.
+ */
+void accumulateTap(const float* const center[7], const float* const neighbor[7],
+                   float* __restrict sumR, float* __restrict sumG, float* __restrict sumB, float* __restrict sumW,
+                   int count, float kernel, float invColor, float invNormal, float depthScale) {
+    const float* __restrict r0 = center[0];
+    const float* __restrict g0 = center[1];
+    const float* __restrict b0 = center[2];
+    const float* __restrict nx0 = center[3];
+    const float* __restrict ny0 = center[4];
+    const float* __restrict nz0 = center[5];
+    const float* __restrict z0 = center[6];
+    const float* __restrict r1 = neighbor[0];
+    const float* __restrict g1 = neighbor[1];
+    const float* __restrict b1 = neighbor[2];
+    const float* __restrict nx1 = neighbor[3];
+    const float* __restrict ny1 = neighbor[4];
+    const float* __restrict nz1 = neighbor[5];
+    const float* __restrict z1 = neighbor[6];
+
+    for (int x = 0; x < count; ++x) {
+        float dr = r1[x] - r0[x], dg = g1[x] - g0[x], db = b1[x] - b0[x];
+        float dnx = nx1[x] - nx0[x], dny = ny1[x] - ny0[x], dnz = nz1[x] - nz0[x];
+        float colorDistance = dr * dr + dg * dg + db * db;
+        float normalDistance = dnx * dnx + dny * dny + dnz * dnz;
+        float depthDistance = std::fabs(z1[x] - z0[x]) * depthScale / z0[x];
+
+        float weight = kernel * approxNegExp(colorDistance * invColor + normalDistance * invNormal + depthDistance);
+        sumR[x] += weight * r1[x];
+        sumG[x] += weight * g1[x];
+        sumB[x] += weight * b1[x];
+        sumW[x] += weight;
+    }
+}
+
+// Imagen con un arreglo por canal
+struct PlanarImage {
+    std::vector<float> r, g, b;
+
+    explicit PlanarImage(size_t size) : r(size), g(size), b(size) {}
+};
+
+/**
+ * Una pasada del filtro à-trous sobre un rango de filas.
+ *
+ * Se recorre vecino por vecino y, para cada uno, toda la fila: así el bucle interno lee memoria
+ * contigua y no tiene ramas (los vecinos fuera de la imagen se excluyen ajustando el rango de x).
+ */
+void filterRows(const PlanarImage& input, PlanarImage& output, const GuideBuffers& guides, int step, float sigmaColor,
+                int y0, int y1, std::vector<float>& sums) {
+    const int width = guides.width;
+    const int rows = guides.rows;
+    const float invColor = 1.0f / (sigmaColor * sigmaColor);
+    const float invNormal = 1.0f / (DENOISE_SIGMA_NORMAL * DENOISE_SIGMA_NORMAL);
+    const float depthScale = 1.0f / (DENOISE_SIGMA_DEPTH * step);
+
+    float* __restrict sumR = sums.data();
+    float* __restrict sumG = sumR + width;
+    float* __restrict sumB = sumG + width;
+    float* __restrict sumW = sumB + width;
+
+    for (int y = y0; y < y1; ++y) {
+        const size_t row = static_cast<size_t>(y) * width;
+        const float* __restrict cr = &input.r[row];
+        const float* __restrict cg = &input.g[row];
+        const float* __restrict cb = &input.b[row];
+        const float* cnx = &guides.normalX[row];
+        const float* cny = &guides.normalY[row];
+        const float* cnz = &guides.normalZ[row];
+        const float* cz = &guides.depth[row];
+
+        // El píxel central tiene peso de borde 1
+        const float centerWeight = KERNEL[2] * KERNEL[2];
+        for (int x = 0; x < width; ++x) {
+            sumR[x] = centerWeight * cr[x];
+            sumG[x] = centerWeight * cg[x];
+            sumB[x] = centerWeight * cb[x];
+            sumW[x] = centerWeight;
+        }
+
+        for (int ky = 0; ky < 5; ++ky) {
+            int neighborY = y + (ky - 2) * step;
+            if (neighborY < 0 || neighborY >= rows) {
+                continue;
+            }
+            const size_t neighborRow = static_cast<size_t>(neighborY) * width;
+
+            for (int kx = 0; kx < 5; ++kx) {
+                if (kx == 2 && ky == 2) {
+                    continue;
+                }
+                const int offset = (kx - 2) * step;
+                const float kernel = KERNEL[kx] * KERNEL[ky];
+                const int xBegin = std::max(0, -offset);
+                const int xEnd = std::min(width, width - offset);
+                if (xEnd <= xBegin) {
+                    continue;
+                }
+
+                // Primer píxel válido del centro y de su vecino
+                const size_t first = neighborRow + xBegin + offset;
+                const float* center[7] = { cr + xBegin, cg + xBegin, cb + xBegin, cnx + xBegin, cny + xBegin, cnz + xBegin, cz + xBegin };
+                const float* neighbor[7] = { &input.r[first], &input.g[first], &input.b[first], &guides.normalX[first],
+                                             &guides.normalY[first], &guides.normalZ[first], &guides.depth[first] };
+                accumulateTap(center, neighbor, sumR + xBegin, sumG + xBegin, sumB + xBegin, sumW + xBegin, xEnd - xBegin,
+                              kernel, invColor, invNormal, depthScale);
+            }
+        }
+
+        float* __restrict outR = &output.r[row];
+        float* __restrict outG = &output.g[row];
+        float* __restrict outB = &output.b[row];
+        for (int x = 0; x < width; ++x) {
+            float inverse = 1.0f / sumW[x];
+            outR[x] = sumR[x] * inverse;
+            outG[x] = sumG[x] * inverse;
+            outB[x] = sumB[x] * inverse;
+        }
+    }
+}
+
+/**
+ * Limita cada canal de cada píxel al máximo de sus 8 vecinos en un rango de filas.
+ *
+ * Elimina las muestras aisladas muy brillantes (luciérnagas), que el filtro conservaría porque su color
+ * es distinto del de todos sus vecinos. En un borde real el píxel tiene vecinos igual de brillantes, así
+ * que no cambia.
+ */
+void clampFireflies(const PlanarImage& input, PlanarImage& output, int width, int rows, int y0, int y1) {
+    const std::vector<float>* inChannels[3] = { &input.r, &input.g, &input.b };
+    std::vector<float>* outChannels[3] = { &output.r, &output.g, &output.b };
+
+    for (int channel = 0; channel < 3; ++channel) {
+        const std::vector<float>& in = *inChannels[channel];
+        std::vector<float>& out = *outChannels[channel];
+        for (int y = y0; y < y1; ++y) {
+            for (int x = 0; x < width; ++x) {
+                float neighborMax = 0.0f;
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        int nx = x + dx, ny = y + dy;
+                        if ((dx != 0 || dy != 0) && nx >= 0 && nx < width && ny >= 0 && ny < rows) {
+                            neighborMax = std::max(neighborMax, in[static_cast<size_t>(ny) * width + nx]);
+                        }
+                    }
+                }
+                size_t i = static_cast<size_t>(y) * width + x;
+                out[i] = std::min(in[i], neighborMax);
+            }
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Calcula los búferes auxiliares con un rayo por el centro de cada píxel.
+ *
+ * @param scene Escena.
+ * @param cam Cámara.
+ * @param width Ancho de la imagen completa.
+ * @param height Alto de la imagen completa.
+ * @param rowBegin Primera fila.
+ * @param rowEnd Fila siguiente a la última.
+ * @param viewportWidth Ancho del viewport.
+ * @param viewportHeight Alto del viewport.
+ * @param distanceToViewport Distancia entre la cámara y el viewport.
+ * @return Búferes del rango de filas.
+ */
+GuideBuffers computeGuideBuffers(const Scene& scene, const Camera& cam, int width, int height, int rowBegin, int rowEnd,
+                                 double viewportWidth, double viewportHeight, double distanceToViewport) {
+    GuideBuffers guides;
+    guides.width = width;
+    guides.rows = rowEnd - rowBegin;
+    size_t size = static_cast<size_t>(guides.rows) * width;
+    guides.normalX.assign(size, 0.0f);
+    guides.normalY.assign(size, 0.0f);
+    guides.normalZ.assign(size, 0.0f);
+    guides.depth.assign(size, DENOISE_NO_HIT_DEPTH);
+    guides.albedoR.assign(size, 1.0f);
+    guides.albedoG.assign(size, 1.0f);
+    guides.albedoB.assign(size, 1.0f);
+
+    int tileSize = getTileSize();
+    int firstTileY = (rowBegin / tileSize) * tileSize;
+    int tileColumns = (width + tileSize - 1) / tileSize;
+    int tileRows = (rowEnd - firstTileY + tileSize - 1) / tileSize;
+
+    TilePool::shared().run(tileColumns * tileRows, [&](int tile, int) {
+        int tileX = (tile % tileColumns) * tileSize;
+        int tileY = firstTileY + (tile / tileColumns) * tileSize;
+        int x1 = std::min(tileX + tileSize, width);
+        PrimitiveList candidates = cullPrimitivesForTile(scene, cam, tileX, tileY, x1, std::min(tileY + tileSize, height),
+                                                         width, height, viewportWidth, viewportHeight, distanceToViewport);
+
+        for (int y = std::max(tileY, rowBegin); y < std::min(tileY + tileSize, rowEnd); ++y) {
+            for (int x = tileX; x < x1; ++x) {
+                Ray ray = cam.generateRay(x + 0.5, y + 0.5, width, height, viewportWidth, viewportHeight, distanceToViewport);
+                HitRecord hit;
+                if (!scene.closestHit(ray, candidates, hit)) {
+                    continue;
+                }
+
+                // Normal orientada hacia la cámara, para que las dos caras de un triángulo coincidan
+                Vector3D normal = hit.normal.dot(ray.getDirection()) > 0 ? hit.normal * -1 : hit.normal;
+                double footprint = ray.getConeWidth(hit.t) / std::max(std::fabs(normal.dot(ray.getDirection())), 0.2);
+
+                SurfaceMaterial material = scene.getMaterial(hit, footprint);
+                double localWeight = (1 - material.transparency) * (1 - material.reflectivity);
+
+                size_t i = static_cast<size_t>(y - rowBegin) * width + x;
+                guides.normalX[i] = static_cast<float>(normal.getX());
+                guides.normalY[i] = static_cast<float>(normal.getY());
+                guides.normalZ[i] = static_cast<float>(normal.getZ());
+                guides.depth[i] = static_cast<float>(hit.t);
+                guides.albedoR[i] = static_cast<float>(material.color.getX() / 255.0 * localWeight + (1 - localWeight));
+                guides.albedoG[i] = static_cast<float>(material.color.getY() / 255.0 * localWeight + (1 - localWeight));
+                guides.albedoB[i] = static_cast<float>(material.color.getZ() / 255.0 * localWeight + (1 - localWeight));
+            }
+        }
+    });
+
+    return guides;
+}
+
+/**
+ * @brief Filtra el ruido de la imagen guiándose por los búferes auxiliares.
+ *
+ * @param framebuffer Imagen a filtrar; se sobrescribe.
+ * @param guides Búferes auxiliares.
+ * @param iterations Número de pasadas.
+ * @return Tiempo de filtrado en segundos.
+ */
+double denoiseImage(Framebuffer& framebuffer, const GuideBuffers& guides, int iterations) {
+    auto start = std::chrono::high_resolution_clock::now();
+    const int width = guides.width;
+    const int rows = guides.rows;
+    const size_t size = static_cast<size_t>(width) * rows;
+
+    // Separar la iluminación del albedo
+    PlanarImage current(size), next(size);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < width; ++x) {
+            size_t i = static_cast<size_t>(y) * width + x;
+            Vector3D color = framebuffer.getPixel(x, y);
+            current.r[i] = static_cast<float>(color.getX()) / std::max(guides.albedoR[i], DENOISE_MIN_ALBEDO);
+            current.g[i] = static_cast<float>(color.getY()) / std::max(guides.albedoG[i], DENOISE_MIN_ALBEDO);
+            current.b[i] = static_cast<float>(color.getZ()) / std::max(guides.albedoB[i], DENOISE_MIN_ALBEDO);
+        }
+    }
+
+    // Sumas parciales de una fila por hilo
+    TilePool& pool = TilePool::shared();
+    std::vector<std::vector<float>> threadSums(pool.getThreadCount(), std::vector<float>(static_cast<size_t>(width) * 4));
+    int taskCount = (rows + DENOISE_ROWS_PER_TASK - 1) / DENOISE_ROWS_PER_TASK;
+
+    pool.run(taskCount, [&](int task, int) {
+        int y0 = task * DENOISE_ROWS_PER_TASK;
+        clampFireflies(current, next, width, rows, y0, std::min(y0 + DENOISE_ROWS_PER_TASK, rows));
+    });
+    std::swap(current, next);
+
+    float sigmaColor = DENOISE_SIGMA_COLOR;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        int step = 1 << iteration;
+        pool.run(taskCount, [&](int task, int thread) {
+            int y0 = task * DENOISE_ROWS_PER_TASK;
+            int y1 = std::min(y0 + DENOISE_ROWS_PER_TASK, rows);
+            filterRows(current, next, guides, step, sigmaColor, y0, y1, threadSums[thread]);
+        });
+        std::swap(current, next);
+        sigmaColor *= 0.5f;
+    }
+
+    // Volver a multiplicar por el albedo
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < width; ++x) {
+            size_t i = static_cast<size_t>(y) * width + x;
+            framebuffer.setPixel(x, y, Vector3D(current.r[i] * std::max(guides.albedoR[i], DENOISE_MIN_ALBEDO),
+                                                current.g[i] * std::max(guides.albedoG[i], DENOISE_MIN_ALBEDO),
+                                                current.b[i] * std::max(guides.albedoB[i], DENOISE_MIN_ALBEDO)));
+        }
+    }
+
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
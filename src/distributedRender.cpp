@@ -0,0 +1,293 @@
+#include "distributedRender.h"
+#include <iostream>    // Para std::cout y std::cerr
+#include <chrono>      // Para medir la duración de los trabajos
+#include <thread>      // Para std::this_thread::sleep_for
+#include <deque>       // Para la cola de trabajos pendientes
+#include <filesystem>  // Para crear directorios, renombrar y borrar archivos (C++17)
+#include <algorithm>   // Para std::min
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <spawn.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace fs = std::filesystem;
+
+#define MAX_JOB_FAILURES 3      // Intentos fallidos permitidos por trabajo antes de abortar
+#define POLL_INTERVAL_MS 10     // Intervalo de sondeo de los procesos trabajadores
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#ifdef _WIN32
+using ProcessHandle = HANDLE;
+#else
+using ProcessHandle = pid_t;
+#endif
+
+/**
+ * Lanza un proceso con los argumentos dados.
+ *
+ * @param args: Ejecutable seguido de sus argumentos.
+ * @param handle: Identificador del proceso lanzado.
+ * @return bool: true si el proceso se lanzó correctamente.
+ */
+bool spawnProcess(const std::vector<std::string>& args, ProcessHandle& handle) {
+#ifdef _WIN32
+    std::string commandLine;
+    for (const auto& arg : args) {
+        commandLine += "\"" + arg + "\" ";
+    }
+    STARTUPINFOA startupInfo = {};
+    startupInfo.cb = sizeof(startupInfo);
+    PROCESS_INFORMATION processInfo = {};
+    if (!CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInfo)) {
+        return false;
+    }
+    CloseHandle(processInfo.hThread);
+    handle = processInfo.hProcess;
+    return true;
+#else
+    std::vector<char*> argv;
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    return posix_spawnp(&handle, argv[0], nullptr, nullptr, argv.data(), environ) == 0;
+#endif
+}
+
+/**
+ * Comprueba sin bloquear si un proceso terminó.
+ *
+ * @param handle: Proceso a comprobar.
+ * @param success: true si el proceso terminó con código de salida 0.
+ * @return bool: true si el proceso ya terminó.
+ */
+bool pollProcess(ProcessHandle handle, bool& success) {
+#ifdef _WIN32
+    if (WaitForSingleObject(handle, 0) != WAIT_OBJECT_0) {
+        return false;
+    }
+    DWORD exitCode = 1;
+    GetExitCodeProcess(handle, &exitCode);
+    CloseHandle(handle);
+    success = exitCode == 0;
+    return true;
+#else
+    int status = 0;
+    if (waitpid(handle, &status, WNOHANG) != handle) {
+        return false;
+    }
+    success = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    return true;
+#endif
+}
+
+/**
+ * Termina un proceso y espera a que finalice.
+ *
+ * @param handle: Proceso a terminar.
+ */
+void killProcess(ProcessHandle handle) {
+#ifdef _WIN32
+    TerminateProcess(handle, 1);
+    WaitForSingleObject(handle, INFINITE);
+    CloseHandle(handle);
+#else
+    kill(handle, SIGTERM);
+    int status = 0;
+    waitpid(handle, &status, 0);
+#endif
+}
+
+/**
+ * Rango de filas asignado a los trabajadores.
+ */
+struct Job {
+    int rowBegin;
+    int rowEnd;
+    std::string partPath;   ///< Ruta final de la imagen parcial.
+    bool done = false;
+    int activeAttempts = 0;
+    int failures = 0;
+};
+
+/**
+ * Ejecución de un trabajo en un proceso trabajador.
+ */
+struct Attempt {
+    size_t job;
+    ProcessHandle process;
+    std::string tempPath;   ///< Archivo propio del intento; se renombra a partPath si gana.
+    Clock::time_point start;
+};
+
+} // namespace
+
+/**
+ * Renderiza una imagen repartiendo rangos de filas entre procesos trabajadores locales.
+ *
+ * @param workerArgs: Ejecutable y argumentos comunes de los trabajadores.
+ * @param workerCount: Número máximo de procesos simultáneos.
+ * @param height: Alto de la imagen en píxeles.
+ * @param rowsPerJob: Filas por trabajo.
+ * @param partsDirectory: Directorio donde se escriben las imágenes parciales.
+ * @param partPaths: Rutas de las imágenes parciales resultantes.
+ * @return bool: true si todos los trabajos terminaron correctamente.
+ */
+bool renderDistributed(const std::vector<std::string>& workerArgs, int workerCount, int height, int rowsPerJob, const std::string& partsDirectory, std::vector<std::string>& partPaths) {
+    std::error_code error;
+    fs::create_directories(partsDirectory, error);
+
+    std::vector<Job> jobs;
+    for (int row = 0; row < height; row += rowsPerJob) {
+        Job job;
+        job.rowBegin = row;
+        job.rowEnd = std::min(row + rowsPerJob, height);
+        job.partPath = (fs::path(partsDirectory) / ("part_" + std::to_string(jobs.size()) + ".rtpart")).string();
+        jobs.push_back(job);
+    }
+
+    std::deque<size_t> pending;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        pending.push_back(i);
+    }
+
+    std::vector<Attempt> running;
+    size_t completed = 0;
+    size_t attemptCounter = 0;
+    size_t backups = 0;
+    double completedSeconds = 0.0;
+    bool failed = false;
+
+    auto launch = [&](size_t jobIndex) {
+        Attempt attempt;
+        attempt.job = jobIndex;
+        attempt.tempPath = jobs[jobIndex].partPath + "." + std::to_string(attemptCounter++);
+        attempt.start = Clock::now();
+
+        std::vector<std::string> args = workerArgs;
+        args.push_back("--rows");
+        args.push_back(std::to_string(jobs[jobIndex].rowBegin) + ":" + std::to_string(jobs[jobIndex].rowEnd));
+        args.push_back("--partial");
+        args.push_back(attempt.tempPath);
+
+        if (!spawnProcess(args, attempt.process)) {
+            std::cerr << "Error: No se pudo lanzar el proceso trabajador " << args[0] << std::endl;
+            return false;
+        }
+        jobs[jobIndex].activeAttempts++;
+        running.push_back(attempt);
+        return true;
+    };
+
+    while (completed < jobs.size() && !failed) {
+        // Ocupar los procesos libres: primero trabajos pendientes, luego copias de los trabajos lentos
+        while (static_cast<int>(running.size()) < workerCount && !failed) {
+            if (!pending.empty()) {
+                size_t jobIndex = pending.front();
+                pending.pop_front();
+                failed = !launch(jobIndex);
+                continue;
+            }
+
+            if (completed == 0) {
+                break; // Sin duraciones de referencia todavía no se puede saber qué trabajo es lento
+            }
+            double meanSeconds = completedSeconds / completed;
+            const Attempt* slowest = nullptr;
+            for (const auto& attempt : running) {
+                double elapsed = std::chrono::duration<double>(Clock::now() - attempt.start).count();
+                if (jobs[attempt.job].activeAttempts == 1 && elapsed > meanSeconds &&
+                    (!slowest || attempt.start < slowest->start)) {
+                    slowest = &attempt;
+                }
+            }
+            if (!slowest) {
+                break;
+            }
+            size_t jobIndex = slowest->job;
+            backups++;
+            failed = !launch(jobIndex);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+
+        // Recoger los procesos terminados
+        for (size_t i = 0; i < running.size();) {
+            bool success = false;
+            if (!pollProcess(running[i].process, success)) {
+                ++i;
+                continue;
+            }
+
+            Attempt attempt = running[i];
+            running.erase(running.begin() + i);
+            Job& job = jobs[attempt.job];
+            job.activeAttempts--;
+
+            if (job.done) {
+                fs::remove(attempt.tempPath, error);
+                continue;
+            }
+
+            if (success) {
+                fs::rename(attempt.tempPath, job.partPath, error);
+                if (error) {
+                    std::cerr << "Error: No se pudo mover " << attempt.tempPath << " a " << job.partPath << std::endl;
+                    failed = true;
+                    continue;
+                }
+                job.done = true;
+                completed++;
+                completedSeconds += std::chrono::duration<double>(Clock::now() - attempt.start).count();
+                std::cout << "Filas " << job.rowBegin << "-" << job.rowEnd << " completadas ("
+                          << completed << "/" << jobs.size() << ")" << std::endl;
+
+                // Cancelar los demás intentos del mismo trabajo
+                for (size_t j = 0; j < running.size();) {
+                    if (running[j].job == attempt.job) {
+                        killProcess(running[j].process);
+                        fs::remove(running[j].tempPath, error);
+                        job.activeAttempts--;
+                        running.erase(running.begin() + j);
+                    } else {
+                        ++j;
+                    }
+                }
+            } else {
+                fs::remove(attempt.tempPath, error);
+                if (++job.failures >= MAX_JOB_FAILURES) {
+                    std::cerr << "Error: las filas " << job.rowBegin << "-" << job.rowEnd << " fallaron "
+                              << job.failures << " veces." << std::endl;
+                    failed = true;
+                } else if (job.activeAttempts == 0) {
+                    pending.push_back(attempt.job);
+                }
+            }
+        }
+    }
+
+    // Si algo falló, cancelar los procesos que sigan en ejecución
+    for (const auto& attempt : running) {
+        killProcess(attempt.process);
+        fs::remove(attempt.tempPath, error);
+    }
+
+    if (backups > 0) {
+        std::cout << "Trabajos relanzados por lentitud: " << backups << std::endl;
+    }
+
+    partPaths.clear();
+    for (const auto& job : jobs) {
+        partPaths.push_back(job.partPath);
+    }
+    return !failed;
+}
@@ -3,13 +3,93 @@
 #include "Vector3D.h"
 #include "Camera.h"
 #include "Scene.h"
+#include "Frustum.h"
+#include "TilePool.h"
+#include <algorithm> // Para std::min y std::max
+
+// Lado de los tiles de todos los renderizadores
+static int tileSize = DEFAULT_TILE_SIZE;
+
+// Descarte por frustum de las primitivas de cada tile
+static bool frustumCulling = true;
+
+/**
+ * Fija el tamaño de los tiles.
+ *
+ * @param size: Lado de los tiles en píxeles.
+ */
+void setTileSize(int size) {
+    tileSize = size;
+}
+
+int getTileSize() {
+    return tileSize;
+}
+
+/**
+ * Activa o desactiva el descarte por frustum.
+ *
+ * @param enabled: false para devolver todas las primitivas en cada tile.
+ */
+void setFrustumCulling(bool enabled) {
+    frustumCulling = enabled;
+}
+
+/**
+ * Calcula las primitivas que los rayos primarios de un tile pueden intersectar.
+ *
+ * @param scene: La escena que contiene los objetos.
+ * @param cam: La cámara desde la cual se generan los rayos.
+ * @param x0: Primera columna del tile.
+ * @param y0: Primera fila del tile.
+ * @param x1: Columna siguiente a la última del tile.
+ * @param y1: Fila siguiente a la última del tile.
+ * @param width: Ancho de la imagen en píxeles.
+ * @param height: Alto de la imagen en píxeles.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia desde la cámara hasta el viewport.
+ * @return PrimitiveList: Triángulos y esferas candidatos para el tile.
+ */
+PrimitiveList cullPrimitivesForTile(const Scene& scene, const Camera& cam, int x0, int y0, int x1, int y1, int width, int height, double viewportWidth, double viewportHeight, double distanceToViewport) {
+    PrimitiveList candidates;
+    if (!frustumCulling) {
+        for (const auto& triangle : scene.getTriangles()) {
+            candidates.triangles.push_back(&triangle);
+        }
+        for (const auto& sphere : scene.getSpheres()) {
+            candidates.spheres.push_back(&sphere);
+        }
+        return candidates;
+    }
+
+    // Rayos de las esquinas, un píxel por fuera del tile para que el frustum contenga holgadamente
+    // todos los rayos primarios del tile (y no sea degenerado en tiles de un píxel de ancho)
+    Vector3D c0 = cam.generateRay(x0 - 1, y0 - 1, width, height, viewportWidth, viewportHeight, distanceToViewport).getDirection();
+    Vector3D c1 = cam.generateRay(x1, y0 - 1, width, height, viewportWidth, viewportHeight, distanceToViewport).getDirection();
+    Vector3D c2 = cam.generateRay(x1, y1, width, height, viewportWidth, viewportHeight, distanceToViewport).getDirection();
+    Vector3D c3 = cam.generateRay(x0 - 1, y1, width, height, viewportWidth, viewportHeight, distanceToViewport).getDirection();
+    Frustum frustum(cam.getPosition(), c0, c1, c2, c3);
+
+    for (const auto& triangle : scene.getTriangles()) {
+        if (frustum.intersectsTriangle(triangle.getVertexA(), triangle.getVertexB(), triangle.getVertexC())) {
+            candidates.triangles.push_back(&triangle);
+        }
+    }
+    for (const auto& sphere : scene.getSpheres()) {
+        if (frustum.intersectsSphere(sphere.getCenter(), sphere.getRadius())) {
+            candidates.spheres.push_back(&sphere);
+        }
+    }
+    return candidates;
+}
 
 /**
  * Genera la imagen utilizando la escena y la cámara especificadas.
  *
  * @param scene: La escena que contiene los objetos y las luces a renderizar.
  * @param cam: La cámara desde la cual se generarán los rayos.
- * @param framebuffer: Vector que almacena los colores de cada píxel de la imagen.
+ * @param framebuffer: Framebuffer donde se guarda la imagen.
  * @param width: Ancho de la imagen en píxeles.
  * @param height: Alto de la imagen en píxeles.
  * @param maxDepth: Profundidad máxima de las reflexiones para los rayos.
@@ -17,15 +97,83 @@
  * @param viewportHeight: Alto del viewport en unidades del mundo.
  * @param distanceToViewport: Distancia desde la cámara hasta el viewport.
  */
-void generateImage(const Scene& scene, const Camera& cam, std::vector<Vector3D>& framebuffer, int width, int height, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport) {
-    // Recorre cada píxel de la imagen
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
+void generateImage(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, int width, int height, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport) {
+    generateImageRows(scene, cam, framebuffer, width, height, 0, height, maxDepth, viewportWidth, viewportHeight, distanceToViewport);
+}
+
+/**
+ * Genera un rango de filas de la imagen.
+ *
+ * @param scene: La escena que contiene los objetos y las luces a renderizar.
+ * @param cam: La cámara desde la cual se generarán los rayos.
+ * @param framebuffer: Framebuffer de (rowEnd - rowBegin) filas donde se guardan las filas generadas.
+ * @param width: Ancho de la imagen completa en píxeles.
+ * @param height: Alto de la imagen completa en píxeles.
+ * @param rowBegin: Primera fila a renderizar.
+ * @param rowEnd: Fila siguiente a la última a renderizar.
+ * @param maxDepth: Profundidad máxima de las reflexiones para los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia desde la cámara hasta el viewport.
+ * @param specializeKernel: false para usar el kernel genérico.
+ * @param preview: Vista previa que recibe los tiles terminados (puede ser nullptr).
+ */
+void generateImageRows(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, int width, int height, int rowBegin, int rowEnd, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport, bool specializeKernel, PreviewStream* preview) {
+    // Kernel compilado solo con las características que usa la escena
+    Scene::TraceKernel traceKernel = Scene::selectKernel(specializeKernel ? scene.getFeatures(maxDepth) : FEATURE_ALL);
+
+    // Recorre por tiles alineados a la cuadrícula global las filas solicitadas, repartidos entre los hilos
+    int firstTileY = (rowBegin / tileSize) * tileSize;
+    int tileColumns = (width + tileSize - 1) / tileSize;
+    int tileRows = (rowEnd - firstTileY + tileSize - 1) / tileSize;
+
+    TilePool::shared().run(tileColumns * tileRows, [&](int tile, int) {
+        int tileX = (tile % tileColumns) * tileSize;
+        int tileY = firstTileY + (tile / tileColumns) * tileSize;
+        renderTile(scene, cam, framebuffer, traceKernel, tileX, tileY, width, height, rowBegin, rowEnd, maxDepth, viewportWidth, viewportHeight, distanceToViewport);
+        if (preview) {
+            preview->publishTile(framebuffer, tileX, std::max(tileY, rowBegin), std::min(tileX + tileSize, width), std::min(tileY + tileSize, rowEnd), rowBegin);
+        }
+    });
+    if (preview) {
+        preview->endPass(1);
+    }
+}
+
+/**
+ * Renderiza un tile de la cuadrícula global.
+ *
+ * @param scene: La escena que contiene los objetos y las luces a renderizar.
+ * @param cam: La cámara desde la cual se generarán los rayos.
+ * @param framebuffer: Framebuffer de (rowEnd - rowBegin) filas.
+ * @param traceKernel: Kernel de trazado (Scene::selectKernel).
+ * @param tileX: Primera columna del tile.
+ * @param tileY: Primera fila del tile (múltiplo de getTileSize()).
+ * @param width: Ancho de la imagen completa en píxeles.
+ * @param height: Alto de la imagen completa en píxeles.
+ * @param rowBegin: Primera fila guardada en el framebuffer.
+ * @param rowEnd: Fila siguiente a la última a renderizar.
+ * @param maxDepth: Profundidad máxima de las reflexiones para los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia desde la cámara hasta el viewport.
+ */
+void renderTile(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, Scene::TraceKernel traceKernel, int tileX, int tileY, int width, int height, int rowBegin, int rowEnd, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport) {
+    int x1 = std::min(tileX + tileSize, width);
+    int y0 = std::max(tileY, rowBegin);
+    int y1 = std::min(tileY + tileSize, rowEnd);
+
+    // Primitivas visibles desde el tile, calculadas una sola vez para todos sus rayos primarios.
+    // El frustum se calcula sobre el tile completo para que no dependa del rango de filas.
+    PrimitiveList candidates = cullPrimitivesForTile(scene, cam, tileX, tileY, x1, std::min(tileY + tileSize, height), width, height, viewportWidth, viewportHeight, distanceToViewport);
+
+    for (int y = y0; y < y1; ++y) {
+        for (int x = tileX; x < x1; ++x) {
             // Genera un rayo desde la cámara para el píxel actual
             Ray ray = cam.generateRay(x, y, width, height, viewportWidth, viewportHeight, distanceToViewport);
 
-            // Trazar el rayo a través de la escena y almacenar el color resultante en el framebuffer
-            framebuffer[y * width + x] = scene.traceRay(ray, maxDepth);
+            // Trazar el rayo a través de la escena y guardar el color (escala 0-255) convertido al formato del framebuffer
+            framebuffer.setPixel(x, y - rowBegin, traceKernel(scene, ray, maxDepth, candidates) * (1.0 / 255.0));
         }
     }
 }
@@ -0,0 +1,81 @@
+#include "imageCompare.h"
+#include "createPPM.h"
+#include <algorithm> // Para std::max
+#include <cmath>     // Para std::log10 y std::abs
+#include <iostream>  // Para std::cout y std::cerr
+#include <limits>    // Para std::numeric_limits
+#include <vector>    // Para std::vector
+
+/**
+ * Compara una imagen con su imagen de referencia.
+ *
+ * @param image: Imagen a comprobar.
+ * @param reference: Imagen de referencia.
+ * @param tolerance: Diferencia por canal que no cuenta como cambio.
+ * @return ImageDifference: Diferencias encontradas.
+ */
+ImageDifference compareImages(const Framebuffer& image, const Framebuffer& reference, int tolerance) {
+    ImageDifference difference;
+    difference.sameSize = image.getWidth() == reference.getWidth() && image.getRows() == reference.getRows();
+    if (!difference.sameSize) {
+        return difference;
+    }
+
+    int width = image.getWidth();
+    std::vector<unsigned char> row(static_cast<size_t>(width) * 3), referenceRow(static_cast<size_t>(width) * 3);
+    double squaredError = 0.0;
+    for (int y = 0; y < image.getRows(); ++y) {
+        image.encodeRowSRGB8(y, row.data());
+        reference.encodeRowSRGB8(y, referenceRow.data());
+        for (int x = 0; x < width; ++x) {
+            int pixelDifference = 0;
+            for (int channel = 0; channel < 3; ++channel) {
+                int delta = std::abs(row[x * 3 + channel] - referenceRow[x * 3 + channel]);
+                pixelDifference = std::max(pixelDifference, delta);
+                squaredError += static_cast<double>(delta) * delta;
+            }
+            difference.maxDifference = std::max(difference.maxDifference, pixelDifference);
+            difference.changedPixels += pixelDifference > tolerance;
+        }
+    }
+
+    double pixels = static_cast<double>(width) * image.getRows();
+    difference.changedFraction = difference.changedPixels / pixels;
+    double meanSquaredError = squaredError / (pixels * 3);
+    difference.psnr = meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : std::numeric_limits<double>::infinity();
+    return difference;
+}
+
+/**
+ * Compara un render con una imagen de referencia guardada e informa el resultado.
+ *
+ * @param image: Imagen renderizada.
+ * @param referencePath: Ruta del PPM de referencia.
+ * @param renderSeconds: Tiempo de render medido.
+ * @param thresholds: Umbrales de la comprobación.
+ * @return bool: true si la imagen y el tiempo cumplen los umbrales.
+ */
+bool checkGoldenImage(const Framebuffer& image, const std::string& referencePath, double renderSeconds, const GoldenThresholds& thresholds) {
+    Framebuffer reference;
+    if (!readPPM(referencePath, reference)) {
+        std::cerr << "Referencia: no se pudo leer " << referencePath << std::endl;
+        return false;
+    }
+    ImageDifference difference = compareImages(image, reference, thresholds.tolerance);
+    if (!difference.sameSize) {
+        std::cerr << "Referencia: " << referencePath << " es de " << reference.getWidth() << "x" << reference.getRows()
+                  << " y el render de " << image.getWidth() << "x" << image.getRows() << std::endl;
+        return false;
+    }
+
+    bool imageOk = difference.changedFraction <= thresholds.maxChangedFraction && difference.psnr >= thresholds.minPsnr;
+    bool timeOk = thresholds.timeBudget <= 0.0 || renderSeconds <= thresholds.timeBudget;
+    std::cout << "Referencia " << referencePath << ": diferencia máxima " << difference.maxDifference << ", "
+              << difference.changedPixels << " píxeles (" << 100.0 * difference.changedFraction << "%) sobre la tolerancia "
+              << thresholds.tolerance << ", PSNR " << difference.psnr << " dB; tiempo " << renderSeconds << " s";
+    if (thresholds.timeBudget > 0.0) {
+        std::cout << " (presupuesto " << thresholds.timeBudget << " s)";
+    }
+    std::cout << ": " << (imageOk && timeOk ? "OK" : !imageOk ? "IMAGEN DISTINTA" : "FUERA DE PRESUPUESTO") << std::endl;
+    return imageOk && timeOk;
+}
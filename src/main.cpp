@@ -2,89 +2,519 @@
 #include "Camera.h"
 #include "createPPM.h"
 #include "generateImage.h"
+#include "scenes.h"
+#include "partialImage.h"
+#include "distributedRender.h"
+#include "renderCache.h"
+#include "PathTracer.h"
+#include "TilePool.h"
+#include "denoise.h"
+#include "Framebuffer.h"
+#include "PreviewStream.h"
+#include "MappedImageFile.h"
+#include "RenderConfig.h"
+#include "imageCompare.h"
+#include "PagedGeometry.h"
+#include "wavefront.h"
+#include "WavefrontPipeline.h"
+#include "multiView.h"
+#include "numaPlacement.h"
 #include <vector>
 #include <chrono>
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <memory>
+#include <cerrno>
 
-#define IMAGE_WIDTH 1000
-#define IMAGE_HEIGHT 1000
-#define VIEWPORT_WIDTH 2
-#define VIEWPORT_HEIGHT 2
-#define DISTANCE_TO_VIEWPORT 1
-#define MAX_REFLECTION_DEPTH 10  // Profundidad de reflejo alta para reflejos detallados
+/**
+ * @brief Lee un rango de filas "inicio:fin".
+ * @param text Texto del rango.
+ * @param rowBegin Primera fila, si el rango es válido.
+ * @param rowEnd Fila siguiente a la última, si el rango es válido.
+ * @return true si los dos extremos son enteros completos.
+ */
+static bool parseRowRange(const std::string& text, int& rowBegin, int& rowEnd) {
+    size_t colon = text.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    std::string bounds[2] = { text.substr(0, colon), text.substr(colon + 1) };
+    long values[2];
+    for (int i = 0; i < 2; ++i) {
+        char* end = nullptr;
+        errno = 0;
+        values[i] = std::strtol(bounds[i].c_str(), &end, 10);
+        if (bounds[i].empty() || *end != '\0' || errno != 0 || values[i] < 0 || values[i] > std::numeric_limits<int>::max()) {
+            return false;
+        }
+    }
+    rowBegin = static_cast<int>(values[0]);
+    rowEnd = static_cast<int>(values[1]);
+    return true;
+}
+
+/**
+ * @brief Imprime el uso del programa.
+ */
+static void printUsage() {
+    std::cerr << "Uso:\n"
+              << "  main [escena] [--output archivo.ppm] [--cache dir]   Render completo en este proceso\n"
+              << "  main [escena] --workers N [--output archivo.ppm]     Render repartido entre N procesos locales\n"
+              << "  main [escena] --rows inicio:fin --partial archivo    Renderiza un rango de filas (proceso trabajador)\n"
+              << "  main --merge archivo.ppm parte1 [parte2 ...]         Ensambla imágenes parciales\n"
+              << "Opciones:\n"
+              << "  --pathtrace             Trazado de caminos (iluminación global) con --spp muestras por píxel\n"
+              << "  --denoise               Filtra el ruido del trazado de caminos (permite usar 4-8 muestras)\n"
+              << "  --preview [PUERTO]      Envía los tiles a preview_viewer.py en 127.0.0.1 mientras se renderiza\n"
+              << "  --write-city archivo N  Genera el archivo de geometría de una ciudad de N x N manzanas (escena city)\n"
+              << "  --config archivo        Lee los parámetros de un archivo \"clave = valor\" (las opciones los sobrescriben)\n"
+              << "  --print-config          Muestra la configuración efectiva en el formato de --config y termina\n"
+              << "  --golden referencia.ppm Compara el render con una imagen de referencia (código de salida 1 si difiere)\n"
+              << "  --tolerance N           Diferencia por canal (0-255) que --golden no cuenta como cambio [" << GOLDEN_TOLERANCE << "]\n"
+              << "  --min-psnr DB           PSNR mínimo frente a la referencia [" << GOLDEN_MIN_PSNR << "]\n"
+              << "  --time-budget S         Tiempo máximo de render en segundos para --golden (0 = sin límite)\n"
+              << "Parámetros (opción, clave del archivo de configuración y valor por defecto):\n";
+    RenderConfig defaults;
+    for (const RenderConfigOption& option : renderConfigOptions()) {
+        std::string usage = std::string(option.flag) + " (" + option.key + ")";
+        std::cerr << "  " << usage << std::string(usage.size() < 36 ? 36 - usage.size() : 1, ' ') << option.description
+                  << " [" << getRenderConfigValue(defaults, option.key) << "]\n";
+    }
+    std::cerr << "Escenas: default, shadows, textured, softshadows, glass, spheres, particles, mesh, city" << std::endl;
+}
 
 /**
- * @brief Función principal que configura la escena, agrega objetos y luces, genera la imagen y la guarda como un archivo PPM.
+ * @brief Ensambla imágenes parciales y guarda el resultado como un archivo PPM.
+ *
+ * @param outputPath Ruta del PPM resultante.
+ * @param partPaths Rutas de las imágenes parciales.
+ * @return Código de salida del programa.
  */
-int main() {
-    // 1. Crear la escena
+static int mergeParts(const std::string& outputPath, const std::vector<std::string>& partPaths) {
+    Framebuffer framebuffer;
+    int width = 0, height = 0;
+    if (!mergePartialImages(partPaths, framebuffer, width, height)) {
+        return 1;
+    }
+    createPPM(framebuffer, outputPath);
+    return 0;
+}
+
+/**
+ * @brief Elimina el ruido de una imagen trazada con pocas muestras e informa los tiempos.
+ *
+ * @param scene Escena renderizada.
+ * @param camera Cámara del render.
+ * @param config Parámetros del render.
+ * @param framebuffer Filas [rowBegin, rowEnd) de la imagen en RGBA_F32; se sobrescriben con el resultado filtrado.
+ * @param rowBegin Primera fila guardada en el framebuffer.
+ * @param rowEnd Fila siguiente a la última del framebuffer.
+ */
+static void denoiseFramebuffer(const Scene& scene, const Camera& camera, const RenderConfig& config, Framebuffer& framebuffer, int rowBegin, int rowEnd) {
+    auto start = std::chrono::high_resolution_clock::now();
+    GuideBuffers guides = computeGuideBuffers(scene, camera, config.width, config.height, rowBegin, rowEnd, config.viewportWidth, config.getViewportHeight(), config.distanceToViewport);
+    std::chrono::duration<double> guideDuration = std::chrono::high_resolution_clock::now() - start;
+    double filterSeconds = denoiseImage(framebuffer, guides);
+    std::cout << "Tiempo de eliminación de ruido: " << filterSeconds << " segundos (más "
+              << guideDuration.count() << " segundos de búferes auxiliares)" << std::endl;
+}
+
+/**
+ * @brief Función principal que construye la escena, genera la imagen y la guarda como un archivo PPM.
+ *
+ * Además del render en un solo proceso, permite renderizar rangos de filas en procesos trabajadores,
+ * coordinar varios trabajadores locales y ensamblar sus imágenes parciales (ver printUsage).
+ */
+int main(int argc, char* argv[]) {
+    RenderConfig config;
+    std::string sceneName = "default";
+    std::string partialPath;
+    std::string cacheDirectory;
+    int rowBegin = 0, rowEnd = -1; // -1 = hasta la última fila de la imagen
+    int workers = 0;
+    bool pathTrace = false;
+    bool denoise = false;
+    bool printConfig = false;
+    std::string cityPath;
+    int cityBlocks = 0;
+    int previewPort = 0;
+    std::string goldenPath;
+    GoldenThresholds goldenThresholds;
+    std::string configError;
+
+    // El archivo de configuración se lee antes que el resto de opciones, que tienen prioridad sobre él
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--config" && !loadRenderConfig(argv[i + 1], config, configError)) {
+            std::cerr << "Error: " << configError << std::endl;
+            return 1;
+        }
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const RenderConfigOption* option = findRenderConfigFlag(arg);
+        if (arg == "--merge") {
+            if (i + 2 >= argc) {
+                printUsage();
+                return 1;
+            }
+            return mergeParts(argv[i + 1], std::vector<std::string>(argv + i + 2, argv + argc));
+        } else if (option && i + 1 < argc) {
+            if (!setRenderConfigValue(config, option->key, argv[++i], configError)) {
+                std::cerr << "Error: " << configError << std::endl;
+                return 1;
+            }
+        } else if (arg == "--config" && i + 1 < argc) {
+            ++i; // Ya leído
+        } else if (arg == "--print-config") {
+            printConfig = true;
+        } else if (arg == "--cache" && i + 1 < argc) {
+            cacheDirectory = argv[++i];
+        } else if (arg == "--partial" && i + 1 < argc) {
+            partialPath = argv[++i];
+        } else if (arg == "--pathtrace") {
+            pathTrace = true;
+        } else if (arg == "--denoise") {
+            denoise = true;
+        } else if (arg == "--write-city" && i + 2 < argc) {
+            cityPath = argv[++i];
+            cityBlocks = std::atoi(argv[++i]);
+        } else if (arg == "--preview") {
+            // El puerto es opcional
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                previewPort = std::atoi(argv[++i]);
+            } else {
+                previewPort = PREVIEW_DEFAULT_PORT;
+            }
+        } else if (arg == "--golden" && i + 1 < argc) {
+            goldenPath = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            goldenThresholds.tolerance = std::atoi(argv[++i]);
+        } else if (arg == "--min-psnr" && i + 1 < argc) {
+            goldenThresholds.minPsnr = std::atof(argv[++i]);
+        } else if (arg == "--time-budget" && i + 1 < argc) {
+            goldenThresholds.timeBudget = std::atof(argv[++i]);
+        } else if (arg == "--workers" && i + 1 < argc) {
+            workers = std::atoi(argv[++i]);
+        } else if (arg == "--rows" && i + 1 < argc) {
+            std::string range = argv[++i];
+            if (!parseRowRange(range, rowBegin, rowEnd)) {
+                std::cerr << "Error: rango de filas inválido '" << range << "' (se espera inicio:fin)" << std::endl;
+                return 1;
+            }
+        } else if (arg[0] != '-') {
+            sceneName = arg;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (!validateRenderConfig(config, configError)) {
+        std::cerr << "Error: " << configError << std::endl;
+        return 1;
+    }
+    if (printConfig) {
+        writeRenderConfig(std::cout, config);
+        return 0;
+    }
+    // Un rango de filas solo tiene sentido como parte de un render repartido: el framebuffer tiene solo esas filas
+    if (rowEnd >= 0 && partialPath.empty()) {
+        std::cerr << "Error: --rows necesita --partial" << std::endl;
+        return 1;
+    }
+    if (rowEnd < 0) {
+        rowEnd = config.height;
+    }
+    if (rowBegin < 0 || rowEnd > config.height || rowBegin >= rowEnd) {
+        std::cerr << "Error: rango de filas inválido " << rowBegin << ":" << rowEnd << " (debe cumplir 0 <= inicio < fin <= " << config.height << ")" << std::endl;
+        return 1;
+    }
+    // La caché guarda imágenes y tiles completos de la escena: no se usa para las imágenes parciales
+    if (!cacheDirectory.empty() && (rowBegin != 0 || rowEnd != config.height || !partialPath.empty())) {
+        std::cerr << "Aviso: --cache solo se aplica a la imagen completa; se ignora con --rows y --partial" << std::endl;
+        cacheDirectory.clear();
+    }
+    if (denoise && !pathTrace) {
+        std::cerr << "Aviso: --denoise solo se aplica con --pathtrace" << std::endl;
+    }
+    if (denoise && pathTrace && !partialPath.empty()) {
+        std::cerr << "Aviso: --denoise no se aplica a las imágenes parciales (el coordinador filtra la imagen ensamblada)" << std::endl;
+    }
+    if ((config.secondaryRays != SecondaryRays::RECURSIVE || config.pipeline != RenderPipeline::MEGAKERNEL) && (pathTrace || !cacheDirectory.empty())) {
+        std::cerr << "Aviso: --secondary y --pipeline solo se aplican al trazador de Whitted sin --cache" << std::endl;
+    }
+    // La colocación NUMA solo cambia el render de tiles del trazador de Whitted (los hilos se fijan igualmente)
+    bool numaRender = config.numa != NumaPlacement::OFF && !pathTrace && cacheDirectory.empty() &&
+                      config.secondaryRays == SecondaryRays::RECURSIVE && config.pipeline == RenderPipeline::MEGAKERNEL;
+    if (config.numa != NumaPlacement::OFF && !numaRender) {
+        std::cerr << "Aviso: --numa solo coloca la escena y la imagen con el trazador de Whitted sin --cache, --secondary ni --pipeline" << std::endl;
+    }
+    // El filtro trabaja sobre el color sin cuantizar: se renderiza en float y se convierte al final
+    bool filterOutput = pathTrace && denoise;
+    PixelFormat renderFormat = filterOutput ? PixelFormat::RGBA_F32 : config.format;
+    const std::string& outputPath = config.outputPath;
+    int width = config.width, height = config.height;
+    double viewportWidth = config.viewportWidth, viewportHeight = config.getViewportHeight();
+    TilePool::setSharedThreadCount(config.threads);
+    TilePool::setSharedPinning(config.numa != NumaPlacement::OFF);
+    setTileSize(config.tileSize);
+    setFrustumCulling(config.acceleration != Acceleration::NONE);
+
+    if (!cityPath.empty()) {
+        if (cityBlocks <= 0) {
+            std::cerr << "Error: el número de manzanas debe ser positivo" << std::endl;
+            return 1;
+        }
+        GeometryFileWriter writer;
+        auto start = std::chrono::high_resolution_clock::now();
+        if (!writeCityGeometry(cityPath, cityBlocks, writer)) {
+            return 1;
+        }
+        std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "Ciudad: " << cityBlocks << "x" << cityBlocks << " manzanas, " << writer.getChunkCount() << " chunks, "
+                  << writer.getTriangleCount() << " triángulos, " << std::filesystem::file_size(cityPath) / (1024.0 * 1024.0)
+                  << " MB en " << cityPath << " (" << duration.count() << " s)" << std::endl;
+        return 0;
+    }
+
+    // 1. Crear la escena y la cámara
     Scene scene;
+    Camera camera;
+    if (!buildScene(sceneName, scene, camera)) {
+        std::cerr << "Error: escena desconocida '" << sceneName << "'" << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    // Geometría paginada: solo la tabla de chunks se lee ahora; los chunks se leen cuando los rayos llegan a ellos
+    std::shared_ptr<PagedGeometry> pagedGeometry;
+    if (!config.geometryPath.empty()) {
+        pagedGeometry = std::make_shared<PagedGeometry>();
+        if (!pagedGeometry->open(config.geometryPath, static_cast<size_t>(config.geometryCacheMB) * 1024 * 1024)) {
+            return 1;
+        }
+        scene.setPagedGeometry(pagedGeometry);
+        std::cout << "Geometría paginada: " << pagedGeometry->getChunks().size() << " chunks, " << pagedGeometry->getTriangleCount()
+                  << " triángulos, " << pagedGeometry->getFileBytes() / (1024.0 * 1024.0) << " MB en el archivo, caché de "
+                  << config.geometryCacheMB << " MB" << std::endl;
+    } else if (sceneName == "city") {
+        std::cerr << "Aviso: la escena city solo tiene el suelo sin --geometry (genera los edificios con --write-city)" << std::endl;
+    }
+
+    if (config.acceleration == Acceleration::GRID) {
+        size_t moved = scene.moveSpheresToGrid();
+        std::cout << "Aceleración: " << moved << " esferas movidas a la malla (" << scene.getSphereGrid().size() << " en total)" << std::endl;
+    }
+
+
+    if (previewPort > 0 && (workers > 0 || !partialPath.empty())) {
+        std::cerr << "Aviso: --preview solo se aplica a los renders en un solo proceso" << std::endl;
+        previewPort = 0;
+    }
+    if (!goldenPath.empty() && !partialPath.empty()) {
+        std::cerr << "Aviso: --golden no se aplica a las imágenes parciales" << std::endl;
+        goldenPath.clear();
+    }
+
+    // Varias cámaras: la escena se congela y todas las vistas la comparten en un único lote de tiles
+    if (config.views != ViewLayout::SINGLE) {
+        if (pathTrace || !cacheDirectory.empty() || workers > 0 || !partialPath.empty() || previewPort > 0 ||
+            config.secondaryRays != SecondaryRays::RECURSIVE || config.pipeline != RenderPipeline::MEGAKERNEL) {
+            std::cerr << "Aviso: --views solo usa el trazador de Whitted en un solo proceso; se ignoran las demás opciones de render" << std::endl;
+        }
+        SceneSnapshot frozen = Scene::freeze(std::move(scene));
+        std::vector<RenderView> views = config.views == ViewLayout::STEREO
+            ? stereoViews(camera, width, height, viewportWidth, viewportHeight, config.eyeSeparation)
+            : cubeMapViews(camera, width, config.distanceToViewport);
+        int imageWidth = 0, imageHeight = 0;
+        getViewsImageSize(views, imageWidth, imageHeight);
+        Framebuffer image(imageWidth, imageHeight, config.format);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        generateImageViews(*frozen, views, image, config.maxDepth, config.distanceToViewport);
+        std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "Vistas (" << viewLayoutName(config.views) << "): " << views.size() << " de " << views[0].width << "x"
+                  << views[0].height << " en una imagen de " << imageWidth << "x" << imageHeight << std::endl;
+        std::cout << "Tiempo de renderizado: " << duration.count() << " segundos" << std::endl;
 
-    // Agregar triángulos a la escena con propiedades específicas y mejor separados
-    scene.addTriangle(Triangle(Vector3D(-2, 0, 3), Vector3D(-1, 2, 3), Vector3D(-3, 2, 3), Vector3D(80, 80, 255), 1000, 0.02)); // Triángulo azul brillante (baja reflectividad, mate)
-    scene.addTriangle(Triangle(Vector3D(0, 0, 2), Vector3D(1, 2, 2), Vector3D(-1, 2, 2), Vector3D(255, 50, 50), 2000, 1.0));  // Triángulo rojo brillante (alta reflectividad, como espejo)
-    scene.addTriangle(Triangle(Vector3D(2, 0, 4), Vector3D(3, 2, 4), Vector3D(1, 2, 4), Vector3D(50, 255, 50), 1000, 0.02));  // Triángulo verde brillante (baja reflectividad, mate)
-    scene.addTriangle(Triangle(Vector3D(-2, 3, 3), Vector3D(-1, 5, 3), Vector3D(-3, 5, 3), Vector3D(0, 255, 255), 800, 0.5));   // Triángulo cian (posicionado más cerca para mejor visibilidad)
-    scene.addTriangle(Triangle(Vector3D(5, 3, 10), Vector3D(7, 8, 10), Vector3D(3, 8, 10), Vector3D(150, 150, 255), 1000, 0.4)); // Triángulo azul claro grande
-    scene.addTriangle(Triangle(Vector3D(8, 0, 12), Vector3D(9, 5, 12), Vector3D(7, 5, 12), Vector3D(255, 200, 0), 1200, 0.6)); // Triángulo amarillo alto
-    scene.addTriangle(Triangle(Vector3D(-8, -3, 10), Vector3D(-7, 2, 10), Vector3D(-9, 2, 10), Vector3D(200, 100, 100), 900, 0.3)); // Triángulo rojo oscuro (más abajo)
-    scene.addTriangle(Triangle(Vector3D(3, 1, 6), Vector3D(4, 3, 6), Vector3D(2, 3, 6), Vector3D(100, 255, 100), 1000, 0.2)); // Triángulo verde claro
-    scene.addTriangle(Triangle(Vector3D(-6, 4, 8), Vector3D(-5, 7, 8), Vector3D(-7, 7, 8), Vector3D(255, 0, 255), 1100, 0.7)); // Triángulo magenta reflectivo (más arriba)
-    scene.addTriangle(Triangle(Vector3D(0, 6, 15), Vector3D(1, 8, 15), Vector3D(-1, 8, 15), Vector3D(150, 150, 150), 1200, 0.5)); // Triángulo gris claro (alto, en el centro)
-    scene.addTriangle(Triangle(Vector3D(-10, 8, 20), Vector3D(-9, 12, 20), Vector3D(-11, 12, 20), Vector3D(200, 200, 50), 1300, 0.8)); // Triángulo dorado (muy alto)
-    scene.addTriangle(Triangle(Vector3D(10, -5, 25), Vector3D(12, -2, 25), Vector3D(8, -2, 25), Vector3D(100, 100, 100), 1100, 0.3)); // Triángulo gris oscuro (más abajo y lejos)
-
-    // Agregar esferas a la escena y mejor separadas
-    scene.addSphere(Sphere(Vector3D(0, 3, 3), 1, Vector3D(255, 0, 0), 500, 0.5));  // Esfera roja sobre los triángulos (reflectividad media)
-    scene.addSphere(Sphere(Vector3D(0, -1, 3), 1, Vector3D(0, 255, 0), 500, 0.5)); // Esfera verde debajo de los triángulos (reflectividad media)
-    scene.addSphere(Sphere(Vector3D(7, 0, 15), 1.5, Vector3D(238, 130, 238), 400, 0.6)); // Esfera violeta grande (reflectividad alta, posicionada más cerca para mejor visibilidad)
-    scene.addSphere(Sphere(Vector3D(-5, 2, 7), 1.2, Vector3D(0, 255, 255), 600, 0.4)); // Esfera cian mediana
-    scene.addSphere(Sphere(Vector3D(4, -4, 10), 2.0, Vector3D(255, 255, 0), 700, 0.3)); // Esfera amarilla grande (más abajo)
-    scene.addSphere(Sphere(Vector3D(-7, 5, 12), 1.8, Vector3D(100, 100, 255), 500, 0.5)); // Esfera azul claro (más arriba)
-    scene.addSphere(Sphere(Vector3D(6, 3, 8), 0.9, Vector3D(255, 100, 100), 800, 0.6)); // Esfera roja pequeña (media altura)
-    scene.addSphere(Sphere(Vector3D(-4, 0, 5), 1.3, Vector3D(0, 200, 100), 450, 0.4)); // Esfera verde oscuro
-    scene.addSphere(Sphere(Vector3D(8, -2, 11), 1.1, Vector3D(200, 200, 50), 600, 0.5)); // Esfera dorada mediana (más abajo)
-    scene.addSphere(Sphere(Vector3D(-9, 6, 14), 1.4, Vector3D(150, 50, 150), 500, 0.7)); // Esfera púrpura reflectiva (alta)
-    scene.addSphere(Sphere(Vector3D(3, -3, 13), 1.6, Vector3D(50, 150, 200), 550, 0.6)); // Esfera azul celeste grande (más abajo)
-    scene.addSphere(Sphere(Vector3D(-10, 1, 16), 1.0, Vector3D(100, 255, 100), 650, 0.4)); // Esfera verde claro (media altura)
-    scene.addSphere(Sphere(Vector3D(10, 4, 18), 2.2, Vector3D(255, 215, 0), 700, 0.3)); // Esfera dorada grande (alta)
-    scene.addSphere(Sphere(Vector3D(-15, -6, 20), 2.5, Vector3D(100, 255, 255), 750, 0.6)); // Esfera cian gigante (muy lejos y abajo)
-    scene.addSphere(Sphere(Vector3D(15, 10, 25), 1.8, Vector3D(255, 0, 100), 800, 0.7)); // Esfera rosa alta y lejos
-    scene.addSphere(Sphere(Vector3D(-12, 3, 18), 1.3, Vector3D(0, 100, 255), 550, 0.5)); // Esfera azul medio (media altura y lejos)
-    scene.addSphere(Sphere(Vector3D(12, -8, 22), 1.7, Vector3D(255, 150, 0), 600, 0.4)); // Esfera naranja (muy abajo y lejos)
-
-    // Agregar planos para crear un efecto de "caja" con reflectividad reducida para un mejor contraste de los triángulos
-    scene.addPlane(Plane(Vector3D(0, -10, 0), Vector3D(0, 1, 0), Vector3D(50, 50, 50), 10, 0.1));   // Plano del piso (gris oscuro, reflectividad baja)
-    scene.addPlane(Plane(Vector3D(0, 10, 0), Vector3D(0, -1, 0), Vector3D(150, 150, 150), 50, 0.0));   // Plano del techo (gris claro, sin reflectividad)
-    scene.addPlane(Plane(Vector3D(-20, 0, 0), Vector3D(1, 0, 0), Vector3D(120, 120, 120), 10, 0.2));   // Plano de la pared izquierda (gris medio, reflectividad media)
-    scene.addPlane(Plane(Vector3D(20, 0, 0), Vector3D(-1, 0, 0), Vector3D(130, 130, 130), 10, 0.2));   // Plano de la pared derecha (gris medio claro, reflectividad media)
-    scene.addPlane(Plane(Vector3D(0, 0, -10), Vector3D(0, 0, 1), Vector3D(80, 80, 80), 10, 0.0));   // Plano de la pared trasera (gris oscuro, sin reflectividad)
-
-    // Agregar luces a la escena
-    scene.addLight(LightSource(LightSource::AMBIENT, 0.015));  // Luz ambiental ligeramente aumentada para una mejor iluminación de áreas oscuras
-    scene.addLight(LightSource(LightSource::POINT, 60.0, Vector3D(0, 10, 4)));  // Luz puntual fuerte posicionada más arriba y hacia el frente para iluminar los objetos superiores
-    scene.addLight(LightSource(LightSource::DIRECTIONAL, 12.0, Vector3D(), Vector3D(-1, -1, -1))); // Luz direccional fuerte para sombras bien definidas
-    scene.addLight(LightSource(LightSource::POINT, 50.0, Vector3D(-5, -8, -4)));  // Luz puntual adicional desde otro ángulo para una mejor iluminación
-
-    // 2. Crear la cámara con una posición ajustada para visualizar bien la escena
-    Camera camera(0, 1.8, -8);  // Posicionada más lejos para tener una buena perspectiva de todos los objetos
-
-    // 3. Inicializar el framebuffer
-    std::vector<Vector3D> framebuffer(IMAGE_WIDTH * IMAGE_HEIGHT);
+        bool goldenOk = goldenPath.empty() || checkGoldenImage(image, goldenPath, duration.count(), goldenThresholds);
+        createPPM(image, outputPath);
+        return goldenOk ? 0 : 1;
+    }
+
+    // Modo coordinador: repartir las filas entre procesos trabajadores que ejecutan este mismo binario
+    if (workers > 0) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::string> partPaths;
+        std::string partsDirectory = outputPath + ".parts";
+        // Cada trabajador usa un solo hilo: el paralelismo lo dan los procesos
+        std::vector<std::string> workerArgs = { argv[0], sceneName, "--threads", "1", "--format", pixelFormatName(renderFormat) };
+        std::vector<std::string> configArgs = renderConfigArguments(config);
+        workerArgs.insert(workerArgs.end(), configArgs.begin(), configArgs.end());
+        if (pathTrace) {
+            workerArgs.push_back("--pathtrace");
+        }
+        if (!renderDistributed(workerArgs, workers, height, config.tileSize, partsDirectory, partPaths)) {
+            return 1;
+        }
+        std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "Tiempo de renderizado (" << workers << " procesos): " << duration.count() << " segundos" << std::endl;
+
+        int result = 0;
+        if (filterOutput) {
+            // El filtro necesita la imagen completa, así que se aplica después de ensamblar las partes
+            Framebuffer merged;
+            int mergedWidth = 0, mergedHeight = 0;
+            if (mergePartialImages(partPaths, merged, mergedWidth, mergedHeight)) {
+                denoiseFramebuffer(scene, camera, config, merged, 0, config.height);
+                createPPM(merged.convertTo(config.format), outputPath);
+            } else {
+                result = 1;
+            }
+        } else {
+            result = mergeParts(outputPath, partPaths);
+        }
+        std::error_code error;
+        std::filesystem::remove_all(partsDirectory, error);
+        if (result == 0 && !goldenPath.empty()) {
+            Framebuffer merged;
+            if (!readPPM(outputPath, merged) || !checkGoldenImage(merged, goldenPath, duration.count(), goldenThresholds)) {
+                result = 1;
+            }
+        }
+        return result;
+    }
+
+    // 2. Inicializar el framebuffer (solo las filas a renderizar). En sRGB de 8 bits los píxeles ya
+    // son el cuerpo del PPM: el framebuffer se construye sobre el archivo de salida mapeado en memoria
+    // y cada hilo escribe sus tiles directamente en él
+    MappedImageFile mappedOutput;
+    bool directOutput = partialPath.empty() && rowBegin == 0 && rowEnd == height && renderFormat == PixelFormat::SRGB8 && mappedOutput.open(outputPath, width, height);
+    // Con --numa, la memoria se reserva sin tocar para que cada página quede en el nodo que la escribe primero
+    FirstTouchBuffer placedPixels;
+    bool placedOutput = !directOutput && numaRender && placedPixels.allocate(static_cast<size_t>(width) * (rowEnd - rowBegin) * pixelFormatSize(renderFormat));
+    Framebuffer framebuffer = directOutput ? Framebuffer(width, height, renderFormat, mappedOutput.getPixels())
+                            : placedOutput ? Framebuffer(width, rowEnd - rowBegin, renderFormat, placedPixels.getData())
+                                           : Framebuffer(width, rowEnd - rowBegin, renderFormat);
+    std::cout << "Framebuffer: " << pixelFormatName(renderFormat) << ", "
+              << framebuffer.getByteSize() / (1024.0 * 1024.0) << " MB"
+              << (directOutput ? " (mapeado sobre " + outputPath + ")" : std::string()) << std::endl;
+
+    // Vista previa en vivo: si el visor no está escuchando, se renderiza sin ella
+    std::unique_ptr<PreviewStream> preview;
+    if (previewPort > 0) {
+        preview.reset(new PreviewStream(width, height, config.tileSize));
+        if (!preview->connect("127.0.0.1", previewPort)) {
+            std::cerr << "Aviso: no hay un visor escuchando en el puerto " << previewPort << "; se renderiza sin vista previa" << std::endl;
+            preview.reset();
+        }
+    }
 
     // Medir el tiempo de generación de la imagen
     auto start = std::chrono::high_resolution_clock::now();
 
-    // 4. Generar la imagen usando la escena y la cámara
-    generateImage(scene, camera, framebuffer, IMAGE_WIDTH, IMAGE_HEIGHT, MAX_REFLECTION_DEPTH, VIEWPORT_WIDTH, VIEWPORT_HEIGHT, DISTANCE_TO_VIEWPORT);
+    // 3. Generar la imagen usando la escena y la cámara (con caché solo para la imagen completa)
+    if (pathTrace) {
+        PathTracer tracer(scene, config.maxBounces);
+        PathTraceStats stats = tracer.render(camera, framebuffer, width, height, rowBegin, rowEnd, config.samplesPerPixel, viewportWidth, viewportHeight, config.distanceToViewport, preview.get());
+        std::cout << "Trazado de caminos: " << config.samplesPerPixel << " muestras por píxel, " << stats.threads << " hilos, "
+                  << stats.samplesPerSecond / 1e6 << " millones de muestras por segundo" << std::endl;
+    } else if (!cacheDirectory.empty()) {
+        RenderCache cache(cacheDirectory);
+        CacheStats stats = generateImageCached(scene, camera, framebuffer, width, height, config.maxDepth, viewportWidth, viewportHeight, config.distanceToViewport, cache, preview.get());
+        if (stats.frameHit) {
+            std::cout << "Caché: imagen completa reutilizada" << std::endl;
+        } else {
+            std::cout << "Caché: " << stats.tilesReused << "/" << stats.tilesTotal << " tiles reutilizados" << std::endl;
+        }
+    } else if (config.pipeline == RenderPipeline::WAVEFRONT) {
+        WavefrontPipeline pipeline(scene, camera, width, height, config.maxDepth, viewportWidth, viewportHeight, config.distanceToViewport);
+        pipeline.render(framebuffer, rowBegin, rowEnd, config.secondaryRays == SecondaryRays::SORTED, config.wavefrontBatch, preview.get());
+        const PipelineStats& stats = pipeline.getStats();
+        std::cout << "Render por etapas: " << stats.primaryRays << " rayos primarios, " << stats.secondaryRays << " secundarios en "
+                  << stats.waves << " frentes, " << stats.shadowRays << " de sombra" << std::endl;
+        for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+            std::cout << "  " << pipelineStageName(static_cast<PipelineStage>(stage)) << ": " << stats.seconds[stage] << " s, "
+                      << stats.items[stage] << " elementos" << std::endl;
+        }
+    } else if (config.secondaryRays != SecondaryRays::RECURSIVE) {
+        WavefrontStats stats = generateImageWavefront(scene, camera, framebuffer, width, height, rowBegin, rowEnd, config.maxDepth, viewportWidth, viewportHeight,
+                                                      config.distanceToViewport, config.secondaryRays == SecondaryRays::SORTED, config.wavefrontBatch, preview.get());
+        std::cout << "Rayos secundarios: " << stats.secondaryRays << " en " << stats.waves << " frentes, trazado " << stats.traceSeconds
+                  << " s, ordenación " << stats.sortSeconds << " s" << std::endl;
+    } else if (numaRender) {
+        std::vector<SceneSnapshot> scenes = replicateScene(scene, config.numa);
+        NumaStats stats = generateImageNuma(scenes, camera, framebuffer, width, height, rowBegin, rowEnd, config.maxDepth, viewportWidth, viewportHeight,
+                                            config.distanceToViewport, config.numa, preview.get());
+        std::cout << "NUMA (" << numaPlacementName(config.numa) << "): " << stats.threads << " hilos en " << stats.nodes << " nodos, "
+                  << stats.stolenTiles << "/" << stats.localTiles + stats.stolenTiles << " tiles de otro nodo, primera escritura "
+                  << stats.touchSeconds << " s" << std::endl;
+    } else {
+        generateImageRows(scene, camera, framebuffer, width, height, rowBegin, rowEnd, config.maxDepth, viewportWidth, viewportHeight, config.distanceToViewport, true, preview.get());
+    }
 
     // Medir el tiempo después de la generación
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> duration = end - start;
     std::cout << "Tiempo de renderizado: " << duration.count() << " segundos" << std::endl;
+    if (pagedGeometry) {
+        std::cout << "Geometría paginada: ";
+        writePagedGeometryStats(std::cout, pagedGeometry->getStats());
+        std::cout << std::endl;
+    }
 
-    // 5. Guardar la imagen como un archivo PPM
-    createPPM(framebuffer, IMAGE_WIDTH, IMAGE_HEIGHT);
+    // Modo trabajador: guardar solo las filas renderizadas como imagen parcial
+    if (!partialPath.empty()) {
+        PartialImage part;
+        part.width = width;
+        part.height = height;
+        part.rowBegin = rowBegin;
+        part.rowEnd = rowEnd;
+        part.pixels = std::move(framebuffer);
+        return writePartialImage(partialPath, part) ? 0 : 1;
+    }
 
-    return 0;
+    // Filtrar el ruido entre el render y la escritura del PPM
+    if (filterOutput) {
+        denoiseFramebuffer(scene, camera, config, framebuffer, rowBegin, rowEnd);
+        framebuffer = framebuffer.convertTo(config.format);
+    }
+
+    // Comparar con la imagen de referencia antes de cerrar el archivo mapeado (que libera los píxeles).
+    // El presupuesto de tiempo incluye el filtro de ruido
+    bool goldenOk = true;
+    if (!goldenPath.empty()) {
+        std::chrono::duration<double> checkedDuration = std::chrono::high_resolution_clock::now() - start;
+        goldenOk = checkGoldenImage(framebuffer, goldenPath, checkedDuration.count(), goldenThresholds);
+    }
+
+    if (preview) {
+        // Imagen final (filtrada, si corresponde): solo viajan los tiles que cambiaron
+        // (el framebuffer guarda las filas [rowBegin, rowEnd), como en la publicación durante el render)
+        for (int tileY = (rowBegin / config.tileSize) * config.tileSize; tileY < rowEnd; tileY += config.tileSize) {
+            for (int tileX = 0; tileX < width; tileX += config.tileSize) {
+                preview->publishTile(framebuffer, tileX, std::max(tileY, rowBegin), std::min(tileX + config.tileSize, width), std::min(tileY + config.tileSize, rowEnd), rowBegin);
+            }
+        }
+        preview->close(); // Envía el fin del render y espera a que el visor reciba todo
+        PreviewStats previewStats = preview->getStats();
+        std::cout << "Vista previa: " << previewStats.tilesSent << " tiles enviados, " << previewStats.tilesSkipped
+                  << " sin cambios omitidos, " << previewStats.bytesSent / (1024.0 * 1024.0) << " MB" << std::endl;
+    }
+
+    // 4. Guardar la imagen como un archivo PPM (si está mapeado, los píxeles ya están en el archivo)
+    if (directOutput) {
+        mappedOutput.close();
+        std::cout << "Imagen escrita directamente en " << outputPath << std::endl;
+    } else {
+        createPPM(framebuffer, outputPath);
+    }
+
+    return goldenOk ? 0 : 1;
 }
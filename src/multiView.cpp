@@ -0,0 +1,124 @@
+#include "multiView.h"
+#include "generateImage.h"
+#include "TilePool.h"
+#include <algorithm> // Para std::max
+#include <utility>   // Para std::pair
+
+/**
+ * Calcula las dos vistas de una pareja estéreo.
+ *
+ * @param center: Cámara central.
+ * @param width: Ancho de cada vista en píxeles.
+ * @param height: Alto de cada vista en píxeles.
+ * @param viewportWidth: Ancho del viewport de cada vista.
+ * @param viewportHeight: Alto del viewport de cada vista.
+ * @param eyeSeparation: Distancia entre las dos cámaras.
+ * @return std::vector<RenderView>: Vista izquierda y derecha.
+ */
+std::vector<RenderView> stereoViews(const Camera& center, int width, int height, double viewportWidth, double viewportHeight, double eyeSeparation) {
+    Vector3D halfBaseline = center.getRight() * (eyeSeparation / 2.0);
+    std::vector<RenderView> views(2);
+    for (int eye = 0; eye < 2; ++eye) {
+        RenderView& view = views[eye];
+        view.name = eye == 0 ? "left" : "right";
+        view.camera = Camera(eye == 0 ? center.getPosition() - halfBaseline : center.getPosition() + halfBaseline, center.getForward(), center.getUp());
+        view.width = width;
+        view.height = height;
+        view.viewportWidth = viewportWidth;
+        view.viewportHeight = viewportHeight;
+        view.offsetX = eye * width;
+    }
+    return views;
+}
+
+/**
+ * Calcula las seis caras de un cubemap.
+ *
+ * @param center: Cámara cuya posición es el centro del cubemap.
+ * @param faceSize: Lado de cada cara en píxeles.
+ * @param distanceToViewport: Distancia entre la cámara y el viewport.
+ * @return std::vector<RenderView>: Las seis caras.
+ */
+std::vector<RenderView> cubeMapViews(const Camera& center, int faceSize, double distanceToViewport) {
+    // Dirección de la vista y vector hacia arriba de cada cara; las caras laterales mantienen +y arriba
+    const char* names[6] = { "+x", "-x", "+y", "-y", "+z", "-z" };
+    const Vector3D forward[6] = { Vector3D(1, 0, 0), Vector3D(-1, 0, 0), Vector3D(0, 1, 0), Vector3D(0, -1, 0), Vector3D(0, 0, 1), Vector3D(0, 0, -1) };
+    const Vector3D up[6] = { Vector3D(0, 1, 0), Vector3D(0, 1, 0), Vector3D(0, 0, -1), Vector3D(0, 0, 1), Vector3D(0, 1, 0), Vector3D(0, 1, 0) };
+
+    std::vector<RenderView> views(6);
+    for (int face = 0; face < 6; ++face) {
+        RenderView& view = views[face];
+        view.name = names[face];
+        view.camera = Camera(center.getPosition(), forward[face], up[face]);
+        view.width = faceSize;
+        view.height = faceSize;
+        view.viewportWidth = 2.0 * distanceToViewport;
+        view.viewportHeight = 2.0 * distanceToViewport;
+        view.offsetX = face * faceSize;
+    }
+    return views;
+}
+
+/**
+ * Calcula el tamaño de la imagen compuesta.
+ *
+ * @param views: Vistas.
+ * @param width: Ancho de la imagen.
+ * @param height: Alto de la imagen.
+ */
+void getViewsImageSize(const std::vector<RenderView>& views, int& width, int& height) {
+    width = 0;
+    height = 0;
+    for (const RenderView& view : views) {
+        width = std::max(width, view.offsetX + view.width);
+        height = std::max(height, view.offsetY + view.height);
+    }
+}
+
+/**
+ * Renderiza varias vistas de una misma escena en un único lote de tiles.
+ *
+ * @param scene: Escena que contiene los objetos y las luces.
+ * @param views: Vistas a renderizar.
+ * @param image: Imagen compuesta.
+ * @param maxDepth: Profundidad máxima de las reflexiones de los rayos.
+ * @param distanceToViewport: Distancia entre las cámaras y el viewport.
+ */
+void generateImageViews(const Scene& scene, const std::vector<RenderView>& views, Framebuffer& image, int maxDepth, double distanceToViewport) {
+    // El kernel depende solo de la escena, así que todas las vistas comparten el mismo
+    Scene::TraceKernel traceKernel = Scene::selectKernel(scene.getFeatures(maxDepth));
+    int tileSize = getTileSize();
+
+    // Tareas intercaladas: (vista, tile) para el tile 0 de cada vista, después el 1, ...
+    std::vector<Framebuffer> images;
+    std::vector<int> tileColumns, tileCounts;
+    std::vector<std::pair<int, int>> tasks;
+    int maxTiles = 0;
+    for (const RenderView& view : views) {
+        images.emplace_back(view.width, view.height, image.getFormat());
+        tileColumns.push_back((view.width + tileSize - 1) / tileSize);
+        tileCounts.push_back(tileColumns.back() * ((view.height + tileSize - 1) / tileSize));
+        maxTiles = std::max(maxTiles, tileCounts.back());
+    }
+    for (int tile = 0; tile < maxTiles; ++tile) {
+        for (size_t view = 0; view < views.size(); ++view) {
+            if (tile < tileCounts[view]) {
+                tasks.emplace_back(static_cast<int>(view), tile);
+            }
+        }
+    }
+
+    TilePool::shared().run(static_cast<int>(tasks.size()), [&](int task, int) {
+        int index = tasks[task].first;
+        int tile = tasks[task].second;
+        const RenderView& view = views[index];
+        int tileX = (tile % tileColumns[index]) * tileSize;
+        int tileY = (tile / tileColumns[index]) * tileSize;
+        renderTile(scene, view.camera, images[index], traceKernel, tileX, tileY, view.width, view.height, 0, view.height, maxDepth,
+                   view.viewportWidth, view.viewportHeight, distanceToViewport);
+    });
+
+    for (size_t view = 0; view < views.size(); ++view) {
+        image.copyFrom(images[view], views[view].offsetX, views[view].offsetY);
+    }
+}
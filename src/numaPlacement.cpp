@@ -0,0 +1,366 @@
+#include "numaPlacement.h"
+#include "generateImage.h"
+#include "TilePool.h"
+#include <algorithm> // Para std::min, std::sort, std::find
+#include <atomic>
+#include <chrono>
+#include <cstring>   // Para std::memset
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <filesystem>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+/**
+ * Devuelve el tamaño de página de la memoria virtual.
+ *
+ * @return size_t: Bytes por página.
+ */
+size_t getPageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+#else
+    long pageSize = sysconf(_SC_PAGESIZE);
+    return pageSize > 0 ? static_cast<size_t>(pageSize) : 4096;
+#endif
+}
+
+/**
+ * Devuelve las CPUs que el proceso puede usar.
+ *
+ * @return std::vector<int>: CPUs en orden (vacío si no se conocen).
+ */
+std::vector<int> getAllowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+/**
+ * Convierte una lista de CPUs de sysfs ("0-3,8-11") en los números de CPU.
+ *
+ * @param list: Lista de rangos separados por comas.
+ * @return std::vector<int>: CPUs de la lista.
+ */
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    size_t position = 0;
+    while (position < list.size()) {
+        size_t end = list.find(',', position);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        std::string range = list.substr(position, end - position);
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // Rango vacío o ilegible (por ejemplo, un nodo sin CPUs): se ignora
+        }
+        position = end + 1;
+    }
+    return cpus;
+}
+
+/**
+ * Reparte tareas agrupadas por nodo entre todos los hilos del pool.
+ *
+ * Cada hilo toma primero las tareas de su nodo y, si steal es true, después las de los demás nodos;
+ * sin steal, cada tarea la ejecuta un hilo de su nodo (todos los nodos tienen al menos un hilo).
+ *
+ * @param pool: Pool con los hilos fijados.
+ * @param nodeTaskCounts: Número de tareas de cada nodo.
+ * @param steal: Permite que un hilo ejecute tareas de otros nodos al terminar las del suyo.
+ * @param task: Función que recibe el nodo de la tarea, su índice dentro del nodo y el hilo.
+ */
+void runNodeTasks(TilePool& pool, const std::vector<int>& nodeTaskCounts, bool steal, const std::function<void(int, int, int)>& task) {
+    int nodeCount = static_cast<int>(nodeTaskCounts.size());
+    std::unique_ptr<std::atomic<int>[]> nextTask(new std::atomic<int>[nodeCount]);
+    for (int node = 0; node < nodeCount; ++node) {
+        nextTask[node].store(0);
+    }
+
+    pool.runPerThread([&](int thread) {
+        int home = pool.getThreadNode(thread);
+        for (int offset = 0; offset < (steal ? nodeCount : 1); ++offset) {
+            int node = (home + offset) % nodeCount;
+            for (int i = nextTask[node].fetch_add(1); i < nodeTaskCounts[node]; i = nextTask[node].fetch_add(1)) {
+                task(node, i, thread);
+            }
+        }
+    });
+}
+
+} // namespace
+
+FirstTouchBuffer::~FirstTouchBuffer() {
+    release();
+}
+
+/**
+ * @brief Reserva memoria anónima: las páginas no se asignan hasta la primera escritura.
+ * @param bytes Tamaño en bytes.
+ * @return true si la memoria quedó reservada.
+ */
+bool FirstTouchBuffer::allocate(size_t bytes) {
+    release();
+    if (bytes == 0) {
+        return false;
+    }
+#ifdef _WIN32
+    void* memory = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!memory) {
+        return false;
+    }
+#else
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+#endif
+    data = static_cast<unsigned char*>(memory);
+    size = bytes;
+    return true;
+}
+
+/**
+ * @brief Libera la memoria.
+ */
+void FirstTouchBuffer::release() {
+    if (data) {
+#ifdef _WIN32
+        VirtualFree(data, 0, MEM_RELEASE);
+#else
+        munmap(data, size);
+#endif
+    }
+    data = nullptr;
+    size = 0;
+}
+
+unsigned char* FirstTouchBuffer::getData() const {
+    return data;
+}
+
+size_t FirstTouchBuffer::getSize() const {
+    return size;
+}
+
+/**
+ * Lee los nodos NUMA del sistema.
+ *
+ * @return std::vector<NumaNode>: Nodos con CPUs que el proceso puede usar.
+ */
+std::vector<NumaNode> readNumaTopology() {
+    std::vector<int> allowed = getAllowedCpus();
+    std::vector<NumaNode> nodes;
+#ifdef __linux__
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 || name.find_first_not_of("0123456789", 4) != std::string::npos) {
+            continue;
+        }
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        if (!std::getline(file, list)) {
+            continue;
+        }
+
+        NumaNode node;
+        node.id = std::stoi(name.substr(4));
+        for (int cpu : parseCpuList(list)) {
+            if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+                node.cpus.push_back(cpu);
+            }
+        }
+        if (!node.cpus.empty()) {
+            nodes.push_back(node);
+        }
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+#endif
+
+    if (nodes.empty()) {
+        NumaNode node;
+        node.cpus = allowed;
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+/**
+ * Fija el hilo actual a un conjunto de CPUs.
+ *
+ * @param cpus: CPUs permitidas.
+ * @return bool: true si el sistema aceptó la afinidad.
+ */
+bool pinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Prepara una escena por nodo del pool compartido.
+ *
+ * @param scene: Escena completa.
+ * @param placement: Colocación.
+ * @return std::vector<SceneSnapshot>: Escena de cada nodo.
+ */
+std::vector<SceneSnapshot> replicateScene(const Scene& scene, NumaPlacement placement) {
+    TilePool& pool = TilePool::shared();
+
+    // Sin copias, todos los nodos usan la escena original (el shared_ptr no la posee)
+    std::vector<SceneSnapshot> scenes(pool.getNodeCount(), SceneSnapshot(SceneSnapshot(), &scene));
+    if (placement != NumaPlacement::LOCAL) {
+        return scenes;
+    }
+
+    // El primer hilo de cada nodo hace la copia, así que el sistema la coloca en la memoria de ese nodo
+    pool.runPerThread([&](int thread) {
+        int node = pool.getThreadNode(thread);
+        if (thread == 0 || pool.getThreadNode(thread - 1) != node) {
+            scenes[node] = std::make_shared<const Scene>(scene);
+        }
+    });
+    return scenes;
+}
+
+/**
+ * Genera las filas [rowBegin, rowEnd) de la imagen con los hilos y la memoria colocados por nodo NUMA.
+ *
+ * @param scenes: Escena de cada nodo.
+ * @param cam: Cámara que genera los rayos para renderizar la imagen.
+ * @param framebuffer: Framebuffer sin tocar de width x (rowEnd - rowBegin) píxeles.
+ * @param width: Ancho de la imagen completa en píxeles.
+ * @param height: Alto de la imagen completa en píxeles.
+ * @param rowBegin: Primera fila a renderizar.
+ * @param rowEnd: Fila siguiente a la última a renderizar.
+ * @param maxDepth: Profundidad máxima de las reflexiones de los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia entre la cámara y el viewport.
+ * @param placement: Colocación de la memoria del framebuffer.
+ * @param preview: Vista previa en vivo (puede ser nullptr).
+ * @return NumaStats: Estadísticas del render.
+ */
+NumaStats generateImageNuma(const std::vector<SceneSnapshot>& scenes, const Camera& cam, Framebuffer& framebuffer, int width, int height, int rowBegin, int rowEnd,
+                            int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport, NumaPlacement placement, PreviewStream* preview) {
+    TilePool& pool = TilePool::shared();
+    NumaStats stats;
+    stats.nodes = pool.getNodeCount();
+    stats.threads = pool.getThreadCount();
+
+    // Las copias tienen las mismas características, así que comparten el kernel
+    Scene::TraceKernel traceKernel = Scene::selectKernel(scenes[0]->getFeatures(maxDepth));
+
+    // Franja de filas de tiles de cada nodo, alineadas a la cuadrícula global como en generateImageRows
+    int tileSize = getTileSize();
+    int firstTileY = (rowBegin / tileSize) * tileSize;
+    int tileColumns = (width + tileSize - 1) / tileSize;
+    int tileRows = (rowEnd - firstTileY + tileSize - 1) / tileSize;
+    std::vector<int> bandBegin(stats.nodes + 1);
+    for (int node = 0; node <= stats.nodes; ++node) {
+        bandBegin[node] = node * tileRows / stats.nodes;
+    }
+
+    // 1. Primera escritura del framebuffer (con ceros), que decide el nodo de cada página
+    auto start = std::chrono::high_resolution_clock::now();
+    unsigned char* data = framebuffer.getData();
+    size_t byteSize = framebuffer.getByteSize();
+    std::vector<int> touchTasks(stats.nodes);
+    std::vector<size_t> touchBegin(stats.nodes), touchEnd(stats.nodes);
+    size_t pageSize = getPageSize();
+    size_t pageCount = (byteSize + pageSize - 1) / pageSize;
+    for (int node = 0; node < stats.nodes; ++node) {
+        if (placement == NumaPlacement::LOCAL) {
+            int firstRow = std::max(firstTileY + bandBegin[node] * tileSize, rowBegin) - rowBegin;
+            int lastRow = std::min(firstTileY + bandBegin[node + 1] * tileSize, rowEnd) - rowBegin;
+            touchBegin[node] = static_cast<size_t>(firstRow) * framebuffer.getRowBytes();
+            touchEnd[node] = std::max(touchBegin[node], static_cast<size_t>(lastRow) * framebuffer.getRowBytes());
+            touchTasks[node] = static_cast<int>((touchEnd[node] - touchBegin[node] + NUMA_TOUCH_CHUNK_BYTES - 1) / NUMA_TOUCH_CHUNK_BYTES);
+        } else {
+            // Páginas node, node + nodes, node + 2 * nodes, ...
+            touchTasks[node] = static_cast<int>(pageCount > static_cast<size_t>(node) ? (pageCount - node + stats.nodes - 1) / stats.nodes : 0);
+        }
+    }
+    runNodeTasks(pool, touchTasks, false, [&](int node, int task, int) {
+        size_t begin, end;
+        if (placement == NumaPlacement::LOCAL) {
+            begin = touchBegin[node] + static_cast<size_t>(task) * NUMA_TOUCH_CHUNK_BYTES;
+            end = std::min(begin + NUMA_TOUCH_CHUNK_BYTES, touchEnd[node]);
+        } else {
+            begin = (static_cast<size_t>(task) * stats.nodes + node) * pageSize;
+            end = std::min(begin + pageSize, byteSize);
+        }
+        std::memset(data + begin, 0, end - begin);
+    });
+    stats.touchSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    // 2. Render: cada hilo usa la escena de su nodo, también en los tiles que toma de otras franjas
+    std::vector<int> nodeTiles(stats.nodes);
+    for (int node = 0; node < stats.nodes; ++node) {
+        nodeTiles[node] = (bandBegin[node + 1] - bandBegin[node]) * tileColumns;
+    }
+    std::atomic<int> localTiles{0}, stolenTiles{0};
+    runNodeTasks(pool, nodeTiles, true, [&](int node, int task, int thread) {
+        int home = pool.getThreadNode(thread);
+        int tileX = (task % tileColumns) * tileSize;
+        int tileY = firstTileY + (bandBegin[node] + task / tileColumns) * tileSize;
+        renderTile(*scenes[home], cam, framebuffer, traceKernel, tileX, tileY, width, height, rowBegin, rowEnd, maxDepth, viewportWidth, viewportHeight, distanceToViewport);
+        ++(node == home ? localTiles : stolenTiles);
+        if (preview) {
+            preview->publishTile(framebuffer, tileX, std::max(tileY, rowBegin), std::min(tileX + tileSize, width), std::min(tileY + tileSize, rowEnd), rowBegin);
+        }
+    });
+    if (preview) {
+        preview->endPass(1);
+    }
+    stats.localTiles = localTiles.load();
+    stats.stolenTiles = stolenTiles.load();
+    return stats;
+}
@@ -0,0 +1,113 @@
+#include "partialImage.h"
+#include <fstream>   // Para std::ifstream y std::ofstream
+#include <iostream>  // Para std::cerr
+#include <cstring>   // Para std::memcmp
+#include <cstdint>   // Para std::int32_t
+
+// Identificador al inicio de cada archivo parcial
+static const char PARTIAL_MAGIC[8] = { 'R', 'T', 'P', 'A', 'R', 'T', '2', '\n' };
+
+/**
+ * Escribe una imagen parcial: identificador, cinco enteros de 32 bits (ancho, alto, fila inicial,
+ * fila final, formato de los píxeles) y los bytes del framebuffer.
+ *
+ * @param path: Ruta del archivo.
+ * @param image: Imagen parcial a escribir.
+ * @return bool: true si el archivo se escribió correctamente.
+ */
+bool writePartialImage(const std::string& path, const PartialImage& image) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo abrir " << path << " para escritura." << std::endl;
+        return false;
+    }
+
+    std::int32_t header[5] = { image.width, image.height, image.rowBegin, image.rowEnd, static_cast<std::int32_t>(image.pixels.getFormat()) };
+    file.write(PARTIAL_MAGIC, sizeof(PARTIAL_MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(image.pixels.getData()), image.pixels.getByteSize());
+    return static_cast<bool>(file);
+}
+
+/**
+ * Lee una imagen parcial.
+ *
+ * @param path: Ruta del archivo.
+ * @param image: Imagen parcial leída.
+ * @return bool: true si el archivo existe y tiene un formato válido.
+ */
+bool readPartialImage(const std::string& path, PartialImage& image) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo abrir " << path << "." << std::endl;
+        return false;
+    }
+
+    char magic[sizeof(PARTIAL_MAGIC)];
+    std::int32_t header[5];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || std::memcmp(magic, PARTIAL_MAGIC, sizeof(magic)) != 0 ||
+        header[0] <= 0 || header[1] <= 0 || header[2] < 0 || header[3] > header[1] || header[2] >= header[3] ||
+        header[4] < static_cast<std::int32_t>(PixelFormat::RGB_F16) || header[4] > static_cast<std::int32_t>(PixelFormat::SRGB8)) {
+        std::cerr << "Error: " << path << " no es una imagen parcial válida." << std::endl;
+        return false;
+    }
+
+    image.width = header[0];
+    image.height = header[1];
+    image.rowBegin = header[2];
+    image.rowEnd = header[3];
+    image.pixels = Framebuffer(image.width, image.rowEnd - image.rowBegin, static_cast<PixelFormat>(header[4]));
+
+    file.read(reinterpret_cast<char*>(image.pixels.getData()), image.pixels.getByteSize());
+    if (!file) {
+        std::cerr << "Error: " << path << " está incompleto." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Ensambla varias imágenes parciales en un framebuffer completo.
+ *
+ * @param paths: Rutas de las imágenes parciales.
+ * @param framebuffer: Framebuffer completo resultante.
+ * @param width: Ancho de la imagen ensamblada.
+ * @param height: Alto de la imagen ensamblada.
+ * @return bool: true si las partes son consistentes y cubren toda la imagen.
+ */
+bool mergePartialImages(const std::vector<std::string>& paths, Framebuffer& framebuffer, int& width, int& height) {
+    std::vector<bool> covered;
+    width = 0;
+    height = 0;
+
+    for (const auto& path : paths) {
+        PartialImage part;
+        if (!readPartialImage(path, part)) {
+            return false;
+        }
+        if (width == 0) {
+            width = part.width;
+            height = part.height;
+            framebuffer = Framebuffer(width, height, part.pixels.getFormat());
+            covered.assign(height, false);
+        } else if (part.width != width || part.height != height || part.pixels.getFormat() != framebuffer.getFormat()) {
+            std::cerr << "Error: " << path << " tiene dimensiones o formato distintos al resto de las partes." << std::endl;
+            return false;
+        }
+
+        framebuffer.copyFrom(part.pixels, 0, part.rowBegin);
+        for (int y = part.rowBegin; y < part.rowEnd; ++y) {
+            covered[y] = true;
+        }
+    }
+
+    for (int y = 0; y < height; ++y) {
+        if (!covered[y]) {
+            std::cerr << "Error: la fila " << y << " no está cubierta por ninguna parte." << std::endl;
+            return false;
+        }
+    }
+    return width > 0;
+}
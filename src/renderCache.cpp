@@ -0,0 +1,422 @@
+#include "renderCache.h"
+#include "sceneHash.h"
+#include "generateImage.h"
+#include "Ray.h"
+#include <fstream>     // Para std::ifstream y std::ofstream
+#include <cstring>     // Para std::memcmp
+#include <algorithm>   // Para std::min y std::max
+#include <limits>      // Para std::numeric_limits
+#include <cstdio>      // Para std::snprintf
+#include <filesystem>  // Para crear el directorio y renombrar entradas (C++17)
+
+namespace fs = std::filesystem;
+
+// Identificador al inicio de cada entrada de la caché; cambia cuando cambia el sombreado
+// para no reutilizar imágenes calculadas con una versión anterior
+static const char CACHE_MAGIC[8] = { 'R', 'T', 'C', 'A', 'C', 'H', 'E', '3' };
+
+namespace {
+
+/**
+ * Caja alineada a los ejes usada para estimar qué objetos pueden bloquear los rayos de sombra de un tile.
+ */
+struct Bounds {
+    double min[3] = { std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+    double max[3] = { -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+
+    bool empty() const {
+        return min[0] > max[0];
+    }
+
+    void expand(const Vector3D& point) {
+        const double p[3] = { point.getX(), point.getY(), point.getZ() };
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], p[axis]);
+            max[axis] = std::max(max[axis], p[axis]);
+        }
+    }
+
+    void expand(const Vector3D& center, double radius) {
+        expand(center - Vector3D(radius, radius, radius));
+        expand(center + radius);
+    }
+
+    void expand(const Bounds& other) {
+        if (!other.empty()) {
+            expand(Vector3D(other.min[0], other.min[1], other.min[2]));
+            expand(Vector3D(other.max[0], other.max[1], other.max[2]));
+        }
+    }
+
+    bool overlaps(const Bounds& other) const {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (min[axis] > other.max[axis] || max[axis] < other.min[axis]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double diagonal() const {
+        if (empty()) {
+            return 0.0;
+        }
+        return Vector3D(max[0] - min[0], max[1] - min[1], max[2] - min[2]).norm();
+    }
+};
+
+Bounds triangleBounds(const Triangle& triangle) {
+    Bounds bounds;
+    bounds.expand(triangle.getVertexA());
+    bounds.expand(triangle.getVertexB());
+    bounds.expand(triangle.getVertexC());
+    return bounds;
+}
+
+Bounds sphereBounds(const Sphere& sphere) {
+    Bounds bounds;
+    bounds.expand(sphere.getCenter(), sphere.getRadius());
+    return bounds;
+}
+
+// Indica si el objeto visto lanza rayos secundarios (reflexión o refracción)
+bool hitSpawnsSecondaryRays(const HitRecord& hit) {
+    double reflectivity, transparency;
+    if (hit.triangle) {
+        reflectivity = hit.triangle->getReflectivity();
+        transparency = hit.triangle->getTransparency();
+    } else if (hit.plane) {
+        reflectivity = hit.plane->getReflectivity();
+        transparency = hit.plane->getTransparency();
+    } else if (hit.sphereGrid) {
+        const SphereMaterial& material = hit.sphereGrid->getMaterial(hit.gridSphere);
+        reflectivity = material.reflectivity;
+        transparency = material.transparency;
+    } else if (hit.mesh) {
+        reflectivity = hit.mesh->getMaterial().reflectivity;
+        transparency = hit.mesh->getMaterial().transparency;
+    } else if (hit.paged) {
+        reflectivity = hit.paged->getMaterial(hit.pagedChunk).reflectivity;
+        transparency = hit.paged->getMaterial(hit.pagedChunk).transparency;
+    } else {
+        reflectivity = hit.sphere->getReflectivity();
+        transparency = hit.sphere->getTransparency();
+    }
+    return reflectivity > 0 || transparency > 0;
+}
+
+} // namespace
+
+RenderCache::RenderCache(const std::string& directory) : directory(directory) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+}
+
+std::string RenderCache::pathFor(std::uint64_t key, const char* extension) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.%s", static_cast<unsigned long long>(key), extension);
+    return (fs::path(directory) / name).string();
+}
+
+bool RenderCache::load(const std::string& path, std::uint64_t key, Framebuffer& pixels) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[sizeof(CACHE_MAGIC)];
+    std::uint64_t header[2];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 || header[0] != key || header[1] != pixels.getByteSize()) {
+        return false;
+    }
+
+    file.read(reinterpret_cast<char*>(pixels.getData()), pixels.getByteSize());
+    return static_cast<bool>(file);
+}
+
+void RenderCache::store(const std::string& path, std::uint64_t key, const Framebuffer& pixels) const {
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary);
+        if (!file.is_open()) {
+            return; // La caché es opcional: si no se puede escribir, simplemente no se guarda
+        }
+        std::uint64_t header[2] = { key, pixels.getByteSize() };
+        file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(pixels.getData()), pixels.getByteSize());
+        if (!file) {
+            return;
+        }
+    }
+    std::error_code error;
+    fs::rename(tempPath, path, error);
+}
+
+bool RenderCache::loadFrame(std::uint64_t key, Framebuffer& pixels) const {
+    return load(pathFor(key, "frame"), key, pixels);
+}
+
+void RenderCache::storeFrame(std::uint64_t key, const Framebuffer& pixels) const {
+    store(pathFor(key, "frame"), key, pixels);
+}
+
+bool RenderCache::loadTile(std::uint64_t key, Framebuffer& pixels) const {
+    return load(pathFor(key, "tile"), key, pixels);
+}
+
+void RenderCache::storeTile(std::uint64_t key, const Framebuffer& pixels) const {
+    store(pathFor(key, "tile"), key, pixels);
+}
+
+/**
+ * Genera una imagen reutilizando los resultados guardados en la caché.
+ *
+ * @param scene: La escena que contiene los objetos y las luces a renderizar.
+ * @param cam: La cámara desde la cual se generarán los rayos.
+ * @param framebuffer: Framebuffer de width x height píxeles donde se guarda la imagen.
+ * @param width: Ancho de la imagen en píxeles.
+ * @param height: Alto de la imagen en píxeles.
+ * @param maxDepth: Profundidad máxima de las reflexiones para los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia desde la cámara hasta el viewport.
+ * @param cache: Caché donde se buscan y guardan los resultados.
+ * @param preview: Vista previa que recibe los tiles (puede ser nullptr).
+ * @return CacheStats: Aciertos de la caché.
+ */
+CacheStats generateImageCached(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, int width, int height, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport, const RenderCache& cache, PreviewStream* preview) {
+    CacheStats stats;
+    int tileSize = getTileSize();
+
+    // Parámetros del render independientes de la escena
+    Hasher settingsHasher;
+    settingsHasher.add(hashCamera(cam));
+    settingsHasher.add(static_cast<std::uint64_t>(width));
+    settingsHasher.add(static_cast<std::uint64_t>(height));
+    settingsHasher.add(static_cast<std::uint64_t>(maxDepth));
+    settingsHasher.add(viewportWidth);
+    settingsHasher.add(viewportHeight);
+    settingsHasher.add(distanceToViewport);
+    settingsHasher.add(MIN_RAY_CONTRIBUTION);
+    settingsHasher.add(static_cast<std::uint64_t>(MAX_SECONDARY_RAYS_PER_PIXEL));
+    settingsHasher.add(static_cast<std::uint64_t>(framebuffer.getFormat()));
+    settingsHasher.add(static_cast<std::uint64_t>(tileSize));
+    std::uint64_t settingsHash = settingsHasher.value();
+    std::uint64_t sceneHash = hashScene(scene);
+
+    Hasher frameHasher;
+    frameHasher.add(settingsHash);
+    frameHasher.add(sceneHash);
+    std::uint64_t frameKey = frameHasher.value();
+
+    if (cache.loadFrame(frameKey, framebuffer)) {
+        stats.frameHit = true;
+        if (preview) {
+            for (int tileY = 0; tileY < height; tileY += tileSize) {
+                for (int tileX = 0; tileX < width; tileX += tileSize) {
+                    preview->publishTile(framebuffer, tileX, tileY, std::min(tileX + tileSize, width), std::min(tileY + tileSize, height), 0);
+                }
+            }
+            preview->endPass(1);
+        }
+        return stats;
+    }
+
+    // Hashes por objeto, límites de los objetos finitos y de toda la escena
+    const auto& triangles = scene.getTriangles();
+    const auto& planes = scene.getPlanes();
+    const auto& spheres = scene.getSpheres();
+    std::vector<std::uint64_t> triangleHashes, planeHashes, sphereHashes;
+    std::vector<Bounds> triangleBoxes, sphereBoxes;
+    Bounds sceneBounds;
+    for (const auto& triangle : triangles) {
+        triangleHashes.push_back(hashTriangle(triangle));
+        triangleBoxes.push_back(triangleBounds(triangle));
+        sceneBounds.expand(triangleBoxes.back());
+    }
+    for (const auto& plane : planes) {
+        planeHashes.push_back(hashPlane(plane));
+    }
+    for (const auto& sphere : spheres) {
+        sphereHashes.push_back(hashSphere(sphere));
+        sphereBoxes.push_back(sphereBounds(sphere));
+        sceneBounds.expand(sphereBoxes.back());
+    }
+    std::uint64_t lightsHash = hashLights(scene);
+    const SphereGrid& sphereGrid = scene.getSphereGrid();
+    std::uint64_t sphereGridHash = sphereGrid.empty() ? 0 : hashSphereGrid(sphereGrid);
+    const auto& meshes = scene.getMeshes();
+    std::vector<std::uint64_t> meshHashes;
+    std::vector<Bounds> meshBoxes;
+    for (const auto& mesh : meshes) {
+        Vector3D minimum, maximum;
+        mesh.getBounds(minimum, maximum);
+        Bounds box;
+        box.expand(minimum);
+        box.expand(maximum);
+        meshHashes.push_back(hashMesh(mesh));
+        meshBoxes.push_back(box);
+        sceneBounds.expand(box);
+    }
+    // Los chunks de la geometría paginada se tratan como mallas sueltas, con el hash y la caja de su tabla
+    const PagedGeometry* paged = scene.getPagedGeometry();
+    std::vector<std::uint64_t> chunkHashes;
+    std::vector<Bounds> chunkBoxes;
+    if (paged) {
+        for (const auto& chunk : paged->getChunks()) {
+            Bounds box;
+            box.expand(chunk.boundsMin);
+            box.expand(chunk.boundsMax);
+            chunkHashes.push_back(chunk.hash);
+            chunkBoxes.push_back(box);
+            sceneBounds.expand(box);
+        }
+    }
+
+    auto objectHash = [&](const HitRecord& hit) {
+        if (hit.triangle) {
+            return triangleHashes[hit.triangle - triangles.data()];
+        } else if (hit.plane) {
+            return planeHashes[hit.plane - planes.data()];
+        } else if (hit.sphereGrid) {
+            return hashGridSphere(*hit.sphereGrid, hit.gridSphere);
+        } else if (hit.mesh) {
+            return hashMeshTriangle(*hit.mesh, hit.meshTriangle);
+        } else if (hit.paged) {
+            return hashPagedTriangle(*hit.paged, hit.pagedChunk, hit.pagedTriangle);
+        }
+        return sphereHashes[hit.sphere - spheres.data()];
+    };
+
+    std::vector<Ray> rays;
+    std::vector<HitRecord> hits;
+    std::vector<char> hasHit;
+
+    for (int tileY = 0; tileY < height; tileY += tileSize) {
+        for (int tileX = 0; tileX < width; tileX += tileSize) {
+            int x1 = std::min(tileX + tileSize, width);
+            int y1 = std::min(tileY + tileSize, height);
+            size_t tilePixelCount = static_cast<size_t>(x1 - tileX) * (y1 - tileY);
+            stats.tilesTotal++;
+
+            // Pasada primaria: intersecciones de los rayos primarios del tile
+            PrimitiveList candidates = cullPrimitivesForTile(scene, cam, tileX, tileY, x1, y1, width, height, viewportWidth, viewportHeight, distanceToViewport);
+            rays.clear();
+            hits.assign(tilePixelCount, HitRecord());
+            hasHit.assign(tilePixelCount, 0);
+
+            Hasher tileHasher;
+            tileHasher.add(settingsHash);
+            tileHasher.add(static_cast<std::uint64_t>(tileX));
+            tileHasher.add(static_cast<std::uint64_t>(tileY));
+            tileHasher.add(static_cast<std::uint64_t>(x1));
+            tileHasher.add(static_cast<std::uint64_t>(y1));
+            tileHasher.add(lightsHash);
+
+            Bounds hitBounds;
+            bool reflective = false;
+            for (int y = tileY; y < y1; ++y) {
+                for (int x = tileX; x < x1; ++x) {
+                    size_t i = rays.size();
+                    rays.push_back(cam.generateRay(x, y, width, height, viewportWidth, viewportHeight, distanceToViewport));
+                    hasHit[i] = scene.closestHit(rays[i], candidates, hits[i]);
+                    if (hasHit[i]) {
+                        // El objeto visto determina el punto, la normal y el material del píxel
+                        tileHasher.add(objectHash(hits[i]));
+                        hitBounds.expand(hits[i].point);
+                        reflective = reflective || (maxDepth > 0 && hitSpawnsSecondaryRays(hits[i]));
+                    } else {
+                        tileHasher.add(static_cast<std::uint64_t>(0));
+                    }
+                }
+            }
+
+            if (reflective) {
+                // Los rayos reflejados o refractados pueden alcanzar cualquier objeto
+                tileHasher.add(sceneHash);
+            } else if (!hitBounds.empty()) {
+                // Región que pueden recorrer los rayos de sombra: desde los puntos del tile hasta cada luz
+                Bounds shadowBounds = hitBounds;
+                Bounds reach = sceneBounds;
+                reach.expand(hitBounds);
+                double sweep = reach.diagonal();
+                for (const auto& light : scene.getLights()) {
+                    if (light.getType() == LightSource::POINT) {
+                        shadowBounds.expand(light.getPosition());
+                    } else if (light.getType() == LightSource::RECTANGLE) {
+                        // Los rayos de sombra pueden llegar a cualquier esquina del rectángulo
+                        Vector3D halfU = light.getEdgeU() * 0.5;
+                        Vector3D halfV = light.getEdgeV() * 0.5;
+                        shadowBounds.expand(light.getPosition() + halfU + halfV);
+                        shadowBounds.expand(light.getPosition() + halfU - halfV);
+                        shadowBounds.expand(light.getPosition() - halfU + halfV);
+                        shadowBounds.expand(light.getPosition() - halfU - halfV);
+                    } else if (light.getType() == LightSource::SPHERE) {
+                        Vector3D extent(light.getRadius(), light.getRadius(), light.getRadius());
+                        shadowBounds.expand(light.getPosition() + extent);
+                        shadowBounds.expand(light.getPosition() - extent);
+                    } else if (light.getType() == LightSource::DIRECTIONAL) {
+                        Vector3D offset = light.getDirection().normalize() * sweep;
+                        shadowBounds.expand(Vector3D(hitBounds.min[0], hitBounds.min[1], hitBounds.min[2]) + offset);
+                        shadowBounds.expand(Vector3D(hitBounds.max[0], hitBounds.max[1], hitBounds.max[2]) + offset);
+                    }
+                }
+                for (size_t i = 0; i < triangles.size(); ++i) {
+                    if (triangleBoxes[i].overlaps(shadowBounds)) {
+                        tileHasher.add(triangleHashes[i]);
+                    }
+                }
+                for (size_t i = 0; i < spheres.size(); ++i) {
+                    if (sphereBoxes[i].overlaps(shadowBounds)) {
+                        tileHasher.add(sphereHashes[i]);
+                    }
+                }
+                for (std::uint64_t planeHash : planeHashes) {
+                    tileHasher.add(planeHash);
+                }
+                if (!sphereGrid.empty()) {
+                    // La malla se trata como un único objeto: cualquiera de sus esferas puede dar sombra
+                    tileHasher.add(sphereGridHash);
+                }
+                for (size_t i = 0; i < meshes.size(); ++i) {
+                    // Cada malla también cuenta como un único objeto
+                    if (meshBoxes[i].overlaps(shadowBounds)) {
+                        tileHasher.add(meshHashes[i]);
+                    }
+                }
+                for (size_t i = 0; i < chunkHashes.size(); ++i) {
+                    if (chunkBoxes[i].overlaps(shadowBounds)) {
+                        tileHasher.add(chunkHashes[i]);
+                    }
+                }
+            }
+
+            std::uint64_t tileKey = tileHasher.value();
+            Framebuffer tilePixels(x1 - tileX, y1 - tileY, framebuffer.getFormat());
+            bool reused = cache.loadTile(tileKey, tilePixels);
+            if (reused) {
+                stats.tilesReused++;
+            } else {
+                // Sombrear reutilizando las intersecciones de la pasada primaria
+                for (size_t i = 0; i < tilePixelCount; ++i) {
+                    Vector3D color = hasHit[i] ? scene.shade(rays[i], hits[i], maxDepth) : Vector3D(0, 0, 0);
+                    tilePixels.setPixel(static_cast<int>(i % (x1 - tileX)), static_cast<int>(i / (x1 - tileX)), color * (1.0 / 255.0));
+                }
+                cache.storeTile(tileKey, tilePixels);
+            }
+            framebuffer.copyFrom(tilePixels, tileX, tileY);
+            if (preview) {
+                preview->publishTile(framebuffer, tileX, tileY, x1, y1, 0);
+            }
+        }
+    }
+    if (preview) {
+        preview->endPass(1);
+    }
+
+    cache.storeFrame(frameKey, framebuffer);
+    return stats;
+}
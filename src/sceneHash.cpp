@@ -0,0 +1,304 @@
+#include "sceneHash.h"
+#include <cstring> // Para std::memcpy
+
+// Primo de FNV-1a de 64 bits
+static const std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+// Etiquetas para que objetos de distinto tipo con los mismos números no colisionen
+enum HashTag : std::uint64_t { TAG_TRIANGLE = 1, TAG_PLANE, TAG_SPHERE, TAG_LIGHT, TAG_CAMERA, TAG_GRID_SPHERE, TAG_SPHERE_GRID, TAG_MESH_TRIANGLE, TAG_MESH, TAG_PAGED_TRIANGLE, TAG_PAGED_GEOMETRY };
+
+void Hasher::addBytes(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        state ^= bytes[i];
+        state *= FNV_PRIME;
+    }
+}
+
+void Hasher::add(std::uint64_t value) {
+    addBytes(&value, sizeof(value));
+}
+
+void Hasher::add(double value) {
+    if (value == 0.0) {
+        value = 0.0; // Normalizar -0.0
+    }
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    add(bits);
+}
+
+void Hasher::add(const Vector3D& value) {
+    add(value.getX());
+    add(value.getY());
+    add(value.getZ());
+}
+
+std::uint64_t Hasher::value() const {
+    return state;
+}
+
+// Identidad de una textura por su contenido (0 si el objeto no tiene textura)
+static std::uint64_t textureHash(const std::shared_ptr<const Texture>& texture) {
+    return texture ? texture->getContentHash() : 0;
+}
+
+/**
+ * @brief Hash del contenido de un triángulo.
+ * @param triangle Triángulo.
+ * @return Hash de sus vértices y material (incluida la textura).
+ */
+std::uint64_t hashTriangle(const Triangle& triangle) {
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_TRIANGLE));
+    hasher.add(triangle.getVertexA());
+    hasher.add(triangle.getVertexB());
+    hasher.add(triangle.getVertexC());
+    hasher.add(triangle.getColor());
+    hasher.add(triangle.getSpecular());
+    hasher.add(triangle.getReflectivity());
+    hasher.add(triangle.getTransparency());
+    hasher.add(triangle.getRefractiveIndex());
+    hasher.add(textureHash(triangle.getTexture()));
+    if (triangle.getTexture()) {
+        for (int vertex = 0; vertex < 3; ++vertex) {
+            hasher.add(triangle.getTexCoord(vertex).u);
+            hasher.add(triangle.getTexCoord(vertex).v);
+        }
+    }
+    return hasher.value();
+}
+
+/**
+ * @brief Hash del contenido de un plano.
+ * @param plane Plano.
+ * @return Hash de su geometría y material.
+ */
+std::uint64_t hashPlane(const Plane& plane) {
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_PLANE));
+    hasher.add(plane.getPoint());
+    hasher.add(plane.getNormal());
+    hasher.add(plane.getColor());
+    hasher.add(plane.getSpecular());
+    hasher.add(plane.getReflectivity());
+    hasher.add(plane.getTransparency());
+    hasher.add(plane.getRefractiveIndex());
+    hasher.add(textureHash(plane.getTexture()));
+    if (plane.getTexture()) {
+        hasher.add(plane.getTextureScale());
+    }
+    return hasher.value();
+}
+
+/**
+ * @brief Hash del contenido de una esfera.
+ * @param sphere Esfera.
+ * @return Hash de su geometría y material.
+ */
+std::uint64_t hashSphere(const Sphere& sphere) {
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_SPHERE));
+    hasher.add(sphere.getCenter());
+    hasher.add(sphere.getRadius());
+    hasher.add(sphere.getColor());
+    hasher.add(sphere.getSpecular());
+    hasher.add(sphere.getReflectivity());
+    hasher.add(sphere.getTransparency());
+    hasher.add(sphere.getRefractiveIndex());
+    hasher.add(textureHash(sphere.getTexture()));
+    return hasher.value();
+}
+
+/**
+ * @brief Hash de una esfera de una malla de esferas.
+ * @param grid Malla.
+ * @param index Índice de la esfera.
+ * @return Hash de su geometría y material.
+ */
+std::uint64_t hashGridSphere(const SphereGrid& grid, std::uint32_t index) {
+    const PackedSphere& sphere = grid.getSpheres()[index];
+    const SphereMaterial& material = grid.getMaterial(index);
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_GRID_SPHERE));
+    hasher.addBytes(&sphere, sizeof(sphere));
+    hasher.add(material.color);
+    hasher.add(material.specular);
+    hasher.add(material.reflectivity);
+    hasher.add(material.transparency);
+    hasher.add(material.refractiveIndex);
+    return hasher.value();
+}
+
+/**
+ * @brief Hash de todas las esferas y materiales de una malla de esferas.
+ * @param grid Malla.
+ * @return Hash de su contenido.
+ */
+std::uint64_t hashSphereGrid(const SphereGrid& grid) {
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_SPHERE_GRID));
+    hasher.add(static_cast<std::uint64_t>(grid.size()));
+    hasher.addBytes(grid.getSpheres().data(), grid.getSpheres().size() * sizeof(PackedSphere));
+    hasher.addBytes(grid.getMaterialIndices().data(), grid.getMaterialIndices().size() * sizeof(std::uint16_t));
+    for (const auto& material : grid.getMaterials()) {
+        hasher.add(material.color);
+        hasher.add(material.specular);
+        hasher.add(material.reflectivity);
+        hasher.add(material.transparency);
+        hasher.add(material.refractiveIndex);
+    }
+    return hasher.value();
+}
+
+/**
+ * @brief Hash de un triángulo de una malla comprimida.
+ * @param mesh Malla.
+ * @param index Índice del triángulo.
+ * @return Hash de sus vértices descomprimidos y del material.
+ */
+std::uint64_t hashMeshTriangle(const CompressedMesh& mesh, std::uint32_t index) {
+    Vector3D a, b, c;
+    mesh.getTriangle(index, a, b, c);
+    const MeshMaterial& material = mesh.getMaterial();
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_MESH_TRIANGLE));
+    hasher.add(a);
+    hasher.add(b);
+    hasher.add(c);
+    hasher.add(material.color);
+    hasher.add(material.specular);
+    hasher.add(material.reflectivity);
+    hasher.add(material.transparency);
+    hasher.add(material.refractiveIndex);
+    return hasher.value();
+}
+
+/**
+ * @brief Hash de una malla comprimida completa.
+ * @param mesh Malla.
+ * @return Hash de su caja, sus datos cuantizados y su material.
+ */
+std::uint64_t hashMesh(const CompressedMesh& mesh) {
+    Vector3D minimum, maximum;
+    mesh.getBounds(minimum, maximum);
+    const MeshMaterial& material = mesh.getMaterial();
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_MESH));
+    hasher.add(minimum);
+    hasher.add(maximum);
+    hasher.addBytes(mesh.getVertices().data(), mesh.getVertices().size() * sizeof(QuantizedVertex));
+    hasher.addBytes(mesh.getIndices().data(), mesh.getIndices().size() * sizeof(std::uint32_t));
+    hasher.add(material.color);
+    hasher.add(material.specular);
+    hasher.add(material.reflectivity);
+    hasher.add(material.transparency);
+    hasher.add(material.refractiveIndex);
+    return hasher.value();
+}
+
+/**
+ * @brief Hash de un triángulo de la geometría paginada.
+ *
+ * El triángulo queda determinado por el contenido de su chunk y su índice, así que no hace falta
+ * leer el chunk del archivo.
+ *
+ * @param geometry Geometría paginada.
+ * @param chunk Índice del chunk.
+ * @param index Índice del triángulo dentro del chunk.
+ * @return Hash del chunk y del índice.
+ */
+std::uint64_t hashPagedTriangle(const PagedGeometry& geometry, std::uint32_t chunk, std::uint32_t index) {
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_PAGED_TRIANGLE));
+    hasher.add(geometry.getChunks()[chunk].hash);
+    hasher.add(static_cast<std::uint64_t>(index));
+    return hasher.value();
+}
+
+/**
+ * @brief Hash de toda la geometría paginada.
+ * @param geometry Geometría paginada.
+ * @return Hash de la tabla de chunks (cada entrada incluye el hash de su contenido).
+ */
+std::uint64_t hashPagedGeometry(const PagedGeometry& geometry) {
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_PAGED_GEOMETRY));
+    hasher.add(static_cast<std::uint64_t>(geometry.getChunks().size()));
+    for (const auto& chunk : geometry.getChunks()) {
+        hasher.add(chunk.hash);
+        hasher.add(chunk.material.color);
+        hasher.add(chunk.material.specular);
+        hasher.add(chunk.material.reflectivity);
+        hasher.add(chunk.material.transparency);
+        hasher.add(chunk.material.refractiveIndex);
+    }
+    return hasher.value();
+}
+
+/**
+ * @brief Hash de todas las luces de la escena.
+ * @param scene Escena.
+ * @return Hash del tipo, intensidad, posición y dirección de cada luz.
+ */
+std::uint64_t hashLights(const Scene& scene) {
+    Hasher hasher;
+    for (const auto& light : scene.getLights()) {
+        hasher.add(static_cast<std::uint64_t>(TAG_LIGHT));
+        hasher.add(static_cast<std::uint64_t>(light.getType()));
+        hasher.add(light.getIntensity());
+        hasher.add(light.getPosition());
+        hasher.add(light.getDirection());
+        hasher.add(light.getEdgeU());
+        hasher.add(light.getEdgeV());
+        hasher.add(light.getRadius());
+    }
+    return hasher.value();
+}
+
+/**
+ * @brief Hash de toda la escena.
+ * @param scene Escena.
+ * @return Hash de todas las primitivas y luces.
+ */
+std::uint64_t hashScene(const Scene& scene) {
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(scene.getTriangles().size()));
+    for (const auto& triangle : scene.getTriangles()) {
+        hasher.add(hashTriangle(triangle));
+    }
+    hasher.add(static_cast<std::uint64_t>(scene.getPlanes().size()));
+    for (const auto& plane : scene.getPlanes()) {
+        hasher.add(hashPlane(plane));
+    }
+    hasher.add(static_cast<std::uint64_t>(scene.getSpheres().size()));
+    for (const auto& sphere : scene.getSpheres()) {
+        hasher.add(hashSphere(sphere));
+    }
+    if (!scene.getSphereGrid().empty()) {
+        hasher.add(hashSphereGrid(scene.getSphereGrid()));
+    }
+    for (const auto& mesh : scene.getMeshes()) {
+        hasher.add(hashMesh(mesh));
+    }
+    if (scene.getPagedGeometry()) {
+        hasher.add(hashPagedGeometry(*scene.getPagedGeometry()));
+    }
+    hasher.add(hashLights(scene));
+    return hasher.value();
+}
+
+/**
+ * @brief Hash de los parámetros de la cámara.
+ * @param camera Cámara.
+ * @return Hash de su posición y su orientación.
+ */
+std::uint64_t hashCamera(const Camera& camera) {
+    Hasher hasher;
+    hasher.add(static_cast<std::uint64_t>(TAG_CAMERA));
+    hasher.add(camera.getPosition());
+    hasher.add(camera.getRight());
+    hasher.add(camera.getUp());
+    hasher.add(camera.getForward());
+    return hasher.value();
+}
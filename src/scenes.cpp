@@ -0,0 +1,511 @@
+#include "scenes.h"
+#include "Random.h"
+#include <algorithm> // Para std::min y std::max
+#include <cmath>     // Para std::sin, std::cos y std::sqrt
+#include <utility>   // Para std::move
+
+/**
+ * @brief Construye la escena por defecto del proyecto.
+ *
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildDefaultScene(Scene& scene, Camera& camera) {
+    // Agregar triángulos a la escena con propiedades específicas y mejor separados
+    scene.addTriangle(Triangle(Vector3D(-2, 0, 3), Vector3D(-1, 2, 3), Vector3D(-3, 2, 3), Vector3D(80, 80, 255), 1000, 0.02)); // Triángulo azul brillante (baja reflectividad, mate)
+    scene.addTriangle(Triangle(Vector3D(0, 0, 2), Vector3D(1, 2, 2), Vector3D(-1, 2, 2), Vector3D(255, 50, 50), 2000, 1.0));  // Triángulo rojo brillante (alta reflectividad, como espejo)
+    scene.addTriangle(Triangle(Vector3D(2, 0, 4), Vector3D(3, 2, 4), Vector3D(1, 2, 4), Vector3D(50, 255, 50), 1000, 0.02));  // Triángulo verde brillante (baja reflectividad, mate)
+    scene.addTriangle(Triangle(Vector3D(-2, 3, 3), Vector3D(-1, 5, 3), Vector3D(-3, 5, 3), Vector3D(0, 255, 255), 800, 0.5));   // Triángulo cian (posicionado más cerca para mejor visibilidad)
+    scene.addTriangle(Triangle(Vector3D(5, 3, 10), Vector3D(7, 8, 10), Vector3D(3, 8, 10), Vector3D(150, 150, 255), 1000, 0.4)); // Triángulo azul claro grande
+    scene.addTriangle(Triangle(Vector3D(8, 0, 12), Vector3D(9, 5, 12), Vector3D(7, 5, 12), Vector3D(255, 200, 0), 1200, 0.6)); // Triángulo amarillo alto
+    scene.addTriangle(Triangle(Vector3D(-8, -3, 10), Vector3D(-7, 2, 10), Vector3D(-9, 2, 10), Vector3D(200, 100, 100), 900, 0.3)); // Triángulo rojo oscuro (más abajo)
+    scene.addTriangle(Triangle(Vector3D(3, 1, 6), Vector3D(4, 3, 6), Vector3D(2, 3, 6), Vector3D(100, 255, 100), 1000, 0.2)); // Triángulo verde claro
+    scene.addTriangle(Triangle(Vector3D(-6, 4, 8), Vector3D(-5, 7, 8), Vector3D(-7, 7, 8), Vector3D(255, 0, 255), 1100, 0.7)); // Triángulo magenta reflectivo (más arriba)
+    scene.addTriangle(Triangle(Vector3D(0, 6, 15), Vector3D(1, 8, 15), Vector3D(-1, 8, 15), Vector3D(150, 150, 150), 1200, 0.5)); // Triángulo gris claro (alto, en el centro)
+    scene.addTriangle(Triangle(Vector3D(-10, 8, 20), Vector3D(-9, 12, 20), Vector3D(-11, 12, 20), Vector3D(200, 200, 50), 1300, 0.8)); // Triángulo dorado (muy alto)
+    scene.addTriangle(Triangle(Vector3D(10, -5, 25), Vector3D(12, -2, 25), Vector3D(8, -2, 25), Vector3D(100, 100, 100), 1100, 0.3)); // Triángulo gris oscuro (más abajo y lejos)
+
+    // Agregar esferas a la escena y mejor separadas
+    scene.addSphere(Sphere(Vector3D(0, 3, 3), 1, Vector3D(255, 0, 0), 500, 0.5));  // Esfera roja sobre los triángulos (reflectividad media)
+    scene.addSphere(Sphere(Vector3D(0, -1, 3), 1, Vector3D(0, 255, 0), 500, 0.5)); // Esfera verde debajo de los triángulos (reflectividad media)
+    scene.addSphere(Sphere(Vector3D(7, 0, 15), 1.5, Vector3D(238, 130, 238), 400, 0.6)); // Esfera violeta grande (reflectividad alta, posicionada más cerca para mejor visibilidad)
+    scene.addSphere(Sphere(Vector3D(-5, 2, 7), 1.2, Vector3D(0, 255, 255), 600, 0.4)); // Esfera cian mediana
+    scene.addSphere(Sphere(Vector3D(4, -4, 10), 2.0, Vector3D(255, 255, 0), 700, 0.3)); // Esfera amarilla grande (más abajo)
+    scene.addSphere(Sphere(Vector3D(-7, 5, 12), 1.8, Vector3D(100, 100, 255), 500, 0.5)); // Esfera azul claro (más arriba)
+    scene.addSphere(Sphere(Vector3D(6, 3, 8), 0.9, Vector3D(255, 100, 100), 800, 0.6)); // Esfera roja pequeña (media altura)
+    scene.addSphere(Sphere(Vector3D(-4, 0, 5), 1.3, Vector3D(0, 200, 100), 450, 0.4)); // Esfera verde oscuro
+    scene.addSphere(Sphere(Vector3D(8, -2, 11), 1.1, Vector3D(200, 200, 50), 600, 0.5)); // Esfera dorada mediana (más abajo)
+    scene.addSphere(Sphere(Vector3D(-9, 6, 14), 1.4, Vector3D(150, 50, 150), 500, 0.7)); // Esfera púrpura reflectiva (alta)
+    scene.addSphere(Sphere(Vector3D(3, -3, 13), 1.6, Vector3D(50, 150, 200), 550, 0.6)); // Esfera azul celeste grande (más abajo)
+    scene.addSphere(Sphere(Vector3D(-10, 1, 16), 1.0, Vector3D(100, 255, 100), 650, 0.4)); // Esfera verde claro (media altura)
+    scene.addSphere(Sphere(Vector3D(10, 4, 18), 2.2, Vector3D(255, 215, 0), 700, 0.3)); // Esfera dorada grande (alta)
+    scene.addSphere(Sphere(Vector3D(-15, -6, 20), 2.5, Vector3D(100, 255, 255), 750, 0.6)); // Esfera cian gigante (muy lejos y abajo)
+    scene.addSphere(Sphere(Vector3D(15, 10, 25), 1.8, Vector3D(255, 0, 100), 800, 0.7)); // Esfera rosa alta y lejos
+    scene.addSphere(Sphere(Vector3D(-12, 3, 18), 1.3, Vector3D(0, 100, 255), 550, 0.5)); // Esfera azul medio (media altura y lejos)
+    scene.addSphere(Sphere(Vector3D(12, -8, 22), 1.7, Vector3D(255, 150, 0), 600, 0.4)); // Esfera naranja (muy abajo y lejos)
+
+    // Agregar planos para crear un efecto de "caja" con reflectividad reducida para un mejor contraste de los triángulos
+    scene.addPlane(Plane(Vector3D(0, -10, 0), Vector3D(0, 1, 0), Vector3D(50, 50, 50), 10, 0.1));   // Plano del piso (gris oscuro, reflectividad baja)
+    scene.addPlane(Plane(Vector3D(0, 10, 0), Vector3D(0, -1, 0), Vector3D(150, 150, 150), 50, 0.0));   // Plano del techo (gris claro, sin reflectividad)
+    scene.addPlane(Plane(Vector3D(-20, 0, 0), Vector3D(1, 0, 0), Vector3D(120, 120, 120), 10, 0.2));   // Plano de la pared izquierda (gris medio, reflectividad media)
+    scene.addPlane(Plane(Vector3D(20, 0, 0), Vector3D(-1, 0, 0), Vector3D(130, 130, 130), 10, 0.2));   // Plano de la pared derecha (gris medio claro, reflectividad media)
+    scene.addPlane(Plane(Vector3D(0, 0, -10), Vector3D(0, 0, 1), Vector3D(80, 80, 80), 10, 0.0));   // Plano de la pared trasera (gris oscuro, sin reflectividad)
+
+    // Agregar luces a la escena
+    scene.addLight(LightSource(LightSource::AMBIENT, 0.015));  // Luz ambiental ligeramente aumentada para una mejor iluminación de áreas oscuras
+    scene.addLight(LightSource(LightSource::POINT, 60.0, Vector3D(0, 10, 4)));  // Luz puntual fuerte posicionada más arriba y hacia el frente para iluminar los objetos superiores
+    scene.addLight(LightSource(LightSource::DIRECTIONAL, 12.0, Vector3D(), Vector3D(-1, -1, -1))); // Luz direccional fuerte para sombras bien definidas
+    scene.addLight(LightSource(LightSource::POINT, 50.0, Vector3D(-5, -8, -4)));  // Luz puntual adicional desde otro ángulo para una mejor iluminación
+
+    // Cámara con una posición ajustada para visualizar bien la escena
+    camera = Camera(0, 1.8, -8);  // Posicionada más lejos para tener una buena perspectiva de todos los objetos
+}
+
+/**
+ * @brief Construye la escena de regresión de sombras de luces puntuales.
+ *
+ * Antes de acotar los rayos de sombra con la distancia real a la luz, solo los oclusores a menos
+ * de una unidad del punto sombreado proyectaban sombra, y los objetos detrás de la luz la habrían
+ * bloqueado si se usara una distancia infinita. Esta escena contiene ambos casos.
+ *
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildShadowTestScene(Scene& scene, Camera& camera) {
+    // Piso blanco mate sin reflectividad para que las sombras se vean limpias
+    scene.addPlane(Plane(Vector3D(0, 0, 0), Vector3D(0, 1, 0), Vector3D(220, 220, 220), -1, 0.0));
+
+    // Esfera entre el piso y la luz, a 2.5 unidades del piso: debe proyectar sombra
+    scene.addSphere(Sphere(Vector3D(-1.5, 2.5, 6), 0.6, Vector3D(255, 60, 60), 300, 0.0));
+
+    // Esfera más lejos que la luz (por encima de ella): no debe proyectar sombra sobre el piso
+    scene.addSphere(Sphere(Vector3D(1.5, 7.5, 6), 0.8, Vector3D(60, 60, 255), 300, 0.0));
+
+    // Triángulo a 0.5 unidades del piso: debe proyectar sombra (también lo hacía antes de la corrección)
+    scene.addTriangle(Triangle(Vector3D(2.5, 0.5, 4), Vector3D(3.5, 0.5, 5), Vector3D(2.0, 0.5, 5.5), Vector3D(60, 255, 60), -1, 0.0));
+
+    // Luz ambiental tenue y una luz puntual sobre los oclusores
+    scene.addLight(LightSource(LightSource::AMBIENT, 0.05));
+    scene.addLight(LightSource(LightSource::POINT, 0.9, Vector3D(0, 5, 6)));
+
+    camera = Camera(0, 3, -4);
+}
+
+/**
+ * @brief Construye la escena de texturas.
+ *
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildTexturedScene(Scene& scene, Camera& camera) {
+    std::shared_ptr<const Texture> checker = TextureCache::shared().acquire("./textures/checker.ppm");
+
+    // Piso y pared del fondo con la textura repetida
+    Plane floor(Vector3D(0, -1, 0), Vector3D(0, 1, 0), Vector3D(200, 200, 200), 50, 0.1);
+    floor.setTexture(checker, 2.0);
+    scene.addPlane(floor);
+    Plane wall(Vector3D(0, 0, 30), Vector3D(0, 0, -1), Vector3D(150, 150, 150), -1, 0.0);
+    wall.setTexture(checker, 4.0);
+    scene.addPlane(wall);
+
+    // Cuadrícula de esferas texturizadas que se alejan de la cámara
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 6; ++column) {
+            Sphere sphere(Vector3D(-5 + 2 * column, 0, 3 + 4 * row), 0.8, Vector3D(255, 255, 255), 300, row == 0 ? 0.2 : 0.0);
+            sphere.setTexture(checker);
+            scene.addSphere(sphere);
+        }
+    }
+
+    // Un cuadrado formado por dos triángulos (con la normal hacia la cámara) con la textura completa
+    Triangle lower(Vector3D(-2, 1.5, 8), Vector3D(2, 5.5, 8), Vector3D(2, 1.5, 8), Vector3D(255, 255, 255), 500, 0.0);
+    lower.setTexture(checker, TexCoord{ 0, 1 }, TexCoord{ 1, 0 }, TexCoord{ 1, 1 });
+    scene.addTriangle(lower);
+    Triangle upper(Vector3D(-2, 1.5, 8), Vector3D(-2, 5.5, 8), Vector3D(2, 5.5, 8), Vector3D(255, 255, 255), 500, 0.0);
+    upper.setTexture(checker, TexCoord{ 0, 1 }, TexCoord{ 0, 0 }, TexCoord{ 1, 0 });
+    scene.addTriangle(upper);
+
+    scene.addLight(LightSource(LightSource::AMBIENT, 0.2));
+    scene.addLight(LightSource(LightSource::POINT, 0.6, Vector3D(-4, 8, -2)));
+    scene.addLight(LightSource(LightSource::DIRECTIONAL, 0.3, Vector3D(), Vector3D(1, 2, -1)));
+
+    camera = Camera(0, 1.5, -6);
+}
+
+/**
+ * @brief Construye la escena de sombras suaves con luces de área.
+ *
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildSoftShadowScene(Scene& scene, Camera& camera) {
+    // Piso y pared del fondo mates para que las penumbras se vean limpias
+    scene.addPlane(Plane(Vector3D(0, 0, 0), Vector3D(0, 1, 0), Vector3D(220, 220, 220), -1, 0.0));
+    scene.addPlane(Plane(Vector3D(0, 0, 14), Vector3D(0, 0, -1), Vector3D(180, 180, 200), -1, 0.0));
+
+    // Oclusores a distintas alturas: cuanto más lejos del piso, más ancha la penumbra
+    scene.addSphere(Sphere(Vector3D(-2.5, 0.8, 6), 0.8, Vector3D(255, 80, 80), 300, 0.0));
+    scene.addSphere(Sphere(Vector3D(0, 2.2, 7), 0.6, Vector3D(80, 255, 80), 300, 0.0));
+    scene.addSphere(Sphere(Vector3D(2.5, 1.0, 5), 0.5, Vector3D(80, 80, 255), 300, 0.0));
+    scene.addTriangle(Triangle(Vector3D(-1, 1.5, 9), Vector3D(0.5, 3.5, 9), Vector3D(1, 1.5, 9), Vector3D(255, 200, 60), -1, 0.0));
+
+    // Luz rectangular sobre la escena y una luz esférica a la derecha
+    scene.addLight(LightSource(LightSource::AMBIENT, 0.08));
+    scene.addLight(LightSource(0.55, Vector3D(-1, 5, 6), Vector3D(2.5, 0, 0), Vector3D(0, 0, 2.5)));
+    scene.addLight(LightSource(0.35, Vector3D(4, 3.5, 4), 0.6));
+
+    camera = Camera(0, 3, -3);
+}
+
+/**
+ * @brief Construye la escena de materiales transparentes.
+ *
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildGlassScene(Scene& scene, Camera& camera) {
+    std::shared_ptr<const Texture> checker = TextureCache::shared().acquire("./textures/checker.ppm");
+
+    // Piso y pared con textura para que se note la distorsión de la refracción
+    Plane floor(Vector3D(0, -1, 0), Vector3D(0, 1, 0), Vector3D(200, 200, 200), -1, 0.0);
+    floor.setTexture(checker, 4.0);
+    scene.addPlane(floor);
+    Plane wall(Vector3D(0, 0, 20), Vector3D(0, 0, -1), Vector3D(150, 150, 150), -1, 0.0);
+    wall.setTexture(checker, 6.0);
+    scene.addPlane(wall);
+
+    // Varias filas de esferas de vidrio: cada rayo atraviesa varias, con reflexión y refracción en cada superficie
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 5; ++column) {
+            scene.addSphere(Sphere(Vector3D(-4 + 2 * column + (row % 2), 0, 4 + 2.5 * row), 0.9,
+                                   Vector3D(230, 240, 255), 800, 0.0, 0.95, 1.5));
+        }
+    }
+
+    // Objetos opacos de color detrás del vidrio
+    scene.addSphere(Sphere(Vector3D(-2, 0.5, 13), 1.5, Vector3D(255, 60, 60), 300, 0.0));
+    scene.addSphere(Sphere(Vector3D(2.5, 0.5, 12), 1.5, Vector3D(60, 120, 255), 300, 0.0));
+
+    // Lámina de vidrio fino (dos triángulos) delante de la cámara, con poca refracción
+    scene.addTriangle(Triangle(Vector3D(-1.5, 1.2, 2), Vector3D(1.5, 3.2, 2), Vector3D(1.5, 1.2, 2), Vector3D(200, 255, 200), 500, 0.0, 0.8, 1.05));
+    scene.addTriangle(Triangle(Vector3D(-1.5, 1.2, 2), Vector3D(-1.5, 3.2, 2), Vector3D(1.5, 3.2, 2), Vector3D(200, 255, 200), 500, 0.0, 0.8, 1.05));
+
+    scene.addLight(LightSource(LightSource::AMBIENT, 0.25));
+    scene.addLight(LightSource(LightSource::POINT, 0.5, Vector3D(-3, 8, -2)));
+    scene.addLight(LightSource(LightSource::DIRECTIONAL, 0.25, Vector3D(), Vector3D(1, 2, -1)));
+
+    camera = Camera(0, 1.5, -5);
+}
+
+/**
+ * @brief Construye la escena simple de esferas difusas.
+ *
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildSpheresScene(Scene& scene, Camera& camera) {
+    // Una esfera enorme hace de suelo, así la escena no tiene triángulos ni planos
+    scene.addSphere(Sphere(Vector3D(0, -1000, 0), 999, Vector3D(180, 180, 180), -1, 0.0));
+
+    // Cuadrícula de esferas mates de colores
+    for (int row = 0; row < 6; ++row) {
+        for (int column = 0; column < 9; ++column) {
+            Vector3D color(60 + 24 * column, 90 + 25 * row, 255 - 20 * column);
+            scene.addSphere(Sphere(Vector3D(-8 + 2 * column, 0, 4 + 2.5 * row), 0.8, color, -1, 0.0));
+        }
+    }
+
+    scene.addLight(LightSource(LightSource::AMBIENT, 0.15));
+    scene.addLight(LightSource(LightSource::DIRECTIONAL, 0.6, Vector3D(), Vector3D(-1, 2, -1)));
+    scene.addLight(LightSource(LightSource::DIRECTIONAL, 0.25, Vector3D(), Vector3D(2, 1, -1)));
+
+    camera = Camera(0, 2.5, -6);
+}
+
+/**
+ * @brief Llena una malla con esferas pequeñas en posiciones aleatorias dentro de una bola.
+ *
+ * @param grid Malla a la que se agregan las esferas y los materiales.
+ * @param count Número de esferas.
+ * @param center Centro de la bola.
+ * @param radius Radio de la bola.
+ * @param seed Semilla de las posiciones.
+ */
+void addRandomParticles(SphereGrid& grid, size_t count, const Vector3D& center, double radius, std::uint64_t seed) {
+    // Degradado de naranja (abajo) a azul (arriba); uno de cada cuatro materiales tiene brillo
+    std::uint16_t materials[PARTICLE_MATERIALS];
+    for (int i = 0; i < PARTICLE_MATERIALS; ++i) {
+        double f = static_cast<double>(i) / (PARTICLE_MATERIALS - 1);
+        SphereMaterial material;
+        material.color = Vector3D(255 - 185 * f, 140 + 40 * f, 40 + 215 * f);
+        material.specular = i % 4 == 0 ? 50 : -1;
+        materials[i] = grid.addMaterial(material);
+    }
+
+    grid.reserve(grid.size() + count);
+    RandomSequence random(seed, 0);
+    for (size_t i = 0; i < count; ++i) {
+        // Punto uniforme en la bola por rechazo
+        double x, y, z;
+        do {
+            x = random.next() * 2 - 1;
+            y = random.next() * 2 - 1;
+            z = random.next() * 2 - 1;
+        } while (x * x + y * y + z * z > 1);
+        double sphereRadius = radius * (0.002 + 0.004 * random.next());
+        int material = std::min(static_cast<int>((y + 1) / 2 * PARTICLE_MATERIALS), PARTICLE_MATERIALS - 1);
+        grid.addSphere(center + Vector3D(x, y, z) * radius, sphereRadius, materials[material]);
+    }
+}
+
+/**
+ * @brief Construye una nube de partículas sobre un suelo plano.
+ *
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildParticlesScene(Scene& scene, Camera& camera) {
+    SphereGrid particles;
+    addRandomParticles(particles, PARTICLE_SCENE_COUNT, Vector3D(0, 1.5, 10), 5.0);
+    particles.build();
+    scene.setSphereGrid(std::move(particles));
+
+    scene.addPlane(Plane(Vector3D(0, -4, 0), Vector3D(0, 1, 0), Vector3D(200, 200, 200), -1, 0.0));
+
+    scene.addLight(LightSource(LightSource::AMBIENT, 0.2));
+    scene.addLight(LightSource(LightSource::DIRECTIONAL, 0.7, Vector3D(), Vector3D(-1, 2, -1)));
+
+    camera = Camera(0, 1.5, 0);
+}
+
+/**
+ * @brief Llena una malla con una esfera con relieve.
+ *
+ * @param mesh Malla a la que se agregan los vértices y los triángulos.
+ * @param triangles Número aproximado de triángulos.
+ * @param center Centro de la esfera.
+ * @param radius Radio medio de la esfera.
+ */
+void addBumpySphere(TriangleMesh& mesh, size_t triangles, const Vector3D& center, double radius) {
+    // Con el doble de segmentos que anillos hay 4 * anillos * (anillos - 1) triángulos
+    int rings = std::max(3, static_cast<int>(std::sqrt(triangles / 4.0)) + 1);
+    int segments = 2 * rings;
+    const double pi = 3.14159265358979323846;
+
+    auto addVertex = [&](double theta, double phi) {
+        double bump = 1.0 + 0.05 * std::sin(7 * theta) * std::sin(9 * phi) + 0.01 * std::sin(31 * theta + 17 * phi);
+        double r = radius * bump;
+        mesh.vertices.push_back(center + Vector3D(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)) * r);
+    };
+    auto addTriangle = [&](size_t a, size_t b, size_t c) {
+        mesh.indices.push_back(static_cast<std::uint32_t>(a));
+        mesh.indices.push_back(static_cast<std::uint32_t>(b));
+        mesh.indices.push_back(static_cast<std::uint32_t>(c));
+    };
+
+    size_t base = mesh.vertices.size();
+    size_t north = base;
+    addVertex(0.0, 0.0);
+    for (int ring = 1; ring < rings; ++ring) {
+        for (int segment = 0; segment < segments; ++segment) {
+            addVertex(pi * ring / rings, 2 * pi * segment / segments);
+        }
+    }
+    size_t south = mesh.vertices.size();
+    addVertex(pi, 0.0);
+
+    // Vértice del anillo ring (1 a rings - 1) y el segmento dado (cíclico)
+    auto ringVertex = [&](int ring, int segment) {
+        return base + 1 + static_cast<size_t>(ring - 1) * segments + segment % segments;
+    };
+    for (int segment = 0; segment < segments; ++segment) {
+        addTriangle(north, ringVertex(1, segment + 1), ringVertex(1, segment));
+        addTriangle(south, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1));
+    }
+    for (int ring = 1; ring < rings - 1; ++ring) {
+        for (int segment = 0; segment < segments; ++segment) {
+            addTriangle(ringVertex(ring, segment), ringVertex(ring, segment + 1), ringVertex(ring + 1, segment));
+            addTriangle(ringVertex(ring, segment + 1), ringVertex(ring + 1, segment + 1), ringVertex(ring + 1, segment));
+        }
+    }
+}
+
+/**
+ * @brief Construye una esfera con relieve sobre un suelo plano.
+ *
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildMeshScene(Scene& scene, Camera& camera) {
+    TriangleMesh surface;
+    addBumpySphere(surface, MESH_SCENE_TRIANGLES, Vector3D(0, 0, 8), 3.0);
+    MeshMaterial material;
+    material.color = Vector3D(230, 170, 60);
+    material.specular = 200;
+    material.reflectivity = 0.2;
+    CompressedMesh mesh;
+    mesh.build(surface, material);
+    scene.addMesh(std::move(mesh));
+
+    scene.addPlane(Plane(Vector3D(0, -3.5, 0), Vector3D(0, 1, 0), Vector3D(200, 200, 200), -1, 0.0));
+
+    scene.addLight(LightSource(LightSource::AMBIENT, 0.15));
+    scene.addLight(LightSource(LightSource::POINT, 40.0, Vector3D(-6, 8, 0)));
+    scene.addLight(LightSource(LightSource::DIRECTIONAL, 0.4, Vector3D(), Vector3D(1, 2, -1)));
+
+    camera = Camera(0, 1, -1);
+}
+
+// Agrega un cuadrilátero (dos triángulos) con la normal del lado de facing
+static void addQuad(TriangleMesh& mesh, const Vector3D& a, const Vector3D& b, const Vector3D& c, const Vector3D& d, const Vector3D& facing) {
+    std::uint32_t base = static_cast<std::uint32_t>(mesh.vertices.size());
+    mesh.vertices.push_back(a);
+    mesh.vertices.push_back(b);
+    mesh.vertices.push_back(c);
+    mesh.vertices.push_back(d);
+    static const int forward[6] = { 0, 1, 2, 0, 2, 3 };
+    static const int backward[6] = { 0, 2, 1, 0, 3, 2 };
+    const int* order = (b - a).cross(c - a).dot(facing) < 0 ? backward : forward;
+    for (int i = 0; i < 6; ++i) {
+        mesh.indices.push_back(base + order[i]);
+    }
+}
+
+// Agrega una celda de fachada: marco en el plano de la fachada, ventana hundida y sus cuatro jambas.
+// origin es la esquina inferior izquierda vista desde fuera y across/up los lados de la celda
+static void addWindowCell(TriangleMesh& mesh, const Vector3D& origin, const Vector3D& across, const Vector3D& up, const Vector3D& normal) {
+    const double side = 0.2, bottom = 0.3, top = 0.15, depth = 0.3;
+    Vector3D outer[4] = { origin, origin + across, origin + across + up, origin + up };
+    Vector3D inner[4] = { origin + across * side + up * bottom, origin + across * (1 - side) + up * bottom,
+                          origin + across * (1 - side) + up * (1 - top), origin + across * side + up * (1 - top) };
+    Vector3D recessed[4];
+    for (int i = 0; i < 4; ++i) {
+        recessed[i] = inner[i] - normal * depth;
+    }
+    Vector3D acrossDirection = across.normalize();
+    Vector3D upDirection = up.normalize();
+
+    addQuad(mesh, outer[0], outer[1], inner[1], inner[0], normal);
+    addQuad(mesh, inner[3], inner[2], outer[2], outer[3], normal);
+    addQuad(mesh, outer[0], inner[0], inner[3], outer[3], normal);
+    addQuad(mesh, inner[1], outer[1], outer[2], inner[2], normal);
+    addQuad(mesh, inner[0], inner[1], recessed[1], recessed[0], upDirection);
+    addQuad(mesh, inner[3], inner[2], recessed[2], recessed[3], -upDirection);
+    addQuad(mesh, inner[0], inner[3], recessed[3], recessed[0], acrossDirection);
+    addQuad(mesh, inner[1], inner[2], recessed[2], recessed[1], -acrossDirection);
+    addQuad(mesh, recessed[0], recessed[1], recessed[2], recessed[3], normal);
+}
+
+// Agrega un edificio de planta cuadrada con una ventana por piso y columna en cada fachada
+static void addBuilding(TriangleMesh& mesh, const Vector3D& corner, double width, int floors) {
+    const Vector3D up(0, 1, 0);
+    const Vector3D normals[4] = { Vector3D(0, 0, -1), Vector3D(1, 0, 0), Vector3D(0, 0, 1), Vector3D(-1, 0, 0) };
+    Vector3D center = corner + Vector3D(width / 2, 0, width / 2);
+    int columns = std::max(1, static_cast<int>(width / CITY_WINDOW_WIDTH));
+    double cellWidth = width / columns;
+    for (const Vector3D& normal : normals) {
+        // Eje horizontal de la fachada, de izquierda a derecha visto desde fuera
+        Vector3D across = up.cross(normal);
+        Vector3D faceOrigin = center + normal * (width / 2) - across * (width / 2);
+        for (int floor = 0; floor < floors; ++floor) {
+            for (int column = 0; column < columns; ++column) {
+                addWindowCell(mesh, faceOrigin + across * (column * cellWidth) + up * (floor * CITY_FLOOR_HEIGHT), across * cellWidth,
+                              up * CITY_FLOOR_HEIGHT, normal);
+            }
+        }
+    }
+    double height = floors * CITY_FLOOR_HEIGHT;
+    addQuad(mesh, corner + up * height, corner + Vector3D(width, height, 0), corner + Vector3D(width, height, width),
+            corner + Vector3D(0, height, width), up);
+}
+
+/**
+ * @brief Genera el archivo de geometría de una ciudad, una manzana por chunk.
+ *
+ * La altura y el color de cada edificio dependen solo de su posición, así que el mismo número de
+ * manzanas produce siempre el mismo archivo.
+ *
+ * @param path Ruta del archivo de geometría.
+ * @param blocks Manzanas por lado.
+ * @param writer Escritor que se usa.
+ * @return true si el archivo se escribió completo.
+ */
+bool writeCityGeometry(const std::string& path, int blocks, GeometryFileWriter& writer) {
+    if (!writer.open(path)) {
+        return false;
+    }
+    const double pitch = CITY_BLOCK_SIZE + CITY_STREET_WIDTH;
+    const double margin = 1.0, gap = 2.0;
+    const double buildingWidth = (CITY_BLOCK_SIZE - 2 * margin - (CITY_BLOCK_BUILDINGS - 1) * gap) / CITY_BLOCK_BUILDINGS;
+    for (int blockZ = 0; blockZ < blocks; ++blockZ) {
+        for (int blockX = 0; blockX < blocks; ++blockX) {
+            Vector3D blockCorner((blockX - blocks / 2) * pitch + CITY_STREET_WIDTH / 2, 0, blockZ * pitch + CITY_STREET_WIDTH / 2);
+            std::uint64_t blockKey = hashMix(static_cast<std::uint64_t>(blockZ) * 1000003 + blockX);
+            TriangleMesh mesh;
+            for (int row = 0; row < CITY_BLOCK_BUILDINGS; ++row) {
+                for (int column = 0; column < CITY_BLOCK_BUILDINGS; ++column) {
+                    double height = hashToUnit(hashMix(blockKey + row * CITY_BLOCK_BUILDINGS + column));
+                    int floors = 4 + static_cast<int>(height * height * 17);
+                    Vector3D corner = blockCorner + Vector3D(margin + column * (buildingWidth + gap), 0, margin + row * (buildingWidth + gap));
+                    addBuilding(mesh, corner, buildingWidth, floors);
+                }
+            }
+            // Tonos de hormigón y ladrillo claro, uno por manzana
+            double tone = hashToUnit(blockKey);
+            MeshMaterial material;
+            material.color = Vector3D(170 + 60 * tone, 160 + 45 * tone, 150 + 20 * tone);
+            if (!writer.addChunk(mesh, material)) {
+                return false;
+            }
+        }
+    }
+    return writer.close();
+}
+
+/**
+ * @brief Construye el suelo, las luces y la cámara de la ciudad.
+ *
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ */
+void buildCityScene(Scene& scene, Camera& camera) {
+    scene.addPlane(Plane(Vector3D(0, 0, 0), Vector3D(0, 1, 0), Vector3D(110, 110, 115), -1, 0.0));
+
+    scene.addLight(LightSource(LightSource::AMBIENT, 0.25));
+    scene.addLight(LightSource(LightSource::DIRECTIONAL, 0.75, Vector3D(), Vector3D(-1, 2.5, -1.5)));
+
+    camera = Camera(0, 12, -30);
+}
+
+/**
+ * @brief Construye una escena a partir de su nombre.
+ *
+ * @param name Nombre de la escena.
+ * @param scene Escena a la que se agregan los objetos y luces.
+ * @param camera Cámara de la escena.
+ * @return true si la escena existe, false de lo contrario.
+ */
+bool buildScene(const std::string& name, Scene& scene, Camera& camera) {
+    if (name == "default") {
+        buildDefaultScene(scene, camera);
+    } else if (name == "shadows") {
+        buildShadowTestScene(scene, camera);
+    } else if (name == "textured") {
+        buildTexturedScene(scene, camera);
+    } else if (name == "softshadows") {
+        buildSoftShadowScene(scene, camera);
+    } else if (name == "glass") {
+        buildGlassScene(scene, camera);
+    } else if (name == "spheres") {
+        buildSpheresScene(scene, camera);
+    } else if (name == "particles") {
+        buildParticlesScene(scene, camera);
+    } else if (name == "mesh") {
+        buildMeshScene(scene, camera);
+    } else if (name == "city") {
+        buildCityScene(scene, camera);
+    } else {
+        return false;
+    }
+    return true;
+}
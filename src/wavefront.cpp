@@ -0,0 +1,242 @@
+#include "wavefront.h"
+#include "generateImage.h"
+#include "TilePool.h"
+#include <algorithm> // Para std::min y std::max
+#include <chrono>    // Para medir la ordenación y el trazado
+#include <numeric>   // Para std::iota
+
+namespace {
+
+// Bits de la clave de ordenación: octante de la dirección (3) y celda del origen (3 ejes)
+const int SORT_KEY_BITS = 3 + 3 * RAY_SORT_CELL_BITS;
+
+// Bits de la clave que ordena cada pasada del radix sort
+const int RADIX_BITS = 10;
+
+// Separa los bits bajos de v dejando dos ceros entre cada uno (para intercalar tres coordenadas)
+std::uint32_t spreadBits(std::uint32_t v) {
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v << 8)) & 0x0300f00f;
+    v = (v | (v << 4)) & 0x030c30c3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+}
+
+// Celda de una coordenada en RAY_SORT_CELL_BITS bits
+std::uint32_t cellIndex(double value, double minimum, double scale) {
+    const double lastCell = (1 << RAY_SORT_CELL_BITS) - 1;
+    return static_cast<std::uint32_t>(std::min(std::max((value - minimum) * scale, 0.0), lastCell));
+}
+
+// Rayos que generó un rayo del frente: están en la lista de la tarea que lo trazó
+struct SpawnedRange {
+    std::uint32_t task;
+    std::uint32_t first;
+    std::uint32_t count;
+};
+
+} // namespace
+
+/**
+ * Ordena rayos por el octante de su dirección y la celda de Morton de su origen.
+ *
+ * @param rays: Rayos a ordenar.
+ * @param order: Índices de rays en el orden de trazado.
+ */
+void sortRaysByCoherence(const std::vector<DeferredRay>& rays, std::vector<std::uint32_t>& order) {
+    size_t count = rays.size();
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0u);
+    if (count < 2) {
+        return;
+    }
+
+    // Caja de los orígenes, dividida en 2^RAY_SORT_CELL_BITS celdas por eje
+    Vector3D minimum = rays[0].ray.getOrigin();
+    Vector3D maximum = minimum;
+    for (const DeferredRay& ray : rays) {
+        Vector3D origin = ray.ray.getOrigin();
+        minimum = Vector3D(std::min(minimum.getX(), origin.getX()), std::min(minimum.getY(), origin.getY()), std::min(minimum.getZ(), origin.getZ()));
+        maximum = Vector3D(std::max(maximum.getX(), origin.getX()), std::max(maximum.getY(), origin.getY()), std::max(maximum.getZ(), origin.getZ()));
+    }
+    double cells = 1 << RAY_SORT_CELL_BITS;
+    double extent[3] = { maximum.getX() - minimum.getX(), maximum.getY() - minimum.getY(), maximum.getZ() - minimum.getZ() };
+    double scale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        scale[axis] = extent[axis] > 0.0 ? cells / extent[axis] : 0.0;
+    }
+
+    std::vector<std::uint32_t> keys(count);
+    for (size_t i = 0; i < count; ++i) {
+        Vector3D origin = rays[i].ray.getOrigin();
+        Vector3D direction = rays[i].ray.getDirection();
+        std::uint32_t octant = (direction.getX() < 0 ? 1u : 0u) | (direction.getY() < 0 ? 2u : 0u) | (direction.getZ() < 0 ? 4u : 0u);
+        std::uint32_t morton = spreadBits(cellIndex(origin.getX(), minimum.getX(), scale[0])) |
+                               (spreadBits(cellIndex(origin.getY(), minimum.getY(), scale[1])) << 1) |
+                               (spreadBits(cellIndex(origin.getZ(), minimum.getZ(), scale[2])) << 2);
+        keys[i] = (octant << (3 * RAY_SORT_CELL_BITS)) | morton;
+    }
+
+    // Radix sort LSD: cada pasada es estable, así que el resultado también lo es
+    std::vector<std::uint32_t> sorted(count);
+    std::vector<size_t> offsets(static_cast<size_t>(1) << RADIX_BITS);
+    const std::uint32_t mask = (1u << RADIX_BITS) - 1;
+    for (int shift = 0; shift < SORT_KEY_BITS; shift += RADIX_BITS) {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (std::uint32_t index : order) {
+            ++offsets[(keys[index] >> shift) & mask];
+        }
+        size_t position = 0;
+        for (size_t& offset : offsets) {
+            size_t bucket = offset;
+            offset = position;
+            position += bucket;
+        }
+        for (std::uint32_t index : order) {
+            sorted[offsets[(keys[index] >> shift) & mask]++] = index;
+        }
+        order.swap(sorted);
+    }
+}
+
+/**
+ * Pasa al frente siguiente los rayos que caben en el presupuesto de su píxel; los demás se sustituyen por su color local.
+ *
+ * @param rays: Rayos generados.
+ * @param count: Número de rayos.
+ * @param raysLeft: Rayos secundarios que le quedan a cada píxel del lote.
+ * @param colors: Color acumulado de cada píxel del lote.
+ * @param wave: Frente siguiente.
+ */
+void enqueueDeferredRays(const DeferredRay* rays, size_t count, std::vector<int>& raysLeft, std::vector<Vector3D>& colors, std::vector<DeferredRay>& wave) {
+    for (size_t i = 0; i < count; ++i) {
+        const DeferredRay& ray = rays[i];
+        if (raysLeft[ray.pixel] > 0) {
+            --raysLeft[ray.pixel];
+            wave.push_back(ray);
+        } else {
+            colors[ray.pixel] = colors[ray.pixel] + ray.fallback * ray.weight;
+        }
+    }
+}
+
+/**
+ * Genera un rango de filas de la imagen trazando los rayos secundarios por frentes de onda.
+ *
+ * @param scene: La escena que contiene los objetos y las luces a renderizar.
+ * @param cam: La cámara desde la cual se generarán los rayos.
+ * @param framebuffer: Framebuffer de (rowEnd - rowBegin) filas.
+ * @param width: Ancho de la imagen completa en píxeles.
+ * @param height: Alto de la imagen completa en píxeles.
+ * @param rowBegin: Primera fila a renderizar.
+ * @param rowEnd: Fila siguiente a la última a renderizar.
+ * @param maxDepth: Profundidad máxima de las reflexiones para los rayos.
+ * @param viewportWidth: Ancho del viewport en unidades del mundo.
+ * @param viewportHeight: Alto del viewport en unidades del mundo.
+ * @param distanceToViewport: Distancia desde la cámara hasta el viewport.
+ * @param sortRays: true para ordenar cada frente con sortRaysByCoherence.
+ * @param batchPixels: Píxeles aproximados de cada lote.
+ * @param preview: Vista previa que recibe los tiles terminados (puede ser nullptr).
+ * @return WavefrontStats: Estadísticas del render.
+ */
+WavefrontStats generateImageWavefront(const Scene& scene, const Camera& cam, Framebuffer& framebuffer, int width, int height, int rowBegin, int rowEnd, int maxDepth, double viewportWidth, double viewportHeight, double distanceToViewport, bool sortRays, int batchPixels, PreviewStream* preview) {
+    WavefrontStats stats;
+    Scene::DeferredKernel kernel = Scene::selectDeferredKernel(scene.getFeatures(maxDepth));
+    TilePool& pool = TilePool::shared();
+
+    // Lotes de filas de tiles alineadas a la cuadrícula global, como en generateImageRows
+    int tileSize = getTileSize();
+    int tileColumns = (width + tileSize - 1) / tileSize;
+    int bandRows = std::max(1, batchPixels / (width * tileSize)) * tileSize;
+    int firstTileY = (rowBegin / tileSize) * tileSize;
+
+    for (int bandY = firstTileY; bandY < rowEnd; bandY += bandRows) {
+        int y0 = std::max(bandY, rowBegin);
+        int y1 = std::min(bandY + bandRows, rowEnd);
+        int tileRows = (y1 - bandY + tileSize - 1) / tileSize;
+        std::vector<Vector3D> colors(static_cast<size_t>(y1 - y0) * width);
+        std::vector<int> raysLeft(colors.size(), MAX_SECONDARY_RAYS_PER_PIXEL);
+
+        // Rayos primarios por tiles; sus rayos secundarios se guardan en la lista de su tile
+        std::vector<std::vector<DeferredRay>> tileSpawned(static_cast<size_t>(tileColumns) * tileRows);
+        pool.run(tileColumns * tileRows, [&](int tile, int) {
+            int tileX = (tile % tileColumns) * tileSize;
+            int tileY = bandY + (tile / tileColumns) * tileSize;
+            int x1 = std::min(tileX + tileSize, width);
+            PrimitiveList candidates = cullPrimitivesForTile(scene, cam, tileX, tileY, x1, std::min(tileY + tileSize, height), width, height, viewportWidth, viewportHeight, distanceToViewport);
+            for (int y = std::max(tileY, y0); y < std::min(tileY + tileSize, y1); ++y) {
+                for (int x = tileX; x < x1; ++x) {
+                    std::uint32_t pixel = static_cast<std::uint32_t>((y - y0) * width + x);
+                    Ray ray = cam.generateRay(x, y, width, height, viewportWidth, viewportHeight, distanceToViewport);
+                    colors[pixel] = kernel(scene, ray, &candidates, maxDepth, 1.0, pixel, tileSpawned[tile]);
+                }
+            }
+        });
+        std::vector<DeferredRay> wave;
+        for (const auto& spawned : tileSpawned) {
+            enqueueDeferredRays(spawned.data(), spawned.size(), raysLeft, colors, wave);
+        }
+
+        // Un frente por profundidad: todos los rayos secundarios del lote que la alcanzan
+        std::vector<std::uint32_t> order;
+        for (int depth = maxDepth - 1, waveIndex = 1; !wave.empty(); --depth, ++waveIndex) {
+            stats.secondaryRays += static_cast<long long>(wave.size());
+            stats.waves = std::max(stats.waves, waveIndex);
+
+            auto sortStart = std::chrono::high_resolution_clock::now();
+            if (sortRays) {
+                sortRaysByCoherence(wave, order);
+            } else {
+                order.resize(wave.size());
+                std::iota(order.begin(), order.end(), 0u);
+            }
+            auto traceStart = std::chrono::high_resolution_clock::now();
+            stats.sortSeconds += std::chrono::duration<double>(traceStart - sortStart).count();
+
+            // Cada tarea traza un tramo consecutivo del orden; el color y los rayos generados se guardan por rayo
+            int taskCount = static_cast<int>((wave.size() + WAVEFRONT_TASK_RAYS - 1) / WAVEFRONT_TASK_RAYS);
+            std::vector<Vector3D> rayColors(wave.size());
+            std::vector<SpawnedRange> ranges(wave.size());
+            std::vector<std::vector<DeferredRay>> taskSpawned(taskCount);
+            pool.run(taskCount, [&](int task, int) {
+                std::vector<DeferredRay>& spawned = taskSpawned[task];
+                size_t end = std::min(wave.size(), static_cast<size_t>(task + 1) * WAVEFRONT_TASK_RAYS);
+                for (size_t i = static_cast<size_t>(task) * WAVEFRONT_TASK_RAYS; i < end; ++i) {
+                    std::uint32_t index = order[i];
+                    const DeferredRay& ray = wave[index];
+                    std::uint32_t first = static_cast<std::uint32_t>(spawned.size());
+                    rayColors[index] = kernel(scene, ray.ray, nullptr, depth, ray.weight, ray.pixel, spawned);
+                    ranges[index] = { static_cast<std::uint32_t>(task), first, static_cast<std::uint32_t>(spawned.size()) - first };
+                }
+            });
+            stats.traceSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - traceStart).count();
+
+            // Sumar los colores y encolar el frente siguiente en el orden en que se generaron los rayos
+            std::vector<DeferredRay> next;
+            for (size_t i = 0; i < wave.size(); ++i) {
+                colors[wave[i].pixel] = colors[wave[i].pixel] + rayColors[i] * wave[i].weight;
+                const SpawnedRange& range = ranges[i];
+                enqueueDeferredRays(taskSpawned[range.task].data() + range.first, range.count, raysLeft, colors, next);
+            }
+            wave.swap(next);
+        }
+
+        pool.run(y1 - y0, [&](int row, int) {
+            for (int x = 0; x < width; ++x) {
+                framebuffer.setPixel(x, y0 + row - rowBegin, colors[static_cast<size_t>(row) * width + x] * (1.0 / 255.0));
+            }
+        });
+        if (preview) {
+            for (int tileY = bandY; tileY < y1; tileY += tileSize) {
+                for (int tileX = 0; tileX < width; tileX += tileSize) {
+                    preview->publishTile(framebuffer, tileX, std::max(tileY, y0), std::min(tileX + tileSize, width), std::min(tileY + tileSize, y1), rowBegin);
+                }
+            }
+        }
+    }
+    if (preview) {
+        preview->endPass(1);
+    }
+    return stats;
+}